@@ -60,6 +60,8 @@ macro(pal_options)
 
     option(PAL_BUILD_NULL_DEVICE "Build null device backend for offline compilation?" ON)
 
+    cmake_dependent_option(PAL_BUILD_BENCHMARKS "Build PAL benchmarks?" OFF "PAL_BUILD_NULL_DEVICE" OFF)
+
     option(PAL_BUILD_GPUOPEN "Build GPUOpen developer driver support?" OFF)
 
     if (DEFINED PAL_ENABLE_LTO)
@@ -152,6 +154,7 @@ macro(pal_options)
     # Paths to PAL's dependencies
     set(PAL_METROHASH_PATH ${PROJECT_SOURCE_DIR}/src/util/imported/metrohash CACHE PATH "Specify the path to the MetroHash project.")
     set(   PAL_CWPACK_PATH ${PROJECT_SOURCE_DIR}/src/util/imported/cwpack    CACHE PATH "Specify the path to the CWPack project.")
+    set(      PAL_LZ4_PATH ${PROJECT_SOURCE_DIR}/shared/gpuopen/third_party/lz4 CACHE PATH "Specify the path to the LZ4 project.")
     set(      PAL_VAM_PATH ${PROJECT_SOURCE_DIR}/src/core/imported/vam       CACHE PATH "Specify the path to the VAM project.")
     set(     PAL_ADDR_PATH ${PROJECT_SOURCE_DIR}/src/core/imported/addrlib   CACHE PATH "Specify the path to the ADDRLIB project.")
 
@@ -385,8 +385,21 @@ struct CmdBufferCreateInfo
             /// Target queue uses dispatch tunneling.
             uint32  dispatchTunneling    :  1;
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+            /// Keeps this command buffer's command chunks when it is reset or begun, even if returnGpuMemory is set,
+            /// and reuses them for later recordings once the GPU has finished executing the old commands.  New chunks
+            /// are only taken from the command allocator if a recording needs more space or the old commands are still
+            /// executing.  This removes most command allocator traffic for command buffers that are re-recorded every
+            /// frame.  It has no effect on nested command buffers, or if the command allocator doesn't automatically
+            /// reuse memory, and the chunks are still returned if the command buffer switches command allocators.
+            uint32  retainChunksOnReset  :  1;
+
+            /// Reserved for future use.
+            uint32  reserved             : 28;
+#else
             /// Reserved for future use.
             uint32  reserved             : 29;
+#endif
         };
 
         /// Flags packed as 32-bit uint.
@@ -1424,7 +1424,16 @@ struct DeviceFinalizeInfo
             uint32 internalGpuMemAutoPriority   :  1; ///< Forces internal GPU memory allocation priorities to be
                                                       ///  determined automatically. It is an error to set this flag
                                                       ///  if the device does not report that it supports this feature.
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+            uint32 internStateObjects           :  1; ///< Share one hardware image between all color blend,
+                                                      ///  depth/stencil and MSAA state objects created from identical
+                                                      ///  create infos. Makes repeated state object creation cheap at
+                                                      ///  the cost of keeping unique images alive until the device is
+                                                      ///  cleaned up. Only honored by GFX9+ devices.
+            uint32 reserved                     : 27; ///< Reserved for future use.
+#else
             uint32 reserved                     : 28; ///< Reserved for future use.
+#endif
         };
         uint32 u32All;                    ///< Flags packed as 32-bit uint.
     } flags;                              ///< Device finalization flags.
@@ -42,6 +42,7 @@ class      IImage;
 class      IPrivateScreen;
 class      IScreen;
 class      ISwapChain;
+struct     MemoryImageCopyRegion;
 
 /// When used as the value of the viewFormatCount parameter of image creation it indicates that all compatible formats
 /// can be used for views of the created image.
@@ -562,6 +563,54 @@ public:
         SubresId      subresId,
         SubresLayout* pLayout) const = 0;
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    /// Copies linear texel data from CPU memory into a region of a CPU-mapped image subresource, swizzling it on the
+    /// CPU using the subresource's swizzle equation.  This is the host-side equivalent of
+    /// ICmdBuffer::CmdCopyMemoryToImage() and doesn't need a staging allocation or a GPU copy.
+    ///
+    /// The image must be single-sampled and must not have any compression metadata (e.g., it was created with
+    /// MetadataMode::Disabled), since the copy doesn't update compression state.  This function doesn't modify any
+    /// object state, so a client may split a large copy into several regions (e.g., ranges of slices or rows) and
+    /// execute them concurrently on many threads.
+    ///
+    /// @param [in]  region      Selects the image region and the layout of the linear data.  The gpuMemory* fields
+    ///                          describe pLinearData.  The region's swizzledFormat is ignored as this is a raw copy.
+    /// @param [in]  pLinearData CPU pointer to the linear texel data.
+    /// @param [out] pImageData    CPU pointer to the start of the image's data (i.e., the mapped GPU memory plus the
+    ///                            offset the image is bound at).
+    /// @param [in]  imageDataSize Size in bytes of the mapped range starting at pImageData.  It must cover the image's
+    ///                            whole GPU memory size as reported by GetGpuMemoryRequirements().
+    ///
+    /// @returns Success if the data was copied.  Otherwise, one of the following error codes may be returned:
+    ///          + ErrorInvalidPointer if pLinearData or pImageData is null.
+    ///          + ErrorInvalidValue if the region is out of range for this image.
+    ///          + ErrorInvalidMemorySize if imageDataSize is smaller than the image's GPU memory size.
+    ///          + Unsupported if the image is multisampled or has metadata, the subresource's layout can't be
+    ///            described by a swizzle equation, or the image's address library doesn't support CPU swizzling.
+    virtual Result CpuCopyMemoryToImage(
+        const MemoryImageCopyRegion& region,
+        const void*                  pLinearData,
+        void*                        pImageData,
+        gpusize                      imageDataSize) const = 0;
+
+    /// Copies texel data from a region of a CPU-mapped image subresource into linear CPU memory, unswizzling it on the
+    /// CPU.  This is the inverse of CpuCopyMemoryToImage() and has the same requirements.
+    ///
+    /// @param [in]  region      Selects the image region and the layout of the linear data.  The gpuMemory* fields
+    ///                          describe pLinearData.  The region's swizzledFormat is ignored as this is a raw copy.
+    /// @param [in]  pImageData    CPU pointer to the start of the image's data (i.e., the mapped GPU memory plus the
+    ///                            offset the image is bound at).
+    /// @param [in]  imageDataSize Size in bytes of the mapped range starting at pImageData.
+    /// @param [out] pLinearData   CPU pointer which receives the linear texel data.
+    ///
+    /// @returns Success if the data was copied.  Otherwise, one of the error codes listed for CpuCopyMemoryToImage().
+    virtual Result CpuCopyImageToMemory(
+        const MemoryImageCopyRegion& region,
+        const void*                  pImageData,
+        gpusize                      imageDataSize,
+        void*                        pLinearData) const = 0;
+#endif
+
     /// Reports the create info of image.
     ///
     /// @returns the reference to ImageCreateInfo
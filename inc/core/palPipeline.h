@@ -482,6 +482,9 @@ public:
 
     /// Returns a list of GPU memory allocations used by this pipeline.
     ///
+    /// Since interface 636, pipelines created from the same binary may share one copy of their code and data, in which
+    /// case each of them reports a second allocation holding its own register values.
+    ///
     /// @param [in,out] pNumEntries    Input value specifies the available size in pAllocInfoList; output value
     ///                                reports the number of GPU memory allocations.
     /// @param [out]    pAllocInfoList If pAllocInfoList=nullptr, then pNumEntries is ignored on input.  On output it
@@ -50,6 +50,92 @@ struct SymbolEntry
     uint32 m_index;
 };
 
+/// A lazily-decoded view of the PAL metadata of a pipeline ELF.
+///
+/// Building the view makes a single pass over the msgpack metadata blob and only records where the per-stage entries
+/// and the register map live.  Hardware stages, API shaders and registers are then decoded on demand by seeking a
+/// @ref MsgPackReader to the recorded offsets, so callers only pay for the fields they actually query.
+///
+/// The view does not own the metadata blob; it is only valid as long as the ELF it was built from is alive.  All of
+/// the accessors expect the MsgPackReader which was used to build the view (or another reader initialized with the
+/// same blob).
+class PipelineMetadataView
+{
+public:
+    PipelineMetadataView() { Reset(); }
+
+    /// Indexes the given metadata blob.
+    ///
+    /// @param [in/out] pReader           Pointer to the MsgPackReader to (re)init with the metadata blob.
+    /// @param [in]     pRawMetadata      The content of the metadata note.
+    /// @param [in]     metadataSize      The length of the metadata note.
+    /// @param [in]     metadataMajorVer  The major metadata version.
+    /// @param [in]     metadataMinorVer  The minor metadata version.
+    ///
+    /// @returns Success if successful, ErrorInvalidValue, ErrorUnknown or ErrorUnsupportedPipelineElfAbiVersion
+    ///          if a parser error occurred.
+    Result Init(
+        MsgPackReader* pReader,
+        const void*    pRawMetadata,
+        uint32         metadataSize,
+        uint32         metadataMajorVer,
+        uint32         metadataMinorVer);
+
+    /// Returns true if the metadata contains an entry for the given hardware stage.
+    bool HasHardwareStage(HardwareStage stage) const
+        { return (m_hwStageOffset[static_cast<uint32>(stage)] != InvalidOffset); }
+
+    /// Returns true if the metadata contains an entry for the given API shader.
+    bool HasShader(ApiShaderType shaderType) const
+        { return (m_shaderOffset[static_cast<uint32>(shaderType)] != InvalidOffset); }
+
+    /// Returns true if the metadata contains a register map.
+    bool HasRegisters() const { return (m_registersOffset != InvalidOffset); }
+
+    /// Decodes the metadata of a single hardware stage.  A stage without an entry is returned zeroed.
+    ///
+    /// @param [in/out] pReader    Pointer to the MsgPackReader used to build this view.
+    /// @param [in]     stage      The hardware stage to decode.
+    /// @param [out]    pMetadata  Pointer to where to store the deserialized stage metadata.
+    ///
+    /// @returns Success if successful, ErrorInvalidValue or ErrorUnknown if a parser error occurred.
+    Result GetHardwareStage(MsgPackReader* pReader, HardwareStage stage, HardwareStageMetadata* pMetadata) const;
+
+    /// Decodes the metadata of a single API shader.  A shader without an entry is returned zeroed.
+    ///
+    /// @param [in/out] pReader     Pointer to the MsgPackReader used to build this view.
+    /// @param [in]     shaderType  The API shader to decode.
+    /// @param [out]    pMetadata   Pointer to where to store the deserialized shader metadata.
+    ///
+    /// @returns Success if successful, ErrorInvalidValue or ErrorUnknown if a parser error occurred.
+    Result GetShader(MsgPackReader* pReader, ApiShaderType shaderType, ShaderMetadata* pMetadata) const;
+
+    /// Moves the reader's position to the start of the registers map, or to EOF if there are no registers.
+    ///
+    /// @param [in/out] pReader  Pointer to the MsgPackReader used to build this view.
+    ///
+    /// @returns Success if successful, Eof if there are no registers.
+    Result SeekRegisters(MsgPackReader* pReader) const { return pReader->Seek(m_registersOffset); }
+
+    /// Returns the offset of the registers map, suitable for @ref MsgPackReader::Seek().
+    uint32 RegistersOffset() const { return m_registersOffset; }
+
+    /// Returns the offset of the shader functions map, suitable for @ref MsgPackReader::Seek().
+    uint32 ShaderFunctionsOffset() const { return m_shaderFunctionsOffset; }
+
+private:
+    void Reset();
+    Result IndexPipeline(MsgPackReader* pReader);
+
+    // Seeking to an offset past the end of the blob leaves the reader at EOF.
+    static constexpr uint32 InvalidOffset = UINT32_MAX;
+
+    uint32 m_registersOffset;
+    uint32 m_shaderFunctionsOffset;
+    uint32 m_hwStageOffset[static_cast<uint32>(HardwareStage::Count)];
+    uint32 m_shaderOffset[static_cast<uint32>(ApiShaderType::Count)];
+};
+
 /// The PipelineAbiReader simplifies loading ELFs compatible with the pipeline ABI.
 class PipelineAbiReader
 {
@@ -80,6 +166,16 @@ public:
     ///          if a parser error occurred, ErrorInvalidPipelineElf if there is no metadata.
     Result GetMetadata(MsgPackReader* pReader, PalCodeObjectMetadata* pMetadata) const;
 
+    /// Get a lazily-decoded view of the Pipeline Metadata using the given MsgPackReader instance.  Unlike
+    /// @ref GetMetadata, this only indexes the metadata; nothing is deserialized until it is queried from the view.
+    ///
+    /// @param [in/out] pReader  Pointer to the MsgPackReader to use and (re)init with the metadata blob.
+    /// @param [out]    pView    Pointer to the view to build.
+    ///
+    /// @returns Success if successful, ErrorInvalidValue, ErrorUnknown or ErrorUnsupportedPipelineElfAbiVersion
+    ///          if a parser error occurred, ErrorInvalidPipelineElf if there is no metadata.
+    Result GetMetadataView(MsgPackReader* pReader, PipelineMetadataView* pView) const;
+
     /// Get the GFXIP version.
     ///
     /// @param [out] pGfxIpMajorVer The major version.
@@ -102,6 +198,13 @@ public:
     const Elf::SymbolTableEntry* GetGenericSymbol(const char* pName) const;
 
 private:
+    Result FindMetadata(
+        MsgPackReader* pReader,
+        const void**   ppRawMetadata,
+        uint32*        pMetadataSize,
+        uint32*        pMetadataMajorVer,
+        uint32*        pMetadataMinorVer) const;
+
     IndirectAllocator m_allocator;
     ElfReader::Reader m_elfReader;
 
@@ -162,7 +162,22 @@ struct QueueCreateInfo
 #else
         uint32 placeholder3                    :  1; ///< Reserved field. Set to 0.
 #endif
-        uint32 reserved                        : 26; ///< Reserved for future use.
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+        uint32 submitThread                    :  1; ///< Offload submissions to a PAL worker thread owned by this
+                                                     ///  queue. Submit() validates its inputs, then copies them and
+                                                     ///  returns; the worker performs the per-queue pre-processing,
+                                                     ///  command dumps, residency and OS submission in the same order
+                                                     ///  as the calls were made. pfnCmdDumpCb is therefore called on
+                                                     ///  the worker, after Submit() returned. WaitIdle() waits for the
+                                                     ///  worker to catch up. If the worker fails to execute a command,
+                                                     ///  the error is latched: every later Submit() and WaitIdle(), and
+                                                     ///  GetStatus() of any unsignaled fence submitted on this queue,
+                                                     ///  returns it. On Linux this requires sync object fences; queue
+                                                     ///  creation fails with ErrorInvalidFlags otherwise.
+#else
+        uint32 placeholder4                    :  1; ///< Reserved field. Set to 0.
+#endif
+        uint32 reserved                        : 25; ///< Reserved for future use.
     };
 
     uint32 numReservedCu;           ///< The number of reserved compute units for RT CU queue
@@ -67,6 +67,9 @@ struct ArchiveFileOpenInfo
     bool                allowAsyncFileIo;            ///< Allow use of OS specific asynchronous file routines
     bool                useBufferedReadMemory;       ///< Allow preloading/read-ahead of file into memory
     size_t              maxReadBufferMem;            ///< Maximum size allowed for read buffer
+    bool                useMemoryMappedReads;        ///< Serve reads from a read-only memory mapping of the file
+                                                     ///  instead of the read buffer. Allows ReadMapped() to return
+                                                     ///  entry data without copying it.
 };
 
 /// Get the memory size needed for an archive file object
@@ -137,7 +140,8 @@ public:
 
     /// Signal that information from a file block should be read into the read buffer if available
     ///
-    /// If async file reads are allowed, this function will return before the read is complete.
+    /// If async file reads are allowed, this function will return before the read is complete. Reads of data that is
+    /// still being streamed in will return NotReady until WaitForData() has been called or the data has arrived.
     ///
     /// @param [in] startLocation   Location in file to begin reading
     /// @param [in] maxReadSize     Maximum size in bytes of data to read from file
@@ -198,6 +202,80 @@ public:
         const ArchiveEntryHeader*   pHeader,
         void*                       pDataBuffer) = 0;
 
+    /// Get a pointer to the data for an entry located by its header without copying it
+    ///
+    /// The pointer refers to a read-only memory mapping of the archive file and remains valid until the archive file
+    /// is destroyed. The data has been checked against pHeader->dataCrc64 the same way Read() checks it; the check is
+    /// only made the first time each entry is mapped.
+    ///
+    /// @param [in]  pHeader    Header of data entry desired
+    /// @param [out] ppData     Pointer to pHeader->dataSize bytes of entry data
+    ///
+    /// @return Success if the data was mapped without error. Otherwise, one of the following may be returned:
+    ///         + Unsupported if the file was not opened with useMemoryMappedReads or the mapping is unavailable
+    ///         + ErrorInvalidPointer if pHeader or ppData is nullptr
+    ///         + ErrorInvalidValue if pHeader->dataPosition is past the end of the file
+    ///         + ErrorUnknown if there is an internal error.
+    virtual Result ReadMapped(
+        const ArchiveEntryHeader*   pHeader,
+        const void**                ppData)
+    {
+        return Result::Unsupported;
+    }
+
+    /// Block until the data for an entry located by its header is no longer being streamed in by Preload()
+    ///
+    /// Only the part of the file holding this entry's data is waited on, the rest of the preload continues in the
+    /// background.
+    /// Unlike the other calls this may run concurrently with the rest of the interface, so callers need not hold
+    /// their archive lock while blocked here. Re-read the entry afterwards, its pages may already have been recycled.
+    ///
+    /// @param [in]  pHeader        Header of data entry desired
+    ///
+    /// @return Success once a Read() of the entry will not return NotReady. Otherwise, one of the following may be
+    ///         returned:
+    ///         + ErrorInvalidPointer if pHeader is nullptr
+    virtual Result WaitForData(
+        const ArchiveEntryHeader*   pHeader)
+    {
+        return (pHeader != nullptr) ? Result::Success : Result::ErrorInvalidPointer;
+    }
+
+    /// Get the minor format version of the opened archive, see palArchiveFileFmt.h
+    ///
+    /// Entries may only use the format features of this version, even if the implementation knows of newer ones.
+    ///
+    /// @return Minor version from the archive's header, or zero if unknown
+    virtual uint32 GetMinorVersion() const { return 0; }
+
+    /// Get the number of entries covered by the archive's sorted entry index
+    ///
+    /// Entries with an ordinal ID below this count can be found with FindIndexedEntry() without reading their
+    /// headers one by one.
+    ///
+    /// @return Count of indexed entries, or zero if the archive has no usable index
+    virtual size_t GetIndexedEntryCount() const { return 0; }
+
+    /// Look up an entry by key in the archive's sorted entry index
+    ///
+    /// An index reported by GetIndexedEntryCount() never changes afterwards, so this may be called without
+    /// serializing against other calls on the archive.
+    ///
+    /// @param [in]  pEntryKey  Key of the entry, sizeof(ArchiveEntryHeader::entryKey) bytes
+    /// @param [out] pHeader    Header entry to be filled out
+    ///
+    /// @return Success if the key was found in the index. Otherwise one of the following may be returned:
+    ///         + NotFound if the key is not covered by the index. It may still be present in an entry that was
+    ///           written after the index.
+    ///         + Unsupported if the archive has no usable index
+    ///         + ErrorInvalidPointer if pEntryKey or pHeader is nullptr
+    virtual Result FindIndexedEntry(
+        const uint8*        pEntryKey,
+        ArchiveEntryHeader* pHeader)
+    {
+        return Result::Unsupported;
+    }
+
     /// Write header and data out to archive file
     ///
     /// If async file writes are allowed, this function will return before the write is fully complete.
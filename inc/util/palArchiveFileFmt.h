@@ -53,6 +53,7 @@ constexpr uint8 MagicArchiveMarker[16]  =                       ///< Identifies
      0x8b, 0xd1, 0x48, 0xf5, 0xd8, 0xf0, 0xb4, 0xa7};
 constexpr uint8 MagicFooterMarker[4]    = {'F','O','T','R'};    ///< Identifies the start of the ArchiveFileFooter
 constexpr uint8 MagicEntryMarker[4]     = {'N','T','R','Y'};    ///< Identifies the start of an ArchiveEntryHeader
+constexpr uint8 MagicIndexMarker[4]     = {'I','N','D','X'};    ///< Identifies the start of an ArchiveIndexFooter
 
 /**
 ***********************************************************************************************************************
@@ -60,7 +61,30 @@ constexpr uint8 MagicEntryMarker[4]     = {'N','T','R','Y'};    ///< Identifies
 ***********************************************************************************************************************
 */
 constexpr uint32 CurrentMajorVersion    = 1;    ///< Version number denoting compatibility breaking changes
-constexpr uint32 CurrentMinorVersion    = 1;    ///< Version number denoting changes that should be backward compatible
+constexpr uint32 CurrentMinorVersion    = 3;    ///< Version number denoting changes that should be backward compatible
+
+/**
+***********************************************************************************************************************
+* @brief Version history
+*
+*   1.1: Initial release.
+*   1.2: Archives may end with an entry index (see ArchiveIndexEntry). Readers that do not understand the index see it
+*        as an ordinary entry of type ArchiveIndexDataType and may ignore it.
+*   1.3: Entries may hold LZ4 compressed data (see ArchiveLz4DataFlag). Such entries are never written to archives of
+*        an older minor version, and readers must not use them from such archives.
+***********************************************************************************************************************
+*/
+constexpr uint32 MinIndexedMinorVersion = 2;    ///< First minor version that may contain an entry index
+constexpr uint32 MinLz4MinorVersion     = 3;    ///< First minor version that may contain LZ4 compressed entries
+
+/// ArchiveEntryHeader::dataType reserved for the entry index. Entries of this type do not hold client data.
+constexpr uint32 ArchiveIndexDataType   = 0x58444E49; // 'INDX'
+
+/// Flag set in ArchiveEntryHeader::dataType for entries holding LZ4 compressed data. The dataSize and dataCrc64 of such
+/// an entry describe the compressed data, while metaValue holds the size of the data once decompressed. Only valid in
+/// archives of minor version MinLz4MinorVersion or later. Readers of older versions don't check this flag, so writers
+/// must also store such entries under keys those readers never look up.
+constexpr uint32 ArchiveLz4DataFlag     = 0x80000000;
 
 /**
 ***********************************************************************************************************************
@@ -107,6 +131,40 @@ struct ArchiveEntryHeader
     uint8  entryKey[20];    ///< 160-bit (max) hash key for the entry
     uint32 metaValue;       ///< Optional meta-data value for use by consumer of data
 };
+
+/**
+***********************************************************************************************************************
+* @brief One record of the entry index.
+*
+* The entry index is stored as the data of the last entry in the archive (dataType == ArchiveIndexDataType) and
+* consists of one ArchiveIndexEntry for every preceding entry, sorted by entryKey, followed by an ArchiveIndexFooter.
+* Because the index data ends immediately before the ArchiveFileFooter, a reader can locate the whole index with a
+* single read from the end of the file instead of walking the ArchiveEntryHeader::nextBlock chain. The index is only
+* valid while it is the last entry; any entries found after it must be discovered by walking the chain.
+***********************************************************************************************************************
+*/
+struct ArchiveIndexEntry
+{
+    uint8  entryKey[20];    ///< 160-bit (max) hash key for the entry, the sort key of the index
+    uint32 ordinalId;       ///< Index of entry in the archive file as ordinal number
+    uint32 dataSize;        ///< Size of entry data
+    uint32 dataPosition;    ///< Byte offset of entry data from start of archive
+    uint64 dataCrc64;       ///< Checksum for data integrity
+    uint32 dataType;        ///< Optional ID signifying the data type for the entry
+    uint32 metaValue;       ///< Optional meta-data value for use by consumer of data
+};
+
+/**
+***********************************************************************************************************************
+* @brief Trailer of the entry index, stored directly in front of the ArchiveFileFooter
+***********************************************************************************************************************
+*/
+struct ArchiveIndexFooter
+{
+    uint8  indexMarker[4];  ///< Fixed marker to designate the index, must match MagicIndexMarker
+    uint32 entryCount;      ///< Number of ArchiveIndexEntry records in the index
+    uint32 headerPosition;  ///< Byte offset of the index's own ArchiveEntryHeader from start of archive
+};
 #pragma pack(pop)
 
 } // namespace Util
@@ -382,6 +382,12 @@ struct MemoryCacheCreateInfo
     bool                     evictOnFull;     ///< Whether or not the cache should evict entries based on LRU to
                                               ///  make room for new ones
     bool                     evictDuplicates; ///< Whether or not the cache should evict entries with a duplicate hash
+    uint32                   numShards;       ///< Number of independently locked shards the cache is split into,
+                                              ///  selected by bits of the entry hash. maxObjectCount and
+                                              ///  maxMemorySize apply to the whole cache. Zero or one selects a
+                                              ///  single shard with strict LRU eviction; larger values are rounded
+                                              ///  up to a power of two and use approximate (clock) LRU so that
+                                              ///  cache hits only need a shared lock.
 };
 
 /// Get the memory size for a in-memory cache layer
@@ -437,14 +443,20 @@ Result GetMemoryCacheLayerHashIds(
 */
 struct ArchiveFileCacheCreateInfo
 {
-    CacheLayerBaseCreateInfo baseInfo;     ///< Base cache layer creation info.
-    IArchiveFile*            pFile;        ///< Archive file to use for storage, must exist for the lifetime of the
-                                           ///  cache layer. May be shared between multiple layers but no internal
-                                           ///  thread safety is provided.
-    const IPlatformKey*      pPlatformKey; ///< Optional platform key, allows for data stored to the archive file
-                                           ///  to be keyed to a specific driver/platform fingerprint.
-    uint32                   dataTypeId;   ///< Optional 32-bit data type identifier, allows heterogenous data to be
-                                           ///  stored within an archive file.
+    CacheLayerBaseCreateInfo baseInfo;       ///< Base cache layer creation info.
+    IArchiveFile*            pFile;          ///< Archive file to use for storage, must exist for the lifetime of the
+                                             ///  cache layer. May be shared between multiple layers but no internal
+                                             ///  thread safety is provided.
+    const IPlatformKey*      pPlatformKey;   ///< Optional platform key, allows for data stored to the archive file
+                                             ///  to be keyed to a specific driver/platform fingerprint.
+    uint32                   dataTypeId;     ///< Optional 32-bit data type identifier, allows heterogenous data to be
+                                             ///  stored within an archive file.
+    bool                     useCompression; ///< Store data LZ4 compressed whenever that makes it smaller. Compressed
+                                             ///  data is decompressed transparently on load. Ignored for archives
+                                             ///  written by a version of the format without compression.
+    size_t                   preloadSize;    ///< If non-zero, preload up to this many bytes of the archive file from
+                                             ///  its start when the layer is created (see IArchiveFile::Preload()).
+                                             ///  With async file I/O the data streams in while the layer is in use.
 };
 
 /// Get the memory size for a archive file backed cache layer
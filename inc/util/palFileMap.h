@@ -64,7 +64,7 @@ public:
     ///
     /// @param  pFileName      Name of the file to create a mapping for.
     /// @param  allowWrite     Flag that indicates whhether or not to request executeable access.
-    /// @param  maximumSize    Maximum size allowed for the lifetime of the file mapping.
+    /// @param  maximumSize    Maximum size allowed for the lifetime of the file mapping, ignored when read-only.
     /// @param  pName          System level name for mapping object, used to share the mapping across processes
     ///
     /// @returns Success if the file mapping was successfully created.
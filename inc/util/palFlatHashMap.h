@@ -0,0 +1,293 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  palFlatHashMap.h
+ * @brief PAL utility collection FlatHashMap class declaration.
+ ***********************************************************************************************************************
+ */
+
+#pragma once
+
+#include "palHashBase.h"
+#include "palHashMap.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PAL_FLAT_HASH_MAP_SSE2 1
+#else
+#define PAL_FLAT_HASH_MAP_SSE2 0
+#endif
+
+namespace Util
+{
+
+// Forward declarations.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc> class FlatHashMap;
+
+/// Group of control bytes probed together by @ref FlatHashMap.
+///
+/// Each slot of a FlatHashMap has one control byte.  Empty and deleted slots have the sign bit set; a full slot stores
+/// the low seven bits of its key's hash.  A group of control bytes is compared against a hash tag in one step (with
+/// SSE2 where available), producing a bit-mask of candidate slots.
+class FlatHashGroup
+{
+public:
+    static constexpr uint32 Width   = 16;    ///< Number of slots (and control bytes) in a group.
+    static constexpr int8   Empty   = -128;  ///< Control byte of a slot that has never been used.
+    static constexpr int8   Deleted = -2;    ///< Control byte of a slot whose entry has been erased.
+
+    /// Loads the group of control bytes at pCtrl, which must be aligned to Width bytes.
+    explicit FlatHashGroup(const int8* pCtrl);
+
+    /// Returns a bit-mask of the slots whose control byte matches the given hash tag.
+    uint32 Match(int8 tag) const;
+
+    /// Returns a bit-mask of the empty slots.
+    uint32 MatchEmpty() const;
+
+    /// Returns a bit-mask of the empty or deleted slots.
+    uint32 MatchEmptyOrDeleted() const;
+
+private:
+#if PAL_FLAT_HASH_MAP_SSE2
+    __m128i m_ctrl;
+#else
+    // Without SSE2 the control bytes are tested eight at a time in 64-bit words.
+    static constexpr uint64 LsbMask = 0x0101010101010101ull;
+    static constexpr uint64 MsbMask = 0x8080808080808080ull;
+
+    static uint32 ToBitMask(const uint64 (&byteMasks)[2]);
+
+    uint64  m_ctrl[Width / sizeof(uint64)];
+#endif
+
+    PAL_DISALLOW_DEFAULT_CTOR(FlatHashGroup);
+};
+
+/**
+ ***********************************************************************************************************************
+ * @brief  Iterator for traversal of elements in a FlatHashMap.
+ *
+ * Backward iterating is not supported.  Erasing the entry the iterator currently points at is allowed; any other
+ * modification of the map invalidates the iterator.
+ ***********************************************************************************************************************
+ */
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+class FlatHashIterator
+{
+public:
+    /// Convenience typedef for the associated container for this templated iterator.
+    typedef FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc> Container;
+
+    ~FlatHashIterator() { }
+
+    /// Returns a pointer to current entry.  Will return null if the iterator has been advanced off the end of the
+    /// container.
+    HashMapEntry<Key, Value>* Get() const
+        { return (m_slot < m_pContainer->m_capacity) ? &m_pContainer->m_pSlots[m_slot] : nullptr; }
+
+    /// Advances the iterator to the next position (move forward).
+    void Next();
+
+private:
+    FlatHashIterator(const Container* pContainer, uint32 startSlot);
+
+    // Moves m_slot forward until it points at a full slot or runs off the end of the container.
+    void SkipUnusedSlots();
+
+    const Container* const m_pContainer;  // Hash container that we're iterating over.
+    uint32                 m_slot;        // Index of the slot the iterator points at.
+
+    PAL_DISALLOW_DEFAULT_CTOR(FlatHashIterator);
+
+    // Although this is a transgression of coding standards, it means that Container does not need to have a public
+    // interface specifically to implement this class. The added encapsulation this provides is worthwhile.
+    friend class FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>;
+};
+
+/**
+ ***********************************************************************************************************************
+ * @brief Templated open-addressing hash map container which grows as entries are added.
+ *
+ * This container has the same interface as @ref HashMap and stores the same @ref HashMapEntry type, so the two are
+ * interchangeable for most clients.  Supported operations:
+ *
+ * - Searching
+ * - Insertion
+ * - Deletion
+ * - Iteration
+ *
+ * Entries live in one flat array of slots, with a parallel array of one-byte control words.  The slots are divided into
+ * groups of FlatHashGroup::Width; a lookup picks a starting group from the key's hash and probes whole groups at a time
+ * by comparing their control bytes against seven bits of the hash, so most lookups touch one group of control bytes and
+ * one slot.  When the number of used slots would exceed 7/8 of the capacity the table is rehashed into one twice the
+ * size (or the same size, if erased entries make up most of the used slots), so unlike @ref HashMap the cost of a
+ * lookup doesn't degrade as the map grows past its initial size.
+ *
+ * HashFunc and EqualFunc accept the same functors as @ref HashMap.  The 32-bit hash is mixed before use, so the cheap
+ * DefaultHashFunc is still a good choice for pointer keys.  As with HashMap, keys and values must be POD-style types.
+ *
+ * @warning This class is not thread-safe for Insert, FindAllocate, Erase, or iteration!
+ * @warning Insert and FindAllocate may rehash the table, which invalidates all value pointers and iterators previously
+ *          obtained from the map.  Erase only invalidates pointers to the erased entry.
+ * @warning Init() must be called before using this container. Begin() and Reset() can be safely called before
+ *          initialization and Begin() will always return an iterator that points to null.
+ ***********************************************************************************************************************
+ */
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc  = DefaultHashFunc,
+         template<typename> class EqualFunc = DefaultEqualFunc>
+class FlatHashMap
+{
+public:
+    /// Convenience typedef for a templated entry of this hash map.
+    typedef HashMapEntry<Key, Value> Entry;
+
+    /// Convenience typedef for iterators of this templated FlatHashMap.
+    typedef FlatHashIterator<Key, Value, Allocator, HashFunc, EqualFunc> Iterator;
+
+    /// Constructor.
+    ///
+    /// @param [in] numEntries Number of entries the map should be able to hold before it first needs to grow.
+    /// @param [in] pAllocator Pointer to an allocator that will create system memory requested by this hash container.
+    explicit FlatHashMap(uint32 numEntries, Allocator*const pAllocator);
+    ~FlatHashMap() { PAL_SAFE_FREE(m_pMemory, m_pAllocator); }
+
+    /// Initializes the hash container.
+    ///
+    /// @returns @ref Success if the initialization completed successfully, or ErrorOutOfMemory if the operation failed
+    ///          due to an internal failure to allocate system memory.
+    Result Init();
+
+    /// Returns number of entries in the container.
+    uint32 GetNumEntries() const { return m_numEntries; }
+
+    /// Returns an iterator pointing to the first entry.
+    Iterator Begin() const;
+
+    /// Empty the hash container.  The table keeps its current capacity.
+    void Reset();
+
+    /// Grows the table, if needed, so that it can hold the given number of entries without rehashing.
+    ///
+    /// @param [in] numEntries Total number of entries the table should be able to hold.
+    ///
+    /// @returns @ref Success if the operation completed successfully, or @ref ErrorOutOfMemory if the operation failed
+    ///          because an internal memory allocation failed.
+    Result Reserve(uint32 numEntries);
+
+    /// Finds a given entry; if no entry was found, allocate it.
+    ///
+    /// @param [in]  key      Key to search for.
+    /// @param [out] pExisted True if an entry for the specified key existed before this call was made.  False indicates
+    ///                       that a new entry was allocated as a result of this call.
+    /// @param [out] ppValue  Readable/writeable value in the hash map corresponding to the specified key.  Newly
+    ///                       allocated values are zero-initialized.
+    ///
+    /// @returns @ref Success if the operation completed successfully, or @ref ErrorOutOfMemory if the operation failed
+    ///          because an internal memory allocation failed.
+    Result FindAllocate(const Key& key, bool* pExisted, Value** ppValue);
+
+    /// Gets a pointer to the value that matches the specified key.
+    ///
+    /// @param [in] key Key to search for.
+    ///
+    /// @returns A pointer to the value that matches the specified key or null if an entry for the key does not exist.
+    Value* FindKey(const Key& key) const;
+
+    /// Inserts a key/value pair entry if the key doesn't already exist in the hash map.
+    ///
+    /// @warning No action will be taken if an entry matching this key already exists, even if the specified value
+    ///          differs from the current value stored in the entry matching the specified key.
+    ///
+    /// @param [in] key   Key of the new entry to insert.
+    /// @param [in] value Value of the new entry to insert.
+    ///
+    /// @returns @ref Success if the operation completed successfully, or @ref ErrorOutOfMemory if the operation failed
+    ///          because an internal memory allocation failed.
+    Result Insert(const Key& key, const Value& value);
+
+    /// Removes an entry that matches the specified key.
+    ///
+    /// @param [in] key Key of the entry to erase.
+    ///
+    /// @returns True if the erase completed successfully, false if an entry for this key did not exist.
+    bool Erase(const Key& key);
+
+private:
+    // Returns the mixed hash of a key.  The low seven bits are the control byte tag, the rest select the first group.
+    uint32 HashKey(const Key& key) const;
+
+    // Returns the slot index holding the specified key, or m_capacity if the key isn't in the table.
+    uint32 FindSlot(const Key& key, uint32 hash) const;
+
+    // Returns the index of the first empty or deleted slot along the probe sequence for the specified hash.
+    static uint32 FindFreeSlot(const int8* pCtrl, uint32 numGroups, uint32 hash);
+
+    // Moves every entry into a newly allocated table with the specified number of groups.
+    Result Rehash(uint32 numGroups);
+
+    // Number of slots which may be used (full or deleted) before the table must be rehashed.
+    static uint32 MaxLoad(uint32 capacity) { return capacity - (capacity / 8); }
+
+    // Number of groups needed to hold the specified number of entries without rehashing.
+    static uint32 GroupsForEntries(uint32 numEntries);
+
+    static constexpr uint32 TagBits = 7;
+    static constexpr uint32 TagMask = (1u << TagBits) - 1;
+
+    const HashFunc<Key>  m_hashFunc;    // Hash functor object.
+    const EqualFunc<Key> m_equalFunc;   // Key compare function object.
+    Allocator*const      m_pAllocator;  // Allocator for the table memory.
+
+    uint32               m_numGroups;   // Number of groups in the table; always a power of 2.
+    uint32               m_capacity;    // Number of slots in the table.
+    uint32               m_numEntries;  // Number of full slots.
+    uint32               m_growthLeft;  // Number of empty slots which can be filled before the table must be rehashed.
+    void*                m_pMemory;     // Table allocation, holding the control bytes followed by the slots.
+    int8*                m_pCtrl;       // Control byte of each slot.
+    Entry*               m_pSlots;      // Key/value storage of each slot.
+
+    PAL_DISALLOW_DEFAULT_CTOR(FlatHashMap);
+    PAL_DISALLOW_COPY_AND_ASSIGN(FlatHashMap);
+
+    // Although this is a transgression of coding standards, it prevents FlatHashIterator requiring a public
+    // constructor; constructing a 'bare' FlatHashIterator (i.e. without calling FlatHashMap::Begin) can never be a
+    // legal operation, so this means that these two classes are much safer to use.
+    friend class FlatHashIterator<Key, Value, Allocator, HashFunc, EqualFunc>;
+};
+
+} // Util
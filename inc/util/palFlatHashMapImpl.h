@@ -0,0 +1,617 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  palFlatHashMapImpl.h
+ * @brief PAL utility collection FlatHashMap class implementation.
+ ***********************************************************************************************************************
+ */
+
+#pragma once
+
+#include "palFlatHashMap.h"
+#include "palHashBaseImpl.h"
+#include "palInlineFuncs.h"
+
+namespace Util
+{
+
+// =====================================================================================================================
+PAL_INLINE FlatHashGroup::FlatHashGroup(
+    const int8* pCtrl)
+{
+    PAL_ASSERT(IsPow2Aligned(reinterpret_cast<uintptr_t>(pCtrl), Width));
+
+#if PAL_FLAT_HASH_MAP_SSE2
+    m_ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(pCtrl));
+#else
+    memcpy(m_ctrl, pCtrl, sizeof(m_ctrl));
+#endif
+}
+
+#if PAL_FLAT_HASH_MAP_SSE2
+// =====================================================================================================================
+// Returns a bit-mask of the slots whose control byte matches the given hash tag.
+PAL_INLINE uint32 FlatHashGroup::Match(
+    int8 tag
+    ) const
+{
+    return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), m_ctrl)));
+}
+
+// =====================================================================================================================
+// Returns a bit-mask of the empty slots.
+PAL_INLINE uint32 FlatHashGroup::MatchEmpty() const
+{
+    return Match(Empty);
+}
+
+// =====================================================================================================================
+// Returns a bit-mask of the empty or deleted slots.  Both have the sign bit set, full slots don't.
+PAL_INLINE uint32 FlatHashGroup::MatchEmptyOrDeleted() const
+{
+    return static_cast<uint32>(_mm_movemask_epi8(m_ctrl));
+}
+#else
+// =====================================================================================================================
+// Packs the high bit of each byte of two 64-bit words into one bit per byte, in memory order.
+PAL_INLINE uint32 FlatHashGroup::ToBitMask(
+    const uint64 (&byteMasks)[2])
+{
+    constexpr uint64 Gather = 0x0102040810204080ull;
+
+    return static_cast<uint32>(((byteMasks[0] >> 7) * Gather) >> 56) |
+           (static_cast<uint32>(((byteMasks[1] >> 7) * Gather) >> 56) << 8);
+}
+
+// =====================================================================================================================
+// Returns a bit-mask of the slots whose control byte matches the given hash tag.  This is a byte-wise zero test on the
+// control bytes XOR'd with the tag.  It can report a false match in a byte above a true match, which is harmless since
+// every candidate slot's key is compared anyway.
+PAL_INLINE uint32 FlatHashGroup::Match(
+    int8 tag
+    ) const
+{
+    uint64 byteMasks[2] = {};
+
+    for (uint32 i = 0; i < 2; i++)
+    {
+        const uint64 x = m_ctrl[i] ^ (LsbMask * static_cast<uint8>(tag));
+
+        byteMasks[i] = (x - LsbMask) & ~x & MsbMask;
+    }
+
+    return ToBitMask(byteMasks);
+}
+
+// =====================================================================================================================
+// Returns a bit-mask of the empty slots.  Only empty control bytes have the sign bit set and bit 1 clear.
+PAL_INLINE uint32 FlatHashGroup::MatchEmpty() const
+{
+    const uint64 byteMasks[2] = { m_ctrl[0] & ~(m_ctrl[0] << 6) & MsbMask, m_ctrl[1] & ~(m_ctrl[1] << 6) & MsbMask };
+
+    return ToBitMask(byteMasks);
+}
+
+// =====================================================================================================================
+// Returns a bit-mask of the empty or deleted slots.  Both have the sign bit set, full slots don't.
+PAL_INLINE uint32 FlatHashGroup::MatchEmptyOrDeleted() const
+{
+    const uint64 byteMasks[2] = { m_ctrl[0] & MsbMask, m_ctrl[1] & MsbMask };
+
+    return ToBitMask(byteMasks);
+}
+#endif
+
+// =====================================================================================================================
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE FlatHashIterator<Key, Value, Allocator, HashFunc, EqualFunc>::FlatHashIterator(
+    const Container* pContainer,  // [retained] The hash container to iterate over
+    uint32           startSlot)   // The first slot to consider
+    :
+    m_pContainer(pContainer),
+    m_slot(startSlot)
+{
+    SkipUnusedSlots();
+}
+
+// =====================================================================================================================
+// Proceeds to the next entry, null if to the end.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE void FlatHashIterator<Key, Value, Allocator, HashFunc, EqualFunc>::Next()
+{
+    if (m_slot < m_pContainer->m_capacity)
+    {
+        m_slot++;
+        SkipUnusedSlots();
+    }
+}
+
+// =====================================================================================================================
+// Moves forward until the iterator points at a full slot or runs off the end of the container.  Whole groups of unused
+// slots are skipped at once.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE void FlatHashIterator<Key, Value, Allocator, HashFunc, EqualFunc>::SkipUnusedSlots()
+{
+    constexpr uint32 Width     = FlatHashGroup::Width;
+    constexpr uint32 GroupMask = (1u << Width) - 1;
+
+    while (m_slot < m_pContainer->m_capacity)
+    {
+        const uint32 groupBase = m_slot & ~(Width - 1);
+        const uint32 usedMask  = GroupMask & (GroupMask << (m_slot - groupBase));
+        const uint32 fullMask  = ~FlatHashGroup(&m_pContainer->m_pCtrl[groupBase]).MatchEmptyOrDeleted() & usedMask;
+        uint32       index     = 0;
+
+        if (BitMaskScanForward(&index, fullMask))
+        {
+            m_slot = groupBase + index;
+            break;
+        }
+
+        m_slot = groupBase + Width;
+    }
+}
+
+// =====================================================================================================================
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::FlatHashMap(
+    uint32          numEntries,
+    Allocator*const pAllocator)
+    :
+    m_hashFunc(),
+    m_equalFunc(),
+    m_pAllocator(pAllocator),
+    m_numGroups(GroupsForEntries(numEntries)),
+    m_capacity(0),
+    m_numEntries(0),
+    m_growthLeft(0),
+    m_pMemory(nullptr),
+    m_pCtrl(nullptr),
+    m_pSlots(nullptr)
+{
+}
+
+// =====================================================================================================================
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE Result FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Init()
+{
+    PAL_ASSERT(m_pMemory == nullptr);
+
+    return Rehash(m_numGroups);
+}
+
+// =====================================================================================================================
+// Returns an iterator pointing to the first entry.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE FlatHashIterator<Key, Value, Allocator, HashFunc, EqualFunc>
+    FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Begin() const
+{
+    // An empty map starts off the end of the slots, which also covers the case where the table hasn't been allocated.
+    return Iterator(this, (m_numEntries > 0) ? 0 : m_capacity);
+}
+
+// =====================================================================================================================
+// Empty the hash table.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE void FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Reset()
+{
+    if (m_pCtrl != nullptr)
+    {
+        memset(m_pCtrl, FlatHashGroup::Empty, m_capacity);
+    }
+
+    m_numEntries = 0;
+    m_growthLeft = MaxLoad(m_capacity);
+}
+
+// =====================================================================================================================
+// Grows the table so that it can hold the given number of entries without rehashing.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE Result FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Reserve(
+    uint32 numEntries)
+{
+    Result       result    = Result::Success;
+    const uint32 numGroups = GroupsForEntries(numEntries);
+
+    if ((numGroups > m_numGroups) || (m_pMemory == nullptr))
+    {
+        result = Rehash(Max(numGroups, m_numGroups));
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Gets a pointer to the value that matches the key.  If the key is not present, a pointer to empty space for the value
+// is returned.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE Result FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::FindAllocate(
+    const Key& key,       // Key to search for.
+    bool*      pExisted,  // [out] True if a matching key was found.
+    Value**    ppValue)   // [out] Pointer to the value entry of the hash map's entry for the specified key.
+{
+    PAL_ASSERT(pExisted != nullptr);
+    PAL_ASSERT(ppValue != nullptr);
+
+    Result       result = Result::Success;
+    const uint32 hash   = HashKey(key);
+    uint32       slot   = FindSlot(key, hash);
+
+    *pExisted = (slot != m_capacity);
+    *ppValue  = nullptr;
+
+    if (*pExisted == false)
+    {
+        if (m_growthLeft == 0)
+        {
+            // The table is at its maximum load.  If erased entries make up most of the used slots, rehashing at the
+            // current size is enough to reclaim them; otherwise double the table.
+            const bool   purgeOnly = (m_pMemory != nullptr) && (m_numEntries < (MaxLoad(m_capacity) / 2));
+            const uint32 numGroups = purgeOnly ? m_numGroups : (m_numGroups * 2);
+
+            result = Rehash(numGroups);
+        }
+
+        if (result == Result::Success)
+        {
+            slot = FindFreeSlot(m_pCtrl, m_numGroups, hash);
+
+            // Reusing a deleted slot doesn't bring the table any closer to needing a rehash.
+            if (m_pCtrl[slot] == FlatHashGroup::Empty)
+            {
+                m_growthLeft--;
+            }
+
+            m_pCtrl[slot] = static_cast<int8>(hash & TagMask);
+
+            memset(&m_pSlots[slot], 0, sizeof(Entry));
+            m_pSlots[slot].key = key;
+
+            m_numEntries++;
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        *ppValue = &m_pSlots[slot].value;
+    }
+
+    PAL_ASSERT(result == Result::Success);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Gets a pointer to the value that matches the key.  Returns null if no entry is present matching the specified key.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE Value* FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::FindKey(
+    const Key& key
+    ) const
+{
+    const uint32 slot = FindSlot(key, HashKey(key));
+
+    return (slot != m_capacity) ? &m_pSlots[slot].value : nullptr;
+}
+
+// =====================================================================================================================
+// Inserts a key/value pair entry if it doesn't already exist.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE Result FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Insert(
+    const Key&   key,
+    const Value& value)
+{
+    bool   existed = true;
+    Value* pValue  = nullptr;
+
+    Result result = FindAllocate(key, &existed, &pValue);
+
+    // Add the new value if it did not exist already. If FindAllocate returns Success, pValue != nullptr.
+    if ((result == Result::Success) && (existed == false))
+    {
+        *pValue = value;
+    }
+
+    PAL_ASSERT(result == Result::Success);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Removes an entry with the specified key.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE bool FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Erase(
+    const Key& key)
+{
+    const uint32 slot  = FindSlot(key, HashKey(key));
+    const bool   found = (slot != m_capacity);
+
+    if (found)
+    {
+        const uint32 groupBase = slot & ~(FlatHashGroup::Width - 1);
+
+        // A group that still has an empty slot has never been full, so no probe sequence has ever continued past it
+        // and the slot can simply become empty again.  Otherwise leave a tombstone so later lookups keep probing.
+        if (FlatHashGroup(&m_pCtrl[groupBase]).MatchEmpty() != 0)
+        {
+            m_pCtrl[slot] = FlatHashGroup::Empty;
+            m_growthLeft++;
+        }
+        else
+        {
+            m_pCtrl[slot] = FlatHashGroup::Deleted;
+        }
+
+        PAL_ASSERT(m_numEntries > 0);
+        m_numEntries--;
+    }
+
+    return found;
+}
+
+// =====================================================================================================================
+// Hashes a key with the client's hash functor and mixes the result, so that hash functors which leave some bits
+// constant (like DefaultHashFunc) still spread keys over all groups and tags.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE uint32 FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::HashKey(
+    const Key& key
+    ) const
+{
+    uint32 hash = m_hashFunc(&key, sizeof(key));
+
+    // This is the MurmurHash3 32-bit finalizer.
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+// =====================================================================================================================
+// Returns the slot holding the specified key, or m_capacity if the key isn't in the table.  Groups are visited in
+// triangular order, which covers every group exactly once when the group count is a power of 2.  The probe stops at
+// the first group with an empty slot: the key would have been placed there if the probe had reached it on insertion.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE uint32 FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::FindSlot(
+    const Key& key,
+    uint32     hash
+    ) const
+{
+    uint32 slot = m_capacity;
+
+    if (m_pCtrl != nullptr)
+    {
+        const int8   tag       = static_cast<int8>(hash & TagMask);
+        const uint32 groupMask = m_numGroups - 1;
+        uint32       group     = (hash >> TagBits) & groupMask;
+
+        for (uint32 step = 1; step <= m_numGroups; step++)
+        {
+            const uint32        groupBase = group * FlatHashGroup::Width;
+            const FlatHashGroup ctrl(&m_pCtrl[groupBase]);
+            uint32              matches   = ctrl.Match(tag);
+            uint32              index     = 0;
+
+            while (BitMaskScanForward(&index, matches))
+            {
+                if (m_equalFunc(m_pSlots[groupBase + index].key, key))
+                {
+                    slot = groupBase + index;
+                    break;
+                }
+
+                matches &= (matches - 1);
+            }
+
+            if ((slot != m_capacity) || (ctrl.MatchEmpty() != 0))
+            {
+                break;
+            }
+
+            group = (group + step) & groupMask;
+        }
+    }
+
+    return slot;
+}
+
+// =====================================================================================================================
+// Returns the first empty or deleted slot along the probe sequence for the specified hash.  The table always has at
+// least one empty slot, so this can't fail.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE uint32 FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::FindFreeSlot(
+    const int8* pCtrl,
+    uint32      numGroups,
+    uint32      hash)
+{
+    const uint32 groupMask = numGroups - 1;
+    uint32       group     = (hash >> TagBits) & groupMask;
+    uint32       slot      = 0;
+    uint32       index     = 0;
+
+    for (uint32 step = 1; ; step++)
+    {
+        const uint32 groupBase = group * FlatHashGroup::Width;
+
+        if (BitMaskScanForward(&index, FlatHashGroup(&pCtrl[groupBase]).MatchEmptyOrDeleted()))
+        {
+            slot = groupBase + index;
+            break;
+        }
+
+        PAL_ASSERT(step < numGroups);
+        group = (group + step) & groupMask;
+    }
+
+    return slot;
+}
+
+// =====================================================================================================================
+// Moves every entry into a newly allocated table with the specified number of groups, dropping any tombstones.  The
+// current table is left untouched if the allocation fails.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE Result FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::Rehash(
+    uint32 numGroups)
+{
+    PAL_ASSERT(IsPowerOfTwo(numGroups));
+
+    // The group index comes from the hash bits above the tag, which limits how many groups can be addressed.
+    constexpr uint32 MaxNumGroups = 1u << (32 - TagBits);
+
+    Result result  = Result::ErrorOutOfMemory;
+    void*  pMemory = nullptr;
+
+    const uint32 capacity   = numGroups * FlatHashGroup::Width;
+    const size_t slotOffset = Pow2Align(static_cast<size_t>(capacity), alignof(Entry));
+
+    if (numGroups <= MaxNumGroups)
+    {
+        pMemory = PAL_MALLOC_ALIGNED(slotOffset + (capacity * sizeof(Entry)),
+                                     Max(static_cast<size_t>(FlatHashGroup::Width), alignof(Entry)),
+                                     m_pAllocator,
+                                     AllocInternal);
+    }
+
+    if (pMemory != nullptr)
+    {
+        int8*const  pCtrl  = static_cast<int8*>(pMemory);
+        Entry*const pSlots = static_cast<Entry*>(VoidPtrInc(pMemory, slotOffset));
+
+        memset(pCtrl, FlatHashGroup::Empty, capacity);
+
+        for (uint32 i = 0; i < m_capacity; i++)
+        {
+            if (m_pCtrl[i] >= 0)
+            {
+                const uint32 slot = FindFreeSlot(pCtrl, numGroups, HashKey(m_pSlots[i].key));
+
+                pCtrl[slot] = m_pCtrl[i];
+                memcpy(&pSlots[slot], &m_pSlots[i], sizeof(Entry));
+            }
+        }
+
+        PAL_SAFE_FREE(m_pMemory, m_pAllocator);
+
+        m_pMemory    = pMemory;
+        m_pCtrl      = pCtrl;
+        m_pSlots     = pSlots;
+        m_numGroups  = numGroups;
+        m_capacity   = capacity;
+        m_growthLeft = MaxLoad(capacity) - m_numEntries;
+
+        // The hash func should make sure the hashing result always contains enough effective bits to pick a group.
+        m_hashFunc.Init(Log2(numGroups));
+
+        result = Result::Success;
+    }
+
+    PAL_ALERT(result != Result::Success);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Number of groups needed to hold the specified number of entries without rehashing.
+template<typename Key,
+         typename Value,
+         typename Allocator,
+         template<typename> class HashFunc,
+         template<typename> class EqualFunc>
+PAL_INLINE uint32 FlatHashMap<Key, Value, Allocator, HashFunc, EqualFunc>::GroupsForEntries(
+    uint32 numEntries)
+{
+    // Enough slots that numEntries stays within the 7/8 load limit.
+    const uint64 numSlots = RoundUpQuotient(static_cast<uint64>(numEntries) * 8, static_cast<uint64>(7));
+
+    return Pow2Pad(Max(static_cast<uint32>(RoundUpQuotient(numSlots, static_cast<uint64>(FlatHashGroup::Width))), 1u));
+}
+
+} // Util
@@ -324,6 +324,16 @@ extern uint64 AtomicExchange64(volatile uint64* pTarget, uint64 value);
 /// @returns Previous value at *ppTarget.
 extern void* AtomicExchangePointer(void*volatile* ppTarget, void* pValue);
 
+/// Performs an atomic compare and swap operation on two pointers. This operation compares *ppTarget with pOldValue and
+/// replaces it with pNewValue if they match. If the values don't match, no action is taken.
+///
+/// @param [in,out] ppTarget  Pointer to the address to compare and swap.
+/// @param [in]     pOldValue Value to compare *ppTarget to.
+/// @param [in]     pNewValue Value to replace *ppTarget with if *ppTarget matches pOldValue.
+///
+/// @returns Previous value at *ppTarget.
+extern void* AtomicCompareAndSwapPointer(void*volatile* ppTarget, void* pOldValue, void* pNewValue);
+
 /// Atomically add a value to the specific 32-bit unsigned integer.
 ///
 /// @param [in,out] pAddend Pointer to the value to be modified.
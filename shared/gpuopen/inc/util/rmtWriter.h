@@ -44,12 +44,33 @@ namespace DevDriver
 class RmtWriter
 {
 public:
+    // Receives the RMT file piece by piece when the writer is streaming. The callbacks are never called concurrently.
+    struct StreamCallbacks
+    {
+        // Appends data to the end of the output. Each call passes whole chunks, so the output is a valid RMT file up to
+        // the end of the last successful call.
+        Result (*pfnWrite)(void* pUserdata, const void* pData, size_t dataSize);
+
+        void* pUserdata;
+    };
+
     RmtWriter(const AllocCb& allocCb);
     ~RmtWriter();
 
     // Initializes the RMT file writer.
     void Init();
 
+    // Initializes the RMT file writer in streaming mode. Rather than accumulating the whole file in memory, the writer
+    // fills one of two staging buffers of bufferSize bytes while a background thread passes the other one to the
+    // callbacks. The file data held in memory is therefore capped at twice bufferSize. A data chunk never spans two
+    // buffers: when a buffer fills up, the chunk is ended there and continued in the next buffer by a chunk with the
+    // same process and thread ids and the next chunk index. GetRmtData() returns nothing in this mode.
+    Result InitStreaming(const StreamCallbacks& callbacks, size_t bufferSize);
+
+    // Returns the first error reported by the stream callbacks. Data written after an error is dropped. While the
+    // writer is streaming this waits for any in-flight flush to finish so the result can be read safely.
+    Result GetStreamResult();
+
     // Resets the internal state of the RMT file writer
     void Reset();
 
@@ -100,6 +121,17 @@ public:
 private:
     void WriteBytes(const void* pData, size_t dataSize);
 
+    // Returns the offset in the RMT file at which the next byte will be written.
+    size_t GetWriteOffset() const;
+
+    // Streaming mode helpers
+    static void StreamThreadFunc(void* pThreadParameter);
+    void WriteStreamDataChunkSize();
+    void SubmitFullStreamBuffer();
+    void SubmitStreamBuffer();
+    void WaitForStreamThread();
+    void EndStreaming();
+
     enum RmtWriterState
     {
         Uninitialized,
@@ -111,9 +143,28 @@ private:
     const AllocCb&  m_allocCb;
     RmtWriterState  m_state;
     size_t          m_dataChunkHeaderOffset;
+    uint64          m_dataChunkProcessId;
+    uint64          m_dataChunkThreadId;
+    uint32          m_dataChunkIndex;
     EventTimer      m_eventTimer;
     Vector<uint8>   m_rmtFileData;
 
+    // Streaming mode state. The flush thread only does work between m_flushRequested and m_flushIdle being signaled,
+    // and it owns m_pFlushData, m_flushSize and m_streamResult while it does.
+    bool             m_isStreaming;
+    StreamCallbacks  m_streamCallbacks;
+    size_t           m_streamBufferSize;
+    uint8*           m_pStreamBuffers[2];
+    uint32           m_activeStreamBuffer;
+    size_t           m_activeStreamSize;
+    size_t           m_streamBaseOffset;   // File offset of the first byte in the active buffer
+    const uint8*     m_pFlushData;
+    size_t           m_flushSize;
+    bool             m_stopStreamThread;
+    Result           m_streamResult;
+    Platform::Thread m_streamThread;
+    Platform::Event  m_flushRequested;
+    Platform::Event  m_flushIdle;
 };
 
 } // namespace DevDriver
@@ -26,23 +26,68 @@
 #include <util/rmtWriter.h>
 
 #include <ctime>
+#include <cstddef>
 
 namespace DevDriver
 {
 
+// How long the writer and its flush thread wait on each other before checking again
+static constexpr uint32 kStreamWaitTimeoutInMs = 100;
+
+// Number of distinct non-negative values of RmtFileChunkIdentifier::chunkIndex
+static constexpr uint32 kMaxDataChunkIndexCount = 128;
+
+//=====================================================================================================================
+// Builds the header of an RMT data chunk holding dataSize bytes of token data.
+static RmtFileChunkRmtData BuildDataChunkHeader(
+    uint64 processId,
+    uint64 threadId,
+    size_t dataSize,
+    uint32 chunkIndex)
+{
+    RmtFileChunkRmtData chunkHeader = {};
+    chunkHeader.header.chunkIdentifier.chunkType  = RMT_FILE_CHUNK_TYPE_RMT_DATA;
+    chunkHeader.header.chunkIdentifier.chunkIndex = chunkIndex;
+    chunkHeader.header.versionMinor               = 1;
+    chunkHeader.header.versionMajor               = 0;
+    chunkHeader.header.sizeInBytes                = static_cast<int32>(dataSize) + sizeof(chunkHeader);
+    chunkHeader.header.padding                    = 0;
+    chunkHeader.processId                         = processId;
+    chunkHeader.threadId                          = threadId;
+
+    return chunkHeader;
+}
+
 //=====================================================================================================================
 RmtWriter::RmtWriter(
     const AllocCb& allocCb)
     : m_allocCb(allocCb)
     , m_state(RmtWriterState::Uninitialized)
     , m_dataChunkHeaderOffset(0)
+    , m_dataChunkProcessId(0)
+    , m_dataChunkThreadId(0)
+    , m_dataChunkIndex(0)
     , m_rmtFileData(m_allocCb)
+    , m_isStreaming(false)
+    , m_streamCallbacks()
+    , m_streamBufferSize(0)
+    , m_pStreamBuffers()
+    , m_activeStreamBuffer(0)
+    , m_activeStreamSize(0)
+    , m_streamBaseOffset(0)
+    , m_pFlushData(nullptr)
+    , m_flushSize(0)
+    , m_stopStreamThread(false)
+    , m_streamResult(Result::Success)
+    , m_flushRequested(false)
+    , m_flushIdle(true)
 {
 }
 
 //=====================================================================================================================
 RmtWriter::~RmtWriter()
 {
+    EndStreaming();
 }
 
 //=====================================================================================================================
@@ -50,6 +95,8 @@ void RmtWriter::Init()
 {
     DD_ASSERT((m_state == RmtWriterState::Uninitialized) || (m_state == RmtWriterState::Finalized));
 
+    EndStreaming();
+
     // Make sure we start with an empty file buffer
     m_dataChunkHeaderOffset = 0;
     m_rmtFileData.Resize(0);
@@ -58,9 +105,86 @@ void RmtWriter::Init()
     m_state = RmtWriterState::Initialized;
 }
 
+//=====================================================================================================================
+Result RmtWriter::InitStreaming(
+    const StreamCallbacks& callbacks,
+    size_t                 bufferSize)
+{
+    DD_ASSERT(callbacks.pfnWrite != nullptr);
+
+    Init();
+
+    Result result  = Result::InvalidParameter;
+    uint8* pMemory = nullptr;
+
+    // Each buffer must hold a data chunk header and some token data, and chunk sizes are 32-bit.
+    if ((bufferSize > sizeof(RmtFileChunkRmtData)) && (bufferSize <= static_cast<size_t>(INT32_MAX)))
+    {
+        result  = Result::InsufficientMemory;
+        pMemory = static_cast<uint8*>(DD_MALLOC(2 * bufferSize, alignof(RmtFileChunkRmtData), m_allocCb));
+    }
+
+    if (pMemory != nullptr)
+    {
+        m_streamCallbacks    = callbacks;
+        m_streamBufferSize   = bufferSize;
+        m_pStreamBuffers[0]  = pMemory;
+        m_pStreamBuffers[1]  = pMemory + bufferSize;
+        m_activeStreamBuffer = 0;
+        m_activeStreamSize   = 0;
+        m_streamBaseOffset   = 0;
+        m_pFlushData         = nullptr;
+        m_flushSize          = 0;
+        m_stopStreamThread   = false;
+        m_streamResult       = Result::Success;
+
+        m_flushRequested.Clear();
+        m_flushIdle.Signal();
+
+        result = m_streamThread.Start(StreamThreadFunc, this);
+
+        if (result == Result::Success)
+        {
+            // This is for humans, so we ignore a failure to set the name. The code can't do anything about it anyway.
+            m_streamThread.SetName("DevDriver RMT Stream");
+
+            m_isStreaming = true;
+        }
+        else
+        {
+            DD_FREE(pMemory, m_allocCb);
+            m_pStreamBuffers[0] = nullptr;
+            m_pStreamBuffers[1] = nullptr;
+
+            DD_WARN_REASON("Thread creation failed");
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        m_state = RmtWriterState::Uninitialized;
+    }
+
+    return result;
+}
+
+//=====================================================================================================================
+Result RmtWriter::GetStreamResult()
+{
+    if (m_isStreaming)
+    {
+        // The flush thread owns m_streamResult until it goes idle again
+        WaitForStreamThread();
+    }
+
+    return m_streamResult;
+}
+
 //=====================================================================================================================
 void RmtWriter::Reset()
 {
+    EndStreaming();
+
     m_state = RmtWriterState::Uninitialized;
 }
 
@@ -202,9 +326,19 @@ void RmtWriter::BeginDataChunk(
 {
     DD_ASSERT(m_state == RmtWriterState::Initialized);
 
+    m_dataChunkProcessId = processId;
+    m_dataChunkThreadId  = threadId;
+    m_dataChunkIndex     = 0;
+
+    if (m_isStreaming && ((m_streamBufferSize - m_activeStreamSize) <= sizeof(RmtFileChunkRmtData)))
+    {
+        // The header must stay in the active buffer until the chunk ends, so start the chunk in the next buffer.
+        SubmitStreamBuffer();
+    }
+
     // Save the current data offset, so we can revisit the data chunk header to update the size once we know how many
     // bytes of token data has been written.
-    m_dataChunkHeaderOffset = m_rmtFileData.Size();
+    m_dataChunkHeaderOffset = GetWriteOffset();
 
     // Create the chunk header with a zero byte size and add it to the stream
     WriteDataChunkHeader(processId, threadId, 0, 0);
@@ -277,11 +411,18 @@ void RmtWriter::EndDataChunk()
 {
     DD_ASSERT(m_state == RmtWriterState::WritingDataChunk);
 
-    const int32 rmtDataChunkSize = static_cast<int32>(m_rmtFileData.Size() - m_dataChunkHeaderOffset);
+    if (m_isStreaming == false)
+    {
+        const int32 rmtDataChunkSize = static_cast<int32>(GetWriteOffset() - m_dataChunkHeaderOffset);
 
-    RmtFileChunkRmtData* pHeader =
-        static_cast<RmtFileChunkRmtData*>(VoidPtrInc(m_rmtFileData.Data(), m_dataChunkHeaderOffset));
-    pHeader->header.sizeInBytes = rmtDataChunkSize;
+        RmtFileChunkRmtData* pHeader =
+            static_cast<RmtFileChunkRmtData*>(VoidPtrInc(m_rmtFileData.Data(), m_dataChunkHeaderOffset));
+        pHeader->header.sizeInBytes = rmtDataChunkSize;
+    }
+    else
+    {
+        WriteStreamDataChunkSize();
+    }
 
     // Update our state
     m_state = RmtWriterState::Initialized;
@@ -302,15 +443,7 @@ void RmtWriter::WriteDataChunkHeader(uint64 processId, uint64 threadId, size_t d
     DD_ASSERT(m_state == RmtWriterState::Initialized);
 
     // First create the chunk header and add it to the stream
-    RmtFileChunkRmtData chunkHeader = {};
-    chunkHeader.header.chunkIdentifier.chunkType  = RMT_FILE_CHUNK_TYPE_RMT_DATA;
-    chunkHeader.header.chunkIdentifier.chunkIndex = chunkIndex;
-    chunkHeader.header.versionMinor               = 1;
-    chunkHeader.header.versionMajor               = 0;
-    chunkHeader.header.sizeInBytes                = static_cast<int32>(dataSize) + sizeof(chunkHeader);
-    chunkHeader.header.padding                    = 0;
-    chunkHeader.processId                         = processId;
-    chunkHeader.threadId                          = threadId;
+    const RmtFileChunkRmtData chunkHeader = BuildDataChunkHeader(processId, threadId, dataSize, chunkIndex);
 
     WriteBytes(&chunkHeader, sizeof(chunkHeader));
 }
@@ -320,6 +453,9 @@ void RmtWriter::Finalize()
 {
     DD_ASSERT(m_state == RmtWriterState::Initialized);
 
+    // Push any buffered data to the output before the flush thread goes away
+    EndStreaming();
+
     m_state = RmtWriterState::Finalized;
 }
 
@@ -331,10 +467,180 @@ void RmtWriter::WriteBytes(
 {
     DD_ASSERT((m_state == RmtWriterState::Initialized) || (m_state == RmtWriterState::WritingDataChunk));
 
-    // Add the bytes to our in-memory stream
-    const size_t byteOffset = m_rmtFileData.Grow(dataSize);
-    void* pDst = VoidPtrInc(m_rmtFileData.Data(), byteOffset);
-    memcpy(pDst, pData, dataSize);
+    if (m_isStreaming == false)
+    {
+        // Add the bytes to our in-memory stream
+        const size_t byteOffset = m_rmtFileData.Grow(dataSize);
+        void* pDst = VoidPtrInc(m_rmtFileData.Data(), byteOffset);
+        memcpy(pDst, pData, dataSize);
+    }
+    else
+    {
+        // Fill the active staging buffer, handing it off to the flush thread each time it fills up
+        const uint8* pSrc = static_cast<const uint8*>(pData);
+
+        while (dataSize > 0)
+        {
+            const size_t copySize = Platform::Min(dataSize, m_streamBufferSize - m_activeStreamSize);
+
+            memcpy(m_pStreamBuffers[m_activeStreamBuffer] + m_activeStreamSize, pSrc, copySize);
+
+            m_activeStreamSize += copySize;
+            pSrc               += copySize;
+            dataSize           -= copySize;
+
+            if (m_activeStreamSize == m_streamBufferSize)
+            {
+                SubmitFullStreamBuffer();
+            }
+        }
+    }
+}
+
+//=====================================================================================================================
+size_t RmtWriter::GetWriteOffset() const
+{
+    return m_isStreaming ? (m_streamBaseOffset + m_activeStreamSize) : m_rmtFileData.Size();
+}
+
+//=====================================================================================================================
+// Body of the streaming flush thread. Passes each submitted buffer to the write callback.
+void RmtWriter::StreamThreadFunc(
+    void* pThreadParameter)
+{
+    RmtWriter* pWriter = static_cast<RmtWriter*>(pThreadParameter);
+
+    bool exitThread = false;
+
+    while (exitThread == false)
+    {
+        if (pWriter->m_flushRequested.Wait(kStreamWaitTimeoutInMs) == Result::Success)
+        {
+            pWriter->m_flushRequested.Clear();
+
+            if ((pWriter->m_flushSize > 0) && (pWriter->m_streamResult == Result::Success))
+            {
+                pWriter->m_streamResult = pWriter->m_streamCallbacks.pfnWrite(pWriter->m_streamCallbacks.pUserdata,
+                                                                              pWriter->m_pFlushData,
+                                                                              pWriter->m_flushSize);
+
+                // The callback may refuse data once the output has reached a size limit.
+                DD_ASSERT((pWriter->m_streamResult == Result::Success) ||
+                          (pWriter->m_streamResult == Result::LimitReached));
+            }
+
+            pWriter->m_pFlushData = nullptr;
+            pWriter->m_flushSize  = 0;
+            exitThread            = pWriter->m_stopStreamThread;
+
+            pWriter->m_flushIdle.Signal();
+        }
+    }
+}
+
+//=====================================================================================================================
+// Fills in the size of the data chunk which is being streamed. Its header is always in the active staging buffer.
+void RmtWriter::WriteStreamDataChunkSize()
+{
+    DD_ASSERT(m_dataChunkHeaderOffset >= m_streamBaseOffset);
+
+    const int32  rmtDataChunkSize = static_cast<int32>(GetWriteOffset() - m_dataChunkHeaderOffset);
+    const size_t sizeOffset       = (m_dataChunkHeaderOffset - m_streamBaseOffset) +
+                                    offsetof(RmtFileChunkRmtData, header) +
+                                    offsetof(RmtFileChunkHeader, sizeInBytes);
+
+    memcpy(m_pStreamBuffers[m_activeStreamBuffer] + sizeOffset, &rmtDataChunkSize, sizeof(rmtDataChunkSize));
+}
+
+//=====================================================================================================================
+// Hands a full staging buffer to the flush thread. A data chunk which is being written is ended at the end of the
+// buffer and continued at the start of the next one, so that a chunk's size can always be filled in before it is
+// written out.
+void RmtWriter::SubmitFullStreamBuffer()
+{
+    if (m_state == RmtWriterState::WritingDataChunk)
+    {
+        WriteStreamDataChunkSize();
+        SubmitStreamBuffer();
+
+        // The chunk index field is a signed 8-bit value, so the index wraps around within its non-negative range and
+        // the order of the chunks in the file is what counts.
+        m_dataChunkIndex        = (m_dataChunkIndex + 1) % kMaxDataChunkIndexCount;
+        m_dataChunkHeaderOffset = GetWriteOffset();
+
+        const RmtFileChunkRmtData chunkHeader =
+            BuildDataChunkHeader(m_dataChunkProcessId, m_dataChunkThreadId, 0, m_dataChunkIndex);
+
+        memcpy(m_pStreamBuffers[m_activeStreamBuffer], &chunkHeader, sizeof(chunkHeader));
+        m_activeStreamSize = sizeof(chunkHeader);
+    }
+    else
+    {
+        SubmitStreamBuffer();
+    }
+}
+
+//=====================================================================================================================
+// Hands the active staging buffer to the flush thread and switches to the other one. This only blocks if the flush
+// thread is still writing out the previous buffer.
+void RmtWriter::SubmitStreamBuffer()
+{
+    WaitForStreamThread();
+
+    m_pFlushData = m_pStreamBuffers[m_activeStreamBuffer];
+    m_flushSize  = m_activeStreamSize;
+
+    m_streamBaseOffset  += m_activeStreamSize;
+    m_activeStreamBuffer = (m_activeStreamBuffer ^ 1);
+    m_activeStreamSize   = 0;
+
+    m_flushIdle.Clear();
+    m_flushRequested.Signal();
+}
+
+//=====================================================================================================================
+// Blocks until the flush thread is done with the buffer it was last given.
+void RmtWriter::WaitForStreamThread()
+{
+    Result result = Result::NotReady;
+
+    do
+    {
+        result = m_flushIdle.Wait(kStreamWaitTimeoutInMs);
+    } while (result == Result::NotReady);
+
+    DD_ASSERT(result == Result::Success);
+}
+
+//=====================================================================================================================
+// Writes out any buffered data, stops the flush thread and releases the staging buffers. Returns the writer to
+// in-memory mode.
+void RmtWriter::EndStreaming()
+{
+    if (m_isStreaming)
+    {
+        if (m_state == RmtWriterState::WritingDataChunk)
+        {
+            WriteStreamDataChunkSize();
+        }
+
+        SubmitStreamBuffer();
+        WaitForStreamThread();
+
+        // Wake the thread one last time with nothing to write so that it exits
+        m_stopStreamThread = true;
+        m_flushIdle.Clear();
+        m_flushRequested.Signal();
+
+        WaitForStreamThread();
+        DD_UNHANDLED_RESULT(m_streamThread.Join(kStreamWaitTimeoutInMs));
+
+        DD_FREE(m_pStreamBuffers[0], m_allocCb);
+        m_pStreamBuffers[0] = nullptr;
+        m_pStreamBuffers[1] = nullptr;
+
+        m_isStreaming = false;
+    }
 }
 
 } // namespace DevDriver
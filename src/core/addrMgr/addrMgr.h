@@ -34,6 +34,7 @@ namespace Pal
 
 class  Device;
 class  Image;
+struct MemoryImageCopyRegion;
 struct SubResourceInfo;
 struct SwizzleEquation;
 
@@ -80,6 +81,16 @@ public:
         return 0;
     }
 
+    // Copies between linear CPU memory and a region of a CPU-mapped Image using the subresources' swizzle equations.
+    // Address libraries which can't describe their surfaces with a swizzle equation alone don't support this.
+    virtual Result CpuSwizzleCopy(
+        const Image&                 image,
+        const MemoryImageCopyRegion& region,
+        void*                        pImageData,
+        void*                        pLinearData,
+        bool                         toImage) const
+        { return Result::Unsupported; }
+
 protected:
     AddrMgr(
         const Device* pDevice,
@@ -26,6 +26,7 @@
 #include "core/device.h"
 #include "core/image.h"
 #include "core/addrMgr/addrMgr2/addrMgr2.h"
+#include "palCmdBuffer.h"
 #include "palFormatInfo.h"
 #include "core/settingsLoader.h"
 
@@ -36,9 +37,6 @@ namespace Pal
 namespace AddrMgr2
 {
 
-// Maximum number of mipmap levels we expect to see in an Image.
-constexpr uint32 MaxImageMipLevels = 15;
-
 // =====================================================================================================================
 AddrMgr2::AddrMgr2(
     const Device* pDevice)
@@ -46,8 +44,281 @@ AddrMgr2::AddrMgr2(
     // Note: Each subresource for AddrMgr2 hardware needs the following tiling information: the actual tiling
     // information for itself as computed by the AddrLib.
     AddrMgr(pDevice, sizeof(TileInfo)),
-    m_varBlockSize(pDevice->GetGfxDevice()->GetVarBlockSize())
+    m_varBlockSize(pDevice->GetGfxDevice()->GetVarBlockSize()),
+    m_surfSettingCache(LayoutCacheElements, pDevice->GetPlatform()),
+    m_surfaceInfoCache(LayoutCacheElements, pDevice->GetPlatform()),
+    m_htileInfoCache(LayoutCacheElements, pDevice->GetPlatform()),
+    m_dccInfoCache(LayoutCacheElements, pDevice->GetPlatform()),
+    m_cmaskInfoCache(LayoutCacheElements, pDevice->GetPlatform())
+{
+}
+
+// =====================================================================================================================
+Result AddrMgr2::Init()
+{
+    Result result = AddrMgr::Init();
+
+    if (result == Result::Success)
+    {
+        result = m_layoutCacheLock.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_surfSettingCache.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_surfaceInfoCache.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_htileInfoCache.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_dccInfoCache.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_cmaskInfoCache.Init();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Memoized wrapper around Addr2GetPreferredSurfaceSetting().
+ADDR_E_RETURNCODE AddrMgr2::GetPreferredSurfaceSetting(
+    const ADDR2_GET_PREFERRED_SURF_SETTING_INPUT& input,
+    ADDR2_GET_PREFERRED_SURF_SETTING_OUTPUT*      pOut
+    ) const
+{
+    ADDR_E_RETURNCODE addrRet = ADDR_ERROR;
+    bool              found   = false;
+
+    {
+        MutexAuto lock(&m_layoutCacheLock);
+
+        const ADDR2_GET_PREFERRED_SURF_SETTING_OUTPUT*const pCached = m_surfSettingCache.FindKey(input);
+
+        if (pCached != nullptr)
+        {
+            *pOut   = *pCached;
+            addrRet = ADDR_OK;
+            found   = true;
+        }
+    }
+
+    if (found == false)
+    {
+        addrRet = Addr2GetPreferredSurfaceSetting(AddrLibHandle(), &input, pOut);
+
+        if (addrRet == ADDR_OK)
+        {
+            MutexAuto lock(&m_layoutCacheLock);
+
+            bool                                     existed = false;
+            ADDR2_GET_PREFERRED_SURF_SETTING_OUTPUT* pValue  = nullptr;
+
+            // Failing to cache the result is harmless; the next identical image will just call AddrLib again.
+            if ((m_surfSettingCache.GetNumEntries() < MaxCachedLayouts) &&
+                (m_surfSettingCache.FindAllocate(input, &existed, &pValue) == Result::Success))
+            {
+                *pValue = *pOut;
+            }
+        }
+    }
+
+    return addrRet;
+}
+
+// =====================================================================================================================
+// Memoized wrapper around Addr2ComputeSurfaceInfo(). Stereo surfaces are never cached because AddrLib reports their
+// stereo information through a caller-provided pointer.
+ADDR_E_RETURNCODE AddrMgr2::ComputeSurfaceInfo(
+    const ADDR2_COMPUTE_SURFACE_INFO_INPUT& input,
+    ADDR2_COMPUTE_SURFACE_INFO_OUTPUT*      pOut
+    ) const
 {
+    const bool cacheable = (input.flags.qbStereo == 0) && (input.numMipLevels <= MaxImageMipLevels);
+
+    ADDR_E_RETURNCODE addrRet = ADDR_ERROR;
+    bool              found   = false;
+
+    if (cacheable)
+    {
+        MutexAuto lock(&m_layoutCacheLock);
+
+        const SurfaceInfoEntry*const pCached = m_surfaceInfoCache.FindKey(input);
+
+        if (pCached != nullptr)
+        {
+            // Keep the caller's output pointers; the mip information is copied into their array instead.
+            ADDR_QBSTEREOINFO*const pStereoInfo = pOut->pStereoInfo;
+            ADDR2_MIP_INFO*const    pMipInfo    = pOut->pMipInfo;
+
+            *pOut             = pCached->output;
+            pOut->pStereoInfo = pStereoInfo;
+            pOut->pMipInfo    = pMipInfo;
+
+            if (pMipInfo != nullptr)
+            {
+                memcpy(pMipInfo, &pCached->mipInfo[0], input.numMipLevels * sizeof(ADDR2_MIP_INFO));
+            }
+
+            addrRet = ADDR_OK;
+            found   = true;
+        }
+    }
+
+    if (found == false)
+    {
+        // Always ask AddrLib for the mip information so the cached entry is complete.
+        ADDR2_MIP_INFO       mipInfo[MaxImageMipLevels] = { };
+        ADDR2_MIP_INFO*const pCallerMipInfo             = pOut->pMipInfo;
+
+        if (cacheable && (pCallerMipInfo == nullptr))
+        {
+            pOut->pMipInfo = &mipInfo[0];
+        }
+
+        addrRet = Addr2ComputeSurfaceInfo(AddrLibHandle(), &input, pOut);
+
+        if ((addrRet == ADDR_OK) && cacheable)
+        {
+            MutexAuto lock(&m_layoutCacheLock);
+
+            bool              existed = false;
+            SurfaceInfoEntry* pValue  = nullptr;
+
+            // Failing to cache the result is harmless; the next identical image will just call AddrLib again.
+            if ((m_surfaceInfoCache.GetNumEntries() < MaxCachedLayouts) &&
+                (m_surfaceInfoCache.FindAllocate(input, &existed, &pValue) == Result::Success))
+            {
+                pValue->output             = *pOut;
+                pValue->output.pStereoInfo = nullptr;
+                pValue->output.pMipInfo    = nullptr;
+
+                memcpy(&pValue->mipInfo[0], pOut->pMipInfo, input.numMipLevels * sizeof(ADDR2_MIP_INFO));
+            }
+        }
+
+        pOut->pMipInfo = pCallerMipInfo;
+    }
+
+    return addrRet;
+}
+
+// =====================================================================================================================
+// Memoized wrapper around one of AddrLib's mask-ram info functions. Like the surface info, every entry keeps the
+// per-mip information even if the caller didn't ask for it.
+template <typename Input, typename Output>
+ADDR_E_RETURNCODE AddrMgr2::ComputeMetaInfo(
+    ADDR_E_RETURNCODE (ADDR_API* pfnCompute)(ADDR_HANDLE, const Input*, Output*),
+    Util::FlatHashMap<Input, MetaInfoEntry<Output>, Platform, Util::JenkinsHashFunc>* pCache,
+    const Input&                                                                       input,
+    Output*                                                                            pOut
+    ) const
+{
+    // AddrLib reports at least one mip level even if the caller left numMipLevels at zero.
+    const uint32 numMipLevels = Max(input.numMipLevels, 1u);
+    const bool   cacheable    = (numMipLevels <= MaxImageMipLevels);
+
+    ADDR_E_RETURNCODE addrRet = ADDR_ERROR;
+    bool              found   = false;
+
+    if (cacheable)
+    {
+        MutexAuto lock(&m_layoutCacheLock);
+
+        const MetaInfoEntry<Output>*const pCached = pCache->FindKey(input);
+
+        if (pCached != nullptr)
+        {
+            ADDR2_META_MIP_INFO*const pMipInfo = pOut->pMipInfo;
+
+            *pOut          = pCached->output;
+            pOut->pMipInfo = pMipInfo;
+
+            if (pMipInfo != nullptr)
+            {
+                memcpy(pMipInfo, &pCached->mipInfo[0], numMipLevels * sizeof(ADDR2_META_MIP_INFO));
+            }
+
+            addrRet = ADDR_OK;
+            found   = true;
+        }
+    }
+
+    if (found == false)
+    {
+        ADDR2_META_MIP_INFO       mipInfo[MaxImageMipLevels] = { };
+        ADDR2_META_MIP_INFO*const pCallerMipInfo             = pOut->pMipInfo;
+
+        if (cacheable && (pCallerMipInfo == nullptr))
+        {
+            pOut->pMipInfo = &mipInfo[0];
+        }
+
+        addrRet = pfnCompute(AddrLibHandle(), &input, pOut);
+
+        if ((addrRet == ADDR_OK) && cacheable)
+        {
+            MutexAuto lock(&m_layoutCacheLock);
+
+            bool                   existed = false;
+            MetaInfoEntry<Output>* pValue  = nullptr;
+
+            // Failing to cache the result is harmless; the next identical image will just call AddrLib again.
+            if ((pCache->GetNumEntries() < MaxCachedLayouts) &&
+                (pCache->FindAllocate(input, &existed, &pValue) == Result::Success))
+            {
+                pValue->output          = *pOut;
+                pValue->output.pMipInfo = nullptr;
+
+                memcpy(&pValue->mipInfo[0], pOut->pMipInfo, numMipLevels * sizeof(ADDR2_META_MIP_INFO));
+            }
+        }
+
+        pOut->pMipInfo = pCallerMipInfo;
+    }
+
+    return addrRet;
+}
+
+// =====================================================================================================================
+// Memoized wrapper around Addr2ComputeHtileInfo().
+ADDR_E_RETURNCODE AddrMgr2::ComputeHtileInfo(
+    const ADDR2_COMPUTE_HTILE_INFO_INPUT& input,
+    ADDR2_COMPUTE_HTILE_INFO_OUTPUT*      pOut
+    ) const
+{
+    return ComputeMetaInfo(&Addr2ComputeHtileInfo, &m_htileInfoCache, input, pOut);
+}
+
+// =====================================================================================================================
+// Memoized wrapper around Addr2ComputeDccInfo().
+ADDR_E_RETURNCODE AddrMgr2::ComputeDccInfo(
+    const ADDR2_COMPUTE_DCCINFO_INPUT& input,
+    ADDR2_COMPUTE_DCCINFO_OUTPUT*      pOut
+    ) const
+{
+    return ComputeMetaInfo(&Addr2ComputeDccInfo, &m_dccInfoCache, input, pOut);
+}
+
+// =====================================================================================================================
+// Memoized wrapper around Addr2ComputeCmaskInfo().
+ADDR_E_RETURNCODE AddrMgr2::ComputeCmaskInfo(
+    const ADDR2_COMPUTE_CMASK_INFO_INPUT& input,
+    ADDR2_COMPUTE_CMASK_INFO_OUTPUT*      pOut
+    ) const
+{
+    return ComputeMetaInfo(&Addr2ComputeCmaskInfo, &m_cmaskInfoCache, input, pOut);
 }
 
 // =====================================================================================================================
@@ -665,13 +936,13 @@ Result AddrMgr2::ComputePlaneSwizzleMode(
         surfSettingInput.preferredSwSet.sw_S = 0;
     }
 
-    ADDR_E_RETURNCODE addrRet = Addr2GetPreferredSurfaceSetting(AddrLibHandle(), &surfSettingInput, pOut);
+    ADDR_E_RETURNCODE addrRet = GetPreferredSurfaceSetting(surfSettingInput, pOut);
 
     // It's possible that we can't get what we preferr so retry using the full permitted mask.
     if ((addrRet != ADDR_OK) && (surfSettingInput.preferredSwSet.value != permittedSwSet.value))
     {
         surfSettingInput.preferredSwSet = permittedSwSet;
-        addrRet = Addr2GetPreferredSurfaceSetting(AddrLibHandle(), &surfSettingInput, pOut);
+        addrRet = GetPreferredSurfaceSetting(surfSettingInput, pOut);
     }
 
     if (addrRet == ADDR_OK)
@@ -863,7 +1134,7 @@ Result AddrMgr2::ComputeAlignedPlaneDimensions(
         surfInfoIn.pitchInElement = Util::Pow2Align(surfInfoIn.width, Gfx9LinearAlign * 2);
     }
 
-    ADDR_E_RETURNCODE addrRet = Addr2ComputeSurfaceInfo(AddrLibHandle(), &surfInfoIn, pOut);
+    ADDR_E_RETURNCODE addrRet = ComputeSurfaceInfo(surfInfoIn, pOut);
     if (addrRet == ADDR_OK)
     {
         pBaseTileInfo->ePitch = CalcEpitch(pOut);
@@ -1197,6 +1468,254 @@ uint32 AddrMgr2::GetBlockSize(
     return blockSize;
 }
 
+// Per-coordinate-bit address masks derived from a swizzle equation. Swizzle equations are linear over GF(2), so the
+// in-block byte offset of any coordinate is the XOR of the masks selected by the coordinate's set bits.
+struct SwizzleMasks
+{
+    uint32 channel[3][32]; // Address bits toggled by each bit of the x (in bytes), y and z coordinates.
+    uint32 runBytesLog2;   // Log2 of the number of bytes which are contiguous in both the x coordinate and memory.
+};
+
+// =====================================================================================================================
+// Converts a swizzle equation into per-coordinate-bit address masks.
+static void BuildSwizzleMasks(
+    const SwizzleEquation& equation,
+    SwizzleMasks*          pMasks)
+{
+    memset(pMasks, 0, sizeof(*pMasks));
+
+    uint32 directBits = 0;
+
+    for (uint32 bit = 0; bit < equation.numBits; ++bit)
+    {
+        const SwizzleEquationBit settings[] = { equation.addr[bit], equation.xor1[bit], equation.xor2[bit] };
+
+        for (uint32 idx = 0; idx < ArrayLen(settings); ++idx)
+        {
+            if (settings[idx].valid != 0)
+            {
+                PAL_ASSERT(settings[idx].channel < ArrayLen(pMasks->channel));
+                pMasks->channel[settings[idx].channel][settings[idx].index] ^= (1u << bit);
+            }
+        }
+
+        if ((settings[0].valid   != 0)   &&
+            (settings[0].channel == 0)   &&
+            (settings[0].index   == bit) &&
+            (settings[1].valid   == 0)   &&
+            (settings[2].valid   == 0))
+        {
+            directBits |= (1u << bit);
+        }
+    }
+
+    // The low x bits which map straight onto the same address bits (and nowhere else) select bytes within a run which
+    // is contiguous in memory, so the copy loops can move a whole run at once instead of one element at a time.
+    uint32 runBytesLog2 = 0;
+
+    while (TestAnyFlagSet(directBits, 1u << runBytesLog2) &&
+           (pMasks->channel[0][runBytesLog2] == (1u << runBytesLog2)))
+    {
+        runBytesLog2++;
+    }
+
+    pMasks->runBytesLog2 = runBytesLog2;
+}
+
+// =====================================================================================================================
+// Returns the in-block address bits contributed by one coordinate.
+static uint32 ComputeSwizzleOffset(
+    const uint32* pMasks,   // The masks for the coordinate's channel
+    uint32        coord)
+{
+    uint32 offset = 0;
+    uint32 bit    = 0;
+
+    while (BitMaskScanForward(&bit, coord))
+    {
+        offset ^= pMasks[bit];
+        coord  &= ~(1u << bit);
+    }
+
+    return offset;
+}
+
+// =====================================================================================================================
+// Copies a span of bytes in the requested direction.
+static void CopySwizzledSpan(
+    void*  pImageData,
+    void*  pLinearData,
+    size_t size,
+    bool   toImage)
+{
+    if (toImage)
+    {
+        memcpy(pImageData, pLinearData, size);
+    }
+    else
+    {
+        memcpy(pLinearData, pImageData, size);
+    }
+}
+
+// =====================================================================================================================
+// Copies between linear CPU memory and a region of a CPU-mapped Image using the subresources' swizzle equations. The
+// caller is expected to have validated the region against the Image.
+Result AddrMgr2::CpuSwizzleCopy(
+    const Image&                 image,
+    const MemoryImageCopyRegion& region,
+    void*                        pImageData,
+    void*                        pLinearData,
+    bool                         toImage
+    ) const
+{
+    // Each slice of a 3D Image lives in the same subresource; each slice of an array is its own subresource.
+    const bool   is3d      = (image.GetImageCreateInfo().imageType == ImageType::Tex3d);
+    const uint32 numSlices = is3d ? region.imageExtent.depth : region.numSlices;
+
+    Result result = Result::Success;
+
+    for (uint32 slice = 0; (slice < numSlices) && (result == Result::Success); ++slice)
+    {
+        SubresId subresId = region.imageSubres;
+        uint32   z        = 0;
+
+        if (is3d)
+        {
+            z = static_cast<uint32>(region.imageOffset.z) + slice;
+        }
+        else
+        {
+            subresId.arraySlice += slice;
+        }
+
+        void*const pLinearSlice = VoidPtrInc(pLinearData,
+                                             static_cast<size_t>(region.gpuMemoryOffset +
+                                                                 (slice * region.gpuMemoryDepthPitch)));
+
+        result = CpuSwizzleCopySlice(image,
+                                     *image.SubresourceInfo(subresId),
+                                     region,
+                                     z,
+                                     pImageData,
+                                     pLinearSlice,
+                                     toImage);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Copies one slice of a region between linear CPU memory and a CPU-mapped Image. This mirrors AddrLib's address
+// computation for tiled surfaces: the block index selects a swizzle block and the swizzle equation (XORed with the
+// pipe-bank XOR) selects the byte within it.
+Result AddrMgr2::CpuSwizzleCopySlice(
+    const Image&                 image,
+    const SubResourceInfo&       subResInfo,
+    const MemoryImageCopyRegion& region,
+    uint32                       z,
+    void*                        pImageData,
+    void*                        pLinearData,  // Linear data for this slice
+    bool                         toImage
+    ) const
+{
+    // Convert the region from texels into elements. Block-compressed formats address whole blocks and the 96-bit
+    // formats are addressed as three 32-bit elements per texel.
+    Extent3d texelsPerElement = { 1, 1, 1 };
+    uint32   elementsPerTexel = 1;
+
+    if (Formats::IsBlockCompressed(subResInfo.format.format))
+    {
+        texelsPerElement = Formats::CompressedBlockDim(subResInfo.format.format);
+    }
+    else if (subResInfo.bitsPerTexel == 96)
+    {
+        elementsPerTexel = 3;
+    }
+
+    const uint32 elementBytes = CalcBytesPerElement(&subResInfo);
+    const uint32 startX       = (static_cast<uint32>(region.imageOffset.x) / texelsPerElement.width) * elementsPerTexel;
+    const uint32 startY       = static_cast<uint32>(region.imageOffset.y) / texelsPerElement.height;
+    const uint32 width        = RoundUpQuotient(region.imageExtent.width, texelsPerElement.width) * elementsPerTexel;
+    const uint32 height       = RoundUpQuotient(region.imageExtent.height, texelsPerElement.height);
+
+    const AddrSwizzleMode swizzleMode =
+        static_cast<AddrSwizzleMode>(image.GetGfxImage()->GetSwTileMode(&subResInfo));
+
+    Result result = Result::Success;
+
+    if (IsLinearSwizzleMode(swizzleMode))
+    {
+        const gpusize sliceOffset = subResInfo.offset + (z * subResInfo.depthPitch) + (startX * elementBytes);
+
+        for (uint32 row = 0; row < height; ++row)
+        {
+            CopySwizzledSpan(VoidPtrInc(pImageData, static_cast<size_t>(sliceOffset +
+                                                                          ((startY + row) * subResInfo.rowPitch))),
+                             VoidPtrInc(pLinearData, static_cast<size_t>(row * region.gpuMemoryRowPitch)),
+                             width * elementBytes,
+                             toImage);
+        }
+    }
+    else if ((subResInfo.swizzleEqIndex == InvalidSwizzleEqIndex) || (IsPowerOfTwo(elementBytes) == false))
+    {
+        // Without a swizzle equation (e.g., MSAA surfaces) we'd need AddrLib's full swizzle patterns.
+        result = Result::Unsupported;
+    }
+    else
+    {
+        SwizzleMasks masks;
+        BuildSwizzleMasks(SwizzleEquations()[subResInfo.swizzleEqIndex], &masks);
+
+        const uint32   elementLog2   = Log2(elementBytes);
+        const uint32   blockSizeLog2 = Log2(GetBlockSize(swizzleMode));
+        const gpusize  blockMask     = (1ull << blockSizeLog2) - 1;
+        const Extent3d blockSize     = subResInfo.blockSize;
+        const gpusize  pitchInBlocks = subResInfo.rowPitch / (elementBytes * blockSize.width);
+        const Offset3d tailCoord     = subResInfo.mipTailCoord;
+
+        // Every swizzle equation maps the bytes of one element straight through, so a run holds at least one element.
+        PAL_ASSERT(masks.runBytesLog2 >= elementLog2);
+        const uint32 runElements = 1u << (masks.runBytesLog2 - elementLog2);
+
+        // Mip levels in the mip tail begin partway into their block; AddrLib addresses their texels from the start of
+        // the block by offsetting them with the mip tail coordinates instead.
+        const gpusize slabOffset = (subResInfo.offset & ~blockMask) +
+                                   ((z / blockSize.depth) * subResInfo.depthPitch * blockSize.depth);
+        const uint32  pipeBankXor = GetTileSwizzle(&image, subResInfo.subresId) << 8;
+        const uint32  sliceXor    = pipeBankXor ^
+                                    ComputeSwizzleOffset(masks.channel[2], z + static_cast<uint32>(tailCoord.z));
+
+        for (uint32 row = 0; row < height; ++row)
+        {
+            const uint32  y         = startY + row;
+            const gpusize rowOffset = slabOffset + (((y / blockSize.height) * pitchInBlocks) << blockSizeLog2);
+            const uint32  rowXor    = sliceXor ^
+                                      ComputeSwizzleOffset(masks.channel[1], y + static_cast<uint32>(tailCoord.y));
+
+            void*const pLinearRow = VoidPtrInc(pLinearData, static_cast<size_t>(row * region.gpuMemoryRowPitch));
+
+            for (uint32 x = startX; x < (startX + width); )
+            {
+                const uint32  tailX     = x + static_cast<uint32>(tailCoord.x);
+                const uint32  runLength = Min(runElements - (tailX & (runElements - 1)), (startX + width) - x);
+                const gpusize offset    = rowOffset +
+                                          (static_cast<gpusize>(x / blockSize.width) << blockSizeLog2) +
+                                          (ComputeSwizzleOffset(masks.channel[0], tailX << elementLog2) ^ rowXor);
+
+                CopySwizzledSpan(VoidPtrInc(pImageData, static_cast<size_t>(offset)),
+                                 VoidPtrInc(pLinearRow, (x - startX) << elementLog2),
+                                 runLength << elementLog2,
+                                 toImage);
+
+                x += runLength;
+            }
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Returns the HW tiling / swizzle mode that corresponds to the specified subresource.
 Pal::Gfx9::SWIZZLE_MODE_ENUM AddrMgr2::GetHwSwizzleMode(
@@ -26,7 +26,10 @@
 #pragma once
 
 #include "core/image.h"
+#include "core/platform.h"
 #include "core/addrMgr/addrMgr.h"
+#include "palFlatHashMap.h"
+#include "palMutex.h"
 
 // Need the HW version of the tiling definitions
 #include "core/hw/gfxip/gfx9/chip/gfx9_plus_merged_enum.h"
@@ -38,6 +41,9 @@ class   Device;
 namespace AddrMgr2
 {
 
+// Maximum number of mipmap levels we expect to see in an Image.
+constexpr uint32 MaxImageMipLevels = 15;
+
 // Unique image tile token.
 union TileToken
 {
@@ -258,6 +264,8 @@ public:
     explicit AddrMgr2(const Device*  pDevice);
     virtual ~AddrMgr2() {}
 
+    virtual Result Init() override;
+
     Pal::Gfx9::SWIZZLE_MODE_ENUM GetHwSwizzleMode(AddrSwizzleMode  swizzleMode) const;
 
     virtual Result InitSubresourcesForImage(
@@ -284,6 +292,25 @@ public:
 
     virtual uint32 GetBlockSize(AddrSwizzleMode swizzleMode) const override;
 
+    ADDR_E_RETURNCODE ComputeHtileInfo(
+        const ADDR2_COMPUTE_HTILE_INFO_INPUT& input,
+        ADDR2_COMPUTE_HTILE_INFO_OUTPUT*      pOut) const;
+
+    ADDR_E_RETURNCODE ComputeDccInfo(
+        const ADDR2_COMPUTE_DCCINFO_INPUT& input,
+        ADDR2_COMPUTE_DCCINFO_OUTPUT*      pOut) const;
+
+    ADDR_E_RETURNCODE ComputeCmaskInfo(
+        const ADDR2_COMPUTE_CMASK_INFO_INPUT& input,
+        ADDR2_COMPUTE_CMASK_INFO_OUTPUT*      pOut) const;
+
+    virtual Result CpuSwizzleCopy(
+        const Image&                 image,
+        const MemoryImageCopyRegion& region,
+        void*                        pImageData,
+        void*                        pLinearData,
+        bool                         toImage) const override;
+
 protected:
     virtual void ComputeTilesInMipTail(
         const Image&       image,
@@ -291,6 +318,15 @@ protected:
         ImageMemoryLayout* pGpuMemLayout) const override;
 
 private:
+    Result CpuSwizzleCopySlice(
+        const Image&                 image,
+        const SubResourceInfo&       subResInfo,
+        const MemoryImageCopyRegion& region,
+        uint32                       z,
+        void*                        pImageData,
+        void*                        pLinearData,
+        bool                         toImage) const;
+
     static uint32 GetNumAddrLib3dSlices(
         const Pal::Image*                               pImage,
         const ADDR2_GET_PREFERRED_SURF_SETTING_OUTPUT&  surfSetting,
@@ -348,10 +384,75 @@ private:
         SubResourceInfo* pSubResInfo,
         AddrSwizzleMode  swizzleMode) const;
 
+    ADDR_E_RETURNCODE GetPreferredSurfaceSetting(
+        const ADDR2_GET_PREFERRED_SURF_SETTING_INPUT& input,
+        ADDR2_GET_PREFERRED_SURF_SETTING_OUTPUT*      pOut) const;
+
+    ADDR_E_RETURNCODE ComputeSurfaceInfo(
+        const ADDR2_COMPUTE_SURFACE_INFO_INPUT& input,
+        ADDR2_COMPUTE_SURFACE_INFO_OUTPUT*      pOut) const;
+
     PAL_DISALLOW_DEFAULT_CTOR(AddrMgr2);
     PAL_DISALLOW_COPY_AND_ASSIGN(AddrMgr2);
 
     uint32 m_varBlockSize;
+
+    // AddrLib's surface layouts only depend on their inputs and the device, and render target pools tend to create
+    // many identically-described images, so the results are memoized. The maps stop growing once they hold
+    // MaxCachedLayouts entries.
+    static constexpr uint32 MaxCachedLayouts    = 1024;
+    static constexpr uint32 LayoutCacheElements = 64;
+
+    struct SurfaceInfoEntry
+    {
+        ADDR2_COMPUTE_SURFACE_INFO_OUTPUT output;                     // Pointer members are always null.
+        ADDR2_MIP_INFO                    mipInfo[MaxImageMipLevels];
+    };
+
+    // Mask-ram layouts are cached the same way.
+    template <typename Output>
+    struct MetaInfoEntry
+    {
+        Output              output;                        // The pMipInfo member is always null.
+        ADDR2_META_MIP_INFO mipInfo[MaxImageMipLevels];
+    };
+
+    template <typename Input, typename Output>
+    ADDR_E_RETURNCODE ComputeMetaInfo(
+        ADDR_E_RETURNCODE (ADDR_API* pfnCompute)(ADDR_HANDLE, const Input*, Output*),
+        Util::FlatHashMap<Input, MetaInfoEntry<Output>, Platform, Util::JenkinsHashFunc>* pCache,
+        const Input&                                                                       input,
+        Output*                                                                            pOut) const;
+
+    typedef Util::FlatHashMap<ADDR2_GET_PREFERRED_SURF_SETTING_INPUT,
+                              ADDR2_GET_PREFERRED_SURF_SETTING_OUTPUT,
+                              Platform,
+                              Util::JenkinsHashFunc> SurfSettingMap;
+    typedef Util::FlatHashMap<ADDR2_COMPUTE_SURFACE_INFO_INPUT,
+                              SurfaceInfoEntry,
+                              Platform,
+                              Util::JenkinsHashFunc> SurfaceInfoMap;
+
+    mutable Util::Mutex    m_layoutCacheLock;
+    mutable SurfSettingMap m_surfSettingCache;
+    mutable SurfaceInfoMap m_surfaceInfoCache;
+
+    typedef Util::FlatHashMap<ADDR2_COMPUTE_HTILE_INFO_INPUT,
+                              MetaInfoEntry<ADDR2_COMPUTE_HTILE_INFO_OUTPUT>,
+                              Platform,
+                              Util::JenkinsHashFunc> HtileInfoMap;
+    typedef Util::FlatHashMap<ADDR2_COMPUTE_DCCINFO_INPUT,
+                              MetaInfoEntry<ADDR2_COMPUTE_DCCINFO_OUTPUT>,
+                              Platform,
+                              Util::JenkinsHashFunc> DccInfoMap;
+    typedef Util::FlatHashMap<ADDR2_COMPUTE_CMASK_INFO_INPUT,
+                              MetaInfoEntry<ADDR2_COMPUTE_CMASK_INFO_OUTPUT>,
+                              Platform,
+                              Util::JenkinsHashFunc> CmaskInfoMap;
+
+    mutable HtileInfoMap m_htileInfoCache;
+    mutable DccInfoMap   m_dccInfoCache;
+    mutable CmaskInfoMap m_cmaskInfoCache;
 };
 
 } // AddrMgr2
@@ -100,14 +100,23 @@ CmdAllocator::CmdAllocator(
     m_pDevice(pDevice),
     m_pChunkLock(nullptr),
     m_lastPagingFence(0),
+    m_threadChunkCaches(pDevice->GetPlatform()),
+    m_resetEpoch(0),
     m_pLinearAllocLock(nullptr),
     m_pDummyChunkAllocation(nullptr)
 {
 #if PAL_ENABLE_PRINTS_ASSERTS
     memset(m_pHistograms, 0, sizeof(m_pHistograms));
     m_numHistogramBins = 0;
+
+    m_magazineHits = 0;
 #endif
 
+    memset(&m_chunkLockStats,       0, sizeof(m_chunkLockStats));
+    memset(&m_linearAllocLockStats, 0, sizeof(m_linearAllocLockStats));
+
+    memset(&m_threadChunkCacheKey, 0, sizeof(m_threadChunkCacheKey));
+
     m_flags.u32All          = 0;
     m_flags.autoMemoryReuse = createInfo.flags.autoMemoryReuse;
     if (createInfo.flags.disableBusyChunkTracking == 0)
@@ -222,6 +231,19 @@ CmdAllocator::~CmdAllocator()
         m_pLinearAllocLock = nullptr;
     }
 
+    if (m_flags.threadChunkCache != 0)
+    {
+        const Result result = DeleteThreadLocalKey(m_threadChunkCacheKey);
+        PAL_ASSERT(result == Result::Success);
+
+        for (uint32 idx = 0; idx < m_threadChunkCaches.NumElements(); ++idx)
+        {
+            PAL_FREE(m_threadChunkCaches.At(idx), m_pDevice->GetPlatform());
+        }
+
+        m_threadChunkCaches.Clear();
+    }
+
     FreeAllChunks();
     FreeAllLinearAllocators();
 
@@ -364,6 +386,12 @@ Result CmdAllocator::Init(
             m_pLinearAllocLock = PAL_PLACEMENT_NEW(m_pChunkLock + 1) Mutex();
             result             = m_pLinearAllocLock->Init();
         }
+
+        // Per-thread chunk caches are only an optimization, so running out of thread-local keys isn't an error.
+        if (result == Result::Success)
+        {
+            m_flags.threadChunkCache = (CreateThreadLocalKey(&m_threadChunkCacheKey) == Result::Success);
+        }
     }
 
 #if PAL_ENABLE_PRINTS_ASSERTS
@@ -439,6 +467,9 @@ Result CmdAllocator::Reset()
         TransferChunks(&m_sysAllocInfo.freeList, &m_sysAllocInfo.reuseList);
     }
 
+    // Every chunk cached by a thread was on a busy list, so they've all been reclaimed. Invalidate the caches.
+    AtomicIncrement(&m_resetEpoch);
+
     if (m_pChunkLock != nullptr)
     {
         m_pChunkLock->Unlock();
@@ -532,26 +563,192 @@ Result CmdAllocator::GetNewChunk(
     // System memory allocations are only allowed for command data!
     PAL_ASSERT((systemMemory == false) || (allocType == CommandDataAlloc));
 
-    // If necessary, engage the chunk lock while we search for a free chunk.
-    if (m_pChunkLock != nullptr)
+    Result result = Result::Success;
+
+    ThreadChunkCache* pCache    = nullptr;
+    ChunkMagazine*    pMagazine = nullptr;
+
+    if (m_flags.threadChunkCache != 0)
     {
-        m_pChunkLock->Lock();
+        pCache = static_cast<ThreadChunkCache*>(GetThreadLocalValue(m_threadChunkCacheKey));
     }
 
-    Result result = FindFreeChunk(systemMemory ? &m_sysAllocInfo : &m_gpuAllocInfo[allocType], ppChunk);
-    if (result == Result::Success)
+    if (pCache != nullptr)
     {
-        (*ppChunk)->AddCommandStreamReference();
+        pMagazine = systemMemory ? &pCache->sysMagazine : &pCache->gpuMagazines[allocType];
     }
 
-    if (m_pChunkLock != nullptr)
+    if ((pMagazine != nullptr) && TakeMagazineChunk(pMagazine, ppChunk))
     {
-        m_pChunkLock->Unlock();
+        // The common case: this thread already owns a free chunk so we don't need the chunk lock.
+        (*ppChunk)->AddCommandStreamReference();
+
+#if PAL_ENABLE_PRINTS_ASSERTS
+        AtomicIncrement64(&m_magazineHits);
+#endif
+    }
+    else
+    {
+        // If necessary, engage the chunk lock while we search for a free chunk.
+        if (m_pChunkLock != nullptr)
+        {
+            LockAndCount(m_pChunkLock, &m_chunkLockStats);
+        }
+
+        if ((m_flags.threadChunkCache != 0) && (pCache == nullptr))
+        {
+            pCache = CreateThreadChunkCache();
+
+            if (pCache != nullptr)
+            {
+                pMagazine = systemMemory ? &pCache->sysMagazine : &pCache->gpuMagazines[allocType];
+            }
+        }
+
+        CmdAllocInfo*const pAllocInfo = systemMemory ? &m_sysAllocInfo : &m_gpuAllocInfo[allocType];
+
+        result = FindFreeChunk(pAllocInfo, ppChunk);
+        if (result == Result::Success)
+        {
+            (*ppChunk)->AddCommandStreamReference();
+
+            if (pMagazine != nullptr)
+            {
+                RefillMagazine(pAllocInfo, pMagazine);
+            }
+        }
+
+        if (m_pChunkLock != nullptr)
+        {
+            m_pChunkLock->Unlock();
+        }
     }
 
     return result;
 }
 
+// =====================================================================================================================
+// Pops a chunk from the calling thread's own magazine without taking the chunk lock. Fails if the magazine is empty or
+// was invalidated by a reset. Another thread may be reclaiming the magazine at the same time, so the count is only
+// lowered with a compare-and-swap; whichever thread wins owns the chunks it removed.
+bool CmdAllocator::TakeMagazineChunk(
+    ChunkMagazine*   pMagazine,
+    CmdStreamChunk** ppChunk
+    ) const
+{
+    bool   taken     = false;
+    uint32 numChunks = (pMagazine->resetEpoch == m_resetEpoch) ? pMagazine->numChunks : 0;
+
+    while ((numChunks > 0) && (taken == false))
+    {
+        const uint32 prevNumChunks = AtomicCompareAndSwap(&pMagazine->numChunks, numChunks, numChunks - 1);
+
+        if (prevNumChunks == numChunks)
+        {
+            *ppChunk = pMagazine->pChunks[numChunks - 1];
+            taken    = true;
+        }
+        else
+        {
+            numChunks = prevNumChunks;
+        }
+    }
+
+    return taken;
+}
+
+// =====================================================================================================================
+// Moves up to half a magazine of chunks from the free list to the calling thread's magazine. Only chunks which are
+// already free are taken; we don't want to create new allocations just to fill a cache. The chunk lock must be held.
+void CmdAllocator::RefillMagazine(
+    CmdAllocInfo*  pAllocInfo,
+    ChunkMagazine* pMagazine)
+{
+    // Anything left in a magazine from before the last reset has been reclaimed by the allocator.
+    if (pMagazine->resetEpoch != m_resetEpoch)
+    {
+        pMagazine->resetEpoch = m_resetEpoch;
+        pMagazine->numChunks  = 0;
+    }
+
+    while ((pMagazine->numChunks < (ChunkMagazineSize / 2)) && (pAllocInfo->freeList.IsEmpty() == false))
+    {
+        CmdStreamChunk*const pChunk = pAllocInfo->freeList.Back();
+        PAL_ASSERT((AutomaticMemoryReuse() && pChunk->IsIdle()) || pChunk->IsIdleOnGpu());
+
+        // Cached chunks go on the busy list right away so that Reset and FreeAllChunks account for them.
+        auto*const pNode = pChunk->ListNode();
+        pAllocInfo->freeList.Erase(pNode);
+        pAllocInfo->busyList.PushFront(pNode);
+
+        pMagazine->pChunks[pMagazine->numChunks] = pChunk;
+        pMagazine->numChunks++;
+    }
+}
+
+// =====================================================================================================================
+// Takes back the chunks of the given type cached by every thread and puts them on the free list. Threads which have
+// stopped recording would otherwise hold on to their chunks until the next Reset, so this is done before creating a
+// new allocation. The chunk lock must be held, which keeps the owning threads from refilling their magazines while we
+// empty them. Returns the number of chunks reclaimed.
+uint32 CmdAllocator::ReclaimMagazineChunks(
+    CmdAllocInfo* pAllocInfo)
+{
+    const bool   systemMemory = (pAllocInfo == &m_sysAllocInfo);
+    const uint32 allocType    = systemMemory ? CommandDataAlloc : static_cast<uint32>(pAllocInfo - &m_gpuAllocInfo[0]);
+
+    uint32 numReclaimed = 0;
+
+    for (uint32 idx = 0; idx < m_threadChunkCaches.NumElements(); ++idx)
+    {
+        ThreadChunkCache*const pCache    = m_threadChunkCaches.At(idx);
+        ChunkMagazine*const    pMagazine = systemMemory ? &pCache->sysMagazine : &pCache->gpuMagazines[allocType];
+
+        // Chunks cached before the last reset are already back on the free list.
+        if (pMagazine->resetEpoch == m_resetEpoch)
+        {
+            const uint32 numChunks = AtomicExchange(&pMagazine->numChunks, 0);
+
+            for (uint32 chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+            {
+                auto*const pNode = pMagazine->pChunks[chunkIdx]->ListNode();
+                pAllocInfo->busyList.Erase(pNode);
+                pAllocInfo->freeList.PushFront(pNode);
+            }
+
+            numReclaimed += numChunks;
+        }
+    }
+
+    return numReclaimed;
+}
+
+// =====================================================================================================================
+// Creates the calling thread's chunk cache and registers it with the thread-local key. The chunk lock must be held.
+CmdAllocator::ThreadChunkCache* CmdAllocator::CreateThreadChunkCache()
+{
+    auto* pCache = static_cast<ThreadChunkCache*>(PAL_CALLOC(sizeof(ThreadChunkCache),
+                                                             m_pDevice->GetPlatform(),
+                                                             AllocInternal));
+
+    if (pCache != nullptr)
+    {
+        // The caches are freed when the allocator is destroyed, so we must track them all.
+        if ((m_threadChunkCaches.PushBack(pCache) != Result::Success) ||
+            (SetThreadLocalValue(m_threadChunkCacheKey, pCache) != Result::Success))
+        {
+            if ((m_threadChunkCaches.IsEmpty() == false) && (m_threadChunkCaches.Back() == pCache))
+            {
+                m_threadChunkCaches.PopBack(nullptr);
+            }
+
+            PAL_SAFE_FREE(pCache, m_pDevice->GetPlatform());
+        }
+    }
+
+    return pCache;
+}
+
 // =====================================================================================================================
 // Searches the free and busy lists for a free chunk. A new CmdStreamAllocation will be created if needed.
 Result CmdAllocator::FindFreeChunk(
@@ -597,6 +794,15 @@ Result CmdAllocator::FindFreeChunk(
             }
         }
 
+        if ((pChunk == nullptr) && (m_flags.threadChunkCache != 0) && (ReclaimMagazineChunks(pAllocInfo) > 0))
+        {
+            pChunk = pAllocInfo->freeList.Back();
+
+            auto*const pNode = pChunk->ListNode();
+            pAllocInfo->freeList.Erase(pNode);
+            pAllocInfo->busyList.PushFront(pNode);
+        }
+
         if (pChunk == nullptr)
         {
             // All busy chunks were still in-use so we must create a new ChunkAllocation. It is possible for this call
@@ -746,7 +952,7 @@ VirtualLinearAllocator* CmdAllocator::GetNewLinearAllocator()
     // If necessary, engage the linear allocator lock.
     if (m_pLinearAllocLock != nullptr)
     {
-        m_pLinearAllocLock->Lock();
+        LockAndCount(m_pLinearAllocLock, &m_linearAllocLockStats);
     }
 
     if (m_linearAllocFreeList.IsEmpty() == false)
@@ -815,6 +1021,24 @@ void CmdAllocator::ReuseLinearAllocator(
     }
 }
 
+// =====================================================================================================================
+// Engages one of the allocator's locks, counting whether another thread was already holding it. The statistics are only
+// modified while holding the lock so they don't need to be atomic.
+void CmdAllocator::LockAndCount(
+    Mutex*     pLock,
+    LockStats* pStats)
+{
+    const bool contended = (pLock->TryLock() == false);
+
+    if (contended)
+    {
+        pLock->Lock();
+    }
+
+    pStats->acquires++;
+    pStats->contended += contended ? 1 : 0;
+}
+
 #if PAL_ENABLE_PRINTS_ASSERTS
 // =====================================================================================================================
 // Updates the histogram for the given queue type. This can only be called when logCmdBufCommitSizes is true.
@@ -901,6 +1125,22 @@ void CmdAllocator::PrintCommitLog() const
         }
     }
 
+    if (result == Result::Success)
+    {
+        // Follow the histograms with the lock statistics so multi-threaded recording runs can be compared.
+        result = commitLog.Printf("Chunk Lock Acquires,%llu\nChunk Lock Contended,%llu\nChunk Cache Hits,%llu\n",
+                                  m_chunkLockStats.acquires,
+                                  m_chunkLockStats.contended,
+                                  m_magazineHits);
+    }
+
+    if (result == Result::Success)
+    {
+        result = commitLog.Printf("Linear Allocator Lock Acquires,%llu\nLinear Allocator Lock Contended,%llu\n",
+                                  m_linearAllocLockStats.acquires,
+                                  m_linearAllocLockStats.contended);
+    }
+
     if (result == Result::Success)
     {
         // Put a divider at the end to make it easier to distinguish multiple data sets.
@@ -29,6 +29,7 @@
 #include "palCmdAllocator.h"
 #include "palIntrusiveList.h"
 #include "palLinearAllocator.h"
+#include "palThread.h"
 #include "palVector.h"
 
 namespace Util { class Mutex; }
@@ -92,6 +93,20 @@ public:
 
     uint64 LastPagingFence() const { return m_lastPagingFence; }
 
+    // Changes each time Reset reclaims every chunk this allocator has handed out.
+    uint32 ResetEpoch() const { return m_resetEpoch; }
+
+    // How often recording threads fought over one of this allocator's locks, which is the main scaling bottleneck when
+    // many threads record from one thread-safe allocator. Only meaningful once those threads are done.
+    struct LockStats
+    {
+        uint64 acquires;  // Number of times the lock was engaged.
+        uint64 contended; // Number of those times where another thread was already holding the lock.
+    };
+
+    const LockStats& ChunkLockStats() const       { return m_chunkLockStats; }
+    const LockStats& LinearAllocLockStats() const { return m_linearAllocLockStats; }
+
     static size_t GetPlacementSize(const CmdAllocatorCreateInfo& createInfo);
 
 protected:
@@ -111,8 +126,33 @@ private:
         CmdStreamAllocationCreateInfo allocCreateInfo;
     };
 
+    // Thread-safe allocators give each recording thread a small cache of free chunks per alloc type, so that most
+    // GetNewChunk calls don't need to take the chunk lock.  The cache is refilled from the free list in batches.  Its
+    // chunks are already on the busy list, so Reset reclaims them like any other busy chunk; the cache just has to be
+    // discarded, which is done by comparing its epoch to m_resetEpoch instead of touching other threads' caches.
+    // Only the owning thread takes chunks without the lock; other threads may take back the whole magazine while
+    // holding the chunk lock, so numChunks is only ever lowered atomically.
+    static constexpr uint32 ChunkMagazineSize = 8;
+
+    struct ChunkMagazine
+    {
+        uint32          resetEpoch;                  // Value of m_resetEpoch when these chunks were cached.
+        volatile uint32 numChunks;                   // Number of valid entries in pChunks.
+        CmdStreamChunk* pChunks[ChunkMagazineSize];  // Free chunks owned by this thread.
+    };
+
+    struct ThreadChunkCache
+    {
+        ChunkMagazine gpuMagazines[CmdAllocatorTypeCount];
+        ChunkMagazine sysMagazine;
+    };
+
     // These internal functions are used to manage all types of chunks.
     Result FindFreeChunk(CmdAllocInfo* pAllocInfo, CmdStreamChunk** ppChunk);
+    bool TakeMagazineChunk(ChunkMagazine* pMagazine, CmdStreamChunk** ppChunk) const;
+    void RefillMagazine(CmdAllocInfo* pAllocInfo, ChunkMagazine* pMagazine);
+    uint32 ReclaimMagazineChunks(CmdAllocInfo* pAllocInfo);
+    ThreadChunkCache* CreateThreadChunkCache();
     Result CreateAllocation(CmdAllocInfo* pAllocInfo, bool dummyAlloc, CmdStreamChunk** ppChunk);
     Result CreateDummyChunkAllocation();
 
@@ -128,10 +168,11 @@ private:
     {
         struct
         {
-            uint32 autoMemoryReuse :  1; // Indicates that the allocator will automatically recycle idle chunks.
-            uint32 trackBusyChunks :  1; // Indicates that the allocator will track which chunks are idle (for debugging
-                                         // purposes, or for supporting 'autoMemoryReuse').
-            uint32 reserved        : 30;
+            uint32 autoMemoryReuse  :  1; // Indicates that the allocator will automatically recycle idle chunks.
+            uint32 trackBusyChunks  :  1; // Indicates that the allocator will track which chunks are idle (for
+                                          // debugging purposes, or for supporting 'autoMemoryReuse').
+            uint32 threadChunkCache :  1; // Indicates that m_threadChunkCacheKey is valid and threads cache chunks.
+            uint32 reserved         : 29;
         };
         uint32 u32All;
     }  m_flags;
@@ -143,6 +184,12 @@ private:
     // Most-recent paging fence value returned from the OS when allocating command-chunk allocations
     uint64          m_lastPagingFence;
 
+    Util::ThreadLocalKey                           m_threadChunkCacheKey; // Looks up the calling thread's chunk cache.
+    Util::Vector<ThreadChunkCache*, 16, Platform> m_threadChunkCaches;   // All chunk caches, so they can be reclaimed
+                                                                          // and freed.
+    volatile uint32                                m_resetEpoch;          // Incremented whenever the chunk lists are
+                                                                          // reset, which invalidates all chunk caches.
+
     Util::Mutex*    m_pLinearAllocLock;    // If non-null, this protects the allocator's linear allocator state.
     LinearAllocList m_linearAllocFreeList; // Unordered list of allocators that are reset and not in use.
     LinearAllocList m_linearAllocBusyList; // Unordered list of allocators that are being used by command buffers.
@@ -159,8 +206,15 @@ private:
     // be rounded up when selecting a bin as this will guarantee that the "zero" bin only holds commits of size zero.
     uint64* m_pHistograms[HistogramCount];
     uint32  m_numHistogramBins;
+
+    volatile uint64 m_magazineHits; // GetNewChunk calls served by a per-thread chunk cache without locking.
 #endif
 
+    static void LockAndCount(Util::Mutex* pLock, LockStats* pStats);
+
+    LockStats m_chunkLockStats;       // Chunk lock statistics from GetNewChunk.
+    LockStats m_linearAllocLockStats; // Linear allocator lock statistics from GetNewLinearAllocator.
+
     // Dummy chunk used to handle cases where we've run out of GPU memory.
     CmdStreamAllocation* m_pDummyChunkAllocation;
 
@@ -744,6 +744,13 @@ public:
     bool IsRealtimeComputeUnits() const { return (m_createInfo.flags.realtimeComputeUnits != 0); }
     bool UsesDispatchTunneling()  const { return (m_createInfo.flags.dispatchTunneling    != 0); }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    // Nested command buffers can't retain their chunks because their callers also reference them.
+    bool RetainsChunksOnReset() const { return (m_createInfo.flags.retainChunksOnReset != 0) && (IsNested() == false); }
+#else
+    bool RetainsChunksOnReset() const { return false; }
+#endif
+
     bool IsExclusiveSubmit() const { return (m_buildFlags.optimizeExclusiveSubmit    != 0); }
     bool IsOneTimeSubmit()   const { return (m_buildFlags.optimizeOneTimeSubmit      != 0); }
     bool AllowLaunchViaIb2() const { return (m_buildFlags.disallowNestedLaunchViaIb2 == 0); }
@@ -52,6 +52,8 @@ CmdStream::CmdStream(
     :
     m_chunkList(pDevice->GetPlatform()),
     m_retainedChunkList(pDevice->GetPlatform()),
+    m_deferredChunkList(pDevice->GetPlatform()),
+    m_deferredResetEpoch(0),
     m_subEngineType(subEngineType),
     m_cmdStreamUsage(cmdStreamUsage),
     m_sizeAlignDwords(pDevice->EngineProperties().perEngine[engineType].sizeAlignInDwords),
@@ -128,6 +130,9 @@ CmdStream::CmdStream(
 // =====================================================================================================================
 CmdStream::~CmdStream()
 {
+    // Nothing would be left to return deferred chunks to the allocator, so stop retaining them before the final reset.
+    m_flags.retainChunks = 0;
+
     // Call reset to drop all chunk references.
     Reset(nullptr, true);
 }
@@ -299,6 +304,12 @@ CmdStreamChunk* CmdStream::GetNextChunk(
 
     if (m_status == Result::Success)
     {
+        // If we ran out of retained chunks, check if the chunks from our last recording can be reused yet.
+        if (m_retainedChunkList.IsEmpty() && (m_deferredChunkList.IsEmpty() == false))
+        {
+            ReclaimDeferredChunks();
+        }
+
         // First search the retained chunk list
         if (m_retainedChunkList.IsEmpty() == false)
         {
@@ -432,8 +443,23 @@ void CmdStream::Reset(
             m_chunkList.PushBack(pChunk);
         }
 
+        // If our last recording's chunks are still around they were never reused, so they go back to the allocator.
+        ReturnDeferredChunks();
+
+        // Streams which retain their chunks keep them as long as we aren't switching to a new allocator and the
+        // allocator can tell us when the GPU is done with them.
+        const bool deferChunks = (m_flags.retainChunks != 0)                                        &&
+                                 (m_status == Result::Success)                                      &&
+                                 ((pNewAllocator == nullptr) || (pNewAllocator == m_pCmdAllocator)) &&
+                                 (m_pCmdAllocator != nullptr)                                       &&
+                                 m_pCmdAllocator->TrackBusyChunks();
+
+        if (deferChunks)
+        {
+            DeferChunks();
+        }
         // Return all remaining chunks to the command allocator.
-        if (m_chunkList.IsEmpty() == false)
+        else if (m_chunkList.IsEmpty() == false)
         {
             for (auto iter = m_chunkList.Begin(); iter.IsValid(); iter.Next())
             {
@@ -484,6 +510,77 @@ void CmdStream::Reset(
     m_pMemAllocator = nullptr;
 }
 
+// =====================================================================================================================
+// Moves our chunks to the deferred list instead of returning them to the command allocator. We give up our command
+// stream references so that the chunks look like any other returned chunk if the allocator is reset underneath us.
+void CmdStream::DeferChunks()
+{
+    PAL_ASSERT(m_deferredChunkList.IsEmpty());
+
+    for (auto iter = m_chunkList.Begin(); iter.IsValid(); iter.Next())
+    {
+        iter.Get()->RemoveCommandStreamReference();
+
+        const Result result = m_deferredChunkList.PushBack(iter.Get());
+        PAL_ASSERT(result == Result::Success);
+    }
+
+    m_deferredResetEpoch = m_pCmdAllocator->ResetEpoch();
+}
+
+// =====================================================================================================================
+// Moves the deferred chunks to the retained list if the GPU is done with all of them. Chunks which were reclaimed by an
+// allocator reset are forgotten instead.
+void CmdStream::ReclaimDeferredChunks()
+{
+    if (m_pCmdAllocator->ResetEpoch() != m_deferredResetEpoch)
+    {
+        m_deferredChunkList.Clear();
+    }
+    else
+    {
+        // No one else can reference these chunks while the allocator still considers them busy, so it's safe to look
+        // at their busy trackers without the allocator's lock.
+        bool isIdle = true;
+
+        for (auto iter = m_deferredChunkList.Begin(); isIdle && iter.IsValid(); iter.Next())
+        {
+            isIdle = iter.Get()->IsIdleOnGpu();
+        }
+
+        if (isIdle)
+        {
+            while (m_deferredChunkList.IsEmpty() == false)
+            {
+                CmdStreamChunk* pChunk = nullptr;
+                m_deferredChunkList.PopBack(&pChunk);
+
+                pChunk->Reset(true);
+                pChunk->AddCommandStreamReference();
+
+                const Result result = m_retainedChunkList.PushBack(pChunk);
+                PAL_ASSERT(result == Result::Success);
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Hands the deferred chunks back to the command allocator, which will recycle them once they're idle.
+void CmdStream::ReturnDeferredChunks()
+{
+    if (m_deferredChunkList.IsEmpty() == false)
+    {
+        // If the allocator was reset it has already reclaimed these chunks.
+        if (m_pCmdAllocator->ResetEpoch() == m_deferredResetEpoch)
+        {
+            m_pCmdAllocator->ReuseChunks(CommandDataAlloc, (m_flags.buildInSysMem != 0), m_deferredChunkList.Begin());
+        }
+
+        m_deferredChunkList.Clear();
+    }
+}
+
 // =====================================================================================================================
 // A basic implementation of End. If any IP-specific subclasses need more functionality (e.g., chaining) they should
 // override EndCurrentChunk.
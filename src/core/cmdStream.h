@@ -82,7 +82,8 @@ union CmdStreamFlags
         uint32 enablePreemption  :  1; // This command stream can be preempted.
         uint32 addressDependent  :  1; // One or more commands are dependent on the command chunk's GPU address. This
                                        // disables optimizations that copy commands and execute them without patching.
-        uint32 reserved          : 26;
+        uint32 retainChunks      :  1; // Chunks returned by Reset are kept and reused once they are idle on the GPU.
+        uint32 reserved          : 25;
     };
     uint32     value;
 };
@@ -211,6 +212,11 @@ public:
 
     void EnableDropIfSameContext(bool enable) { m_flags.dropIfSameContext = enable; }
 
+    // When enabled, a Reset which returns GPU memory keeps this stream's chunks instead of returning them to the
+    // command allocator. They are reused by the next recording once the GPU is done with them, so a stream which is
+    // re-recorded every frame stops taking chunks from the allocator. This must not be enabled on nested streams.
+    void EnableChunkRetention(bool enable) { m_flags.retainChunks = enable; }
+
     bool DropIfSameContext() const { return m_flags.dropIfSameContext == 1; }
     bool IsPreemptionEnabled() const { return m_flags.enablePreemption == 1; }
 
@@ -260,6 +266,10 @@ protected:
     ChunkRefList         m_chunkList;
     // A list of chunks that are being retained between command stream resets to avoid calling the allocator
     ChunkRefList         m_retainedChunkList;
+    // If chunk retention is enabled, these are the chunks of the last recording. They may still be in use by the GPU
+    // so they don't hold a command stream reference; they are moved to the retained list once they're idle.
+    ChunkRefList         m_deferredChunkList;
+    uint32               m_deferredResetEpoch; // Allocator reset epoch at the time m_deferredChunkList was filled.
 
     const SubEngineType  m_subEngineType;
     const CmdStreamUsage m_cmdStreamUsage;
@@ -293,6 +303,10 @@ private:
     void TrackNestedChunks(const ChunkRefList& chunkList);
     void ResetNestedChunks();
 
+    void DeferChunks();
+    void ReclaimDeferredChunks();
+    void ReturnDeferredChunks();
+
     Device*const     m_pDevice;
     const EngineType m_engineType;
     const uint32     m_cmdSpaceDwordPadding; // End-of-chunk padding needed for a postamble and/or NOP padding.
@@ -38,16 +38,57 @@ using namespace DevDriver;
 namespace Pal
 {
 // =====================================================================================================================
-EventService::EventService(const AllocCb& allocCb)
-    : m_rmtWriter(allocCb)
-    , m_isMemoryProfilingEnabled(false)
+EventService::EventService(
+    const PalPlatformSettings& settings,
+    const AllocCb&             allocCb)
+    : m_settings(settings)
+    , m_rmtWriter(allocCb)
+    , m_profilingEpoch(0)
     , m_isInitialized(false)
+    , m_streamFilePath()
+    , m_streamFileSize(0)
+    , m_streamFileSizeLimit(0)
+    , m_streamCount(0)
+    , m_drainRequested(false)
+    , m_stopDrainThread(false)
+    , m_allocCb(allocCb)
+    , m_threadBufferKeyValid(false)
+    , m_pThreadBuffers(nullptr)
+    , m_pOverflowRecords(nullptr)
+    , m_nextSequence(0)
+    , m_nextSequenceValid(false)
+    , m_isTruncated(false)
 {
+    m_threadBufferKeyValid = (Util::CreateThreadLocalKey(&m_threadBufferKey) == Util::Result::Success);
 }
 
 // =====================================================================================================================
 EventService::~EventService()
 {
+    StopDrainThread();
+
+    // Stop any stream while m_streamFile can still receive the remaining data.
+    m_rmtWriter.Reset();
+
+    while (m_pThreadBuffers != nullptr)
+    {
+        ThreadTokenBuffer* pNext = m_pThreadBuffers->pNext;
+        DD_FREE(m_pThreadBuffers->pRing, m_allocCb);
+        DD_DELETE(m_pThreadBuffers, m_allocCb);
+        m_pThreadBuffers = pNext;
+    }
+
+    while (m_pOverflowRecords != nullptr)
+    {
+        OverflowRecord* pNext = m_pOverflowRecords->pNext;
+        DD_FREE(m_pOverflowRecords, m_allocCb);
+        m_pOverflowRecords = pNext;
+    }
+
+    if (m_threadBufferKeyValid)
+    {
+        Util::DeleteThreadLocalKey(m_threadBufferKey);
+    }
 }
 
 // =====================================================================================================================
@@ -56,9 +97,6 @@ DevDriver::Result EventService::HandleRequest(
 {
     DD_ASSERT(pContext != nullptr);
 
-    // Make sure we aren't logging while we handle a network request
-    Platform::LockGuard<Platform::Mutex> lock(m_mutex);
-
     DevDriver::Result result = DevDriver::Result::Unavailable;
 
     const char* const pArgDelim = " ";
@@ -68,35 +106,97 @@ DevDriver::Result EventService::HandleRequest(
     char* pCmdName = Platform::Strtok(pContext->GetRequestArguments(), pArgDelim, &pStrtokContext);
     char* pCmdArg1 = Platform::Strtok(nullptr, pArgDelim, &pStrtokContext);
 
-    if (strcmp(pCmdName, "enableMemoryProfiling") == 0)
+    const bool enableRequested  = (pCmdName != nullptr) && (strcmp(pCmdName, "enableMemoryProfiling") == 0);
+    const bool disableRequested = (pCmdName != nullptr) && (strcmp(pCmdName, "disableMemoryProfiling") == 0);
+
+    if (disableRequested)
+    {
+        // The drain thread takes m_mutex, so it has to be stopped before we take it. Whatever it hasn't drained yet is
+        // flushed below.
+        StopDrainThread();
+    }
+
+    // Make sure we aren't logging while we handle a network request
+    Platform::LockGuard<Platform::Mutex> lock(m_mutex);
+
+    if (enableRequested)
     {
-        if (m_isMemoryProfilingEnabled == false)
+        if (IsMemoryProfilingEnabled() == false)
         {
-            m_isMemoryProfilingEnabled = true;
-            result = DevDriver::Result::Success;
+            if (pCmdArg1 == nullptr)
+            {
+                m_rmtWriter.Init();
+                result = DevDriver::Result::Success;
+            }
+            else if (strcmp(pCmdArg1, "stream") == 0)
+            {
+                result = BeginStreaming();
+            }
+            else
+            {
+                result = DevDriver::Result::InvalidParameter;
+            }
+
+            if (result == DevDriver::Result::Success)
+            {
+                m_rmtWriter.BeginDataChunk(Util::GetIdOfCurrentProcess(), 0);
+
+                m_nextSequenceValid = false;
+                m_isTruncated       = false;
 
-            m_rmtWriter.Init();
-            m_rmtWriter.BeginDataChunk(Util::GetIdOfCurrentProcess(), 0);
+                // Moves to the next (odd) epoch, which starts accepting tokens.
+                Util::AtomicIncrement(&m_profilingEpoch);
+
+                StartDrainThread();
+            }
         }
     }
-    else if (strcmp(pCmdName, "disableMemoryProfiling") == 0)
+    else if (disableRequested)
     {
-        if (m_isMemoryProfilingEnabled)
+        if (IsMemoryProfilingEnabled())
         {
-            m_isMemoryProfilingEnabled = false;
+            // Moves to the next (even) epoch, after which every record of the enabled epoch is rejected.
+            Util::AtomicIncrement(&m_profilingEpoch);
             result = DevDriver::Result::Success;
 
+            FlushThreadTokenBuffers();
+
             m_rmtWriter.EndDataChunk();
             m_rmtWriter.Finalize();
 
-            const size_t rmtDataSize = m_rmtWriter.GetRmtDataSize();
-            if (rmtDataSize > 0)
+            const void* pResponse    = m_rmtWriter.GetRmtData();
+            size_t      responseSize = m_rmtWriter.GetRmtDataSize();
+
+            if (m_streamFile.IsOpen())
+            {
+                // The writer is no longer streaming, so the result is stable. Reaching the configured size limit
+                // leaves a valid (if incomplete) trace, so it doesn't fail the request.
+                result = m_rmtWriter.GetStreamResult();
+
+                if (result == DevDriver::Result::LimitReached)
+                {
+                    result = DevDriver::Result::Success;
+                }
+
+                if ((m_streamFile.Flush() != Util::Result::Success) && (result == DevDriver::Result::Success))
+                {
+                    result = DevDriver::Result::FileIoError;
+                }
+
+                m_streamFile.Close();
+
+                // Tell the requester where the trace went.
+                pResponse    = m_streamFilePath;
+                responseSize = (result == DevDriver::Result::Success) ? strlen(m_streamFilePath) : 0;
+            }
+
+            if (responseSize > 0)
             {
                 IByteWriter* pWriter = nullptr;
                 result = pContext->BeginByteResponse(&pWriter);
                 if (result == DevDriver::Result::Success)
                 {
-                    pWriter->WriteBytes(m_rmtWriter.GetRmtData(), rmtDataSize);
+                    pWriter->WriteBytes(pResponse, responseSize);
 
                     result = pWriter->End();
                 }
@@ -107,14 +207,469 @@ DevDriver::Result EventService::HandleRequest(
     return result;
 }
 
-void EventService::WriteTokenData(const DevDriver::RMT_TOKEN_DATA& token)
+// =====================================================================================================================
+// Creates a new trace file in the RmtTraceDirectory setting and puts the RMT writer into streaming mode with the
+// staging buffer size and file size limit from the settings.
+DevDriver::Result EventService::BeginStreaming()
 {
-    // Make sure we aren't logging while we handle a network request
-    Platform::LockGuard<Platform::Mutex> lock(m_mutex);
-    if (IsMemoryProfilingEnabled())
+    const size_t bufferSize = static_cast<size_t>(m_settings.rmtTraceStreamBufferSizeInKb) * 1024;
+
+    // The file is named after the process so that traces from several processes can share the directory.
+    char  executableName[MaxPathStrLen] = {};
+    char* pExecutableName               = nullptr;
+
+    if (Util::GetExecutableName(&executableName[0], &pExecutableName, sizeof(executableName)) != Util::Result::Success)
+    {
+        pExecutableName = &executableName[0];
+        Util::Strncpy(executableName, "Unknown", sizeof(executableName));
+    }
+
+    // Create the directory. We don't care if it fails (existing is fine, failure is caught when opening the file).
+    Util::MkDir(m_settings.rmtTraceDirectory);
+
+    Util::Snprintf(m_streamFilePath,
+                   sizeof(m_streamFilePath),
+                   "%s/%s_%u_%u.rmv",
+                   m_settings.rmtTraceDirectory,
+                   pExecutableName,
+                   Util::GetIdOfCurrentProcess(),
+                   m_streamCount++);
+
+    DevDriver::Result result =
+        (m_streamFile.Open(m_streamFilePath, Util::FileAccessWrite | Util::FileAccessBinary) == Util::Result::Success)
+        ? DevDriver::Result::Success : DevDriver::Result::FileAccessError;
+
+    if (result == DevDriver::Result::Success)
+    {
+        m_streamFileSize      = 0;
+        m_streamFileSizeLimit = static_cast<uint64>(m_settings.rmtTraceMaxFileSizeInMb) * 1024 * 1024;
+
+        const RmtWriter::StreamCallbacks callbacks = { StreamWrite, this };
+
+        result = m_rmtWriter.InitStreaming(callbacks, bufferSize);
+
+        if (result != DevDriver::Result::Success)
+        {
+            m_streamFile.Close();
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Appends streamed RMT data to the file. Called from the RMT writer's flush thread. The writer passes whole chunks, so
+// refusing a write which would exceed the size limit leaves a valid file.
+DevDriver::Result EventService::StreamWrite(
+    void*       pUserdata,
+    const void* pData,
+    size_t      dataSize)
+{
+    EventService*const pThis = static_cast<EventService*>(pUserdata);
+
+    DevDriver::Result result = DevDriver::Result::LimitReached;
+
+    if ((pThis->m_streamFileSizeLimit == 0) || ((pThis->m_streamFileSize + dataSize) <= pThis->m_streamFileSizeLimit))
+    {
+        result = DevDriver::Result::FileIoError;
+
+        if (pThis->m_streamFile.Write(pData, dataSize) == Util::Result::Success)
+        {
+            pThis->m_streamFileSize += dataSize;
+            result = DevDriver::Result::Success;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Copies data into a thread's ring at the given (unwrapped) offset.
+static void CopyToRing(
+    uint8*      pRing,
+    uint64      offset,
+    const void* pData,
+    size_t      dataSize)
+{
+    const size_t start     = static_cast<size_t>(offset % kThreadTokenRingSize);
+    const size_t firstSize = Util::Min(dataSize, kThreadTokenRingSize - start);
+
+    memcpy(pRing + start, pData, firstSize);
+    memcpy(pRing, static_cast<const uint8*>(pData) + firstSize, dataSize - firstSize);
+}
+
+// =====================================================================================================================
+// Copies data out of a thread's ring at the given (unwrapped) offset.
+static void CopyFromRing(
+    const uint8* pRing,
+    uint64       offset,
+    void*        pData,
+    size_t       dataSize)
+{
+    const size_t start     = static_cast<size_t>(offset % kThreadTokenRingSize);
+    const size_t firstSize = Util::Min(dataSize, kThreadTokenRingSize - start);
+
+    memcpy(pData, pRing + start, firstSize);
+    memcpy(static_cast<uint8*>(pData) + firstSize, pRing, dataSize - firstSize);
+}
+
+// =====================================================================================================================
+// Returns the calling thread's token buffer, creating it on first use. Returns null if no buffer could be created.
+// Buffers must only ever be written by one thread, otherwise their records would not be sorted by sequence number.
+EventService::ThreadTokenBuffer* EventService::GetThreadTokenBuffer()
+{
+    ThreadTokenBuffer* pBuffer = nullptr;
+
+    if (m_threadBufferKeyValid)
     {
-        m_rmtWriter.WriteTokenData(token);
+        pBuffer = static_cast<ThreadTokenBuffer*>(Util::GetThreadLocalValue(m_threadBufferKey));
+
+        if (pBuffer == nullptr)
+        {
+            pBuffer = DD_NEW(ThreadTokenBuffer, m_allocCb)();
+
+            if (pBuffer != nullptr)
+            {
+                pBuffer->pRing = static_cast<uint8*>(DD_MALLOC(kThreadTokenRingSize, alignof(uint64), m_allocCb));
+
+                if ((pBuffer->pRing != nullptr) &&
+                    (Util::SetThreadLocalValue(m_threadBufferKey, pBuffer) == Util::Result::Success))
+                {
+                    Platform::LockGuard<Platform::Mutex> lock(m_mutex);
+                    pBuffer->pNext   = m_pThreadBuffers;
+                    m_pThreadBuffers = pBuffer;
+                }
+                else
+                {
+                    DD_FREE(pBuffer->pRing, m_allocCb);
+                    DD_DELETE(pBuffer, m_allocCb);
+                    pBuffer = nullptr;
+                }
+            }
+        }
     }
+
+    return pBuffer;
+}
+
+// =====================================================================================================================
+void EventService::WriteTokenData(
+    uint32      epoch,
+    uint64      firstSequence,
+    uint64      sequence,
+    const void* pTokenData,
+    size_t      tokenDataSize)
+{
+    const TokenRecordHeader header = { sequence, firstSequence, tokenDataSize };
+
+    // Cheap early out for events which were logged before profiling was last disabled.
+    if (epoch == m_profilingEpoch)
+    {
+        ThreadTokenBuffer*const pBuffer = GetThreadTokenBuffer();
+
+        bool queued = false;
+
+        if (pBuffer != nullptr)
+        {
+            bool drainRequested = false;
+
+            {
+                Platform::LockGuard<Platform::Mutex> lock(pBuffer->mutex);
+
+                // The epoch must be checked again under the ring's lock, which disabling profiling takes before it
+                // discards whatever could not be drained.
+                queued = (epoch != m_profilingEpoch) || QueueRecord(pBuffer, header, pTokenData);
+
+                drainRequested = ((pBuffer->writeOffset - pBuffer->readOffset) >= kThreadTokenRingDrainThreshold);
+            }
+
+            if (drainRequested)
+            {
+                m_drainRequested.Signal();
+            }
+        }
+
+        if (queued == false)
+        {
+            // The ring is full (or doesn't exist), so make room by draining every ring into the RMT writer.
+            Platform::LockGuard<Platform::Mutex> lock(m_mutex);
+
+            if (pBuffer != nullptr)
+            {
+                DrainThreadTokenBuffers();
+
+                Platform::LockGuard<Platform::Mutex> bufferLock(pBuffer->mutex);
+                queued = (epoch != m_profilingEpoch) || QueueRecord(pBuffer, header, pTokenData);
+            }
+
+            // Draining stops at a record which is still being built by another thread. That thread is never waiting
+            // on us, but rather than wait for it this record goes to the overflow list.
+            if ((queued == false) && (epoch == m_profilingEpoch))
+            {
+                QueueOverflowRecord(header, pTokenData);
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Body of the drain thread. Merges the rings into the RMT writer every kTokenDrainIntervalInMs, or sooner when a ring
+// passes kThreadTokenRingDrainThreshold, so that logging threads rarely have to drain the rings themselves.
+void EventService::DrainThreadFunc(
+    void* pThreadParameter)
+{
+    EventService*const pThis = static_cast<EventService*>(pThreadParameter);
+
+    while (pThis->m_stopDrainThread == false)
+    {
+        pThis->m_drainRequested.Wait(kTokenDrainIntervalInMs);
+        pThis->m_drainRequested.Clear();
+
+        if (pThis->m_stopDrainThread == false)
+        {
+            Platform::LockGuard<Platform::Mutex> lock(pThis->m_mutex);
+
+            if (pThis->IsMemoryProfilingEnabled())
+            {
+                pThis->DrainThreadTokenBuffers();
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Starts the drain thread. The caller must hold m_mutex. If the thread can't be started the rings are still drained
+// whenever one of them fills up.
+void EventService::StartDrainThread()
+{
+    PAL_ASSERT(m_drainThread.IsJoinable() == false);
+
+    m_stopDrainThread = false;
+    m_drainRequested.Clear();
+
+    if (m_drainThread.Start(DrainThreadFunc, this) == DevDriver::Result::Success)
+    {
+        // This is for humans, so we ignore a failure to set the name.
+        m_drainThread.SetName("PAL RMT Token Drain");
+    }
+    else
+    {
+        PAL_ALERT_ALWAYS();
+    }
+}
+
+// =====================================================================================================================
+// Stops the drain thread if it is running. The caller must not hold m_mutex, which the thread may be waiting for.
+void EventService::StopDrainThread()
+{
+    if (m_drainThread.IsJoinable())
+    {
+        m_stopDrainThread = true;
+        m_drainRequested.Signal();
+
+        DevDriver::Result result = DevDriver::Result::NotReady;
+
+        do
+        {
+            result = m_drainThread.Join(kTokenDrainIntervalInMs);
+        } while (result == DevDriver::Result::NotReady);
+
+        PAL_ASSERT(result == DevDriver::Result::Success);
+    }
+}
+
+// =====================================================================================================================
+// Appends a record to a thread's ring. Returns false if there isn't enough room. The caller must hold the ring's lock.
+bool EventService::QueueRecord(
+    ThreadTokenBuffer*       pBuffer,
+    const TokenRecordHeader& header,
+    const void*              pTokenData)
+{
+    const uint64 recordSize = sizeof(header) + header.dataSize;
+    const bool   fits       = (recordSize <= (kThreadTokenRingSize - (pBuffer->writeOffset - pBuffer->readOffset)));
+
+    if (fits)
+    {
+        CopyToRing(pBuffer->pRing, pBuffer->writeOffset, &header, sizeof(header));
+        CopyToRing(pBuffer->pRing,
+                   pBuffer->writeOffset + sizeof(header),
+                   pTokenData,
+                   static_cast<size_t>(header.dataSize));
+
+        pBuffer->writeOffset += recordSize;
+    }
+
+    return fits;
+}
+
+// =====================================================================================================================
+// Keeps a record which could not be queued to its thread's ring until it can be drained. The caller must hold m_mutex.
+void EventService::QueueOverflowRecord(
+    const TokenRecordHeader& header,
+    const void*              pTokenData)
+{
+    OverflowRecord* pRecord = nullptr;
+
+    if (m_isTruncated == false)
+    {
+        pRecord = static_cast<OverflowRecord*>(DD_MALLOC(sizeof(OverflowRecord) + static_cast<size_t>(header.dataSize),
+                                                         alignof(OverflowRecord),
+                                                         m_allocCb));
+    }
+
+    if (pRecord != nullptr)
+    {
+        pRecord->header = header;
+        pRecord->pNext  = m_pOverflowRecords;
+        memcpy(pRecord + 1, pTokenData, static_cast<size_t>(header.dataSize));
+
+        m_pOverflowRecords = pRecord;
+    }
+    else if (m_isTruncated == false)
+    {
+        // Nothing logged after this record can be drained, so stop keeping records until profiling is restarted.
+        m_isTruncated = true;
+        PAL_ALERT_ALWAYS();
+    }
+}
+
+// =====================================================================================================================
+// Writes the run of records at the head of a thread's ring which continue the merged sequence. Returns true if any
+// record was written. The caller must hold m_mutex.
+bool EventService::DrainThreadTokenBuffer(
+    ThreadTokenBuffer* pBuffer)
+{
+    Platform::LockGuard<Platform::Mutex> lock(pBuffer->mutex);
+
+    bool progress = false;
+
+    while (pBuffer->readOffset < pBuffer->writeOffset)
+    {
+        TokenRecordHeader header;
+        CopyFromRing(pBuffer->pRing, pBuffer->readOffset, &header, sizeof(header));
+
+        if (m_nextSequenceValid == false)
+        {
+            m_nextSequence      = header.firstSequence;
+            m_nextSequenceValid = true;
+        }
+
+        if (header.sequence > m_nextSequence)
+        {
+            break;
+        }
+
+        // Anything older than the next record would be stale and is skipped; stale epochs are rejected when queued.
+        if ((header.sequence == m_nextSequence) && (header.dataSize > 0))
+        {
+            const uint64 dataOffset = pBuffer->readOffset + sizeof(header);
+            const size_t start      = static_cast<size_t>(dataOffset % kThreadTokenRingSize);
+            const size_t firstSize  = Util::Min(static_cast<size_t>(header.dataSize), kThreadTokenRingSize - start);
+
+            m_rmtWriter.WriteData(pBuffer->pRing + start, firstSize);
+
+            if (firstSize < header.dataSize)
+            {
+                m_rmtWriter.WriteData(pBuffer->pRing, static_cast<size_t>(header.dataSize) - firstSize);
+            }
+        }
+
+        m_nextSequence       = Util::Max(m_nextSequence, header.sequence + 1);
+        pBuffer->readOffset += sizeof(header) + header.dataSize;
+        progress             = true;
+    }
+
+    return progress;
+}
+
+// =====================================================================================================================
+// Writes every overflow record which continues the merged sequence. Returns true if any record was written. The
+// caller must hold m_mutex.
+bool EventService::DrainOverflowRecords()
+{
+    bool progress = false;
+
+    OverflowRecord** ppRecord = &m_pOverflowRecords;
+
+    while (*ppRecord != nullptr)
+    {
+        OverflowRecord*const pRecord = *ppRecord;
+
+        if (m_nextSequenceValid == false)
+        {
+            m_nextSequence      = pRecord->header.firstSequence;
+            m_nextSequenceValid = true;
+        }
+
+        if (pRecord->header.sequence == m_nextSequence)
+        {
+            if (pRecord->header.dataSize > 0)
+            {
+                m_rmtWriter.WriteData(pRecord + 1, static_cast<size_t>(pRecord->header.dataSize));
+            }
+
+            m_nextSequence++;
+            progress = true;
+
+            // The list isn't sorted, so start over in case an earlier record is next.
+            *ppRecord = pRecord->pNext;
+            DD_FREE(pRecord, m_allocCb);
+            ppRecord  = &m_pOverflowRecords;
+        }
+        else
+        {
+            ppRecord = &pRecord->pNext;
+        }
+    }
+
+    return progress;
+}
+
+// =====================================================================================================================
+// Merges the queued records of every thread into the RMT writer in the order their events were logged, for as long as
+// the next record in that order has been queued. The caller must hold m_mutex.
+void EventService::DrainThreadTokenBuffers()
+{
+    bool progress = true;
+
+    // Each ring is already sorted, so take the run at the head of each one in turn until none of them continues the
+    // sequence. There are only as many rings as threads which logged events, so this is cheap.
+    while (progress)
+    {
+        progress = DrainOverflowRecords();
+
+        for (ThreadTokenBuffer* pBuffer = m_pThreadBuffers; pBuffer != nullptr; pBuffer = pBuffer->pNext)
+        {
+            progress |= DrainThreadTokenBuffer(pBuffer);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Drains whatever is left of the epoch into the RMT writer and discards the rest. The caller must hold m_mutex and
+// must have disabled memory profiling first so that no new records are queued.
+//
+// An event which was logged before profiling was disabled may not have queued its tokens yet, in which case they are
+// dropped. Later events may still have been queued, but their time deltas are relative to the dropped tokens. The
+// merge therefore stops at the first missing sequence number and discards everything queued after it.
+void EventService::FlushThreadTokenBuffers()
+{
+    DrainThreadTokenBuffers();
+
+    for (ThreadTokenBuffer* pBuffer = m_pThreadBuffers; pBuffer != nullptr; pBuffer = pBuffer->pNext)
+    {
+        Platform::LockGuard<Platform::Mutex> lock(pBuffer->mutex);
+        pBuffer->readOffset = pBuffer->writeOffset;
+    }
+
+    while (m_pOverflowRecords != nullptr)
+    {
+        OverflowRecord* pNext = m_pOverflowRecords->pNext;
+        DD_FREE(m_pOverflowRecords, m_allocCb);
+        m_pOverflowRecords = pNext;
+    }
+
+    m_nextSequenceValid = false;
 }
 
 } // Pal
@@ -27,8 +27,13 @@
 
 #include "ddUriInterface.h"
 #include "palEventDefs.h"
+#include "palFile.h"
+#include "palMutex.h"
+#include "palThread.h"
 #include "util/rmtWriter.h"
 
+#include "core/g_palPlatformSettings.h"
+
 namespace Pal
 {
     // String used to identify the service
@@ -36,33 +41,133 @@ namespace Pal
 
     DD_STATIC_CONST DevDriver::Version kEventServiceVersion = 1;
 
+    // Size of each thread's token ring. A thread which fills its ring drains every ring into the RMT writer.
+    DD_STATIC_CONST size_t kThreadTokenRingSize = 64 * 1024;
+
+    // The drain thread empties the rings this often, or sooner once a ring holds kThreadTokenRingDrainThreshold bytes.
+    DD_STATIC_CONST uint32 kTokenDrainIntervalInMs        = 100;
+    DD_STATIC_CONST size_t kThreadTokenRingDrainThreshold = kThreadTokenRingSize / 2;
+
     class EventService : public DevDriver::IService
     {
     public:
-        EventService(const DevDriver::AllocCb& allocCb);
+        EventService(const PalPlatformSettings& settings, const DevDriver::AllocCb& allocCb);
         ~EventService();
 
         // Returns the name of the service
         const char* GetName() const override final { return kEventServiceName; }
         DevDriver::Version GetVersion() const override final { return kEventServiceVersion; }
 
-        // Handles an incoming URI request
+        // Handles an incoming URI request. "enableMemoryProfiling stream" streams the RMT data to a new file in the
+        // RmtTraceDirectory setting rather than returning it from "disableMemoryProfiling", which then returns the
+        // file's path instead.
         DevDriver::Result HandleRequest(DevDriver::IURIRequestContext* pContext) override final;
 
         // Returns true if memory profiling has been enabled
-        bool IsMemoryProfilingEnabled() const { return m_isMemoryProfilingEnabled; }
+        bool IsMemoryProfilingEnabled() const { return IsProfilingEpoch(m_profilingEpoch); }
+
+        // Returns the current profiling epoch. It changes every time memory profiling is enabled or disabled and is
+        // odd while profiling is enabled, so each enabled period has its own epoch.
+        uint32 GetProfilingEpoch() const { return m_profilingEpoch; }
+        static bool IsProfilingEpoch(uint32 epoch) { return ((epoch & 1) != 0); }
 
         uint8 CalculateDelta()
         {
             return m_rmtWriter.CalculateDelta();
         }
 
-        void WriteTokenData(const DevDriver::RMT_TOKEN_DATA& token);
+        // Queues the RMT tokens of one event. Each thread queues into its own ring so concurrent events don't
+        // serialize on the RMT writer; the rings are merged by sequence number on the drain thread, whenever one fills
+        // up and when memory profiling is disabled. "epoch" is the profiling epoch the event was logged in and
+        // "firstSequence" is the sequence number of the first event logged in that epoch. Events from any other epoch
+        // are rejected. Callers must number the events of an epoch contiguously, since the merge stops at the first
+        // missing sequence number.
+        void WriteTokenData(
+            uint32      epoch,
+            uint64      firstSequence,
+            uint64      sequence,
+            const void* pTokenData,
+            size_t      tokenDataSize);
 
     private:
+        // Precedes each event's tokens in a ring or overflow record.
+        struct TokenRecordHeader
+        {
+            uint64 sequence;       // Order in which the event was logged
+            uint64 firstSequence;  // Sequence number of the first event of the record's epoch
+            uint64 dataSize;       // Size of the event's tokens in bytes
+        };
+
+        // Tokens queued by a single thread, in increasing sequence order. The offsets only ever increase; they are
+        // wrapped into the ring when it is accessed.
+        struct ThreadTokenBuffer
+        {
+            ThreadTokenBuffer()
+                : pRing(nullptr)
+                , readOffset(0)
+                , writeOffset(0)
+                , pNext(nullptr)
+            {
+            }
+
+            DevDriver::Platform::Mutex mutex;        // Only contended while the rings are being drained
+            uint8*                     pRing;        // kThreadTokenRingSize bytes of TokenRecordHeader + token data
+            uint64                     readOffset;   // Offset of the next record to drain
+            uint64                     writeOffset;  // Offset at which the next record will be queued
+            ThreadTokenBuffer*         pNext;
+        };
+
+        // A record which did not fit into its thread's ring, followed by its token data.
+        struct OverflowRecord
+        {
+            TokenRecordHeader header;
+            OverflowRecord*   pNext;
+        };
+
+        ThreadTokenBuffer* GetThreadTokenBuffer();
+        bool QueueRecord(ThreadTokenBuffer* pBuffer, const TokenRecordHeader& header, const void* pTokenData);
+        void QueueOverflowRecord(const TokenRecordHeader& header, const void* pTokenData);
+        bool DrainThreadTokenBuffer(ThreadTokenBuffer* pBuffer);
+        bool DrainOverflowRecords();
+        void DrainThreadTokenBuffers();
+        void FlushThreadTokenBuffers();
+
+        static void DrainThreadFunc(void* pThreadParameter);
+        void StartDrainThread();
+        void StopDrainThread();
+
+        DevDriver::Result BeginStreaming();
+
+        // RmtWriter stream callback which writes the RMT data to m_streamFile.
+        static DevDriver::Result StreamWrite(void* pUserdata, const void* pData, size_t dataSize);
+
+        const PalPlatformSettings& m_settings;           // Read when profiling is enabled, so overrides apply
         DevDriver::Platform::Mutex m_mutex;
         DevDriver::RmtWriter       m_rmtWriter;
-        bool                       m_isMemoryProfilingEnabled;
+        volatile uint32            m_profilingEpoch;     // Read by logging threads without m_mutex
         bool                       m_isInitialized;
+
+        // Receives the RMT data if it is being streamed. The file size limit is zero if the size isn't limited.
+        Util::File                 m_streamFile;
+        char                       m_streamFilePath[MaxPathStrLen];
+        uint64                     m_streamFileSize;
+        uint64                     m_streamFileSizeLimit;
+        uint32                     m_streamCount;        // Number of streamed traces, used to name the files
+
+        // Merges the rings in the background while memory profiling is enabled.
+        DevDriver::Platform::Thread m_drainThread;
+        DevDriver::Platform::Event  m_drainRequested;
+        volatile bool               m_stopDrainThread;
+
+        DevDriver::AllocCb         m_allocCb;
+        Util::ThreadLocalKey       m_threadBufferKey;
+        bool                       m_threadBufferKeyValid;
+        ThreadTokenBuffer*         m_pThreadBuffers;     // Every thread's buffer, guarded by m_mutex
+
+        // The merge state of the current epoch, guarded by m_mutex.
+        OverflowRecord*            m_pOverflowRecords;
+        uint64                     m_nextSequence;       // Sequence number of the next record to drain
+        bool                       m_nextSequenceValid;  // False until the first record of the epoch is queued
+        bool                       m_isTruncated;        // A record was lost, later ones can never be drained
 };
 } // DevDriPal
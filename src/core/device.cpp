@@ -214,6 +214,7 @@ Device::Device(
     :
     m_pPlatform(pPlatform),
     m_memMgr(this),
+    m_pipelineUploadCache(this),
     m_connectedPrivateScreens(0),
     m_emulatedPrivateScreens(0),
     m_emulatedTargetId(UINT_MAX),
@@ -236,6 +237,7 @@ Device::Device(
     m_settingsMgr(SettingsFileName, pPlatform),
 #endif
     m_dmaUploadRingLock(),
+    m_dmaUploadRingSubmitted(),
     m_pDmaUploadRing(nullptr),
     m_referencedGpuMem(ReferencedMemoryMapElements, pPlatform),
     m_referencedGpuMemLock(),
@@ -417,6 +419,8 @@ Result Device::Cleanup()
         }
     }
 
+    m_pipelineUploadCache.Reset();
+
     // NOTE: Explicitly free all internal GPU memory. Any child object which needs to free GPU memory MUST be torn
     // down before this!
     m_memMgr.FreeAllocations();
@@ -452,6 +456,11 @@ Result Device::EarlyInit(
     // video memory!
     Result result = m_memMgr.Init();
 
+    if (result == Result::Success)
+    {
+        result = m_pipelineUploadCache.Init();
+    }
+
     if (result == Result::Success)
     {
         result = m_referencedGpuMemLock.Init();
@@ -489,6 +498,11 @@ Result Device::EarlyInit(
         result = m_dmaUploadRingLock.Init();
     }
 
+    if (result == Result::Success)
+    {
+        result = m_dmaUploadRingSubmitted.Init();
+    }
+
     return result;
 }
 
@@ -2370,8 +2384,8 @@ size_t Device::UploadUsingEmbeddedData(
 }
 
 // =====================================================================================================================
-// Submit command buffer at slotId to the DmaUploadRing's internal dma queue.
-// pCompletionFence is used to track when GPU finishes the work of this command buffer.
+// Finishes the upload recorded at slotId.  The DmaUploadRing may batch it with later uploads before submitting it to its
+// internal dma queue.  pCompletionFence is used to track when GPU finishes the upload.
 Result Device::SubmitDmaUploadRing(
     UploadRingSlot    slotId,
     UploadFenceToken* pCompletionFence,
@@ -2380,11 +2394,16 @@ Result Device::SubmitDmaUploadRing(
     Util::MutexAuto lock(&m_dmaUploadRingLock);
 
     PAL_ASSERT(m_pDmaUploadRing != nullptr);
-    return m_pDmaUploadRing->Submit(slotId, pCompletionFence, pagingFenceVal);
+    const Result result = m_pDmaUploadRing->Submit(slotId, pCompletionFence, pagingFenceVal);
+
+    // Wake any waiter which needs the batch this upload was recorded into.
+    m_dmaUploadRingSubmitted.WakeAll();
+
+    return result;
 }
 
 // =====================================================================================================================
-// pWaiter will wait until DmaUploadRing's internal dma queue's internal fence value reach fenceValue.
+// pWaiter will wait until the upload identified by fenceValue, and every upload before it, has finished.
 Result Device::WaitForPendingUpload(
     Pal::Queue*      pWaiter,
     UploadFenceToken fenceValue)
@@ -2392,7 +2411,39 @@ Result Device::WaitForPendingUpload(
     Util::MutexAuto lock(&m_dmaUploadRingLock);
 
     PAL_ASSERT(m_pDmaUploadRing != nullptr);
-    return m_pDmaUploadRing->WaitForPendingUpload(pWaiter, fenceValue);
+
+    uint64 timestamp = 0;
+    Result result    = m_pDmaUploadRing->ResolveUploadFence(fenceValue, &timestamp);
+
+    // One of the batches we need is still being recorded by another thread, which submits it once its upload is done.
+    while (result == Result::NotReady)
+    {
+        m_dmaUploadRingSubmitted.Wait(&m_dmaUploadRingLock, UINT32_MAX);
+        result = m_pDmaUploadRing->ResolveUploadFence(fenceValue, &timestamp);
+    }
+
+    if ((result == Result::Success) && (timestamp > 0))
+    {
+        result = m_pDmaUploadRing->WaitForPendingUpload(pWaiter, timestamp);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Submits the DmaUploadRing's open batch if it has outlived its time limit.  This is called on every client submission,
+// so it must not stall behind another thread which holds the ring; such a thread checks the time limit itself.
+Result Device::SubmitExpiredUploads()
+{
+    Result result = Result::Success;
+
+    if ((m_pDmaUploadRing != nullptr) && m_dmaUploadRingLock.TryLock())
+    {
+        result = m_pDmaUploadRing->SubmitExpiredBatch();
+        m_dmaUploadRingLock.Unlock();
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
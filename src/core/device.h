@@ -32,7 +32,9 @@
 #include "core/hw/ossip/ossDevice.h"
 #include "core/addrMgr/addrMgr.h"
 #include "core/dmaUploadRing.h"
+#include "core/pipelineUploadCache.h"
 #include "palCmdAllocator.h"
+#include "palConditionVariable.h"
 #include "palDevice.h"
 #include "palDeque.h"
 #include "palEvent.h"
@@ -1656,6 +1658,7 @@ public:
     SchedulerMode GetSchedulerMode() const { return m_hwsInfo.mode; }
 
     InternalMemMgr* MemMgr() { return &m_memMgr; }
+    PipelineUploadCache* GetPipelineUploadCache() { return &m_pipelineUploadCache; }
 
     // Returns the internal tracked command allocator except for engines that do not support tracking.
     CmdAllocator* InternalCmdAllocator(EngineType engineType) const
@@ -1783,6 +1786,12 @@ public:
     const bool IsUsingAutoPriorityForInternalAllocations() const
         { return m_memoryProperties.flags.autoPrioritySupport & m_finalizeInfo.flags.internalGpuMemAutoPriority; }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    bool InternStateObjects() const { return (m_finalizeInfo.flags.internStateObjects != 0); }
+#else
+    bool InternStateObjects() const { return false; }
+#endif
+
     const bool IsPreemptionSupported(EngineType engineType) const
         { return m_engineProperties.perEngine[engineType].flags.supportsMidCmdBufPreemption; }
 
@@ -1891,6 +1900,8 @@ public:
         Pal::Queue* pWaiter,
         UploadFenceToken fenceValue);
 
+    Result SubmitExpiredUploads();
+
     virtual bool IsHwEmulationEnabled() const { return false; }
 
 protected:
@@ -1990,8 +2001,9 @@ protected:
     uint32 GetDeviceIndex() const
         { return m_deviceIndex; }
 
-    Platform*      m_pPlatform;
-    InternalMemMgr m_memMgr;
+    Platform*           m_pPlatform;
+    InternalMemMgr      m_memMgr;
+    PipelineUploadCache m_pipelineUploadCache;
 
     // An array stores enumerated private screens info and only m_connectedPrivateScreens out of them are valid.
     PrivateScreenCreateInfo m_privateScreenInfo[MaxPrivateScreens];
@@ -2079,8 +2091,9 @@ protected:
     char m_cacheFilePath[MaxPathStrLen];
     char m_debugFilePath[MaxPathStrLen];
 
-    Util::Mutex m_dmaUploadRingLock;
-    DmaUploadRing* m_pDmaUploadRing;
+    Util::Mutex             m_dmaUploadRingLock;
+    Util::ConditionVariable m_dmaUploadRingSubmitted; // Signaled whenever an upload is finished.
+    DmaUploadRing*          m_pDmaUploadRing;
 
 private:
     Result HwlEarlyInit();
@@ -97,6 +97,11 @@ Result DmaCmdBuffer::Init(
         result = m_cmdStream.Init();
     }
 
+    if (result == Result::Success)
+    {
+        m_cmdStream.EnableChunkRetention(RetainsChunksOnReset());
+    }
+
     return result;
 }
 
@@ -40,6 +40,8 @@ namespace Pal
 constexpr EngineType UploadEngine = EngineTypeDma;
 constexpr QueueType  UploadQueue  = QueueTypeDma;
 
+constexpr UploadRingSlot InvalidBatchSlot = UINT32_MAX;
+
 // =====================================================================================================================
 DmaUploadRing::DmaUploadRing(
     Device* pDevice)
@@ -50,7 +52,9 @@ DmaUploadRing::DmaUploadRing(
     m_ringCapacity(RingInitEntries),
     m_firstEntryInUse(0),
     m_firstEntryFree(0),
-    m_numEntriesInUse(0)
+    m_numEntriesInUse(0),
+    m_batchSlot(InvalidBatchSlot),
+    m_lastToken(0)
 {
 
 }
@@ -167,12 +171,39 @@ Result DmaUploadRing::FreeFinishedSlots()
 Result DmaUploadRing::AcquireRingSlot(
     UploadRingSlot* pSlotId)
 {
-    Result result = FreeFinishedSlots();
-    PAL_ASSERT(result == Result::Success);
+    Result result      = Result::Success;
+    bool   joinedBatch = false;
 
-    if (result == Result::Success)
+    if (m_batchSlot != InvalidBatchSlot)
     {
-        if (m_numEntriesInUse >= m_ringCapacity)
+        Entry*const pBatch = &m_pRing[m_batchSlot];
+
+        if (pBatch->uploadActive == false)
+        {
+            if (IsBatchFull(*pBatch))
+            {
+                result = SubmitSlot(m_batchSlot);
+            }
+            else
+            {
+                // Record this upload into the open batch.
+                pBatch->uploadActive = true;
+                pBatch->numUploads++;
+
+                (*pSlotId)  = m_batchSlot;
+                joinedBatch = true;
+            }
+        }
+    }
+
+    // Either there is no open batch, or another thread is still recording into it.  In the latter case this upload
+    // gets a slot of its own which is submitted as soon as the upload is done.
+    if ((result == Result::Success) && (joinedBatch == false))
+    {
+        result = FreeFinishedSlots();
+        PAL_ASSERT(result == Result::Success);
+
+        if ((result == Result::Success) && (m_numEntriesInUse >= m_ringCapacity))
         {
             result = ResizeRing();
         }
@@ -189,7 +220,7 @@ Result DmaUploadRing::AcquireRingSlot(
         }
     }
 
-    if ((result == Result::Success) &&
+    if ((result == Result::Success) && (joinedBatch == false) &&
         ((m_pRing[m_firstEntryFree].pCmdBuf == nullptr) ||
         (m_pRing[m_firstEntryFree].pFence == nullptr)))
     {
@@ -197,7 +228,7 @@ Result DmaUploadRing::AcquireRingSlot(
         result = InitRingItem(m_firstEntryFree);
     }
 
-    if (result == Result::Success)
+    if ((result == Result::Success) && (joinedBatch == false))
     {
         CmdBufferBuildFlags flags     = { };
         flags.optimizeExclusiveSubmit = true;
@@ -209,8 +240,24 @@ Result DmaUploadRing::AcquireRingSlot(
         PAL_ASSERT(result == Result::Success);
     }
 
-    if (result == Result::Success)
+    if ((result == Result::Success) && (joinedBatch == false))
     {
+        Entry*const pEntry = &m_pRing[m_firstEntryFree];
+
+        pEntry->token           = ++m_lastToken;
+        pEntry->timestamp       = 0;
+        pEntry->pagingFenceVal  = 0;
+        pEntry->firstUploadTime = Util::GetPerfCpuTime();
+        pEntry->numBytes        = 0;
+        pEntry->numUploads      = 1;
+        pEntry->uploadActive    = true;
+        pEntry->flushRequested  = false;
+
+        if (m_batchSlot == InvalidBatchSlot)
+        {
+            m_batchSlot = m_firstEntryFree;
+        }
+
         (*pSlotId) = m_firstEntryFree;
         m_firstEntryFree = (m_firstEntryFree + 1) % m_ringCapacity;
         m_numEntriesInUse++;
@@ -248,44 +295,158 @@ size_t DmaUploadRing::UploadUsingEmbeddedData(
     copyRegion.srcOffset        = gpuMemOffset;
 
     m_pRing[slotId].pCmdBuf->CmdCopyMemory(*pGpuMem, *pDst, 1, &copyRegion);
+    m_pRing[slotId].numBytes += allocSize;
 
     return allocSize;
 }
 
 // =====================================================================================================================
+// Returns true if no more uploads should be recorded into the given entry.
+bool DmaUploadRing::IsBatchFull(
+    const Entry& entry
+    ) const
+{
+    const int64 elapsedTicks  = (Util::GetPerfCpuTime() - entry.firstUploadTime);
+    const int64 maxBatchTicks = ((Util::GetPerfFrequency() * MaxBatchedUploadTimeInMs) / 1000);
+
+    return ((entry.numUploads >= MaxBatchedUploads)     ||
+            (entry.numBytes   >= MaxBatchedUploadBytes) ||
+            (elapsedTicks     >= maxBatchTicks));
+}
+
+// =====================================================================================================================
+// Finishes the upload which acquired the given slot.  The slot is submitted right away if it isn't the open batch, if
+// the batch is full, or if a queue is already waiting for it; otherwise later uploads are batched into it.  Either way,
+// the token to wait on for this upload is returned through pCompletionFence.
 Result DmaUploadRing::Submit(
     UploadRingSlot    slotId,
     UploadFenceToken* pCompletionFence,
     uint64            pagingFenceVal)
 {
-    Result result = m_pRing[slotId].pCmdBuf->End();
+    Entry*const pEntry = &m_pRing[slotId];
+    PAL_ASSERT(pEntry->uploadActive && (pEntry->timestamp == 0));
+
+    pEntry->uploadActive   = false;
+    pEntry->pagingFenceVal = Util::Max(pEntry->pagingFenceVal, pagingFenceVal);
+
+    *pCompletionFence = pEntry->token;
+    PAL_ASSERT(*pCompletionFence > 0);
+
+    Result result = Result::Success;
+
+    if ((slotId != m_batchSlot) || pEntry->flushRequested || IsBatchFull(*pEntry))
+    {
+        result = SubmitSlot(slotId);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Submits the uploads recorded into the given slot to the DMA queue.
+Result DmaUploadRing::SubmitSlot(
+    UploadRingSlot slotId)
+{
+    Entry*const pEntry = &m_pRing[slotId];
+    PAL_ASSERT((pEntry->uploadActive == false) && (pEntry->timestamp == 0));
+
+    if (slotId == m_batchSlot)
+    {
+        m_batchSlot = InvalidBatchSlot;
+    }
+
+    pEntry->flushRequested = false;
+
+    Result result = pEntry->pCmdBuf->End();
     if(result == Result::Success)
     {
-        static_cast<CmdBuffer*>(m_pRing[slotId].pCmdBuf)->UpdateLastPagingFence(pagingFenceVal);
+        static_cast<CmdBuffer*>(pEntry->pCmdBuf)->UpdateLastPagingFence(pEntry->pagingFenceVal);
 
         PerSubQueueSubmitInfo perSubQueueInfo = {};
         perSubQueueInfo.cmdBufferCount        = 1;
-        perSubQueueInfo.ppCmdBuffers          = &m_pRing[slotId].pCmdBuf;
+        perSubQueueInfo.ppCmdBuffers          = &pEntry->pCmdBuf;
 
         MultiSubmitInfo submitInfo      = {};
         submitInfo.perSubQueueInfoCount = 1;
         submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
         submitInfo.fenceCount = 1;
-        submitInfo.ppFences   = &m_pRing[slotId].pFence;
+        submitInfo.ppFences   = &pEntry->pFence;
 #else
-        submitInfo.pFence = m_pRing[slotId].pFence;
+        submitInfo.pFence = pEntry->pFence;
 #endif
 
         result = m_pDmaQueue->SubmitInternal(submitInfo, false);
-        *pCompletionFence = m_pDmaQueue->GetSubmissionContext()->LastTimestamp();
-        PAL_ASSERT(*pCompletionFence > 0);
+        pEntry->timestamp = m_pDmaQueue->GetSubmissionContext()->LastTimestamp();
+        PAL_ASSERT(pEntry->timestamp > 0);
         PAL_ASSERT(result == Result::Success);
     }
 
     return result;
 }
 
+// =====================================================================================================================
+Result DmaUploadRing::ResolveUploadFence(
+    UploadFenceToken fenceToken,
+    uint64*          pTimestamp)
+{
+    Result result = Result::Success;
+    uint64 timestamp = 0;
+
+    // Tokens are handed out in acquisition order, but batches can be submitted out of that order, so every batch with
+    // an older token must be submitted too.  Entries which have already been freed are known to be complete.
+    for (uint32 i = 0; (i < m_numEntriesInUse) && ((result == Result::Success) || (result == Result::NotReady)); i++)
+    {
+        const UploadRingSlot slotId = (m_firstEntryInUse + i) % m_ringCapacity;
+        Entry*const          pEntry = &m_pRing[slotId];
+
+        if (pEntry->token <= fenceToken)
+        {
+            if (pEntry->timestamp == 0)
+            {
+                if (pEntry->uploadActive)
+                {
+                    pEntry->flushRequested = true;
+                    result                 = Result::NotReady;
+                }
+                else
+                {
+                    const Result submitResult = SubmitSlot(slotId);
+                    if (submitResult != Result::Success)
+                    {
+                        result = submitResult;
+                    }
+                }
+            }
+
+            timestamp = Util::Max(timestamp, pEntry->timestamp);
+        }
+    }
+
+    *pTimestamp = timestamp;
+
+    return result;
+}
+
+// =====================================================================================================================
+Result DmaUploadRing::SubmitExpiredBatch()
+{
+    Result result = Result::Success;
+
+    if (m_batchSlot != InvalidBatchSlot)
+    {
+        const Entry& batch = m_pRing[m_batchSlot];
+
+        // A batch which is still being recorded into is submitted by the Submit() call which finishes that upload.
+        if ((batch.uploadActive == false) && IsBatchFull(batch))
+        {
+            result = SubmitSlot(m_batchSlot);
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Creates internal fence for tracking previous submission on the internal dma upload queue.
 Result DmaUploadRing::CreateInternalFence(
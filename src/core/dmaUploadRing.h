@@ -47,6 +47,12 @@ typedef uint32 UploadRingSlot;
 
 constexpr uint32 RingInitEntries = 512;  ///< Max number of entries in DmaUploadRing.
 
+// Consecutive uploads are recorded into one command buffer and submitted together.  A batch is submitted once it
+// reaches one of these limits, or as soon as a queue needs to wait for one of its uploads.
+constexpr uint32 MaxBatchedUploads        = 64;           ///< Number of uploads in a batch.
+constexpr size_t MaxBatchedUploadBytes    = 1024 * 1024;  ///< Combined size of the uploads in a batch, in bytes.
+constexpr uint32 MaxBatchedUploadTimeInMs = 4;            ///< Time since a batch's first upload was recorded.
+
 // =====================================================================================================================
 class DmaUploadRing
 {
@@ -60,9 +66,21 @@ public:
         UploadFenceToken* pCompletionFence,
         uint64            pagingFenceVal);
 
+    // Submits every batch up to and including the one identified by the given token, and returns the DMA queue
+    // timestamp to wait on for its completion (or zero if it has completed already).  Returns NotReady if one of those
+    // batches is still being recorded by another thread; it will be submitted as soon as that thread calls Submit().
+    Result ResolveUploadFence(
+        UploadFenceToken fenceToken,
+        uint64*          pTimestamp);
+
+    // Submits the open batch if it has been collecting uploads for longer than MaxBatchedUploadTimeInMs.  Without this,
+    // a batch which no later upload joins would wait for the first queue which needs it.
+    Result SubmitExpiredBatch();
+
+    // Waits for the DMA queue to reach the given timestamp.
     virtual Result WaitForPendingUpload(
-        Pal::Queue*      pWaiter,
-        UploadFenceToken fenceValue) = 0;
+        Pal::Queue* pWaiter,
+        uint64      timestamp) = 0;
 
     // Records DMA upload commands from embedded data to the destination.  Will only copy
     // up to the embedded data limit. Actual bytes copied are returned.  Caller must
@@ -82,8 +100,16 @@ protected:
 private:
     struct Entry
     {
-        ICmdBuffer* pCmdBuf;
-        IFence*     pFence;
+        ICmdBuffer*       pCmdBuf;
+        IFence*           pFence;
+        UploadFenceToken  token;             // Token handed out to each upload recorded into this entry.
+        uint64            timestamp;         // DMA queue timestamp of this entry's submission; zero until submitted.
+        uint64            pagingFenceVal;    // Largest paging fence value of the uploads recorded into this entry.
+        int64             firstUploadTime;   // CPU time at which the first upload was recorded into this entry.
+        size_t            numBytes;          // Combined size of the uploads recorded into this entry.
+        uint32            numUploads;        // Number of uploads recorded into this entry.
+        bool              uploadActive;      // True while an upload between AcquireRingSlot and Submit uses this entry.
+        bool              flushRequested;    // True if this entry must be submitted once its active upload is done.
     };
     // Initialize each item of the ring from m_firstEntryFree to the end of the ring.
     Result InitRingItem(uint32 slotIdx);
@@ -92,12 +118,17 @@ private:
     Result CreateInternalFence(IFence** ppFence);
     Result ResizeRing();
     Result FreeFinishedSlots();
+    Result SubmitSlot(UploadRingSlot slotId);
+    bool IsBatchFull(const Entry& entry) const;
 
     Entry* m_pRing;
     uint32 m_ringCapacity;
     uint32 m_firstEntryInUse;
     uint32 m_firstEntryFree;
     uint32 m_numEntriesInUse;
+
+    UploadRingSlot    m_batchSlot;   // Slot which further uploads are batched into, or InvalidBatchSlot if none.
+    UploadFenceToken  m_lastToken;   // Token of the most recently acquired slot.
 };
 
 }
@@ -70,8 +70,12 @@ EventProvider::EventProvider(Platform* pPlatform)
             kEventFlushTimeoutInMs
         ),
         m_pPlatform(pPlatform),
-        m_eventService({ pPlatform, DevDriverAlloc, DevDriverFree }),
-        m_eventTimer()
+        m_eventService(*pPlatform->PlatformSettingsPtr(), { pPlatform, DevDriverAlloc, DevDriverFree }),
+        m_eventTimer(),
+        m_tokenAllocCb({ pPlatform, DevDriverAlloc, DevDriverFree }),
+        m_tokenSequence(0),
+        m_tokenEpoch(0),
+        m_tokenEpochFirstSequence(0)
         {}
 
 // =====================================================================================================================
@@ -392,21 +396,47 @@ void EventProvider::LogEvent(
     if (ShouldLog(eventId))
     {
         // The RMT format requires that certain tokens strictly follow each other (e.g. resource create + description),
-        // so we need to lock to ensure another event isn't inserted into the stream while writing dependent tokens.
-        DevDriver::Platform::LockGuard<DevDriver::Platform::Mutex> providerLock(m_providerLock);
+        // and timestamp deltas only make sense in the order they were taken. The event service receives each event's
+        // tokens as one batch tagged with a sequence number, so it only needs the lock while we take the timestamp.
+        // The event protocol writes tokens one at a time, so when it is listening we hold the lock for the whole event.
+        RmtTokenBatch batch(m_tokenAllocCb);
+
+        m_providerLock.Lock();
+
+        batch.writeEvents = (QueryEventWriteStatus(static_cast<uint32>(PalEvent::RmtToken)) ==
+                             DevDriver::Result::Success);
+
+        // Sample this under the lock along with the sequence number, so the events which memory profiling picks up
+        // have contiguous sequence numbers.
+        const uint32 profilingEpoch = m_eventService.GetProfilingEpoch();
+        batch.queueTokens = EventService::IsProfilingEpoch(profilingEpoch);
 
         const EventTimestamp timestamp = m_eventTimer.CreateTimestamp();
+        const uint64         sequence  = m_tokenSequence++;
         uint8 delta = 0;
 
+        if (batch.queueTokens && (profilingEpoch != m_tokenEpoch))
+        {
+            m_tokenEpoch              = profilingEpoch;
+            m_tokenEpochFirstSequence = sequence;
+        }
+
+        const uint64 epochFirstSequence = m_tokenEpochFirstSequence;
+
+        if (batch.writeEvents == false)
+        {
+            m_providerLock.Unlock();
+        }
+
         if (timestamp.type == EventTimestampType::Full)
         {
             RMT_MSG_TIMESTAMP tsToken(timestamp.full.timestamp, timestamp.full.frequency);
-            WriteTokenData(tsToken);
+            WriteTokenData(&batch, tsToken);
         }
         else if (timestamp.type == EventTimestampType::LargeDelta)
         {
             RMT_MSG_TIME_DELTA tdToken(timestamp.largeDelta.delta, timestamp.largeDelta.numBytes);
-            WriteTokenData(tdToken);
+            WriteTokenData(&batch, tdToken);
         }
         else
         {
@@ -444,7 +474,7 @@ void EventProvider::LogEvent(
                     RMT_HEAP_TYPE_LOCAL,
                     RMT_HEAP_TYPE_LOCAL);
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
 
                 break;
             }
@@ -456,13 +486,13 @@ void EventProvider::LogEvent(
 
                 RMT_MSG_FREE_VIRTUAL eventToken(delta, pData->gpuVirtualAddr);
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
 
                 break;
             }
             case PalEvent::GpuMemoryResourceCreate:
             {
-                LogResourceCreateEvent(delta, pEventData, eventDataSize);
+                LogResourceCreateEvent(&batch, delta, pEventData, eventDataSize);
                 break;
             }
             case PalEvent::GpuMemoryResourceDestroy:
@@ -472,7 +502,7 @@ void EventProvider::LogEvent(
 
                 RMT_MSG_RESOURCE_DESTROY eventToken(delta, static_cast<uint32>(pData->handle));
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
 
                 break;
             }
@@ -483,7 +513,7 @@ void EventProvider::LogEvent(
 
                 RMT_MSG_MISC eventToken(delta, PalToRmtMiscEventType(pData->type));
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
             case PalEvent::GpuMemorySnapshot:
@@ -496,7 +526,7 @@ void EventProvider::LogEvent(
                     RMT_USERDATA_EVENT_TYPE_SNAPSHOT,
                     pData->pSnapshotName);
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
             case PalEvent::DebugName:
@@ -509,7 +539,7 @@ void EventProvider::LogEvent(
                     pData->pDebugName,
                     static_cast<uint32>(pData->handle));
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
             case PalEvent::GpuMemoryResourceBind:
@@ -525,7 +555,7 @@ void EventProvider::LogEvent(
                     static_cast<uint32>(pData->resourceHandle),
                     pData->isSystemMemory);
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
 
                 GpuMemory* pGpuMemory = reinterpret_cast<GpuMemory*>(pData->handle);
                 if (pGpuMemory != nullptr)
@@ -545,7 +575,7 @@ void EventProvider::LogEvent(
 
                 RMT_MSG_CPU_MAP eventToken(delta, pData->gpuVirtualAddr, false);
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
             case PalEvent::GpuMemoryCpuUnmap:
@@ -555,7 +585,7 @@ void EventProvider::LogEvent(
 
                 RMT_MSG_CPU_MAP eventToken(delta, pData->gpuVirtualAddr, true);
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
             case PalEvent::GpuMemoryAddReference:
@@ -569,7 +599,7 @@ void EventProvider::LogEvent(
                     pData->gpuVirtualAddr,
                     static_cast<uint8>(pData->queueHandle));
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
             case PalEvent::GpuMemoryRemoveReference:
@@ -583,18 +613,33 @@ void EventProvider::LogEvent(
                     pData->gpuVirtualAddr,
                     static_cast<uint8>(pData->queueHandle));
 
-                WriteTokenData(eventToken);
+                WriteTokenData(&batch, eventToken);
                 break;
             }
         }
+
+        if (batch.writeEvents)
+        {
+            m_providerLock.Unlock();
+        }
+
+        if (batch.queueTokens)
+        {
+            m_eventService.WriteTokenData(profilingEpoch,
+                                          epochFirstSequence,
+                                          sequence,
+                                          batch.data.Data(),
+                                          batch.data.Size());
+        }
     }
 }
 
 // =====================================================================================================================
 void EventProvider::LogResourceCreateEvent(
-    uint8       delta,
-    const void* pEventData,
-    size_t      eventDataSize)
+    RmtTokenBatch* pBatch,
+    uint8          delta,
+    const void*    pEventData,
+    size_t         eventDataSize)
 {
     PAL_ASSERT(eventDataSize == sizeof(GpuMemoryResourceCreateData));
     const auto* pRsrcCreateData = reinterpret_cast<const GpuMemoryResourceCreateData*>(pEventData);
@@ -606,7 +651,7 @@ void EventProvider::LogResourceCreateEvent(
         0,
         RMT_COMMIT_TYPE_COMMITTED,
         PalToRmtResourceType(pRsrcCreateData->type));
-    WriteTokenData(rsrcCreateToken);
+    WriteTokenData(pBatch, rsrcCreateToken);
 
     switch (pRsrcCreateData->type)
     {
@@ -643,7 +688,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_IMAGE_TOKEN imgDesc(imgCreateInfo);
 
-        WriteTokenData(imgDesc);
+        WriteTokenData(pBatch, imgDesc);
         break;
     }
 
@@ -658,7 +703,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint16>(pBufferData->usageFlags),
             pBufferData->size);
 
-        WriteTokenData(bufferDesc);
+        WriteTokenData(pBatch, bufferDesc);
         break;
     }
 
@@ -690,7 +735,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_PIPELINE_TOKEN pipelineDesc(flags, hash, stages, false);
 
-        WriteTokenData(pipelineDesc);
+        WriteTokenData(pBatch, pipelineDesc);
         break;
     }
 
@@ -741,7 +786,7 @@ void EventProvider::LogResourceCreateEvent(
             RMT_PAGE_SIZE_4KB,  //< @TODO - we don't currently have this info, so just set to 4KB
             static_cast<uint8>(pHeapData->preferredGpuHeap));
 
-        WriteTokenData(heapDesc);
+        WriteTokenData(pBatch, heapDesc);
         break;
     }
 
@@ -753,7 +798,7 @@ void EventProvider::LogResourceCreateEvent(
         const bool isGpuOnly = (pGpuEventData->pCreateInfo->flags.gpuAccessOnly == 1);
         RMT_RESOURCE_TYPE_GPU_EVENT_TOKEN gpuEventDesc(isGpuOnly);
 
-        WriteTokenData(gpuEventDesc);
+        WriteTokenData(pBatch, gpuEventDesc);
         break;
     }
 
@@ -764,7 +809,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_BORDER_COLOR_PALETTE_TOKEN bcpDesc(static_cast<uint8>(pBcpData->pCreateInfo->paletteSize));
 
-        WriteTokenData(bcpDesc);
+        WriteTokenData(pBatch, bcpDesc);
         break;
     }
 
@@ -779,7 +824,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint32>(pPerfExperimentData->sqttSize),
             static_cast<uint32>(pPerfExperimentData->perfCounterSize));
 
-        WriteTokenData(perfExperimentDesc);
+        WriteTokenData(pBatch, perfExperimentDesc);
         break;
     }
 
@@ -792,7 +837,7 @@ void EventProvider::LogResourceCreateEvent(
             PalToRmtQueryHeapType(pQueryPoolData->pCreateInfo->queryPoolType),
             (pQueryPoolData->pCreateInfo->flags.enableCpuAccess == 1));
 
-        WriteTokenData(queryHeapDesc);
+        WriteTokenData(pBatch, queryHeapDesc);
         break;
     }
 
@@ -818,7 +863,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint8>(pDescriptorHeapData->nodeMask),
             static_cast<uint16>(pDescriptorHeapData->numDescriptors));
 
-        WriteTokenData(descriptorHeapDesc);
+        WriteTokenData(pBatch, descriptorHeapDesc);
         break;
     }
 
@@ -832,7 +877,7 @@ void EventProvider::LogResourceCreateEvent(
             static_cast<uint16>(pDescriptorPoolData->maxSets),
             static_cast<uint8>(pDescriptorPoolData->numPoolSize));
 
-        WriteTokenData(poolSizeDesc);
+        WriteTokenData(pBatch, poolSizeDesc);
 
         // Then loop through writing RMT_POOL_SIZE_DESCs
         for (uint32 i = 0; i < pDescriptorPoolData->numPoolSize; ++i)
@@ -841,7 +886,7 @@ void EventProvider::LogResourceCreateEvent(
                 PalToRmtDescriptorType(pDescriptorPoolData->pPoolSizes[i].type),
                 static_cast<uint16>(pDescriptorPoolData->pPoolSizes[i].numDescriptors));
 
-            WriteTokenData(poolSize);
+            WriteTokenData(pBatch, poolSize);
         }
         break;
     }
@@ -864,7 +909,7 @@ void EventProvider::LogResourceCreateEvent(
             pCmdAllocatorData->pCreateInfo->allocInfo[CmdAllocType::GpuScratchMemAlloc].allocSize,
             pCmdAllocatorData->pCreateInfo->allocInfo[CmdAllocType::GpuScratchMemAlloc].suballocSize);
 
-        WriteTokenData(cmdAllocatorDesc);
+        WriteTokenData(pBatch, cmdAllocatorDesc);
         break;
     }
 
@@ -876,7 +921,7 @@ void EventProvider::LogResourceCreateEvent(
 
         RMT_RESOURCE_TYPE_MISC_INTERNAL_TOKEN miscInternalDesc(PalToRmtMiscInternalType(pMiscInternalData->type));
 
-        WriteTokenData(miscInternalDesc);
+        WriteTokenData(pBatch, miscInternalDesc);
         break;
     }
 
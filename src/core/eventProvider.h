@@ -38,6 +38,7 @@
 #include "protocols/ddEventProvider.h"
 
 #include "util/ddEventTimer.h"
+#include "util/vector.h"
 
 namespace Pal
 {
@@ -64,6 +65,10 @@ public:
         return (IsProviderEnabled() || m_eventService.IsMemoryProfilingEnabled());
     }
 
+    // The memory profiling service is normally driven over the developer driver connection; tools may drive it
+    // directly through HandleRequest().
+    EventService* GetEventService() { return &m_eventService; }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Event Log Functions
     // These functions will result in an event being sent through the DevDriver EventProtocol or to the event log file
@@ -118,27 +123,50 @@ public:
 private:
     bool ShouldLog(PalEvent eventId) const;
 
+    // Collects the RMT tokens of a single PalEvent so they can be handed to the event service in one piece.
+    struct RmtTokenBatch
+    {
+        explicit RmtTokenBatch(const DevDriver::AllocCb& allocCb)
+            : data(allocCb), writeEvents(false), queueTokens(false) {}
+
+        DevDriver::Vector<uint8, 256> data;
+        bool                          writeEvents; // Also send each token over the event protocol as it is built.
+        bool                          queueTokens; // Queue the tokens with the event service for memory profiling.
+    };
+
     // Logs a PalEvent by translating it into one or more RMT Tokens and passing it into WriteTokenData
     void LogEvent(PalEvent eventId, const void* pEventData, size_t eventDataSize);
 
     // Hepler method for LogEvent
-    void LogResourceCreateEvent(uint8 delta, const void* pEventData, size_t eventDataSize);
+    void LogResourceCreateEvent(RmtTokenBatch* pBatch, uint8 delta, const void* pEventData, size_t eventDataSize);
 
-    // Write an RMT token to both the service and event protocol
-    void WriteTokenData(const DevDriver::RMT_TOKEN_DATA& token)
+    // Write an RMT token to the event protocol (if requested) and queue it for the service
+    void WriteTokenData(RmtTokenBatch* pBatch, const DevDriver::RMT_TOKEN_DATA& token)
     {
-        WriteEvent(
-            static_cast<uint32>(PalEvent::RmtToken),
-            token.Data(),
-            token.Size()
-        );
-        m_eventService.WriteTokenData(token);
+        if (pBatch->writeEvents)
+        {
+            WriteEvent(
+                static_cast<uint32>(PalEvent::RmtToken),
+                token.Data(),
+                token.Size()
+            );
+        }
+        if (pBatch->queueTokens)
+        {
+            pBatch->data.Append(static_cast<const uint8*>(token.Data()), token.Size());
+        }
     }
 
     Platform*                  m_pPlatform;
     EventService               m_eventService;
     DevDriver::EventTimer      m_eventTimer;
     DevDriver::Platform::Mutex m_providerLock;
+    DevDriver::AllocCb         m_tokenAllocCb;
+    uint64                     m_tokenSequence; // Orders the events' tokens when the service merges its buffers.
+
+    // The last profiling epoch which an event was queued in and the sequence number of its first event.
+    uint32                     m_tokenEpoch;
+    uint64                     m_tokenEpochFirstSequence;
 
     PAL_DISALLOW_COPY_AND_ASSIGN(EventProvider);
 };
@@ -81,6 +81,15 @@ void PlatformSettingsLoader::SetupDefaults()
 #endif
     memset(m_settings.eventLogFilename, 0, 512);
     strncpy(m_settings.eventLogFilename, "PalEventLog.json", 512);
+#if   (__unix__)
+    memset(m_settings.rmtTraceDirectory, 0, 512);
+    strncpy(m_settings.rmtTraceDirectory, "amdpal/", 512);
+#else
+    memset(m_settings.rmtTraceDirectory, 0, 512);
+    strncpy(m_settings.rmtTraceDirectory, "amdpal/", 512);
+#endif
+    m_settings.rmtTraceMaxFileSizeInMb = 4096;
+    m_settings.rmtTraceStreamBufferSizeInKb = 1024;
 
     m_settings.debugOverlayEnabled = false;
     m_settings.debugOverlayConfig.visualConfirmEnabled = true;
@@ -271,6 +280,22 @@ void PlatformSettingsLoader::ReadSettings(Pal::Device* pDevice)
                            &m_settings.enableEventLogFile,
                            InternalSettingScope::PrivatePalKey);
 
+    pDevice->ReadSetting(pRmtTraceDirectoryStr,
+                           Util::ValueType::Str,
+                           &m_settings.rmtTraceDirectory,
+                           InternalSettingScope::PrivatePalKey,
+                           512);
+
+    pDevice->ReadSetting(pRmtTraceMaxFileSizeInMbStr,
+                           Util::ValueType::Uint,
+                           &m_settings.rmtTraceMaxFileSizeInMb,
+                           InternalSettingScope::PrivatePalKey);
+
+    pDevice->ReadSetting(pRmtTraceStreamBufferSizeInKbStr,
+                           Util::ValueType::Uint,
+                           &m_settings.rmtTraceStreamBufferSizeInKb,
+                           InternalSettingScope::PrivatePalKey);
+
     pDevice->ReadSetting(pDebugOverlayEnabledStr,
                            Util::ValueType::Boolean,
                            &m_settings.debugOverlayEnabled,
@@ -758,6 +783,21 @@ void PlatformSettingsLoader::InitSettingsInfo()
     info.valueSize = sizeof(m_settings.eventLogFilename);
     m_settingsInfoMap.Insert(3387502554, info);
 
+    info.type      = SettingType::String;
+    info.pValuePtr = &m_settings.rmtTraceDirectory;
+    info.valueSize = sizeof(m_settings.rmtTraceDirectory);
+    m_settingsInfoMap.Insert(504837576, info);
+
+    info.type      = SettingType::Uint;
+    info.pValuePtr = &m_settings.rmtTraceMaxFileSizeInMb;
+    info.valueSize = sizeof(m_settings.rmtTraceMaxFileSizeInMb);
+    m_settingsInfoMap.Insert(843790490, info);
+
+    info.type      = SettingType::Uint;
+    info.pValuePtr = &m_settings.rmtTraceStreamBufferSizeInKb;
+    info.valueSize = sizeof(m_settings.rmtTraceStreamBufferSizeInKb);
+    m_settingsInfoMap.Insert(2189355608, info);
+
     info.type      = SettingType::Boolean;
     info.pValuePtr = &m_settings.debugOverlayEnabled;
     info.valueSize = sizeof(m_settings.debugOverlayEnabled);
@@ -115,6 +115,9 @@ struct PalPlatformSettings : public Pal::DriverSettings
     bool                                        enableEventLogFile;
     char                                        eventLogDirectory[MaxPathStrLen];
     char                                        eventLogFilename[MaxPathStrLen];
+    char                                        rmtTraceDirectory[MaxPathStrLen];
+    uint32                                      rmtTraceMaxFileSizeInMb;
+    uint32                                      rmtTraceStreamBufferSizeInKb;
 
     bool                                        debugOverlayEnabled;
     struct {
@@ -251,6 +254,9 @@ static const char* pAlertsEnabledStr = "#3333004859";
 #endif
 
 static const char* pEnableEventLogFileStr = "#3288205286";
+static const char* pRmtTraceDirectoryStr = "#504837576";
+static const char* pRmtTraceMaxFileSizeInMbStr = "#843790490";
+static const char* pRmtTraceStreamBufferSizeInKbStr = "#2189355608";
 
 static const char* pDebugOverlayEnabledStr = "#3362163801";
 static const char* pDebugOverlayConfig_VisualConfirmEnabledStr = "#1802476957";
@@ -367,6 +373,9 @@ static const SettingNameHash g_palPlatformSettingHashList[] = {
 3288205286,
 3789517094,
 3387502554,
+504837576,
+843790490,
+2189355608,
 
 3362163801,
 1802476957,
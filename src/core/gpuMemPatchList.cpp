@@ -25,6 +25,7 @@
 
 #include "core/device.h"
 #include "core/gpuMemPatchList.h"
+#include "palFlatHashMapImpl.h"
 #include "palVectorImpl.h"
 
 using namespace Util;
@@ -32,13 +33,21 @@ using namespace Util;
 namespace Pal
 {
 
+// Reference lists up to this long (including the null reference) are scanned linearly rather than through the hashed
+// index, which isn't worth building for the handful of references most command streams have.
+constexpr uint32 MaxLinearScanRefs = 16;
+
+// Initial number of entries in the hashed reference index.
+constexpr uint32 MemoryRefIndexMapEntries = 64;
+
 // =====================================================================================================================
 GpuMemoryPatchList::GpuMemoryPatchList(
     Device* pDevice)
     :
     m_pDevice(pDevice),
     m_gpuMemoryRefs(pDevice->GetPlatform()),
-    m_patchEntries(pDevice->GetPlatform())
+    m_patchEntries(pDevice->GetPlatform()),
+    m_memoryRefIndexMap(MemoryRefIndexMapEntries, pDevice->GetPlatform())
 {
 }
 
@@ -52,6 +61,7 @@ void GpuMemoryPatchList::Reset()
 {
     m_gpuMemoryRefs.Clear();
     m_patchEntries.Clear();
+    m_memoryRefIndexMap.Reset();
 
     constexpr GpuMemoryRef NullMemoryRef = { };
     Result result = m_gpuMemoryRefs.PushBack(NullMemoryRef);
@@ -166,31 +176,86 @@ Result GpuMemoryPatchList::FindGpuMemoryRefIndex(
 
     Result result = Result::Success;
 
-    // Note: Right now we're just doing a linear scan of the reference list to find the memory object's location. This
-    // isn't the most efficient choice, but since the command buffers which use patch lists tend to have only a few
-    // entries. For tiny patch/reference lists the linear scan isn't expected to be a problem.
-    for ((*pIndex) = 1; (*pIndex) < m_gpuMemoryRefs.NumElements(); ++(*pIndex))
+    const uint32 numRefs = m_gpuMemoryRefs.NumElements();
+
+    (*pIndex) = numRefs;
+
+    if (numRefs <= MaxLinearScanRefs)
+    {
+        // Most command streams which use patch lists only reference a few allocations, so a linear scan is cheapest.
+        for (uint32 idx = 1; idx < numRefs; ++idx)
+        {
+            if (m_gpuMemoryRefs.At(idx).pGpuMemory == pGpuMem)
+            {
+                (*pIndex) = idx;
+                break;
+            }
+        }
+    }
+    else
     {
-        auto*const pMemRef = &m_gpuMemoryRefs.At(*pIndex);
+        if (m_memoryRefIndexMap.GetNumEntries() == 0)
+        {
+            // The list just outgrew the linear scan: index every reference it has so far.
+            result = m_memoryRefIndexMap.Reserve(numRefs * 2);
+
+            for (uint32 idx = 1; (idx < numRefs) && (result == Result::Success); ++idx)
+            {
+                result = m_memoryRefIndexMap.Insert(static_cast<GpuMemory*>(m_gpuMemoryRefs.At(idx).pGpuMemory), idx);
+            }
+        }
 
-        if (pMemRef->pGpuMemory == pGpuMem)
+        bool    existed   = false;
+        uint32* pMapIndex = nullptr;
+
+        if (result == Result::Success)
         {
-            pMemRef->flags.readOnly = (readOnly ? pMemRef->flags.readOnly : 0);
-            break;
+            result = m_memoryRefIndexMap.FindAllocate(pGpuMem, &existed, &pMapIndex);
+        }
+
+        if (result == Result::Success)
+        {
+            if (existed)
+            {
+                (*pIndex) = (*pMapIndex);
+            }
+            else
+            {
+                // The reference is about to be appended to the end of the list.
+                (*pMapIndex) = numRefs;
+            }
+        }
+        else
+        {
+            // Drop the partially built index so that it gets rebuilt from scratch on the next call.
+            m_memoryRefIndexMap.Reset();
         }
     }
 
-    if ((*pIndex) == m_gpuMemoryRefs.NumElements())
+    if (result == Result::Success)
     {
-        // The memory object wasn't in the reference list before, so add it.
-        GpuMemoryRef memRef   = { };
-        memRef.pGpuMemory     = pGpuMem;
-        memRef.flags.readOnly = (readOnly ? 1 : 0);
+        if ((*pIndex) < numRefs)
+        {
+            auto*const pMemRef = &m_gpuMemoryRefs.At(*pIndex);
+            pMemRef->flags.readOnly = (readOnly ? pMemRef->flags.readOnly : 0);
+        }
+        else
+        {
+            // The memory object wasn't in the reference list before, so add it.
+            GpuMemoryRef memRef   = { };
+            memRef.pGpuMemory     = pGpuMem;
+            memRef.flags.readOnly = (readOnly ? 1 : 0);
+
+            result = m_gpuMemoryRefs.PushBack(memRef);
 
-        result = m_gpuMemoryRefs.PushBack(memRef);
+            if ((result != Result::Success) && (numRefs > MaxLinearScanRefs))
+            {
+                m_memoryRefIndexMap.Erase(pGpuMem);
+            }
+        }
     }
 
-    PAL_ASSERT((*pIndex) < m_gpuMemoryRefs.NumElements());
+    PAL_ASSERT((result != Result::Success) || ((*pIndex) < m_gpuMemoryRefs.NumElements()));
     return result;
 }
 
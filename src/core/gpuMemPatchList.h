@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "palFlatHashMap.h"
 #include "palQueue.h"
 #include "palVector.h"
 
@@ -109,6 +110,7 @@ class GpuMemoryPatchList
     // Useful shorthands for vectors of memory references and memory patch entries.
     typedef Util::Vector<GpuMemoryRef, 16, Platform>  MemoryRefVector;
     typedef Util::Vector<GpuMemoryPatchEntry, 16, Platform>  PatchEntryVector;
+    typedef Util::FlatHashMap<GpuMemory*, uint32, Platform>  MemoryRefIndexMap;
 
 public:
     explicit GpuMemoryPatchList(
@@ -159,6 +161,10 @@ private:
     MemoryRefVector   m_gpuMemoryRefs;
     PatchEntryVector  m_patchEntries;
 
+    // Maps each GPU memory object in m_gpuMemoryRefs to its index. Short reference lists are scanned linearly, so this
+    // is only populated once the list grows past MaxLinearScanRefs entries.
+    MemoryRefIndexMap  m_memoryRefIndexMap;
+
     PAL_DISALLOW_DEFAULT_CTOR(GpuMemoryPatchList);
     PAL_DISALLOW_COPY_AND_ASSIGN(GpuMemoryPatchList);
 };
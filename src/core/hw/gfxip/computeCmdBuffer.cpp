@@ -78,6 +78,8 @@ Result ComputeCmdBuffer::Init(
         const auto& chipProps = m_device.Parent()->ChipProperties();
 
         m_spillTableCs.sizeInDwords = chipProps.gfxip.maxUserDataEntries;
+
+        m_pCmdStream->EnableChunkRetention(RetainsChunksOnReset());
     }
 
     return result;
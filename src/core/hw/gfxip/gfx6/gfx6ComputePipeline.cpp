@@ -315,12 +315,7 @@ Result ComputePipeline::HwlInit(
         data.pObj = this;
         m_pDevice->GetPlatform()->GetEventProvider()->LogGpuMemoryResourceCreateEvent(data);
 
-        GpuMemoryResourceBindEventData bindData = {};
-        bindData.pObj = this;
-        bindData.pGpuMemory = m_gpuMem.Memory();
-        bindData.requiredGpuMemSize = m_gpuMemSize;
-        bindData.offset = m_gpuMem.Offset();
-        m_pDevice->GetPlatform()->GetEventProvider()->LogGpuMemoryResourceBindEvent(bindData);
+        LogResourceBindEvents();
     }
 
     return result;
@@ -486,17 +481,6 @@ Result ComputePipeline::GetShaderStats(
                                                                       m_regs.computePgmHi.bits.DATA);
 
             pShaderStats->common.ldsSizePerThreadGroup = chipProps.gfxip.ldsSizePerThreadGroup;
-
-            AbiReader abiReader(m_pDevice->GetPlatform(), m_pPipelineBinary);
-            result = abiReader.Init();
-
-            MsgPackReader      metadataReader;
-            CodeObjectMetadata metadata;
-
-            if (result == Result::Success)
-            {
-                result = abiReader.GetMetadata(&metadataReader, &metadata);
-            }
         }
     }
 
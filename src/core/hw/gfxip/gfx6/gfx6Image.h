@@ -198,6 +198,8 @@ public:
     // Returns true if this Image has associated HTile data.
     virtual bool HasHtileData() const override { return (m_pHtile == nullptr) ? false : true; }
 
+    virtual bool HasMaskRam() const override { return HasHtileData() || HasColorMetaData(); }
+
     bool IsComprFmaskShaderReadable(const SubResourceInfo*  pSubResInfo) const;
 
     // Returns a pointer to the Gfx6Htile object associated with a particular sub-Resource.
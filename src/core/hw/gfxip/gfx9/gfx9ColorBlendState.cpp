@@ -38,19 +38,43 @@ namespace Gfx9
 
 // =====================================================================================================================
 ColorBlendState::ColorBlendState(
-    const Device&                    device,
-    const ColorBlendStateCreateInfo& createInfo)
+    const Device&               device,
+    const ColorBlendStateImage& image,
+    bool                        isInterned)
     :
-    Pal::ColorBlendState()
+    Pal::ColorBlendState(),
+    m_device(device),
+    m_image(image),
+    m_isInterned(isInterned)
 {
-    m_flags.u32All = 0;
-    m_flags.rbPlus = device.Settings().gfx9RbPlusEnable;
+}
 
-    memset(&m_blendOpts[0],      0, sizeof(m_blendOpts));
-    memset(&m_cbBlendControl[0], 0, sizeof(m_cbBlendControl));
-    memset(&m_sxMrtBlendOpt[0],  0, sizeof(m_sxMrtBlendOpt));
+// =====================================================================================================================
+ColorBlendState::~ColorBlendState()
+{
+    if (m_isInterned)
+    {
+        m_device.ReleaseColorBlendStateImage(&m_image);
+    }
+}
 
-    Init(createInfo);
+// =====================================================================================================================
+// Copies the fields of a color blend state create info which affect the hardware image into a zeroed interning key,
+// leaving the padding after each target's bools zero.
+void ColorBlendState::BuildImageKey(
+    const ColorBlendStateCreateInfo& blend,
+    ColorBlendStateCreateInfo*       pKey)
+{
+    for (uint32 i = 0; i < MaxColorTargets; i++)
+    {
+        pKey->targets[i].blendEnable    = blend.targets[i].blendEnable;
+        pKey->targets[i].srcBlendColor  = blend.targets[i].srcBlendColor;
+        pKey->targets[i].dstBlendColor  = blend.targets[i].dstBlendColor;
+        pKey->targets[i].blendFuncColor = blend.targets[i].blendFuncColor;
+        pKey->targets[i].srcBlendAlpha  = blend.targets[i].srcBlendAlpha;
+        pKey->targets[i].dstBlendAlpha  = blend.targets[i].dstBlendAlpha;
+        pKey->targets[i].blendFuncAlpha = blend.targets[i].blendFuncAlpha;
+    }
 }
 
 // =====================================================================================================================
@@ -289,58 +313,64 @@ static uint32 BlendOptToHw(
 // =====================================================================================================================
 // Performs Gfx9 hardware-specific initialization for a color blend state object, including:
 // Set up the image of PM4 commands used to write the pipeline to HW.
-void ColorBlendState::Init(
-    const ColorBlendStateCreateInfo& blend)
+void ColorBlendState::InitImage(
+    const Device&                    device,
+    const ColorBlendStateCreateInfo& blend,
+    ColorBlendStateImage*            pImage)
 {
+    memset(pImage, 0, sizeof(*pImage));
+
+    pImage->flags.rbPlus = device.Settings().gfx9RbPlusEnable;
+
     for (uint32 i = 0; i < MaxColorTargets; i++)
     {
         if (blend.targets[i].blendEnable)
         {
-            m_flags.blendEnable |= (1 << i);
-            m_cbBlendControl[i].bits.ENABLE = 1;
+            pImage->flags.blendEnable |= (1 << i);
+            pImage->cbBlendControl[i].bits.ENABLE = 1;
         }
-        m_cbBlendControl[i].bits.SEPARATE_ALPHA_BLEND = 1;
-        m_cbBlendControl[i].bits.COLOR_SRCBLEND       = HwBlendOp(blend.targets[i].srcBlendColor);
-        m_cbBlendControl[i].bits.COLOR_DESTBLEND      = HwBlendOp(blend.targets[i].dstBlendColor);
-        m_cbBlendControl[i].bits.ALPHA_SRCBLEND       = HwBlendOp(blend.targets[i].srcBlendAlpha);
-        m_cbBlendControl[i].bits.ALPHA_DESTBLEND      = HwBlendOp(blend.targets[i].dstBlendAlpha);
-        m_cbBlendControl[i].bits.COLOR_COMB_FCN       = HwBlendFunc(blend.targets[i].blendFuncColor);
-        m_cbBlendControl[i].bits.ALPHA_COMB_FCN       = HwBlendFunc(blend.targets[i].blendFuncAlpha);
+        pImage->cbBlendControl[i].bits.SEPARATE_ALPHA_BLEND = 1;
+        pImage->cbBlendControl[i].bits.COLOR_SRCBLEND       = HwBlendOp(blend.targets[i].srcBlendColor);
+        pImage->cbBlendControl[i].bits.COLOR_DESTBLEND      = HwBlendOp(blend.targets[i].dstBlendColor);
+        pImage->cbBlendControl[i].bits.ALPHA_SRCBLEND       = HwBlendOp(blend.targets[i].srcBlendAlpha);
+        pImage->cbBlendControl[i].bits.ALPHA_DESTBLEND      = HwBlendOp(blend.targets[i].dstBlendAlpha);
+        pImage->cbBlendControl[i].bits.COLOR_COMB_FCN       = HwBlendFunc(blend.targets[i].blendFuncColor);
+        pImage->cbBlendControl[i].bits.ALPHA_COMB_FCN       = HwBlendFunc(blend.targets[i].blendFuncAlpha);
 
         // BlendOps are forced to ONE for MIN/MAX blend funcs
         if ((blend.targets[i].blendFuncColor == BlendFunc::Min) ||
             (blend.targets[i].blendFuncColor == BlendFunc::Max))
         {
-            m_cbBlendControl[i].bits.COLOR_SRCBLEND  = BLEND_ONE;
-            m_cbBlendControl[i].bits.COLOR_DESTBLEND = BLEND_ONE;
+            pImage->cbBlendControl[i].bits.COLOR_SRCBLEND  = BLEND_ONE;
+            pImage->cbBlendControl[i].bits.COLOR_DESTBLEND = BLEND_ONE;
         }
 
         if ((blend.targets[i].blendFuncAlpha == BlendFunc::Min) ||
             (blend.targets[i].blendFuncAlpha == BlendFunc::Max))
         {
-            m_cbBlendControl[i].bits.ALPHA_SRCBLEND  = BLEND_ONE;
-            m_cbBlendControl[i].bits.ALPHA_DESTBLEND = BLEND_ONE;
+            pImage->cbBlendControl[i].bits.ALPHA_SRCBLEND  = BLEND_ONE;
+            pImage->cbBlendControl[i].bits.ALPHA_DESTBLEND = BLEND_ONE;
         }
     }
 
-    m_flags.dualSourceBlend = (IsDualSrcBlendOption(blend.targets[0].srcBlendColor) |
-                               IsDualSrcBlendOption(blend.targets[0].dstBlendColor) |
-                               IsDualSrcBlendOption(blend.targets[0].srcBlendAlpha) |
-                               IsDualSrcBlendOption(blend.targets[0].dstBlendAlpha));
+    pImage->flags.dualSourceBlend = (IsDualSrcBlendOption(blend.targets[0].srcBlendColor) |
+                                     IsDualSrcBlendOption(blend.targets[0].dstBlendColor) |
+                                     IsDualSrcBlendOption(blend.targets[0].srcBlendAlpha) |
+                                     IsDualSrcBlendOption(blend.targets[0].dstBlendAlpha));
 
     // CB_BLEND1_CONTROL.ENABLE must be 1 for dual source blending.
-    m_cbBlendControl[1].bits.ENABLE |= m_flags.dualSourceBlend;
+    pImage->cbBlendControl[1].bits.ENABLE |= pImage->flags.dualSourceBlend;
 
-    InitBlendOpts(blend);
+    InitBlendOpts(blend, pImage);
 
     // SX blend optimizations must be disabled when RB+ is disabled or when dual-source blending is enabled.
-    if ((m_flags.dualSourceBlend == 0) && (m_flags.rbPlus != 0))
+    if ((pImage->flags.dualSourceBlend == 0) && (pImage->flags.rbPlus != 0))
     {
         for (uint32 i = 0; i < MaxColorTargets; i++)
         {
             if (blend.targets[i].blendEnable == true)
             {
-                m_sxMrtBlendOpt[i].bits.COLOR_SRC_OPT = GetSxBlendOptColor(blend.targets[i].srcBlendColor);
+                pImage->sxMrtBlendOpt[i].bits.COLOR_SRC_OPT = GetSxBlendOptColor(blend.targets[i].srcBlendColor);
 
                 // If src color factor constains Dst, don't optimize color DST. It was said blend factor
                 // SrcAlphaSaturate contains DST in RGB channels only.
@@ -350,14 +380,14 @@ void ColorBlendState::Init(
                     (blend.targets[i].srcBlendColor == Blend::OneMinusDstAlpha) ||
                     (blend.targets[i].srcBlendColor == Blend::SrcAlphaSaturate))
                 {
-                    m_sxMrtBlendOpt[i].bits.COLOR_DST_OPT = BLEND_OPT_PRESERVE_NONE_IGNORE_NONE;
+                    pImage->sxMrtBlendOpt[i].bits.COLOR_DST_OPT = BLEND_OPT_PRESERVE_NONE_IGNORE_NONE;
                 }
                 else
                 {
-                    m_sxMrtBlendOpt[i].bits.COLOR_DST_OPT = GetSxBlendOptColor(blend.targets[i].dstBlendColor);
+                    pImage->sxMrtBlendOpt[i].bits.COLOR_DST_OPT = GetSxBlendOptColor(blend.targets[i].dstBlendColor);
                 }
 
-                m_sxMrtBlendOpt[i].bits.ALPHA_SRC_OPT = GetSxBlendOptAlpha(blend.targets[i].srcBlendAlpha);
+                pImage->sxMrtBlendOpt[i].bits.ALPHA_SRC_OPT = GetSxBlendOptAlpha(blend.targets[i].srcBlendAlpha);
 
                 // If src alpha factor contains DST, don't optimize alpha DST.
                 if ((blend.targets[i].srcBlendAlpha == Blend::DstColor) ||
@@ -365,40 +395,40 @@ void ColorBlendState::Init(
                     (blend.targets[i].srcBlendAlpha == Blend::DstAlpha) ||
                     (blend.targets[i].srcBlendAlpha == Blend::OneMinusDstAlpha))
                 {
-                    m_sxMrtBlendOpt[i].bits.ALPHA_DST_OPT = BLEND_OPT_PRESERVE_NONE_IGNORE_NONE;
+                    pImage->sxMrtBlendOpt[i].bits.ALPHA_DST_OPT = BLEND_OPT_PRESERVE_NONE_IGNORE_NONE;
                 }
                 else
                 {
-                    m_sxMrtBlendOpt[i].bits.ALPHA_DST_OPT = GetSxBlendOptAlpha(blend.targets[i].dstBlendAlpha);
+                    pImage->sxMrtBlendOpt[i].bits.ALPHA_DST_OPT = GetSxBlendOptAlpha(blend.targets[i].dstBlendAlpha);
                 }
 
-                m_sxMrtBlendOpt[i].bits.COLOR_COMB_FCN = GetSxBlendFcn(blend.targets[i].blendFuncColor);
-                m_sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN = GetSxBlendFcn(blend.targets[i].blendFuncAlpha);
+                pImage->sxMrtBlendOpt[i].bits.COLOR_COMB_FCN = GetSxBlendFcn(blend.targets[i].blendFuncColor);
+                pImage->sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN = GetSxBlendFcn(blend.targets[i].blendFuncAlpha);
 
                 // BlendOpts are forced to ONE for MIN/MAX blend fcns
-                if ((m_sxMrtBlendOpt[i].bits.COLOR_COMB_FCN == OPT_COMB_MIN) ||
-                    (m_sxMrtBlendOpt[i].bits.COLOR_COMB_FCN == OPT_COMB_MAX))
+                if ((pImage->sxMrtBlendOpt[i].bits.COLOR_COMB_FCN == OPT_COMB_MIN) ||
+                    (pImage->sxMrtBlendOpt[i].bits.COLOR_COMB_FCN == OPT_COMB_MAX))
                 {
-                    m_sxMrtBlendOpt[i].bits.COLOR_SRC_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
-                    m_sxMrtBlendOpt[i].bits.COLOR_DST_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
+                    pImage->sxMrtBlendOpt[i].bits.COLOR_SRC_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
+                    pImage->sxMrtBlendOpt[i].bits.COLOR_DST_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
                 }
 
-                if ((m_sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN == OPT_COMB_MIN) ||
-                    (m_sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN == OPT_COMB_MAX))
+                if ((pImage->sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN == OPT_COMB_MIN) ||
+                    (pImage->sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN == OPT_COMB_MAX))
                 {
-                    m_sxMrtBlendOpt[i].bits.ALPHA_SRC_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
-                    m_sxMrtBlendOpt[i].bits.ALPHA_DST_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
+                    pImage->sxMrtBlendOpt[i].bits.ALPHA_SRC_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
+                    pImage->sxMrtBlendOpt[i].bits.ALPHA_DST_OPT = BLEND_OPT_PRESERVE_ALL_IGNORE_NONE;
                 }
             }
             else
             {
-                m_sxMrtBlendOpt[i].bits.COLOR_COMB_FCN = OPT_COMB_BLEND_DISABLED;
-                m_sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN = OPT_COMB_BLEND_DISABLED;
+                pImage->sxMrtBlendOpt[i].bits.COLOR_COMB_FCN = OPT_COMB_BLEND_DISABLED;
+                pImage->sxMrtBlendOpt[i].bits.ALPHA_COMB_FCN = OPT_COMB_BLEND_DISABLED;
             }
         }
     }
 
-    InitBlendMasks(blend);
+    InitBlendMasks(blend, pImage);
 }
 
 // =====================================================================================================================
@@ -409,7 +439,8 @@ void ColorBlendState::Init(
 //      + Writing to Color channel only.
 //      + Writing to both Alpha and Color channels.
 void ColorBlendState::InitBlendOpts(
-    const ColorBlendStateCreateInfo& blend)
+    const ColorBlendStateCreateInfo& blend,
+    ColorBlendStateImage*            pImage)
 {
     using namespace GfxBlendOptimizer;
     using GfxBlendOptimizer::BlendOpt;
@@ -417,25 +448,25 @@ void ColorBlendState::InitBlendOpts(
     for (uint32 ct = 0; ct < Pal::MaxColorTargets; ct++)
     {
         // The logic assumes the separate alpha blend is always on
-        PAL_ASSERT(m_cbBlendControl[ct].bits.SEPARATE_ALPHA_BLEND == 1);
+        PAL_ASSERT(pImage->cbBlendControl[ct].bits.SEPARATE_ALPHA_BLEND == 1);
 
         Input optInput = { };
-        optInput.srcBlend       = HwEnumToBlendOp(m_cbBlendControl[ct].bits.COLOR_SRCBLEND);
-        optInput.destBlend      = HwEnumToBlendOp(m_cbBlendControl[ct].bits.COLOR_DESTBLEND);
-        optInput.alphaSrcBlend  = HwEnumToBlendOp(m_cbBlendControl[ct].bits.ALPHA_SRCBLEND);
-        optInput.alphaDestBlend = HwEnumToBlendOp(m_cbBlendControl[ct].bits.ALPHA_DESTBLEND);
+        optInput.srcBlend       = HwEnumToBlendOp(pImage->cbBlendControl[ct].bits.COLOR_SRCBLEND);
+        optInput.destBlend      = HwEnumToBlendOp(pImage->cbBlendControl[ct].bits.COLOR_DESTBLEND);
+        optInput.alphaSrcBlend  = HwEnumToBlendOp(pImage->cbBlendControl[ct].bits.ALPHA_SRCBLEND);
+        optInput.alphaDestBlend = HwEnumToBlendOp(pImage->cbBlendControl[ct].bits.ALPHA_DESTBLEND);
 
-        const uint32 colorCombFcn = m_cbBlendControl[ct].bits.COLOR_COMB_FCN;
-        const uint32 alphaCombFcn = m_cbBlendControl[ct].bits.ALPHA_COMB_FCN;
+        const uint32 colorCombFcn = pImage->cbBlendControl[ct].bits.COLOR_COMB_FCN;
+        const uint32 alphaCombFcn = pImage->cbBlendControl[ct].bits.ALPHA_COMB_FCN;
 
         for (uint32 idx = 0; idx < NumChannelWriteComb; idx++)
         {
             const uint32 optIndex = (ct * NumChannelWriteComb) + idx;
 
             // Start with AUTO settings for all optimizations
-            m_blendOpts[optIndex].discardPixel = BlendOpt::ForceOptAuto;
+            pImage->blendOpts[optIndex].discardPixel = BlendOpt::ForceOptAuto;
             // TODO: Consider explicitly overriding destination read optimization.
-            m_blendOpts[optIndex].dontRdDst    = BlendOpt::ForceOptAuto;
+            pImage->blendOpts[optIndex].dontRdDst    = BlendOpt::ForceOptAuto;
 
             // Use explicit optimization settings only when blending is enabled, since HW doesn't check for blending and
             // would blindly apply optimizations even in cases when they shouldn't be applied.
@@ -443,7 +474,7 @@ void ColorBlendState::InitBlendOpts(
             // Per discussions with HW engineers, RTL has issues with blend optimization for dual source blending.  HW
             // is already turning it off for that case.  Thus, driver must not turn it on as well for dual source
             // blending.
-            if ((blend.targets[ct].blendEnable == true) && (m_flags.dualSourceBlend == 0))
+            if ((blend.targets[ct].blendEnable == true) && (pImage->flags.dualSourceBlend == 0))
             {
                 // The three valid alpha/color combinations are:
                 //  - AlphaEnabled      = 0x01
@@ -463,15 +494,15 @@ void ColorBlendState::InitBlendOpts(
                     ((alphaCombFcn == COMB_DST_PLUS_SRC)   ||
                      (alphaCombFcn == COMB_DST_MINUS_SRC)))
                 {
-                    m_blendOpts[optIndex].discardPixel = OptimizePixDiscard1(optInput);
+                    pImage->blendOpts[optIndex].discardPixel = OptimizePixDiscard1(optInput);
                 }
 
                 // If couldn't optimize, try another pixel discard equation
-                if ((m_blendOpts[optIndex].discardPixel == BlendOpt::ForceOptAuto) &&
+                if ((pImage->blendOpts[optIndex].discardPixel == BlendOpt::ForceOptAuto) &&
                     (colorCombFcn == COMB_DST_PLUS_SRC)                            &&
                     (alphaCombFcn == COMB_DST_PLUS_SRC))
                 {
-                    m_blendOpts[optIndex].discardPixel = OptimizePixDiscard2(optInput);
+                    pImage->blendOpts[optIndex].discardPixel = OptimizePixDiscard2(optInput);
                 }
             }
         } // for each color/alpha combination
@@ -488,11 +519,11 @@ uint32* ColorBlendState::WriteCommands(
 {
     pCmdSpace = pCmdStream->WriteSetSeqContextRegs(mmCB_BLEND0_CONTROL,
                                                    mmCB_BLEND7_CONTROL,
-                                                   &m_cbBlendControl[0],
+                                                   &m_image.cbBlendControl[0],
                                                    pCmdSpace);
     return pCmdStream->WriteSetSeqContextRegs(mmSX_MRT0_BLEND_OPT,
                                               mmSX_MRT7_BLEND_OPT,
-                                              &m_sxMrtBlendOpt[0],
+                                              &m_image.sxMrtBlendOpt[0],
                                               pCmdSpace);
 }
 
@@ -534,8 +565,8 @@ uint8 ColorBlendState::WriteBlendOptimizations(
 
                 const uint32 optIndex = (idx * NumChannelWriteComb) + (channelWritesEnabled - 1);
 
-                dontRdDst    = m_blendOpts[optIndex].dontRdDst;
-                discardPixel = m_blendOpts[optIndex].discardPixel;
+                dontRdDst    = m_image.blendOpts[optIndex].dontRdDst;
+                discardPixel = m_image.blendOpts[optIndex].discardPixel;
             }
 
             // Update blend optimizations if changed
@@ -557,10 +588,11 @@ uint8 ColorBlendState::WriteBlendOptimizations(
 
 // =====================================================================================================================
 // Examines the blend state for each target to determine if the state is commutative and sets/clears the appropriate bit
-// in m_blendCommutativeMask, or if the state allows the destination to be read and sets/clears the appropriate
-// bit in m_blendReadsDestMask.
+// in the image's blendCommutative mask, or if the state allows the destination to be read and sets/clears the
+// appropriate bit in its blendReadsDst mask.
 void ColorBlendState::InitBlendMasks(
-    const ColorBlendStateCreateInfo& createInfo)
+    const ColorBlendStateCreateInfo& createInfo,
+    ColorBlendStateImage*            pImage)
 {
     for (uint32 rtIdx = 0; rtIdx < MaxColorTargets; rtIdx++)
     {
@@ -586,7 +618,7 @@ void ColorBlendState::InitBlendMasks(
                 (srcBlends[k] == Blend::DstColor)         ||
                 (srcBlends[k] == Blend::OneMinusDstColor))
             {
-                m_flags.blendReadsDst |= (1 << rtIdx);
+                pImage->flags.blendReadsDst |= (1 << rtIdx);
             }
 
             // Min and max blend ops are always commutative as they ignore the blend multiplier and operate directly on
@@ -658,7 +690,7 @@ void ColorBlendState::InitBlendMasks(
 
         if (createInfo.targets[rtIdx].blendEnable && isCommutative[0] && isCommutative[1])
         {
-            m_flags.blendCommutative |= (1 << rtIdx);
+            pImage->flags.blendCommutative |= (1 << rtIdx);
         }
     }
 }
@@ -37,19 +37,52 @@ namespace Gfx9
 class CmdStream;
 class Device;
 
+// Hardware image of a color blend state object. When state objects are interned, every color blend state created with
+// an identical create info shares one image.
+struct ColorBlendStateImage
+{
+    union
+    {
+        struct
+        {
+            uint32  blendEnable      :  8; // Indicates if blending is enabled for each target
+            uint32  blendCommutative :  8; // Indicates if blending is commutative for each target
+            uint32  blendReadsDst    :  8; // Indicates if blending will read the destination
+            uint32  dualSourceBlend  :  1; // Indicates if dual-source blending is enabled
+            uint32  rbPlus           :  1; // Indicates if RBPlus is enabled
+            uint32  reserved         :  6;
+        };
+        uint32  u32All;
+    } flags;
+
+    regCB_BLEND0_CONTROL  cbBlendControl[MaxColorTargets];
+    regSX_MRT0_BLEND_OPT  sxMrtBlendOpt[MaxColorTargets];
+
+    GfxBlendOptimizer::BlendOpts  blendOpts[MaxColorTargets * GfxBlendOptimizer::NumChannelWriteComb];
+};
+
 // =====================================================================================================================
 // GFX9-specific color blend  state implementation.  See IColorBlendState documentation for more details.
 class ColorBlendState : public Pal::ColorBlendState
 {
 public:
-    ColorBlendState(const Device& device, const ColorBlendStateCreateInfo& createInfo);
+    typedef ColorBlendStateImage      Image;
+    typedef ColorBlendStateCreateInfo CreateInfo;
+
+    ColorBlendState(const Device& device, const ColorBlendStateImage& image, bool isInterned);
+
+    static void BuildImageKey(const ColorBlendStateCreateInfo& blend, ColorBlendStateCreateInfo* pKey);
+    static void InitImage(
+        const Device&                    device,
+        const ColorBlendStateCreateInfo& blend,
+        ColorBlendStateImage*            pImage);
 
     uint32* WriteCommands(CmdStream* pCmdStream, uint32* pCmdSpace) const;
 
-    bool IsBlendEnabled(uint32 slot) const { return ((m_flags.blendEnable & (1 << slot)) != 0); }
+    bool IsBlendEnabled(uint32 slot) const { return ((m_image.flags.blendEnable & (1 << slot)) != 0); }
 
-    uint32 BlendEnableMask() const { return m_flags.blendEnable; }
-    uint32 BlendReadsDestMask() const { return m_flags.blendReadsDst; }
+    uint32 BlendEnableMask() const { return m_image.flags.blendEnable; }
+    uint32 BlendReadsDestMask() const { return m_image.flags.blendReadsDst; }
 
     uint8 WriteBlendOptimizations(
         CmdStream*                     pCmdStream,
@@ -62,38 +95,22 @@ public:
     bool IsBlendCommutative(uint32 slot) const
     {
         PAL_ASSERT(slot < MaxColorTargets);
-        return (((m_flags.blendCommutative >> slot) & 0x1) != 0);
+        return (((m_image.flags.blendCommutative >> slot) & 0x1) != 0);
     }
 
 private:
-    virtual ~ColorBlendState() { }
+    virtual ~ColorBlendState();
 
-    void Init(const ColorBlendStateCreateInfo& createInfo);
-    void InitBlendOpts(const ColorBlendStateCreateInfo& createInfo);
-    void InitBlendMasks(const ColorBlendStateCreateInfo& createInfo);
+    static void InitBlendOpts(const ColorBlendStateCreateInfo& createInfo, ColorBlendStateImage* pImage);
+    static void InitBlendMasks(const ColorBlendStateCreateInfo& createInfo, ColorBlendStateImage* pImage);
 
     static BlendOp  HwBlendOp(Blend blendOp);
     static CombFunc HwBlendFunc(BlendFunc blendFunc);
     static bool     IsDualSrcBlendOption(Blend blend);
 
-    union
-    {
-        struct
-        {
-            uint32  blendEnable      :  8; // Indicates if blending is enabled for each target
-            uint32  blendCommutative :  8; // Indicates if blending is commutative for each target
-            uint32  blendReadsDst    :  8; // Indicates if blending will read the destination
-            uint32  dualSourceBlend  :  1; // Indicates if dual-source blending is enabled
-            uint32  rbPlus           :  1; // Indicates if RBPlus is enabled
-            uint32  reserved         :  6;
-        };
-        uint32  u32All;
-    } m_flags;
-
-    regCB_BLEND0_CONTROL  m_cbBlendControl[MaxColorTargets];
-    regSX_MRT0_BLEND_OPT  m_sxMrtBlendOpt[MaxColorTargets];
-
-    GfxBlendOptimizer::BlendOpts  m_blendOpts[MaxColorTargets * GfxBlendOptimizer::NumChannelWriteComb];
+    const Device&               m_device;
+    const ColorBlendStateImage& m_image;      // Either interned by the device or stored right after this object.
+    const bool                  m_isInterned;
 
     PAL_DISALLOW_COPY_AND_ASSIGN(ColorBlendState);
     PAL_DISALLOW_DEFAULT_CTOR(ColorBlendState);
@@ -34,16 +34,40 @@ namespace Gfx9
 
 // =====================================================================================================================
 DepthStencilState::DepthStencilState(
-    const DepthStencilStateCreateInfo& createInfo)
+    const Device&                 device,
+    const DepthStencilStateImage& image,
+    bool                          isInterned)
     :
-    Pal::DepthStencilState()
+    Pal::DepthStencilState(),
+    m_device(device),
+    m_image(image),
+    m_isInterned(isInterned)
 {
-    memset(&m_flags, 0, sizeof(m_flags));
+}
 
-    m_dbDepthControl.u32All   = 0;
-    m_dbStencilControl.u32All = 0;
+// =====================================================================================================================
+DepthStencilState::~DepthStencilState()
+{
+    if (m_isInterned)
+    {
+        m_device.ReleaseDepthStencilStateImage(&m_image);
+    }
+}
 
-    Init(createInfo);
+// =====================================================================================================================
+// Copies the fields of a depth/stencil state create info which affect the hardware image into a zeroed interning key,
+// leaving the unused bits of the flags byte zero.
+void DepthStencilState::BuildImageKey(
+    const DepthStencilStateCreateInfo& dsState,
+    DepthStencilStateCreateInfo*       pKey)
+{
+    pKey->front             = dsState.front;
+    pKey->back              = dsState.back;
+    pKey->depthFunc         = dsState.depthFunc;
+    pKey->depthEnable       = dsState.depthEnable;
+    pKey->depthWriteEnable  = dsState.depthWriteEnable;
+    pKey->depthBoundsEnable = dsState.depthBoundsEnable;
+    pKey->stencilEnable     = dsState.stencilEnable;
 }
 
 // =====================================================================================================================
@@ -61,18 +85,22 @@ static bool CanRunOutOfOrder(
 // =====================================================================================================================
 // Performs Gfx9 hardware-specific initialization for a depth/stencil state object, including:
 // Set up the image of PM4 commands used to write the pipeline to HW.
-void DepthStencilState::Init(
-    const DepthStencilStateCreateInfo& dsState)
+void DepthStencilState::InitImage(
+    const Device&                      device,
+    const DepthStencilStateCreateInfo& dsState,
+    DepthStencilStateImage*            pImage)
 {
-    m_flags.isDepthEnabled   = dsState.depthEnable;
-    m_flags.isStencilEnabled = dsState.stencilEnable;
+    memset(pImage, 0, sizeof(*pImage));
+
+    pImage->flags.isDepthEnabled   = dsState.depthEnable;
+    pImage->flags.isStencilEnabled = dsState.stencilEnable;
 
-    m_flags.isDepthWriteEnabled =
+    pImage->flags.isDepthWriteEnabled =
         dsState.depthEnable      &&
         dsState.depthWriteEnable &&
         (dsState.depthFunc != CompareFunc::Never);
 
-    m_flags.isStencilWriteEnabled =
+    pImage->flags.isStencilWriteEnabled =
         dsState.stencilEnable           &&
         ((dsState.front.stencilFailOp != Pal::StencilOp::Keep)      ||
          (dsState.front.stencilPassOp != Pal::StencilOp::Keep)      ||
@@ -81,50 +109,50 @@ void DepthStencilState::Init(
          (dsState.back.stencilPassOp != Pal::StencilOp::Keep)       ||
          (dsState.back.stencilDepthFailOp != Pal::StencilOp::Keep));
 
-    m_flags.canDepthRunOutOfOrder =
-        (dsState.depthEnable == false)         ||
-        (m_flags.isDepthWriteEnabled == false) ||
+    pImage->flags.canDepthRunOutOfOrder =
+        (dsState.depthEnable == false)               ||
+        (pImage->flags.isDepthWriteEnabled == false) ||
         CanRunOutOfOrder(dsState.depthFunc);
 
-    m_flags.canStencilRunOutOfOrder =
-        (dsState.stencilEnable == false)             ||
-        (m_flags.isStencilWriteEnabled == false)     ||
-        (CanRunOutOfOrder(dsState.front.stencilFunc) &&
+    pImage->flags.canStencilRunOutOfOrder =
+        (dsState.stencilEnable == false)               ||
+        (pImage->flags.isStencilWriteEnabled == false) ||
+        (CanRunOutOfOrder(dsState.front.stencilFunc)   &&
          CanRunOutOfOrder(dsState.back.stencilFunc));
 
-    m_flags.depthForcesOrdering =
+    pImage->flags.depthForcesOrdering =
         dsState.depthEnable                        &&
         (dsState.depthFunc != CompareFunc::Always) &&
         (dsState.depthFunc != CompareFunc::NotEqual);
 
     // Setup DB_DEPTH_CONTROL.
-    m_dbDepthControl.bits.Z_ENABLE       = (dsState.depthEnable ? 1 : 0);
-    m_dbDepthControl.bits.Z_WRITE_ENABLE = (dsState.depthWriteEnable ? 1 : 0);
-    m_dbDepthControl.bits.ZFUNC          = HwDepthCompare(dsState.depthFunc);
+    pImage->dbDepthControl.bits.Z_ENABLE       = (dsState.depthEnable ? 1 : 0);
+    pImage->dbDepthControl.bits.Z_WRITE_ENABLE = (dsState.depthWriteEnable ? 1 : 0);
+    pImage->dbDepthControl.bits.ZFUNC          = HwDepthCompare(dsState.depthFunc);
 
-    m_dbDepthControl.bits.STENCIL_ENABLE = (dsState.stencilEnable ? 1 : 0);
-    m_dbDepthControl.bits.STENCILFUNC    = HwStencilCompare(dsState.front.stencilFunc);
-    m_dbDepthControl.bits.STENCILFUNC_BF = HwStencilCompare(dsState.back.stencilFunc);
+    pImage->dbDepthControl.bits.STENCIL_ENABLE = (dsState.stencilEnable ? 1 : 0);
+    pImage->dbDepthControl.bits.STENCILFUNC    = HwStencilCompare(dsState.front.stencilFunc);
+    pImage->dbDepthControl.bits.STENCILFUNC_BF = HwStencilCompare(dsState.back.stencilFunc);
 
-    m_dbDepthControl.bits.DEPTH_BOUNDS_ENABLE = (dsState.depthBoundsEnable ? 1 : 0);
+    pImage->dbDepthControl.bits.DEPTH_BOUNDS_ENABLE = (dsState.depthBoundsEnable ? 1 : 0);
     // NOTE: Always on
-    m_dbDepthControl.bits.BACKFACE_ENABLE = 1;
+    pImage->dbDepthControl.bits.BACKFACE_ENABLE = 1;
 
     // Force off as this is not linked to any API features. Their need/use is unclear.
-    m_dbDepthControl.bits.ENABLE_COLOR_WRITES_ON_DEPTH_FAIL  = 0;
-    m_dbDepthControl.bits.DISABLE_COLOR_WRITES_ON_DEPTH_PASS = 0;
+    pImage->dbDepthControl.bits.ENABLE_COLOR_WRITES_ON_DEPTH_FAIL  = 0;
+    pImage->dbDepthControl.bits.DISABLE_COLOR_WRITES_ON_DEPTH_PASS = 0;
 
     // Setup DB_STENCIL_CONTROL.
 
     // front stencil
-    m_dbStencilControl.bits.STENCILFAIL  = HwStencilOp(dsState.front.stencilFailOp);
-    m_dbStencilControl.bits.STENCILZFAIL = HwStencilOp(dsState.front.stencilDepthFailOp);
-    m_dbStencilControl.bits.STENCILZPASS = HwStencilOp(dsState.front.stencilPassOp);
+    pImage->dbStencilControl.bits.STENCILFAIL  = HwStencilOp(dsState.front.stencilFailOp);
+    pImage->dbStencilControl.bits.STENCILZFAIL = HwStencilOp(dsState.front.stencilDepthFailOp);
+    pImage->dbStencilControl.bits.STENCILZPASS = HwStencilOp(dsState.front.stencilPassOp);
 
     // back stencil
-    m_dbStencilControl.bits.STENCILFAIL_BF  = HwStencilOp(dsState.back.stencilFailOp);
-    m_dbStencilControl.bits.STENCILZFAIL_BF = HwStencilOp(dsState.back.stencilDepthFailOp);
-    m_dbStencilControl.bits.STENCILZPASS_BF = HwStencilOp(dsState.back.stencilPassOp);
+    pImage->dbStencilControl.bits.STENCILFAIL_BF  = HwStencilOp(dsState.back.stencilFailOp);
+    pImage->dbStencilControl.bits.STENCILZFAIL_BF = HwStencilOp(dsState.back.stencilDepthFailOp);
+    pImage->dbStencilControl.bits.STENCILZPASS_BF = HwStencilOp(dsState.back.stencilPassOp);
 }
 
 // =====================================================================================================================
@@ -135,8 +163,8 @@ uint32* DepthStencilState::WriteCommands(
     uint32*    pCmdSpace
     ) const
 {
-    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_DEPTH_CONTROL,   m_dbDepthControl.u32All,   pCmdSpace);
-    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_STENCIL_CONTROL, m_dbStencilControl.u32All, pCmdSpace);
+    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_DEPTH_CONTROL,   m_image.dbDepthControl.u32All,   pCmdSpace);
+    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_STENCIL_CONTROL, m_image.dbStencilControl.u32All, pCmdSpace);
 
     return pCmdSpace;
 }
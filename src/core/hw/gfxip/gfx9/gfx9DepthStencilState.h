@@ -35,35 +35,10 @@ namespace Gfx9
 
 class Device;
 
-// =====================================================================================================================
-// Gfx9 hardware layer DepthStencil State class: implements Gfx9 specific functionality for the IDepthStencilState
-// class.
-class DepthStencilState : public Pal::DepthStencilState
+// Hardware image of a depth/stencil state object. When state objects are interned, every depth/stencil state created
+// with an identical create info shares one image.
+struct DepthStencilStateImage
 {
-public:
-    explicit DepthStencilState(const DepthStencilStateCreateInfo& createInfo);
-
-    static CompareRef HwStencilCompare(CompareFunc func);
-
-    uint32* WriteCommands(CmdStream* pCmdStream, uint32* pCmdSpace) const;
-
-    bool IsDepthEnabled() const { return (m_flags.isDepthEnabled != 0); }
-    bool IsStencilEnabled() const { return (m_flags.isStencilEnabled != 0); }
-    bool IsDepthWriteEnabled() const { return (m_flags.isDepthWriteEnabled != 0); }
-    bool IsStencilWriteEnabled() const { return (m_flags.isStencilWriteEnabled != 0); }
-
-    bool CanDepthRunOutOfOrder() const { return (m_flags.canDepthRunOutOfOrder != 0); }
-    bool CanStencilRunOutOfOrder() const { return (m_flags.canStencilRunOutOfOrder != 0); }
-    bool DepthForcesOrdering() const { return (m_flags.depthForcesOrdering != 0); }
-
-private:
-    virtual ~DepthStencilState() { }
-
-    void Init(const DepthStencilStateCreateInfo& dsState);
-
-    static CompareFrag HwDepthCompare(CompareFunc func);
-    static Gfx9::StencilOp HwStencilOp(Pal::StencilOp stencilOp);
-
     union
     {
         struct
@@ -81,10 +56,51 @@ private:
             uint32 reserved                : 25;
         };
         uint32  u32All;
-    } m_flags;
+    } flags;
+
+    regDB_DEPTH_CONTROL    dbDepthControl;
+    regDB_STENCIL_CONTROL  dbStencilControl;
+};
+
+// =====================================================================================================================
+// Gfx9 hardware layer DepthStencil State class: implements Gfx9 specific functionality for the IDepthStencilState
+// class.
+class DepthStencilState : public Pal::DepthStencilState
+{
+public:
+    typedef DepthStencilStateImage      Image;
+    typedef DepthStencilStateCreateInfo CreateInfo;
+
+    DepthStencilState(const Device& device, const DepthStencilStateImage& image, bool isInterned);
+
+    static void BuildImageKey(const DepthStencilStateCreateInfo& dsState, DepthStencilStateCreateInfo* pKey);
+    static void InitImage(
+        const Device&                      device,
+        const DepthStencilStateCreateInfo& dsState,
+        DepthStencilStateImage*            pImage);
+
+    static CompareRef HwStencilCompare(CompareFunc func);
+
+    uint32* WriteCommands(CmdStream* pCmdStream, uint32* pCmdSpace) const;
+
+    bool IsDepthEnabled() const { return (m_image.flags.isDepthEnabled != 0); }
+    bool IsStencilEnabled() const { return (m_image.flags.isStencilEnabled != 0); }
+    bool IsDepthWriteEnabled() const { return (m_image.flags.isDepthWriteEnabled != 0); }
+    bool IsStencilWriteEnabled() const { return (m_image.flags.isStencilWriteEnabled != 0); }
+
+    bool CanDepthRunOutOfOrder() const { return (m_image.flags.canDepthRunOutOfOrder != 0); }
+    bool CanStencilRunOutOfOrder() const { return (m_image.flags.canStencilRunOutOfOrder != 0); }
+    bool DepthForcesOrdering() const { return (m_image.flags.depthForcesOrdering != 0); }
+
+private:
+    virtual ~DepthStencilState();
+
+    static CompareFrag HwDepthCompare(CompareFunc func);
+    static Gfx9::StencilOp HwStencilOp(Pal::StencilOp stencilOp);
 
-    regDB_DEPTH_CONTROL    m_dbDepthControl;
-    regDB_STENCIL_CONTROL  m_dbStencilControl;
+    const Device&                 m_device;
+    const DepthStencilStateImage& m_image;      // Either interned by the device or stored right after this object.
+    const bool                    m_isInterned;
 
     PAL_DISALLOW_COPY_AND_ASSIGN(DepthStencilState);
     PAL_DISALLOW_DEFAULT_CTOR(DepthStencilState);
@@ -187,7 +187,11 @@ Device::Device(
     m_presentResolution({ 0,0 }),
     m_gbAddrConfig(m_pParent->ChipProperties().gfx9.gbAddrConfig),
     m_gfxIpLevel(pDevice->ChipProperties().gfxLevel),
-    m_varBlockSize(0)
+    m_varBlockSize(0),
+    m_colorBlendStateCache(pDevice->GetPlatform()),
+    m_depthStencilStateCache(pDevice->GetPlatform()),
+    m_msaaStateCache(pDevice->GetPlatform()),
+    m_metaEquationCache(MetaEquationCacheBuckets, pDevice->GetPlatform())
 {
     PAL_ASSERT(((GetGbAddrConfig().bits.NUM_PIPES - GetGbAddrConfig().bits.NUM_RB_PER_SE) < 2) ||
                IsGfx10Plus(m_gfxIpLevel));
@@ -211,6 +215,14 @@ Result Device::Cleanup()
     // RsrcProcMgr is owned by GfxDevice and gets reset on GfxDevice::Cleanup.
     m_pRsrcProcMgr->Cleanup();
 
+    // Every state object must have been destroyed by now, including the ones owned by RsrcProcMgr.
+    m_colorBlendStateCache.Reset();
+    m_depthStencilStateCache.Reset();
+    m_msaaStateCache.Reset();
+
+    // The meta equations depend on the settings, which may change before this device is finalized again.
+    m_metaEquationCache.Reset();
+
     Result result = Result::Success;
 
     if (m_occlusionSrcMem.IsBound())
@@ -266,6 +278,16 @@ Result Device::EarlyInit()
 
     Result result = m_ringSizesLock.Init();
 
+    if (result == Result::Success)
+    {
+        result = m_metaEquationLock.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_metaEquationCache.Init();
+    }
+
     if (result == Result::Success)
     {
         result = m_pRsrcProcMgr->EarlyInit();
@@ -276,6 +298,47 @@ Result Device::EarlyInit()
     return result;
 }
 
+// =====================================================================================================================
+// Looks up a previously finalized mask-ram meta equation. Returns true and copies it into pEquation if one was found.
+bool Device::FindMetaEquation(
+    const MetaEquationKey& key,
+    CachedMetaEquation*    pEquation
+    ) const
+{
+    MutexAuto lock(&m_metaEquationLock);
+
+    const CachedMetaEquation*const pCached = m_metaEquationCache.FindKey(key);
+
+    if (pCached != nullptr)
+    {
+        *pEquation = *pCached;
+    }
+
+    return (pCached != nullptr);
+}
+
+// =====================================================================================================================
+// Remembers a finalized mask-ram meta equation so that later images with the same key can skip generating it. Once
+// the cache is full new equations are simply not remembered.
+void Device::CacheMetaEquation(
+    const MetaEquationKey&    key,
+    const CachedMetaEquation& equation
+    ) const
+{
+    MutexAuto lock(&m_metaEquationLock);
+
+    if (m_metaEquationCache.GetNumEntries() < MaxCachedMetaEquations)
+    {
+        bool                existed = false;
+        CachedMetaEquation* pEntry  = nullptr;
+
+        if ((m_metaEquationCache.FindAllocate(key, &existed, &pEntry) == Result::Success) && (existed == false))
+        {
+            *pEntry = equation;
+        }
+    }
+}
+
 // =====================================================================================================================
 // Sets up the hardware workaround/support flags based on the current ASIC
 void Device::SetupWorkarounds()
@@ -389,6 +452,22 @@ Result Device::Finalize()
 {
     Result result = GfxDevice::Finalize();
 
+    // The state image caches must be enabled before RsrcProcMgr creates its state objects so those get interned too.
+    if ((result == Result::Success) && m_pParent->InternStateObjects())
+    {
+        result = m_colorBlendStateCache.Init();
+
+        if (result == Result::Success)
+        {
+            result = m_depthStencilStateCache.Init();
+        }
+
+        if (result == Result::Success)
+        {
+            result = m_msaaStateCache.Init();
+        }
+    }
+
     if (result == Result::Success)
     {
         result = m_pRsrcProcMgr->LateInit();
@@ -1173,7 +1252,8 @@ size_t Device::GetColorBlendStateSize(
         *pResult = Result::Success;
     }
 
-    return sizeof(ColorBlendState);
+    // State objects which don't use an interned image store their own right after the object.
+    return (sizeof(ColorBlendState) + (m_colorBlendStateCache.IsEnabled() ? 0 : sizeof(ColorBlendStateImage)));
 }
 
 // =====================================================================================================================
@@ -1183,10 +1263,34 @@ Result Device::CreateColorBlendState(
     IColorBlendState**               ppColorBlendState
     ) const
 {
-    *ppColorBlendState = PAL_PLACEMENT_NEW(pPlacementAddr) ColorBlendState(*this, createInfo);
-    PAL_ASSERT(*ppColorBlendState != nullptr);
+    Result                      result     = Result::Success;
+    const ColorBlendStateImage* pImage     = nullptr;
+    const bool                  isInterned = m_colorBlendStateCache.IsEnabled();
 
-    return Result::Success;
+    if (isInterned)
+    {
+        pImage = m_colorBlendStateCache.Acquire(*this, createInfo);
+    }
+    else
+    {
+        ColorBlendStateImage*const pOwnImage =
+            static_cast<ColorBlendStateImage*>(VoidPtrInc(pPlacementAddr, sizeof(ColorBlendState)));
+
+        ColorBlendState::InitImage(*this, createInfo, pOwnImage);
+        pImage = pOwnImage;
+    }
+
+    if (pImage != nullptr)
+    {
+        *ppColorBlendState = PAL_PLACEMENT_NEW(pPlacementAddr) ColorBlendState(*this, *pImage, isInterned);
+        PAL_ASSERT(*ppColorBlendState != nullptr);
+    }
+    else
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -1200,7 +1304,8 @@ size_t Device::GetDepthStencilStateSize(
         (*pResult) = Result::Success;
     }
 
-    return sizeof(DepthStencilState);
+    // State objects which don't use an interned image store their own right after the object.
+    return (sizeof(DepthStencilState) + (m_depthStencilStateCache.IsEnabled() ? 0 : sizeof(DepthStencilStateImage)));
 }
 
 // =====================================================================================================================
@@ -1210,10 +1315,34 @@ Result Device::CreateDepthStencilState(
     IDepthStencilState**               ppDepthStencilState
     ) const
 {
-    *ppDepthStencilState = PAL_PLACEMENT_NEW(pPlacementAddr) DepthStencilState(createInfo);
-    PAL_ASSERT(*ppDepthStencilState != nullptr);
+    Result                        result     = Result::Success;
+    const DepthStencilStateImage* pImage     = nullptr;
+    const bool                    isInterned = m_depthStencilStateCache.IsEnabled();
 
-    return Result::Success;
+    if (isInterned)
+    {
+        pImage = m_depthStencilStateCache.Acquire(*this, createInfo);
+    }
+    else
+    {
+        DepthStencilStateImage*const pOwnImage =
+            static_cast<DepthStencilStateImage*>(VoidPtrInc(pPlacementAddr, sizeof(DepthStencilState)));
+
+        DepthStencilState::InitImage(*this, createInfo, pOwnImage);
+        pImage = pOwnImage;
+    }
+
+    if (pImage != nullptr)
+    {
+        *ppDepthStencilState = PAL_PLACEMENT_NEW(pPlacementAddr) DepthStencilState(*this, *pImage, isInterned);
+        PAL_ASSERT(*ppDepthStencilState != nullptr);
+    }
+    else
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -1227,7 +1356,8 @@ size_t Device::GetMsaaStateSize(
         (*pResult) = Result::Success;
     }
 
-    return sizeof(MsaaState);
+    // State objects which don't use an interned image store their own right after the object.
+    return (sizeof(MsaaState) + (m_msaaStateCache.IsEnabled() ? 0 : sizeof(MsaaStateImage)));
 }
 
 // =====================================================================================================================
@@ -1237,10 +1367,33 @@ Result Device::CreateMsaaState(
     IMsaaState**               ppMsaaState
     ) const
 {
-    *ppMsaaState = PAL_PLACEMENT_NEW(pPlacementAddr) MsaaState(*this, createInfo);
-    PAL_ASSERT(*ppMsaaState != nullptr);
+    Result                result     = Result::Success;
+    const MsaaStateImage* pImage     = nullptr;
+    const bool            isInterned = m_msaaStateCache.IsEnabled();
 
-    return Result::Success;
+    if (isInterned)
+    {
+        pImage = m_msaaStateCache.Acquire(*this, createInfo);
+    }
+    else
+    {
+        MsaaStateImage*const pOwnImage = static_cast<MsaaStateImage*>(VoidPtrInc(pPlacementAddr, sizeof(MsaaState)));
+
+        MsaaState::InitImage(*this, createInfo, pOwnImage);
+        pImage = pOwnImage;
+    }
+
+    if (pImage != nullptr)
+    {
+        *ppMsaaState = PAL_PLACEMENT_NEW(pPlacementAddr) MsaaState(*this, *pImage, isInterned);
+        PAL_ASSERT(*ppMsaaState != nullptr);
+    }
+    else
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
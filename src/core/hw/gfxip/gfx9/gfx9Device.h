@@ -28,12 +28,17 @@
 #include "core/device.h"
 #include "core/hw/gfxip/gfx9/g_gfx9PalSettings.h"
 #include "core/hw/gfxip/gfx9/gfx9CmdUtil.h"
+#include "core/hw/gfxip/gfx9/gfx9ColorBlendState.h"
+#include "core/hw/gfxip/gfx9/gfx9DepthStencilState.h"
 #include "core/hw/gfxip/gfx9/gfx9MetaEq.h"
+#include "core/hw/gfxip/gfx9/gfx9MsaaState.h"
 #include "core/hw/gfxip/gfx9/gfx9SettingsLoader.h"
 #include "core/hw/gfxip/gfx9/gfx9ShaderRingSet.h"
 #include "core/hw/gfxip/gfxDevice.h"
 #include "core/hw/gfxip/rpm/gfx9/gfx9RsrcProcMgr.h"
+#include "core/hw/gfxip/stateImageCache.h"
 
+#include "palFlatHashMap.h"
 #include "palPipelineAbi.h"
 
 namespace Pal
@@ -261,6 +266,17 @@ public:
         const MsaaStateCreateInfo& createInfo,
         void*                      pPlacementAddr,
         IMsaaState**               ppMsaaState) const override;
+
+    // Drop a state object's reference to its interned hardware image.
+    void ReleaseColorBlendStateImage(const ColorBlendStateImage* pImage) const
+        { m_colorBlendStateCache.Release(pImage); }
+    void ReleaseDepthStencilStateImage(const DepthStencilStateImage* pImage) const
+        { m_depthStencilStateCache.Release(pImage); }
+    void ReleaseMsaaStateImage(const MsaaStateImage* pImage) const { m_msaaStateCache.Release(pImage); }
+
+    bool FindMetaEquation(const MetaEquationKey& key, CachedMetaEquation* pEquation) const;
+    void CacheMetaEquation(const MetaEquationKey& key, const CachedMetaEquation& equation) const;
+
     virtual size_t GetImageSize(const ImageCreateInfo& createInfo) const override;
     virtual void CreateImage(
         Pal::Image* pParentImage,
@@ -783,6 +799,25 @@ private:
 
     uint16         m_firstUserDataReg[HwShaderStage::Last];
 
+    // Interned hardware images of immutable state objects, only enabled if the client asked for it when finalizing the
+    // device. These are mutable because the IDevice state object creation functions are const.
+    mutable StateImageCache<ColorBlendState>   m_colorBlendStateCache;
+    mutable StateImageCache<DepthStencilState> m_depthStencilStateCache;
+    mutable StateImageCache<MsaaState>         m_msaaStateCache;
+
+    // Finalized mask-ram meta equations, shared between identically-described images. Generating an equation is a
+    // large part of the cost of creating an image with metadata, so this holds up to MaxCachedMetaEquations of them.
+    static constexpr uint32 MaxCachedMetaEquations   = 256;
+    static constexpr uint32 MetaEquationCacheBuckets = 32;
+
+    typedef Util::FlatHashMap<MetaEquationKey,
+                              CachedMetaEquation,
+                              Platform,
+                              Util::JenkinsHashFunc> MetaEquationMap;
+
+    mutable Util::Mutex     m_metaEquationLock;
+    mutable MetaEquationMap m_metaEquationCache;
+
     PAL_DISALLOW_DEFAULT_CTOR(Device);
     PAL_DISALLOW_COPY_AND_ASSIGN(Device);
 };
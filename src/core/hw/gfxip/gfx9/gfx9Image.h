@@ -236,6 +236,9 @@ public:
 
     virtual bool HasDisplayDccData() const override { return (m_pDispDcc[0] != nullptr); }
 
+    virtual bool HasMaskRam() const override
+        { return HasHtileData() || HasColorMetaData() || (m_pCmask != nullptr) || HasDisplayDccData(); }
+
     // Returns a pointer to the hTile object associated with this image
     const Gfx9Htile* GetHtile() const
         { return (HasHtileData() ? m_pHtile : nullptr); }
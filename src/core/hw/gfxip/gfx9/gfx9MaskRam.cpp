@@ -947,6 +947,12 @@ void Gfx9MetaEqGenerator::FinalizeMetaEquation(
 
     m_meta.PrintEquation(m_pParent->GetGfxDevice()->Parent());
 
+#if PAL_ENABLE_PRINTS_ASSERTS
+    // Every finalized equation (one per swizzle mode and mask-ram type in use) doubles as a check of the batch solver
+    // against the reference CpuSolve().
+    PAL_ASSERT(MetaDataAddrSolver(m_meta).MatchesCpuSolve(m_meta));
+#endif
+
     // Determine how many sample bits are needed to process this equation.
     m_effectiveSamples = m_meta.GetNumSamples();
 
@@ -1240,18 +1246,92 @@ void Gfx9MetaEqGenerator::CpuUploadEq(
 void Gfx9MetaEqGenerator::CalcMetaEquation()
 {
     const Pal::Image*  pParent   = m_pParent->GetImage().Parent();
-    const Pal::Device& palDevice = *(m_pParent->GetGfxDevice()->Parent());
+    const Device*      pDevice   = m_pParent->GetGfxDevice();
+    const Pal::Device& palDevice = *(pDevice->Parent());
+
+    // The equation only depends on the device and on how this mask-ram and its image are described, so identically
+    // created images can reuse an equation that has already been generated and finalized.
+    MetaEquationKey key = {};
+    BuildMetaEquationKey(&key);
 
-    if (IsGfx9(palDevice))
+    CachedMetaEquation cached = {};
+
+    if (pDevice->FindMetaEquation(key, &cached))
     {
-        CalcMetaEquationGfx9();
+        m_meta.RestoreState(cached.meta);
+
+        m_metaEqParam            = cached.metaEqParam;
+        m_effectiveSamples       = cached.effectiveSamples;
+        m_rbAppendedWithPipeBits = cached.rbAppendedWithPipeBits;
+        m_metaEquationValid      = true;
     }
-    else if (IsGfx10(palDevice))
+    else
     {
-        CalcMetaEquationGfx10();
+        if (IsGfx9(palDevice))
+        {
+            CalcMetaEquationGfx9();
+        }
+        else if (IsGfx10(palDevice))
+        {
+            CalcMetaEquationGfx10();
+        }
+
+        if (m_metaEquationValid)
+        {
+            m_meta.SaveState(&cached.meta);
+
+            cached.metaEqParam            = m_metaEqParam;
+            cached.effectiveSamples       = m_effectiveSamples;
+            cached.rbAppendedWithPipeBits = m_rbAppendedWithPipeBits;
+
+            pDevice->CacheMetaEquation(key, cached);
+        }
     }
 }
 
+// =====================================================================================================================
+// Fills out the key which identifies this mask-ram's meta equation in the device's meta equation cache.
+void Gfx9MetaEqGenerator::BuildMetaEquationKey(
+    MetaEquationKey* pKey
+    ) const
+{
+    const ImageCreateInfo& createInfo = m_pParent->GetImage().Parent()->GetImageCreateInfo();
+
+    Gfx9MaskRamBlockSize compBlockLog2 = {};
+    Gfx9MaskRamBlockSize metaBlockLog2 = {};
+    m_pParent->CalcCompBlkSizeLog2(&compBlockLog2);
+    m_pParent->CalcMetaBlkSizeLog2(&metaBlockLog2);
+
+    pKey->maskRamSize          = m_pParent->TotalSize();
+    pKey->maskRamType          = m_pParent->IsColor() ? MetaDataDcc : (m_pParent->IsDepth() ? MetaDataHtile
+                                                                                              : MetaDataCmask);
+    pKey->metaFlags            = m_pParent->GetMetaFlags().value;
+    pKey->swizzleMode          = m_pParent->GetSwizzleMode();
+    pKey->pipeAligned          = m_pParent->PipeAligned();
+    pKey->pipeDist             = m_pipeDist;
+    pKey->bppLog2              = m_pParent->GetBytesPerPixelLog2();
+    pKey->numSamplesLog2       = m_pParent->GetNumSamplesLog2();
+    pKey->metaDataWordSizeLog2 = m_metaDataWordSizeLog2;
+    pKey->firstUploadBit       = m_firstUploadBit;
+    pKey->compBlkSizeLog2[0]   = compBlockLog2.width;
+    pKey->compBlkSizeLog2[1]   = compBlockLog2.height;
+    pKey->compBlkSizeLog2[2]   = compBlockLog2.depth;
+    pKey->metaBlkSizeLog2[0]   = metaBlockLog2.width;
+    pKey->metaBlkSizeLog2[1]   = metaBlockLog2.height;
+    pKey->metaBlkSizeLog2[2]   = metaBlockLog2.depth;
+    pKey->imageType            = static_cast<uint32>(createInfo.imageType);
+    pKey->extent[0]            = createInfo.extent.width;
+    pKey->extent[1]            = createInfo.extent.height;
+    pKey->extent[2]            = createInfo.extent.depth;
+    pKey->mipLevels            = createInfo.mipLevels;
+    pKey->arraySize            = createInfo.arraySize;
+    pKey->samples              = createInfo.samples;
+    pKey->fragments            = createInfo.fragments;
+    pKey->usageFlags           = createInfo.usageFlags.u32All;
+    pKey->createFlags          = createInfo.flags.u32All;
+    pKey->format               = static_cast<uint32>(createInfo.swizzledFormat.format);
+}
+
 // =====================================================================================================================
 void Gfx9MetaEqGenerator::AddMetaPipeBits(
     MetaDataAddrEquation* pPipe,
@@ -2798,7 +2878,7 @@ Result Gfx9Htile::ComputeHtileInfo(
     addrHtileIn.hTileFlags        = GetMetaFlags();
     addrHtileIn.firstMipIdInTail  = pParentSurfAddrOut->firstMipIdInTail;
 
-    const ADDR_E_RETURNCODE addrRet = Addr2ComputeHtileInfo(device.AddrLibHandle(), &addrHtileIn, &m_addrOutput);
+    const ADDR_E_RETURNCODE addrRet = pAddrMgr->ComputeHtileInfo(addrHtileIn, &m_addrOutput);
     PAL_ASSERT(addrRet == ADDR_OK);
 
     if (addrRet == ADDR_OK)
@@ -3296,7 +3376,7 @@ Result Gfx9Dcc::ComputeDccInfo(
     dccInfoInput.dataSurfaceSize  = static_cast<UINT_32>(m_image.GetAddrOutput(pSubResInfo)->surfSize);
     dccInfoInput.firstMipIdInTail = pParentSurfAddrOut->firstMipIdInTail;
 
-    const ADDR_E_RETURNCODE addrRet = Addr2ComputeDccInfo(pDevice->AddrLibHandle(), &dccInfoInput, &m_addrOutput);
+    const ADDR_E_RETURNCODE addrRet = pAddrMgr->ComputeDccInfo(dccInfoInput, &m_addrOutput);
     PAL_ASSERT(addrRet == ADDR_OK);
 
     if (addrRet == ADDR_OK)
@@ -4024,9 +4104,7 @@ Result Gfx9Cmask::ComputeCmaskInfo()
     cMaskInput.swizzleMode     = pFmask->GetSwizzleMode();
     cMaskInput.cMaskFlags      = GetMetaFlags();
 
-    const ADDR_E_RETURNCODE  addrRet = Addr2ComputeCmaskInfo(pDevice->AddrLibHandle(),
-                                                             &cMaskInput,
-                                                             &m_addrOutput);
+    const ADDR_E_RETURNCODE  addrRet = pAddrMgr->ComputeCmaskInfo(cMaskInput, &m_addrOutput);
 
     if (addrRet == ADDR_OK)
     {
@@ -262,6 +262,7 @@ protected:
     const int32           m_metaDataWordSizeLog2;
 
 private:
+    void   BuildMetaEquationKey(MetaEquationKey* pKey) const;
     void   CalcMetaEquationGfx9();
     void   CalcMetaEquationGfx10();
     void   CalcDataOffsetEquation(MetaDataAddrEquation* pDataOffset);
@@ -671,6 +671,29 @@ void MetaDataAddrEquation::SetEquationSize(
     m_maxBits = numBits;
 }
 
+// =====================================================================================================================
+// Copies this equation into the given state structure.
+void MetaDataAddrEquation::SaveState(
+    MetaDataAddrEquationState* pState
+    ) const
+{
+    pState->maxBits = m_maxBits;
+
+    memcpy(&pState->firstPair[0], &m_firstPair[0], sizeof(m_firstPair));
+    memcpy(&pState->equation[0][0], &m_equation[0][0], sizeof(m_equation));
+}
+
+// =====================================================================================================================
+// Replaces this equation with one previously saved by SaveState().
+void MetaDataAddrEquation::RestoreState(
+    const MetaDataAddrEquationState& state)
+{
+    m_maxBits = state.maxBits;
+
+    memcpy(&m_firstPair[0], &state.firstPair[0], sizeof(m_firstPair));
+    memcpy(&m_equation[0][0], &state.equation[0][0], sizeof(m_equation));
+}
+
 // =====================================================================================================================
 void MetaDataAddrEquation::GenerateMetaEqParamConst(
     const Image&       image,
@@ -1120,5 +1143,133 @@ void MetaDataAddrEquation::Rotate(
     }
 }
 
+//=============== Implementation for MetaDataAddrSolver: ===============================================================
+// =====================================================================================================================
+MetaDataAddrSolver::MetaDataAddrSolver(
+    const MetaDataAddrEquation& equation)
+{
+    memset(&m_columns[0][0], 0, sizeof(m_columns));
+
+    for (uint32 bitPos = 0; bitPos < equation.GetNumValidBits(); bitPos++)
+    {
+        for (uint32 compType = 0; compType < MetaDataAddrCompNumTypes; compType++)
+        {
+            uint32 compMask = equation.Get(bitPos, compType);
+            uint32 compPos  = 0;
+
+            while (BitMaskScanForward(&compPos, compMask))
+            {
+                m_columns[compType][compPos] |= (1u << bitPos);
+                compMask                     &= ~(1u << compPos);
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Returns the equation bits produced by one input component.
+uint32 MetaDataAddrSolver::SolveComponent(
+    MetaDataAddrComponentType compType,
+    uint32                    value
+    ) const
+{
+    uint32 result  = 0;
+    uint32 compPos = 0;
+
+    while (BitMaskScanForward(&compPos, value))
+    {
+        result ^= m_columns[compType][compPos];
+        value  &= ~(1u << compPos);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Solves the meta-equation for a single coordinate.  The return value is in the same units as CpuSolve().
+uint32 MetaDataAddrSolver::Solve(
+    uint32  x,         // cartesian coordinates
+    uint32  y,
+    uint32  z,         // which slice of either a 2d array or 3d volume
+    uint32  sample,    // which msaa sample
+    uint32  metaBlock  // which metablock
+    ) const
+{
+    return SolveComponent(MetaDataAddrCompX, x)      ^
+           SolveComponent(MetaDataAddrCompY, y)      ^
+           SolveComponent(MetaDataAddrCompZ, z)      ^
+           SolveComponent(MetaDataAddrCompS, sample) ^
+           SolveComponent(MetaDataAddrCompM, metaBlock);
+}
+
+// =====================================================================================================================
+// Solves the meta-equation for "numOutputs" horizontally consecutive coordinates starting at x.  The y, z, sample and
+// metablock terms are only solved once.  Stepping from x to x + 1 only flips the bits in (x ^ (x + 1)), which
+// is a single bit half of the time, so each output costs about two XORs.
+void MetaDataAddrSolver::SolveRow(
+    uint32  x,
+    uint32  y,
+    uint32  z,
+    uint32  sample,
+    uint32  metaBlock,
+    uint32  numOutputs,
+    uint32* pOutputs    // [out] Receives numOutputs results
+    ) const
+{
+    PAL_ASSERT((pOutputs != nullptr) || (numOutputs == 0));
+
+    uint32 offset = Solve(x, y, z, sample, metaBlock);
+
+    for (uint32 idx = 0; idx < numOutputs; idx++)
+    {
+        pOutputs[idx] = offset;
+
+        offset ^= SolveComponent(MetaDataAddrCompX, x ^ (x + 1));
+        x++;
+    }
+}
+
+// =====================================================================================================================
+// Returns true if this solver gives the same results as equation.CpuSolve() for every possible input.  Both solves are
+// linear over GF(2) in each input, so comparing them on zero and on every single-bit input of every component covers
+// all inputs.  SolveRow() is checked separately since it takes a different path, including across carries in x.
+bool MetaDataAddrSolver::MatchesCpuSolve(
+    const MetaDataAddrEquation& equation
+    ) const
+{
+    bool matches = (Solve(0, 0, 0, 0, 0) == equation.CpuSolve(0, 0, 0, 0, 0));
+
+    for (uint32 compType = 0; (compType < MetaDataAddrCompNumTypes) && matches; compType++)
+    {
+        for (uint32 compPos = 0; (compPos < MetaDataAddrEquation::MaxNumMetaDataAddrBits) && matches; compPos++)
+        {
+            uint32 input[MetaDataAddrCompNumTypes] = {};
+            input[compType] = (1u << compPos);
+
+            matches = (Solve(input[0], input[1], input[2], input[3], input[4]) ==
+                       equation.CpuSolve(input[0], input[1], input[2], input[3], input[4]));
+        }
+    }
+
+    // Start each row just below a power of two so that stepping x carries through several bits, the last one wraps.
+    constexpr uint32 RowLength = 8;
+    uint32           row[RowLength];
+
+    for (uint32 rowStartLog2 = 2; (rowStartLog2 <= MetaDataAddrEquation::MaxNumMetaDataAddrBits) && matches;
+         rowStartLog2++)
+    {
+        const uint32 x = static_cast<uint32>((uint64(1) << rowStartLog2) - (RowLength / 2));
+
+        SolveRow(x, 1, 1, 1, 1, RowLength, row);
+
+        for (uint32 idx = 0; (idx < RowLength) && matches; idx++)
+        {
+            matches = (row[idx] == equation.CpuSolve(x + idx, 1, 1, 1, 1));
+        }
+    }
+
+    return matches;
+}
+
 } // Gfx9
 } // Pal
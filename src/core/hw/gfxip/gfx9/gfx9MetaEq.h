@@ -84,6 +84,8 @@ struct CompPair
 // 0xFF = -1 when interpreted as a signed number which is what the CompareCompPair function does.
 static const uint8  MinMetaEqCompPos = 0xFF;
 
+struct MetaDataAddrEquationState;
+
 // =====================================================================================================================
 // One instance of a "MetaDataAddrEquation" object is one equation -- i.e., all the bits.
 // One equation is something like:
@@ -225,6 +227,9 @@ public:
     void AdjustPipe(int32  num_pipes_log2, int32  offset, bool   undo = false);
     void Rotate(int32 amount, int32 start, int32 end);
 
+    void SaveState(MetaDataAddrEquationState* pState) const;
+    void RestoreState(const MetaDataAddrEquationState& state);
+
 private:
     void ClearBitPos(uint32  bitPos);
     void FilterOneCompType(
@@ -256,5 +261,95 @@ private:
     uint32  m_equation[MaxNumMetaDataAddrBits][MetaDataAddrCompNumTypes];
 };
 
+// A plain copy of everything a MetaDataAddrEquation computes, so finalized equations can be kept in a cache.
+struct MetaDataAddrEquationState
+{
+    uint32    maxBits;
+    CompPair  firstPair[MetaDataAddrEquation::MaxNumMetaDataAddrBits];
+    uint32    equation[MetaDataAddrEquation::MaxNumMetaDataAddrBits][MetaDataAddrCompNumTypes];
+};
+
+// =====================================================================================================================
+// A transposed copy of a MetaDataAddrEquation for evaluating many coordinates on the CPU (e.g., to initialize or
+// validate metadata without the GPU).  Meta equations are linear over GF(2): every bit of every input component
+// toggles a fixed set of equation bits.  Solving therefore XORs together the columns selected by each input's set bits
+// rather than counting set bits once per component for every equation bit like MetaDataAddrEquation::CpuSolve() does.
+// Results are identical to CpuSolve().
+class MetaDataAddrSolver
+{
+public:
+    explicit MetaDataAddrSolver(const MetaDataAddrEquation& equation);
+    ~MetaDataAddrSolver() {}
+
+    uint32 Solve(
+        uint32  x,
+        uint32  y,
+        uint32  z,
+        uint32  sample,
+        uint32  metaBlock) const;
+
+    void SolveRow(
+        uint32  x,
+        uint32  y,
+        uint32  z,
+        uint32  sample,
+        uint32  metaBlock,
+        uint32  numOutputs,
+        uint32* pOutputs) const;
+
+    bool MatchesCpuSolve(const MetaDataAddrEquation& equation) const;
+
+private:
+    uint32 SolveComponent(
+        MetaDataAddrComponentType compType,
+        uint32                    value) const;
+
+    // m_columns[compType][compPos] is the set of equation bits which the "compPos" bit of that component toggles.
+    uint32  m_columns[MetaDataAddrCompNumTypes][MetaDataAddrEquation::MaxNumMetaDataAddrBits];
+
+    PAL_DISALLOW_DEFAULT_CTOR(MetaDataAddrSolver);
+    PAL_DISALLOW_COPY_AND_ASSIGN(MetaDataAddrSolver);
+};
+
+// Everything a mask-ram's meta equation depends on besides the device itself.  Mask-rams of identically-described
+// images produce the same key and can share one finalized equation.  Keys are hashed and compared bytewise, so this
+// must not contain any padding.
+struct MetaEquationKey
+{
+    gpusize maskRamSize;
+    uint32  maskRamType;           // A MetaDataType
+    uint32  metaFlags;
+    uint32  swizzleMode;
+    uint32  pipeAligned;
+    uint32  pipeDist;
+    uint32  bppLog2;
+    uint32  numSamplesLog2;
+    uint32  metaDataWordSizeLog2;
+    uint32  firstUploadBit;
+    uint32  compBlkSizeLog2[3];
+    uint32  metaBlkSizeLog2[3];
+    uint32  imageType;
+    uint32  extent[3];
+    uint32  mipLevels;
+    uint32  arraySize;
+    uint32  samples;
+    uint32  fragments;
+    uint32  usageFlags;
+    uint32  createFlags;
+    uint32  format;
+};
+
+static_assert(sizeof(MetaEquationKey) == (sizeof(gpusize) + (26 * sizeof(uint32))),
+              "MetaEquationKey must not contain padding.");
+
+// The finalized state of a mask-ram's meta equation generator.
+struct CachedMetaEquation
+{
+    MetaDataAddrEquationState meta;
+    MetaEquationParam         metaEqParam;
+    uint32                    effectiveSamples;
+    uint32                    rbAppendedWithPipeBits;
+};
+
 } // Gfx9
 } // Pal
@@ -58,20 +58,45 @@ struct PaScSampleQuad
 
 // =====================================================================================================================
 MsaaState::MsaaState(
-    const Device&              device,
-    const MsaaStateCreateInfo& createInfo)
+    const Device&         device,
+    const MsaaStateImage& image,
+    bool                  isInterned)
     :
     Pal::MsaaState(),
-    m_log2Samples(0),
-    m_log2OcclusionQuerySamples(0)
+    m_device(device),
+    m_image(image),
+    m_isInterned(isInterned)
 {
-    m_paScAaConfig.u32All = 0;
+}
 
-    m_flags.u32All = 0;
-    m_flags.waFixPostZConservativeRasterization = device.Settings().waFixPostZConservativeRasterization;
+// =====================================================================================================================
+MsaaState::~MsaaState()
+{
+    if (m_isInterned)
+    {
+        m_device.ReleaseMsaaStateImage(&m_image);
+    }
+}
 
-    memset(&m_regs, 0, sizeof(m_regs));
-    Init(device, createInfo);
+// =====================================================================================================================
+// Copies the fields of an MSAA state create info which affect the hardware image into a zeroed interning key, leaving
+// any padding and reserved bits zero.
+void MsaaState::BuildImageKey(
+    const MsaaStateCreateInfo& msaaState,
+    MsaaStateCreateInfo*       pKey)
+{
+    pKey->coverageSamples               = msaaState.coverageSamples;
+    pKey->exposedSamples                = msaaState.exposedSamples;
+    pKey->pixelShaderSamples            = msaaState.pixelShaderSamples;
+    pKey->depthStencilSamples           = msaaState.depthStencilSamples;
+    pKey->shaderExportMaskSamples       = msaaState.shaderExportMaskSamples;
+    pKey->sampleMask                    = msaaState.sampleMask;
+    pKey->sampleClusters                = msaaState.sampleClusters;
+    pKey->alphaToCoverageSamples        = msaaState.alphaToCoverageSamples;
+    pKey->occlusionQuerySamples         = msaaState.occlusionQuerySamples;
+    pKey->conservativeRasterizationMode = msaaState.conservativeRasterizationMode;
+    pKey->flags.u32All                  = msaaState.flags.u32All;
+    pKey->flags.reserved                = 0;
 }
 
 // =====================================================================================================================
@@ -81,19 +106,19 @@ uint32* MsaaState::WriteCommands(
     uint32*    pCmdSpace
     ) const
 {
-    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_EQAA, m_regs.dbEqaa.u32All, pCmdSpace);
+    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_EQAA, m_image.regs.dbEqaa.u32All, pCmdSpace);
     pCmdSpace = pCmdStream->WriteSetSeqContextRegs(mmPA_SC_AA_MASK_X0Y0_X1Y0,
                                                    mmPA_SC_AA_MASK_X0Y1_X1Y1,
-                                                   &m_regs.paScAaMask1,
+                                                   &m_image.regs.paScAaMask1,
                                                    pCmdSpace);
-    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmPA_SC_MODE_CNTL_0, m_regs.paScModeCntl0.u32All, pCmdSpace);
-    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_ALPHA_TO_MASK, m_regs.dbAlphaToMask.u32All, pCmdSpace);
+    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmPA_SC_MODE_CNTL_0, m_image.regs.paScModeCntl0.u32All, pCmdSpace);
+    pCmdSpace = pCmdStream->WriteSetOneContextReg(mmDB_ALPHA_TO_MASK, m_image.regs.dbAlphaToMask.u32All, pCmdSpace);
 
-    if (m_flags.waFixPostZConservativeRasterization != 0)
+    if (m_image.flags.waFixPostZConservativeRasterization != 0)
     {
         pCmdSpace = pCmdStream->WriteContextRegRmw(Nv10::mmDB_RESERVED_REG_2,
                                                    static_cast<uint32>(~Nv10::DB_RESERVED_REG_2__FIELD_1_MASK),
-                                                   m_regs.dbReservedReg2,
+                                                   m_image.regs.dbReservedReg2,
                                                    pCmdSpace);
     }
 
@@ -102,18 +127,25 @@ uint32* MsaaState::WriteCommands(
 
 // =====================================================================================================================
 // Pre-constructs all the packets required to set the MSAA state
-void MsaaState::Init(
+void MsaaState::InitImage(
     const Device&              device,
-    const MsaaStateCreateInfo& msaaState)
+    const MsaaStateCreateInfo& msaaState,
+    MsaaStateImage*            pImage)
 {
     const auto& settings = GetGfx9Settings(*device.Parent());
 
-    m_log2Samples               = Log2(msaaState.coverageSamples);
-    m_log2OcclusionQuerySamples = Log2(msaaState.occlusionQuerySamples);
+    memset(pImage, 0, sizeof(*pImage));
+
+    pImage->flags.waFixPostZConservativeRasterization = device.Settings().waFixPostZConservativeRasterization;
+
+    pImage->log2Samples               = Log2(msaaState.coverageSamples);
+    pImage->log2OcclusionQuerySamples = Log2(msaaState.occlusionQuerySamples);
+
+    const uint32 numSamples = (1 << pImage->log2Samples);
 
     // Use the supplied sample mask to initialize the PA_SC_AA_MASK_** registers:
-    uint32 usedMask    = (msaaState.sampleMask & ((1 << NumSamples()) - 1));
-    uint32 maskSamples = NumSamples();
+    uint32 usedMask    = (msaaState.sampleMask & ((1 << numSamples) - 1));
+    uint32 maskSamples = numSamples;
 
     // HW requires us to replicate the sample mask to all 16 bits if there are fewer than 16 samples active.
     while (maskSamples < 16)
@@ -122,42 +154,42 @@ void MsaaState::Init(
         maskSamples <<= 1;
     }
 
-    m_regs.paScAaMask1.u32All = ((usedMask << 16) | usedMask);
-    m_regs.paScAaMask2.u32All = ((usedMask << 16) | usedMask);
+    pImage->regs.paScAaMask1.u32All = ((usedMask << 16) | usedMask);
+    pImage->regs.paScAaMask2.u32All = ((usedMask << 16) | usedMask);
 
     // Setup the PA_SC_MODE_CNTL_0 register
-    m_regs.paScModeCntl0.u32All = 0;
-    m_regs.paScModeCntl0.bits.LINE_STIPPLE_ENABLE  = msaaState.flags.enableLineStipple;
-    m_regs.paScModeCntl0.bits.VPORT_SCISSOR_ENABLE = 1;
-    m_regs.paScModeCntl0.bits.MSAA_ENABLE          = (((NumSamples() > 1) ||
+    pImage->regs.paScModeCntl0.u32All = 0;
+    pImage->regs.paScModeCntl0.bits.LINE_STIPPLE_ENABLE  = msaaState.flags.enableLineStipple;
+    pImage->regs.paScModeCntl0.bits.VPORT_SCISSOR_ENABLE = 1;
+    pImage->regs.paScModeCntl0.bits.MSAA_ENABLE          = (((numSamples > 1) ||
                                                       (msaaState.flags.enable1xMsaaSampleLocations)) ? 1 : 0);
 
     {
-        m_regs.paScModeCntl0.core.ALTERNATE_RBS_PER_TILE = 1;
+        pImage->regs.paScModeCntl0.core.ALTERNATE_RBS_PER_TILE = 1;
     }
 
     // Setup the PA_SC_AA_CONFIG and DB_EQAA registers.
-    m_regs.dbEqaa.bits.STATIC_ANCHOR_ASSOCIATIONS = 1;
-    m_regs.dbEqaa.bits.HIGH_QUALITY_INTERSECTIONS = 1;
-    m_regs.dbEqaa.bits.INCOHERENT_EQAA_READS      = 1;
-    m_regs.dbEqaa.bits.INTERPOLATE_COMP_Z         = 1;
+    pImage->regs.dbEqaa.bits.STATIC_ANCHOR_ASSOCIATIONS = 1;
+    pImage->regs.dbEqaa.bits.HIGH_QUALITY_INTERSECTIONS = 1;
+    pImage->regs.dbEqaa.bits.INCOHERENT_EQAA_READS      = 1;
+    pImage->regs.dbEqaa.bits.INTERPOLATE_COMP_Z         = 1;
 
     if ((msaaState.coverageSamples > 1) || (msaaState.flags.enable1xMsaaSampleLocations))
     {
         const uint32 log2ShaderExportSamples = Log2(msaaState.shaderExportMaskSamples);
 
-        m_paScAaConfig.bits.MSAA_EXPOSED_SAMPLES = Log2(msaaState.exposedSamples);
+        pImage->paScAaConfig.bits.MSAA_EXPOSED_SAMPLES = Log2(msaaState.exposedSamples);
 
-        m_regs.dbEqaa.bits.MAX_ANCHOR_SAMPLES        = Log2(msaaState.depthStencilSamples);
-        m_regs.dbEqaa.bits.PS_ITER_SAMPLES           = Log2(msaaState.pixelShaderSamples);
-        m_regs.dbEqaa.bits.MASK_EXPORT_NUM_SAMPLES   = log2ShaderExportSamples;
-        m_regs.dbEqaa.bits.ALPHA_TO_MASK_NUM_SAMPLES = Log2(msaaState.alphaToCoverageSamples);
-        m_regs.dbEqaa.bits.OVERRASTERIZATION_AMOUNT  = log2ShaderExportSamples - Log2(msaaState.sampleClusters);
+        pImage->regs.dbEqaa.bits.MAX_ANCHOR_SAMPLES        = Log2(msaaState.depthStencilSamples);
+        pImage->regs.dbEqaa.bits.PS_ITER_SAMPLES           = Log2(msaaState.pixelShaderSamples);
+        pImage->regs.dbEqaa.bits.MASK_EXPORT_NUM_SAMPLES   = log2ShaderExportSamples;
+        pImage->regs.dbEqaa.bits.ALPHA_TO_MASK_NUM_SAMPLES = Log2(msaaState.alphaToCoverageSamples);
+        pImage->regs.dbEqaa.bits.OVERRASTERIZATION_AMOUNT  = log2ShaderExportSamples - Log2(msaaState.sampleClusters);
     }
 
     // The DB_SHADER_CONTROL register has a "ALPHA_TO_MASK_DISABLE" field that overrides this one.  DB_SHADER_CONTROL
     // is owned by the pipeline.  Always set this bit here and use the DB_SHADER_CONTROL to control the enabling.
-    m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_ENABLE = 1;
+    pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_ENABLE = 1;
 
     // The following code sets up the alpha to mask dithering pattern.
     // If all offsets are set to the same value then there will be no dithering, and the number of gradations of
@@ -166,51 +198,51 @@ void MsaaState::Init(
     // coverage.
     if (msaaState.flags.disableAlphaToCoverageDither)
     {
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET0 = 2;
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET1 = 2;
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET2 = 2;
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET3 = 2;
-        m_regs.dbAlphaToMask.bits.OFFSET_ROUND          = 0;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET0 = 2;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET1 = 2;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET2 = 2;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET3 = 2;
+        pImage->regs.dbAlphaToMask.bits.OFFSET_ROUND          = 0;
     }
     else
     {
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET0 = 3;
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET1 = 1;
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET2 = 0;
-        m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET3 = 2;
-        m_regs.dbAlphaToMask.bits.OFFSET_ROUND          = 1;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET0 = 3;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET1 = 1;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET2 = 0;
+        pImage->regs.dbAlphaToMask.bits.ALPHA_TO_MASK_OFFSET3 = 2;
+        pImage->regs.dbAlphaToMask.bits.OFFSET_ROUND          = 1;
     }
 
     if (msaaState.flags.enableConservativeRasterization)
     {
-        m_paScAaConfig.bits.AA_MASK_CENTROID_DTMN = 1;
+        pImage->paScAaConfig.bits.AA_MASK_CENTROID_DTMN = 1;
 
-        m_regs.paScConsRastCntl.bits.NULL_SQUAD_AA_MASK_ENABLE     = 0;
-        m_regs.paScConsRastCntl.bits.PREZ_AA_MASK_ENABLE           = 1;
-        m_regs.paScConsRastCntl.bits.POSTZ_AA_MASK_ENABLE          = 1;
-        m_regs.paScConsRastCntl.bits.CENTROID_SAMPLE_OVERRIDE      = 1;
+        pImage->regs.paScConsRastCntl.bits.NULL_SQUAD_AA_MASK_ENABLE     = 0;
+        pImage->regs.paScConsRastCntl.bits.PREZ_AA_MASK_ENABLE           = 1;
+        pImage->regs.paScConsRastCntl.bits.POSTZ_AA_MASK_ENABLE          = 1;
+        pImage->regs.paScConsRastCntl.bits.CENTROID_SAMPLE_OVERRIDE      = 1;
 
-        m_regs.dbEqaa.bits.ENABLE_POSTZ_OVERRASTERIZATION = 0;
-        m_regs.dbEqaa.bits.OVERRASTERIZATION_AMOUNT       = 4;
+        pImage->regs.dbEqaa.bits.ENABLE_POSTZ_OVERRASTERIZATION = 0;
+        pImage->regs.dbEqaa.bits.OVERRASTERIZATION_AMOUNT       = 4;
 
         switch (msaaState.conservativeRasterizationMode)
         {
         case ConservativeRasterizationMode::Overestimate:
-            m_regs.paScConsRastCntl.bits.OVER_RAST_ENABLE              = 1;
-            m_regs.paScConsRastCntl.bits.OVER_RAST_SAMPLE_SELECT       = 0;
-            m_regs.paScConsRastCntl.bits.UNDER_RAST_ENABLE             = 0;
-            m_regs.paScConsRastCntl.bits.UNDER_RAST_SAMPLE_SELECT      = 1;
-            m_regs.paScConsRastCntl.bits.PBB_UNCERTAINTY_REGION_ENABLE = 1;
-            m_regs.paScConsRastCntl.bits.COVERAGE_AA_MASK_ENABLE       = (settings.disableCoverageAaMask ? 0 : 1);
+            pImage->regs.paScConsRastCntl.bits.OVER_RAST_ENABLE              = 1;
+            pImage->regs.paScConsRastCntl.bits.OVER_RAST_SAMPLE_SELECT       = 0;
+            pImage->regs.paScConsRastCntl.bits.UNDER_RAST_ENABLE             = 0;
+            pImage->regs.paScConsRastCntl.bits.UNDER_RAST_SAMPLE_SELECT      = 1;
+            pImage->regs.paScConsRastCntl.bits.PBB_UNCERTAINTY_REGION_ENABLE = 1;
+            pImage->regs.paScConsRastCntl.bits.COVERAGE_AA_MASK_ENABLE       = (settings.disableCoverageAaMask ? 0 : 1);
             break;
 
         case ConservativeRasterizationMode::Underestimate:
-            m_regs.paScConsRastCntl.bits.OVER_RAST_ENABLE              = 0;
-            m_regs.paScConsRastCntl.bits.OVER_RAST_SAMPLE_SELECT       = 1;
-            m_regs.paScConsRastCntl.bits.UNDER_RAST_ENABLE             = 1;
-            m_regs.paScConsRastCntl.bits.UNDER_RAST_SAMPLE_SELECT      = 0;
-            m_regs.paScConsRastCntl.bits.PBB_UNCERTAINTY_REGION_ENABLE = 0;
-            m_regs.paScConsRastCntl.bits.COVERAGE_AA_MASK_ENABLE       = 0;
+            pImage->regs.paScConsRastCntl.bits.OVER_RAST_ENABLE              = 0;
+            pImage->regs.paScConsRastCntl.bits.OVER_RAST_SAMPLE_SELECT       = 1;
+            pImage->regs.paScConsRastCntl.bits.UNDER_RAST_ENABLE             = 1;
+            pImage->regs.paScConsRastCntl.bits.UNDER_RAST_SAMPLE_SELECT      = 0;
+            pImage->regs.paScConsRastCntl.bits.PBB_UNCERTAINTY_REGION_ENABLE = 0;
+            pImage->regs.paScConsRastCntl.bits.COVERAGE_AA_MASK_ENABLE       = 0;
             break;
 
         case ConservativeRasterizationMode::Count:
@@ -220,17 +252,17 @@ void MsaaState::Init(
     }
     else
     {
-        m_regs.paScConsRastCntl.bits.OVER_RAST_ENABLE              = 0;
-        m_regs.paScConsRastCntl.bits.UNDER_RAST_ENABLE             = 0;
-        m_regs.paScConsRastCntl.bits.PBB_UNCERTAINTY_REGION_ENABLE = 0;
-        m_regs.paScConsRastCntl.bits.NULL_SQUAD_AA_MASK_ENABLE     = 1;
-        m_regs.paScConsRastCntl.bits.PREZ_AA_MASK_ENABLE           = 0;
-        m_regs.paScConsRastCntl.bits.POSTZ_AA_MASK_ENABLE          = 0;
-        m_regs.paScConsRastCntl.bits.CENTROID_SAMPLE_OVERRIDE      = 0;
+        pImage->regs.paScConsRastCntl.bits.OVER_RAST_ENABLE              = 0;
+        pImage->regs.paScConsRastCntl.bits.UNDER_RAST_ENABLE             = 0;
+        pImage->regs.paScConsRastCntl.bits.PBB_UNCERTAINTY_REGION_ENABLE = 0;
+        pImage->regs.paScConsRastCntl.bits.NULL_SQUAD_AA_MASK_ENABLE     = 1;
+        pImage->regs.paScConsRastCntl.bits.PREZ_AA_MASK_ENABLE           = 0;
+        pImage->regs.paScConsRastCntl.bits.POSTZ_AA_MASK_ENABLE          = 0;
+        pImage->regs.paScConsRastCntl.bits.CENTROID_SAMPLE_OVERRIDE      = 0;
     }
 
     if (settings.waFixPostZConservativeRasterization &&
-        (TestAllFlagsSet(m_regs.paScAaMask1.u32All, ((1 << msaaState.exposedSamples) - 1)) == false))
+        (TestAllFlagsSet(pImage->regs.paScAaMask1.u32All, ((1 << msaaState.exposedSamples) - 1)) == false))
     {
         //    We have an issue in Navi10 related to Late - Z Conservative rasterization when the mask is partially lit.
         //
@@ -241,22 +273,22 @@ void MsaaState::Init(
         //    lit.  The SWA would require that when PA_SC_AA_MASK_AA_MASK is partially lit with the number of
         //    samples defined by PA_SC_AA_CONFIG_MSAA_EXPOSED_SAMPLES, software would need to write the corresponding
         //    "PARTIALLY LIT" bit for that context.
-        m_regs.dbReservedReg2 = Nv10::DB_RESERVED_REG_2__FIELD_1_MASK & 0x1;
+        pImage->regs.dbReservedReg2 = Nv10::DB_RESERVED_REG_2__FIELD_1_MASK & 0x1;
     }
 
-    if (settings.waWrite1xAASampleLocationsToZero && (m_log2Samples == 0) && (usedMask != 0))
+    if (settings.waWrite1xAASampleLocationsToZero && (pImage->log2Samples == 0) && (usedMask != 0))
     {
         // Writing to PA_SC_AA_SAMPLE_LOCS_X*Y* is not needed because it's set to all 0s in BuildPm4Headers(),
         // and the value will not be changed unless it's non-1xAA case (msaaState.coverageSamples > 1)
 
-        m_regs.paScAaMask1.bits.AA_MASK_X0Y0 = 1;
-        m_regs.paScAaMask1.bits.AA_MASK_X1Y0 = 1;
-        m_regs.paScAaMask2.bits.AA_MASK_X0Y1 = 1;
-        m_regs.paScAaMask2.bits.AA_MASK_X1Y1 = 1;
+        pImage->regs.paScAaMask1.bits.AA_MASK_X0Y0 = 1;
+        pImage->regs.paScAaMask1.bits.AA_MASK_X1Y0 = 1;
+        pImage->regs.paScAaMask2.bits.AA_MASK_X0Y1 = 1;
+        pImage->regs.paScAaMask2.bits.AA_MASK_X1Y1 = 1;
     }
 
     // Make sure we don't write outside of the state this class owns.
-    PAL_ASSERT((m_paScAaConfig.u32All & (~PcScAaConfigMask)) == 0);
+    PAL_ASSERT((pImage->paScAaConfig.u32All & (~PcScAaConfigMask)) == 0);
 }
 
 // =====================================================================================================================
@@ -36,13 +36,49 @@ namespace Gfx9
 
 class Device;
 
+// Hardware image of an MSAA state object. When state objects are interned, every MSAA state created with an identical
+// create info shares one image.
+struct MsaaStateImage
+{
+    uint32             log2Samples;
+    uint32             log2OcclusionQuerySamples;
+    regPA_SC_AA_CONFIG paScAaConfig; // This register is only written in the draw-time validation code.
+
+    union
+    {
+        struct
+        {
+            uint32 waFixPostZConservativeRasterization :  1;
+        };
+        uint32  u32All;
+    }  flags;
+
+    struct
+    {
+        regDB_EQAA                                dbEqaa;
+        regDB_ALPHA_TO_MASK                       dbAlphaToMask;
+        uint32                                    dbReservedReg2;
+        regPA_SC_AA_MASK_X0Y0_X1Y0                paScAaMask1;
+        regPA_SC_AA_MASK_X0Y1_X1Y1                paScAaMask2;
+        regPA_SC_MODE_CNTL_0                      paScModeCntl0;
+        regPA_SC_CONSERVATIVE_RASTERIZATION_CNTL  paScConsRastCntl;
+
+    }  regs;
+};
+
 // =====================================================================================================================
 // Gfx9 hardware layer MSAA State class: implements GFX9 specific functionality for the ApiStateObject class,
 // specifically for MSAA state.
 class MsaaState : public Pal::MsaaState
 {
 public:
-    MsaaState(const Device& device, const MsaaStateCreateInfo& msaaState);
+    typedef MsaaStateImage      Image;
+    typedef MsaaStateCreateInfo CreateInfo;
+
+    MsaaState(const Device& device, const MsaaStateImage& image, bool isInterned);
+
+    static void BuildImageKey(const MsaaStateCreateInfo& msaaState, MsaaStateCreateInfo* pKey);
+    static void InitImage(const Device& device, const MsaaStateCreateInfo& msaaState, MsaaStateImage* pImage);
 
     uint32* WriteCommands(CmdStream* pCmdStream, uint32* pCmdSpace) const;
 
@@ -56,51 +92,29 @@ public:
         CmdStream*                   pCmdStream,
         uint32*                      pCmdSpace);
 
-    bool UsesOverRasterization() const { return (m_regs.dbEqaa.bits.OVERRASTERIZATION_AMOUNT != 0); }
-    bool ShaderCanKill() const { return (m_regs.dbAlphaToMask.bits.ALPHA_TO_MASK_ENABLE != 0); }
-    bool UsesLineStipple() const { return (m_regs.paScModeCntl0.bits.LINE_STIPPLE_ENABLE != 0); }
-    bool ConservativeRasterizationEnabled() const { return (m_regs.paScConsRastCntl.bits.OVER_RAST_ENABLE != 0); }
+    bool UsesOverRasterization() const { return (m_image.regs.dbEqaa.bits.OVERRASTERIZATION_AMOUNT != 0); }
+    bool ShaderCanKill() const { return (m_image.regs.dbAlphaToMask.bits.ALPHA_TO_MASK_ENABLE != 0); }
+    bool UsesLineStipple() const { return (m_image.regs.paScModeCntl0.bits.LINE_STIPPLE_ENABLE != 0); }
+    bool ConservativeRasterizationEnabled() const
+        { return (m_image.regs.paScConsRastCntl.bits.OVER_RAST_ENABLE != 0); }
 
-    uint32 NumSamples() const { return (1 << m_log2Samples); }
-    uint32 Log2NumSamples() const { return m_log2Samples; }
-    uint32 Log2OcclusionQuerySamples() const { return m_log2OcclusionQuerySamples; }
+    uint32 NumSamples() const { return (1 << m_image.log2Samples); }
+    uint32 Log2NumSamples() const { return m_image.log2Samples; }
+    uint32 Log2OcclusionQuerySamples() const { return m_image.log2OcclusionQuerySamples; }
 
-    regPA_SC_CONSERVATIVE_RASTERIZATION_CNTL PaScConsRastCntl() const { return m_regs.paScConsRastCntl; }
-    regPA_SC_AA_CONFIG PaScAaConfig() const { return m_paScAaConfig; }
+    regPA_SC_CONSERVATIVE_RASTERIZATION_CNTL PaScConsRastCntl() const { return m_image.regs.paScConsRastCntl; }
+    regPA_SC_AA_CONFIG PaScAaConfig() const { return m_image.paScAaConfig; }
 
     // THis class only owns these bits in PA_SC_AA_CONFIG.
     static const uint32 PcScAaConfigMask = (PA_SC_AA_CONFIG__MSAA_EXPOSED_SAMPLES_MASK |
                                             PA_SC_AA_CONFIG__AA_MASK_CENTROID_DTMN_MASK);
 
 protected:
-    virtual ~MsaaState() { }
-
-    void Init(const Device& device, const MsaaStateCreateInfo& msaaState);
-
-    uint32             m_log2Samples;
-    uint32             m_log2OcclusionQuerySamples;
-    regPA_SC_AA_CONFIG m_paScAaConfig; // This register is only written in the draw-time validation code.
-
-    union
-    {
-        struct
-        {
-            uint32 waFixPostZConservativeRasterization :  1;
-        };
-        uint32  u32All;
-    }  m_flags;
-
-    struct
-    {
-        regDB_EQAA                                dbEqaa;
-        regDB_ALPHA_TO_MASK                       dbAlphaToMask;
-        uint32                                    dbReservedReg2;
-        regPA_SC_AA_MASK_X0Y0_X1Y0                paScAaMask1;
-        regPA_SC_AA_MASK_X0Y1_X1Y1                paScAaMask2;
-        regPA_SC_MODE_CNTL_0                      paScModeCntl0;
-        regPA_SC_CONSERVATIVE_RASTERIZATION_CNTL  paScConsRastCntl;
+    virtual ~MsaaState();
 
-    }  m_regs;
+    const Device&         m_device;
+    const MsaaStateImage& m_image;      // Either interned by the device or stored right after this object.
+    const bool            m_isInterned;
 
     PAL_DISALLOW_COPY_AND_ASSIGN(MsaaState);
     PAL_DISALLOW_DEFAULT_CTOR(MsaaState);
@@ -29,6 +29,13 @@
 #include "core/hw/gfxip/gfx9/gfx9Pm4Optimizer.h"
 #include "palAutoBuffer.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PAL_PM4_OPTIMIZER_SSE2 1
+#else
+#define PAL_PM4_OPTIMIZER_SSE2 0
+#endif
+
 using namespace Util;
 
 namespace Pal
@@ -51,16 +58,16 @@ static bool UpdateRegState(
     // - The new value is different than the old value.
     // - The previous state is invalid.
     // - We must always write this register.
-    if ((pCurRegState->state[regOffset].value           != newRegVal) ||
-        (pCurRegState->state[regOffset].flags.valid     == 0)         ||
-        (pCurRegState->state[regOffset].flags.mustWrite == 1))
+    if ((pCurRegState->value[regOffset] != newRegVal)                 ||
+        (WideBitfieldIsSet(pCurRegState->valid, regOffset) == false) ||
+        WideBitfieldIsSet(pCurRegState->mustWrite, regOffset))
     {
 #if PAL_BUILD_PM4_INSTRUMENTOR
         pCurRegState->keptSets[regOffset]++;
 #endif
 
-        pCurRegState->state[regOffset].flags.valid = 1;
-        pCurRegState->state[regOffset].value       = newRegVal;
+        WideBitfieldSetBit(pCurRegState->valid, regOffset);
+        pCurRegState->value[regOffset] = newRegVal;
 
         mustKeep = true;
     }
@@ -72,6 +79,108 @@ static bool UpdateRegState(
     return mustKeep;
 }
 
+// =====================================================================================================================
+// Returns a mask with the low numBits bits set. numBits must be in the range [1, 32].
+static uint32 RunMask(
+    uint32 numBits)
+{
+    return static_cast<uint32>(UINT32_MAX >> (32 - numBits));
+}
+
+// =====================================================================================================================
+// Reads numBits consecutive flags starting at firstBit out of a per-register flag array. numBits must be in the range
+// [1, 32]; the flag arrays are padded with an extra DWORD so the 64-bit window never reads past the end.
+static uint32 ReadFlagRun(
+    const uint32* pFlags,
+    uint32        firstBit,
+    uint32        numBits)
+{
+    const uint32 dword  = (firstBit / 32);
+    const uint64 window = (static_cast<uint64>(pFlags[dword + 1]) << 32) | pFlags[dword];
+
+    return (static_cast<uint32>(window >> (firstBit % 32)) & RunMask(numBits));
+}
+
+// =====================================================================================================================
+// Sets numBits consecutive flags starting at firstBit in a per-register flag array. numBits must be in the range
+// [1, 32].
+static void SetFlagRun(
+    uint32* pFlags,
+    uint32  firstBit,
+    uint32  numBits)
+{
+    const uint32 dword = (firstBit / 32);
+    const uint64 mask  = (static_cast<uint64>(RunMask(numBits)) << (firstBit % 32));
+
+    pFlags[dword]     |= LowPart(mask);
+    pFlags[dword + 1] |= HighPart(mask);
+}
+
+// =====================================================================================================================
+// Compares up to 32 new register values against their shadowed values. Returns a mask with bit i set if register i is
+// unchanged.
+static uint32 CompareRegRun(
+    const uint32* pShadowVals,
+    const uint32* pNewVals,
+    uint32        numRegs)
+{
+    uint32 equalMask = 0;
+    uint32 i         = 0;
+
+#if PAL_PM4_OPTIMIZER_SSE2
+    // Compare four registers per iteration and gather the per-lane results into four bits of the mask.
+    for (; (i + 4) <= numRegs; i += 4)
+    {
+        const __m128i shadow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pShadowVals + i));
+        const __m128i data   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pNewVals + i));
+        const __m128i equal  = _mm_cmpeq_epi32(shadow, data);
+
+        equalMask |= (static_cast<uint32>(_mm_movemask_ps(_mm_castsi128_ps(equal))) << i);
+    }
+#endif
+
+    for (; i < numRegs; i++)
+    {
+        equalMask |= (static_cast<uint32>(pShadowVals[i] == pNewVals[i]) << i);
+    }
+
+    return equalMask;
+}
+
+// =====================================================================================================================
+// The run version of UpdateRegState: checks up to 32 sequential registers against the current register state and
+// updates it. Returns a mask with bit i set if register (regOffset + i) must be written to HW.
+template <size_t RegisterCount>
+static uint32 UpdateRegRunState(
+    const uint32*                 pNewRegVals,
+    uint32                        regOffset,
+    uint32                        numRegs,
+    RegGroupState<RegisterCount>* pCurRegState) // [in,out] Current state of the registers being set, will be updated.
+{
+    PAL_ASSERT((numRegs > 0) && (numRegs <= 32) && ((regOffset + numRegs) <= RegisterCount));
+
+    // A register can only be skipped if its value is unchanged, its previous state is valid, and it isn't one of the
+    // registers we must always write.
+    const uint32 skipMask = CompareRegRun(&pCurRegState->value[regOffset], pNewRegVals, numRegs) &
+                            ReadFlagRun(&pCurRegState->valid[0], regOffset, numRegs)         &
+                            ~ReadFlagRun(&pCurRegState->mustWrite[0], regOffset, numRegs);
+    const uint32 keepMask = (RunMask(numRegs) & ~skipMask);
+
+    // Skipped registers already hold the new value so the whole run can be copied into the shadow state.
+    memcpy(&pCurRegState->value[regOffset], pNewRegVals, numRegs * sizeof(uint32));
+    SetFlagRun(&pCurRegState->valid[0], regOffset, numRegs);
+
+#if PAL_BUILD_PM4_INSTRUMENTOR
+    for (uint32 i = 0; i < numRegs; i++)
+    {
+        pCurRegState->totalSets[regOffset + i]++;
+        pCurRegState->keptSets[regOffset + i] += ((keepMask >> i) & 1);
+    }
+#endif
+
+    return keepMask;
+}
+
 // =====================================================================================================================
 Pm4Optimizer::Pm4Optimizer(
     const Device& device)
@@ -101,21 +210,21 @@ void Pm4Optimizer::Reset()
     constexpr uint32 VportEnd   = mmPA_CL_VPORT_ZOFFSET_15 - CONTEXT_SPACE_START;
     for (uint32 regOffset = VportStart; regOffset <= VportEnd; ++regOffset)
     {
-        m_cntxRegs.state[regOffset].flags.mustWrite = 1;
+        WideBitfieldSetBit(m_cntxRegs.mustWrite, regOffset);
     }
 
     constexpr uint32 VportScissorStart = mmPA_SC_VPORT_SCISSOR_0_TL - CONTEXT_SPACE_START;
     constexpr uint32 VportScissorEnd   = mmPA_SC_VPORT_ZMAX_15      - CONTEXT_SPACE_START;
     for (uint32 regOffset = VportScissorStart; regOffset <= VportScissorEnd; ++regOffset)
     {
-        m_cntxRegs.state[regOffset].flags.mustWrite = 1;
+        WideBitfieldSetBit(m_cntxRegs.mustWrite, regOffset);
     }
 
     constexpr uint32 GuardbandStart = mmPA_CL_GB_VERT_CLIP_ADJ - CONTEXT_SPACE_START;
     constexpr uint32 GuardbandEnd   = mmPA_CL_GB_HORZ_DISC_ADJ - CONTEXT_SPACE_START;
     for (uint32 regOffset = GuardbandStart; regOffset <= GuardbandEnd; ++regOffset)
     {
-        m_cntxRegs.state[regOffset].flags.mustWrite = 1;
+        WideBitfieldSetBit(m_cntxRegs.mustWrite, regOffset);
     }
 
     // This workaround on gfx9 adds some writes to DB_Z_INFO which are preceded by a COND_EXEC. Make sure we don't
@@ -124,7 +233,7 @@ void Pm4Optimizer::Reset()
     {
         constexpr uint32 dbZInfoIdx = Gfx09::mmDB_Z_INFO - CONTEXT_SPACE_START;
 
-        m_cntxRegs.state[dbZInfoIdx].flags.mustWrite = 1;
+        WideBitfieldSetBit(m_cntxRegs.mustWrite, dbZInfoIdx);
     }
 
     // Reset the SH register state.
@@ -182,10 +291,10 @@ bool Pm4Optimizer::MustKeepContextRegRmw(
     // regState value to compute newRegVal. If we tried to do it anyway, the fact that our regMask will have some bits
     // disabled means that we would be setting regState's value to something partially invalid which may cause us to
     // skip needed packets in the future.
-    if (m_cntxRegs.state[regOffset].flags.valid != 0)
+    if (WideBitfieldIsSet(m_cntxRegs.valid, regOffset))
     {
         // Computed according to the formula stated in the definition of CmdUtil::BuildContextRegRmw.
-        const uint32 newRegVal = (m_cntxRegs.state[regOffset].value & ~regMask) | (regData & regMask);
+        const uint32 newRegVal = (m_cntxRegs.value[regOffset] & ~regMask) | (regData & regMask);
 
         mustKeep = UpdateRegState(newRegVal, regOffset, &m_cntxRegs);
     }
@@ -285,13 +394,13 @@ uint32* Pm4Optimizer::WriteOptimizedSetShShRegOffset(
 {
     // Since this is an indirect write, we do not know the exact SH register data. Invalidate SH register so that
     // the next SH register write will not be skipped inadvertently
-    m_shRegs.state[setShRegOffset.ordinal2.bitfields.reg_offset].flags.valid = 0;
+    WideBitfieldClearBit(m_shRegs.valid, setShRegOffset.ordinal2.bitfields.reg_offset);
 
     // If the index value is set to 0, this packet actually operates on two sequential SH registers so we need to
     // invalidate the following register as well.
     if (setShRegOffset.ordinal2.bitfields.index == 0)
     {
-        m_shRegs.state[setShRegOffset.ordinal2.bitfields.reg_offset + 1].flags.valid = 0;
+        WideBitfieldClearBit(m_shRegs.valid, setShRegOffset.ordinal2.bitfields.reg_offset + 1);
     }
 
     // memcpy packet into command space
@@ -321,14 +430,20 @@ uint32* Pm4Optimizer::OptimizePm4SetReg(
     // We assume that no more than 32 registers are being set. Currently the driver only sets more than 32 registers in
     // the viewport state object. Luckily, those registers are vector regisers so we can't optimize them anyway. If we
     // ever encounter a set command with more than 32 registers that has redundant values the assert below will trigger.
+    //
+    // The registers are checked in runs of up to 32 so that each run can be compared against the shadowed state as a
+    // block rather than one register at a time.
     uint32 keepRegCount = 0;
     uint32 keepRegMask  = 0;
-    for (uint32 i = 0; i < numRegs; i++)
+    for (uint32 i = 0; i < numRegs; i += 32)
     {
-        if (UpdateRegState(pRegData[i], (regOffset + i), pRegState))
+        const uint32 runMask = UpdateRegRunState((pRegData + i), (regOffset + i), Min(numRegs - i, 32u), pRegState);
+
+        keepRegCount += CountSetBits(runMask);
+
+        if (i == 0)
         {
-            keepRegCount++;
-            keepRegMask |= 1 << i;
+            keepRegMask = runMask;
         }
     }
 
@@ -424,7 +539,7 @@ void Pm4Optimizer::HandlePm4LoadReg(
         const uint32  endRegOffset   = (startRegOffset + pRegisterGroup[1] - 1);
         for (uint32 reg = startRegOffset; reg <= endRegOffset; ++reg)
         {
-            pRegState->state[reg].flags.valid = 0;
+            WideBitfieldClearBit(pRegState->valid, reg);
         }
 
         pRegisterGroup += 2;
@@ -454,7 +569,7 @@ void Pm4Optimizer::HandlePm4LoadRegIndex(
         const uint32 endRegOffset   = (startRegOffset + numRegs - 1);
         for (uint32 reg = startRegOffset; reg <= endRegOffset; ++reg)
         {
-            pRegState->state[reg].flags.valid = 0;
+            WideBitfieldClearBit(pRegState->valid, reg);
         }
 
         pRegisterGroup = VoidPtrInc(pRegisterGroup, sizeof(uint32) * 2);
@@ -478,13 +593,13 @@ void Pm4Optimizer::HandlePm4SetShRegOffset(
     const PM4_PFP_SET_SH_REG_OFFSET& setShRegOffset)
 {
     // Invalidate the register the packet is operating on.
-    m_shRegs.state[setShRegOffset.ordinal2.bitfields.reg_offset].flags.valid = 0;
+    WideBitfieldClearBit(m_shRegs.valid, setShRegOffset.ordinal2.bitfields.reg_offset);
 
     // If the index value is set to 0, this packet actually operates on two sequential SH registers so we need to
     // invalidate the following register as well.
     if (setShRegOffset.ordinal2.bitfields.index == 0)
     {
-        m_shRegs.state[setShRegOffset.ordinal2.bitfields.reg_offset + 1].flags.valid = 0;
+        WideBitfieldClearBit(m_shRegs.valid, setShRegOffset.ordinal2.bitfields.reg_offset + 1);
     }
 }
 
@@ -499,7 +614,7 @@ void Pm4Optimizer::HandlePm4SetContextRegIndirect(
 
     for (uint32 reg = startRegOffset; reg <= endRegOffset; ++reg)
     {
-        m_cntxRegs.state[reg].flags.valid = 0;
+        WideBitfieldClearBit(m_cntxRegs.valid, reg);
     }
 }
 
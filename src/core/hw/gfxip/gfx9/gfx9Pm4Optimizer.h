@@ -37,25 +37,20 @@ namespace Gfx9
 
 class Device;
 
-// Structure used during PM4 optimization to track the current value of a single register.
-struct RegState
-{
-    struct
-    {
-        uint32 valid     :  1;  // This register has been set in this stream, value is valid.
-        uint32 mustWrite :  1;  // All writes to this register must be preserved (can't optimize them out).
-        uint32 reserved  : 30;
-    } flags;
-
-    uint32 value;
-};
-
 // Structure used during PM4 optimization and instrumentation to track the current value of registers as well as the
 // number of times the register was written (via a SET packet) or ignored due to optimization.
+//
+// The register values and their flags live in separate arrays so that a run of sequential registers can be compared
+// against the shadowed state several registers at a time.
 template <size_t RegisterCount>
 struct RegGroupState
 {
-    RegState  state[RegisterCount];     // State of each register in the group.
+    // Each flag array has a spare trailing DWORD so any run of up to 32 flags can be read as one 64-bit window.
+    static constexpr size_t FlagDwords = ((RegisterCount + 31) / 32) + 1;
+
+    uint32    value[RegisterCount];     // Current value of each register, only meaningful if its valid bit is set.
+    uint32    valid[FlagDwords];        // One bit per register: it has been set in this stream, value is valid.
+    uint32    mustWrite[FlagDwords];    // One bit per register: all writes must be preserved (can't optimize them out).
 #if PAL_BUILD_PM4_INSTRUMENTOR
     uint32    totalSets[RegisterCount]; // Number of writes to each register using SET packets.
     uint32    keptSets[RegisterCount];  // Number of writes to each register using SET packets which were not ignored
@@ -87,7 +82,8 @@ public:
 
     void Reset();
 
-    void SetShRegInvalid(uint32 regAddr) { m_shRegs.state[regAddr - PERSISTENT_SPACE_START].flags.valid = 0; }
+    void SetShRegInvalid(uint32 regAddr)
+        { Util::WideBitfieldClearBit(m_shRegs.valid, regAddr - PERSISTENT_SPACE_START); }
 
     bool MustKeepSetContextReg(uint32 regAddr, uint32 regData);
     bool MustKeepSetShReg(uint32 regAddr, uint32 regData);
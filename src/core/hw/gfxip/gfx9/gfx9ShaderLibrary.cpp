@@ -268,18 +268,23 @@ Result ShaderLibrary::GetShaderFunctionStats(
         }
     }
 
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
+    // Only the compute stage and the shader functions are needed here, so avoid decoding the rest of the metadata.
+    MsgPackReader              metadataReader;
+    CodeObjectMetadataView     metadataView;
+    Abi::HardwareStageMetadata stageMetadata;
 
     if (result == Result::Success)
     {
-        result = abiReader.GetMetadata(&metadataReader, &metadata);
+        result = abiReader.GetMetadataView(&metadataReader, &metadataView);
     }
 
     if (result == Result::Success)
     {
-        const auto&  stageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(Abi::HardwareStage::Cs)];
+        result = metadataView.GetHardwareStage(&metadataReader, Abi::HardwareStage::Cs, &stageMetadata);
+    }
 
+    if (result == Result::Success)
+    {
         pShaderStats->numAvailableSgprs = (stageMetadata.hasEntry.sgprLimit != 0)
                                             ? stageMetadata.sgprLimit
                                             : gpuInfo.gfx9.numShaderVisibleSgprs;
@@ -293,7 +298,7 @@ Result ShaderLibrary::GetShaderFunctionStats(
     if (result == Result::Success)
     {
         result = UnpackShaderFunctionStats(pShaderExportName,
-                                           metadata,
+                                           metadataView.ShaderFunctionsOffset(),
                                            &metadataReader,
                                            pShaderStats);
     }
@@ -304,13 +309,13 @@ Result ShaderLibrary::GetShaderFunctionStats(
 // =====================================================================================================================
 // Obtains the shader function stack frame size
 Result ShaderLibrary::UnpackShaderFunctionStats(
-    const char*               pShaderExportName,
-    const CodeObjectMetadata& metadata,
-    Util::MsgPackReader*      pMetadataReader,
-    ShaderLibStats*           pShaderStats
+    const char*          pShaderExportName,
+    uint32               shaderFunctionsOffset,
+    Util::MsgPackReader* pMetadataReader,
+    ShaderLibStats*      pShaderStats
     ) const
 {
-    Result result = pMetadataReader->Seek(metadata.pipeline.shaderFunctions);
+    Result result = pMetadataReader->Seek(shaderFunctionsOffset);
 
     if (result == Result::Success)
     {
@@ -95,10 +95,10 @@ protected:
         Util::MsgPackReader*           pMetadataReader) override;
 
     Result UnpackShaderFunctionStats(
-        const char*               pShaderExportName,
-        const CodeObjectMetadata& metadata,
-        Util::MsgPackReader*      pMetadataReader,
-        ShaderLibStats*           pShaderStats) const;
+        const char*          pShaderExportName,
+        uint32               shaderFunctionsOffset,
+        Util::MsgPackReader* pMetadataReader,
+        ShaderLibStats*      pShaderStats) const;
 
     // Update m_hwInfo afer HwlInit
     void UpdateHwInfo();
@@ -8033,6 +8033,8 @@ CmdStream* UniversalCmdBuffer::GetAceCmdStream()
         {
             const PalSettings& coreSettings = m_device.Parent()->Settings();
 
+            m_pAceCmdStream->EnableChunkRetention(RetainsChunksOnReset());
+
             CmdStreamBeginFlags cmdStreamFlags = {};
             cmdStreamFlags.prefetchCommands    = m_buildFlags.prefetchCommands;
             cmdStreamFlags.optimizeCommands    =
@@ -138,6 +138,9 @@ public:
 
     virtual bool HasDisplayDccData() const { return false; }
 
+    // Returns true if any mask-ram (e.g., DCC, HTile or CMask) is associated with this Image.
+    virtual bool HasMaskRam() const = 0;
+
     virtual bool IsFastColorClearSupported(GfxCmdBuffer*      pCmdBuffer,
                                            ImageLayout        colorLayout,
                                            const uint32*      pColor,
@@ -43,6 +43,9 @@ namespace Pal
 // GPU memory alignment for shader programs.
 constexpr size_t GpuMemByteAlign = 256;
 
+// Size of each loaded register's offset and value pair, in bytes.
+constexpr uint32 RegisterEntryBytes = (sizeof(uint32) << 1);
+
 constexpr Abi::ApiShaderType PalToAbiShaderType[] =
 {
     Abi::ApiShaderType::Cs, // ShaderType::Cs
@@ -65,6 +68,8 @@ Pipeline::Pipeline(
     m_pDevice(pDevice),
     m_gpuMem(),
     m_gpuMemSize(0),
+    m_regGpuMem(),
+    m_regGpuMemSize(0),
     m_pPipelineBinary(nullptr),
     m_pipelineBinaryLen(0),
     m_apiHwMapping(),
@@ -81,17 +86,40 @@ Pipeline::Pipeline(
     memset(&m_info, 0, sizeof(m_info));
     memset(&m_shaderMetaData, 0, sizeof(m_shaderMetaData));
     memset(&m_perfDataInfo, 0, sizeof(m_perfDataInfo));
+    memset(&m_uploadKey, 0, sizeof(m_uploadKey));
 }
 
 // =====================================================================================================================
 Pipeline::~Pipeline()
 {
+    // The DMA upload ring may still be copying into this pipeline's memory, or may not even have submitted that copy
+    // yet.  The memory can't be handed back to the allocator until the copy is done.  Shared uploads are waited on by
+    // the upload cache once their last reference goes away.
+    if ((m_uploadFenceToken > 0) && (m_flags.cachedUpload == 0))
+    {
+        const Result result = m_pDevice->WaitForPendingUpload(nullptr, m_uploadFenceToken);
+        PAL_ALERT(result != Result::Success);
+    }
+
     if (m_gpuMem.IsBound())
     {
-        m_pDevice->MemMgr()->FreeGpuMem(m_gpuMem.Memory(), m_gpuMem.Offset());
+        if (m_flags.cachedUpload != 0)
+        {
+            m_pDevice->GetPipelineUploadCache()->Release(m_uploadKey);
+        }
+        else
+        {
+            m_pDevice->MemMgr()->FreeGpuMem(m_gpuMem.Memory(), m_gpuMem.Offset());
+        }
         m_gpuMem.Update(nullptr, 0);
     }
 
+    if (m_regGpuMem.IsBound())
+    {
+        m_pDevice->MemMgr()->FreeGpuMem(m_regGpuMem.Memory(), m_regGpuMem.Offset());
+        m_regGpuMem.Update(nullptr, 0);
+    }
+
     if (m_perfDataMem.IsBound())
     {
         m_pDevice->MemMgr()->FreeGpuMem(m_perfDataMem.Memory(), m_perfDataMem.Offset());
@@ -196,20 +224,38 @@ Result Pipeline::PerformRelocationsAndUploadToGpuMemory(
 
     if (result == Result::Success)
     {
-        result = pUploader->Begin(metadata, clientPreferredHeap);
-
-    }
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+        // Pipelines created from the same binary can share a single copy of the relocated code and data. Such a
+        // pipeline keeps its register values in a second allocation, which older clients don't expect to find in
+        // QueryAllocationInfo(), so only newer clients get to share.
+        MetroHash128::Hash(static_cast<const uint8*>(m_pPipelineBinary),
+                           m_pipelineBinaryLen,
+                           m_uploadKey.elfHash.bytes);
+        m_uploadKey.elfSize = m_pipelineBinaryLen;
+        m_uploadKey.heap    = clientPreferredHeap;
+
+        pUploader->EnableUploadCache(m_pDevice->GetPipelineUploadCache(), m_uploadKey);
+#endif
 
-    if (result == Result::Success)
-    {
-        result = pUploader->ApplyRelocations();
+        result = pUploader->Begin(metadata, clientPreferredHeap);
     }
 
     if (result == Result::Success)
     {
-        m_pagingFenceVal = pUploader->PagingFenceVal();
-        m_gpuMemSize     = pUploader->GpuMemSize();
+        // Take ownership of the upload before relocating it so that it is released even if relocation fails.
+        m_flags.cachedUpload = pUploader->IsUploadCached();
+        m_flags.sharedUpload = pUploader->IsUploadShared();
+        m_pagingFenceVal     = pUploader->PagingFenceVal();
+        m_gpuMemSize         = pUploader->GpuMemSize();
         m_gpuMem.Update(pUploader->GpuMem(), pUploader->GpuMemOffset());
+
+        if (pUploader->RegGpuMem() != nullptr)
+        {
+            m_regGpuMem.Update(pUploader->RegGpuMem(), pUploader->RegGpuMemOffset());
+            m_regGpuMemSize = pUploader->RegGpuMemSize();
+        }
+
+        result = pUploader->ApplyRelocations();
     }
 
     return result;
@@ -254,13 +300,22 @@ Result Pipeline::QueryAllocationInfo(
 
     if (pNumEntries != nullptr)
     {
-        (*pNumEntries) = 1;
+        // Pipelines sharing their code and data keep the loaded register values in a separate allocation. This can
+        // only happen for clients at interface 636 or newer.
+        (*pNumEntries) = m_regGpuMem.IsBound() ? 2 : 1;
 
         if (pGpuMemList != nullptr)
         {
             pGpuMemList[0].offset     = m_gpuMem.Offset();
             pGpuMemList[0].pGpuMemory = m_gpuMem.Memory();
             pGpuMemList[0].size       = m_gpuMemSize;
+
+            if (m_regGpuMem.IsBound())
+            {
+                pGpuMemList[1].offset     = m_regGpuMem.Offset();
+                pGpuMemList[1].pGpuMemory = m_regGpuMem.Memory();
+                pGpuMemList[1].size       = m_regGpuMemSize;
+            }
         }
 
         result = Result::Success;
@@ -269,6 +324,31 @@ Result Pipeline::QueryAllocationInfo(
     return result;
 }
 
+// =====================================================================================================================
+// Reports the GPU memory owned by this pipeline to the event provider. Code and data shared with earlier pipelines were
+// already reported by the pipeline which uploaded them, so only our own register values are bound in that case.
+void Pipeline::LogResourceBindEvents() const
+{
+    GpuMemoryResourceBindEventData bindData = {};
+    bindData.pObj = this;
+
+    if (m_flags.sharedUpload == 0)
+    {
+        bindData.pGpuMemory = m_gpuMem.Memory();
+        bindData.requiredGpuMemSize = m_gpuMemSize;
+        bindData.offset = m_gpuMem.Offset();
+        m_pDevice->GetPlatform()->GetEventProvider()->LogGpuMemoryResourceBindEvent(bindData);
+    }
+
+    if (m_regGpuMem.IsBound())
+    {
+        bindData.pGpuMemory = m_regGpuMem.Memory();
+        bindData.requiredGpuMemSize = m_regGpuMemSize;
+        bindData.offset = m_regGpuMem.Offset();
+        m_pDevice->GetPlatform()->GetEventProvider()->LogGpuMemoryResourceBindEvent(bindData);
+    }
+}
+
 // =====================================================================================================================
 // Extracts the pipeline's code object ELF binary.
 Result Pipeline::GetCodeObject(
@@ -415,18 +495,24 @@ Result Pipeline::GetShaderStatsForStage(
     AbiReader abiReader(m_pDevice->GetPlatform(), m_pPipelineBinary);
     Result result = abiReader.Init();
 
-    MsgPackReader      metadataReader;
-    CodeObjectMetadata metadata;
+    // Only the requested hardware stages are needed here, so avoid decoding the rest of the metadata.
+    MsgPackReader              metadataReader;
+    CodeObjectMetadataView     metadataView;
+    Abi::HardwareStageMetadata stageMetadata;
+
+    if (result == Result::Success)
+    {
+        result = abiReader.GetMetadataView(&metadataReader, &metadataView);
+    }
 
     if (result == Result::Success)
     {
-        result = abiReader.GetMetadata(&metadataReader, &metadata);
+        result = metadataView.GetHardwareStage(&metadataReader, stageInfo.stageId, &stageMetadata);
     }
 
     if (result == Result::Success)
     {
-        const auto&  gpuInfo       = m_pDevice->ChipProperties();
-        const auto&  stageMetadata = metadata.pipeline.hardwareStage[static_cast<uint32>(stageInfo.stageId)];
+        const auto& gpuInfo = m_pDevice->ChipProperties();
 
         pStats->common.numUsedSgprs = stageMetadata.sgprCount;
         pStats->common.numUsedVgprs = stageMetadata.vgprCount;
@@ -457,11 +543,15 @@ Result Pipeline::GetShaderStatsForStage(
 
         pStats->isaSizeInBytes = stageInfo.disassemblyLength;
 
+        Abi::HardwareStageMetadata copyStageMetadata;
+
         if (pStageInfoCopy != nullptr)
         {
-            const auto& copyStageMetadata =
-                metadata.pipeline.hardwareStage[static_cast<uint32>(pStageInfoCopy->stageId)];
+            result = metadataView.GetHardwareStage(&metadataReader, pStageInfoCopy->stageId, &copyStageMetadata);
+        }
 
+        if ((pStageInfoCopy != nullptr) && (result == Result::Success))
+        {
             pStats->flags.copyShaderPresent = 1;
 
             pStats->copyShader.numUsedSgprs = copyStageMetadata.sgprCount;
@@ -638,8 +728,16 @@ PipelineUploader::PipelineUploader(
     m_pagingFenceVal(0),
     m_pipelineHeapType(GpuHeap::GpuHeapCount),
     m_slotId(0),
-    m_heapInvisUploadOffset(0)
+    m_heapInvisUploadOffset(0),
+    m_pUploadCache(nullptr),
+    m_sharedUpload(false),
+    m_cachedUpload(false),
+    m_sharedUploadFence(0),
+    m_pRegGpuMemory(nullptr),
+    m_regGpuMemOffset(0),
+    m_regGpuMemSize(0)
 {
+    memset(&m_uploadKey, 0, sizeof(m_uploadKey));
 }
 
 // =====================================================================================================================
@@ -748,6 +846,19 @@ GpuHeap PipelineUploader::SelectUploadHeap(
     return m_pipelineHeapType;
 }
 
+// =====================================================================================================================
+// Lets Begin() share code and data with earlier uploads of the same pipeline binary, and lets later uploads share this
+// one.  Must be called before Begin().
+void PipelineUploader::EnableUploadCache(
+    PipelineUploadCache*     pUploadCache,
+    const PipelineUploadKey& key)
+{
+    PAL_ASSERT(m_pGpuMemory == nullptr);
+
+    m_pUploadCache = pUploadCache;
+    m_uploadKey    = key;
+}
+
 // =====================================================================================================================
 // Allocates GPU memory for the current pipeline.  Also, maps the memory for CPU access and uploads the pipeline code
 // and data.  The GPU virtual addresses for the code, data, and register segments are also computed.  The caller is
@@ -782,7 +893,6 @@ Result PipelineUploader::Begin(
 
         if (totalRegisters > 0)
         {
-            constexpr uint32 RegisterEntryBytes = (sizeof(uint32) << 1);
             m_gpuMemSize = (Pow2Align(m_prefetchSize, sizeof(uint32)) + (RegisterEntryBytes * totalRegisters));
         }
 
@@ -796,6 +906,25 @@ Result PipelineUploader::Begin(
 
         m_gpuMemSize = Max(m_gpuMemSize, minSafeSize);
 
+        PipelineUploadEntry upload = { };
+        if (m_pUploadCache != nullptr)
+        {
+            m_sharedUpload = m_pUploadCache->Acquire(m_uploadKey, &upload);
+        }
+
+        if (m_sharedUpload)
+        {
+            m_pGpuMemory        = upload.pGpuMemory;
+            m_baseOffset        = upload.offset;
+            m_gpuMemSize        = upload.gpuMemSize;
+            m_pagingFenceVal    = upload.pagingFenceVal;
+            m_sharedUploadFence = upload.uploadFence;
+            m_cachedUpload      = true;
+        }
+    }
+
+    if ((result == Result::Success) && (m_sharedUpload == false))
+    {
         GpuMemoryCreateInfo createInfo = { };
         createInfo.size      = m_gpuMemSize;
         createInfo.alignment = GpuMemByteAlign;
@@ -815,7 +944,11 @@ Result PipelineUploader::Begin(
     void* pMappedPtr = nullptr;
     if (result == Result::Success)
     {
-        if (ShouldUploadUsingDma())
+        if (m_sharedUpload)
+        {
+            result = UseSharedUpload(addressCalculator, &pMappedPtr);
+        }
+        else if (ShouldUploadUsingDma())
         {
             result = UploadUsingDma(addressCalculator, &pMappedPtr);
         }
@@ -833,7 +966,11 @@ Result PipelineUploader::Begin(
         {
             PAL_ASSERT(pMappedPtr != nullptr);
 
-            gpusize gpuVirtAddr  = (m_prefetchGpuVirtAddr + addressCalculator.GetSize());
+            // Shared code and data are followed by the registers of the pipeline which uploaded them, so our registers
+            // are stored in a separate allocation.
+            gpusize gpuVirtAddr  = m_sharedUpload
+                                   ? (m_pRegGpuMemory->Desc().gpuVirtAddr + m_regGpuMemOffset)
+                                   : (m_prefetchGpuVirtAddr + addressCalculator.GetSize());
             uint64 paddingSize   = Pow2Align(gpuVirtAddr, sizeof(uint32)) - gpuVirtAddr;
             gpuVirtAddr          = gpuVirtAddr + paddingSize;
             uint32* pRegWritePtr = static_cast<uint32*>(VoidPtrInc(pMappedPtr, static_cast<size_t>(paddingSize)));
@@ -858,6 +995,112 @@ Result PipelineUploader::Begin(
             m_pShRegWritePtrStart  = m_pShRegWritePtr;
 #endif
         }
+
+        // Offer a fresh upload to later pipelines created from the same binary. It can't be shared until End()
+        // submits it.
+        if ((m_pUploadCache != nullptr) && (m_sharedUpload == false))
+        {
+            PipelineUploadEntry upload = { };
+            upload.pGpuMemory     = m_pGpuMemory;
+            upload.offset         = m_baseOffset;
+            upload.gpuMemSize     = m_gpuMemSize;
+            upload.pagingFenceVal = m_pagingFenceVal;
+
+            m_cachedUpload = m_pUploadCache->Insert(m_uploadKey, upload);
+        }
+    }
+    else if (m_sharedUpload)
+    {
+        // Drop our references to the shared upload; the caller won't take ownership of anything after a failure.
+        if (m_pMappedPtr != nullptr)
+        {
+            m_pRegGpuMemory->Unmap();
+            m_pMappedPtr = nullptr;
+        }
+
+        if (m_pRegGpuMemory != nullptr)
+        {
+            m_pDevice->MemMgr()->FreeGpuMem(m_pRegGpuMemory, m_regGpuMemOffset);
+            m_pRegGpuMemory = nullptr;
+        }
+
+        m_pUploadCache->Release(m_uploadKey);
+
+        m_pGpuMemory   = nullptr;
+        m_sharedUpload = false;
+        m_cachedUpload = false;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Records the GPU addresses of code and data which were already uploaded and relocated by an earlier pipeline created
+// from the same binary.  Only the loaded registers need new memory, which is mapped for the caller to fill out.
+Result PipelineUploader::UseSharedUpload(
+    const SectionAddressCalculator& addressCalc,
+    void**                          ppMappedPtr)
+{
+    Result result = Result::Success;
+
+    const gpusize            gpuVirtAddr = (m_pGpuMemory->Desc().gpuVirtAddr + m_baseOffset);
+    const ElfReader::Reader& elfReader   = m_abiReader.GetElfReader();
+
+    for (auto sectionIter = addressCalc.GetSectionsBegin(); sectionIter.IsValid(); sectionIter.Next())
+    {
+        const SectionAddressCalculator::SectionOffset& section = sectionIter.Get();
+
+        if (m_memoryMap.AddSection(section.sectionId,
+                                   (gpuVirtAddr + section.offset),
+                                   elfReader.GetSectionData(section.sectionId)) == nullptr)
+        {
+            result = Result::ErrorOutOfMemory;
+            break;
+        }
+    }
+
+    const uint32 totalRegisters = (m_ctxRegisterCount + m_shRegisterCount);
+    if ((result == Result::Success) && (totalRegisters > 0))
+    {
+        GpuMemoryCreateInfo createInfo = { };
+        m_regGpuMemSize = (RegisterEntryBytes * totalRegisters);
+
+        createInfo.size      = m_regGpuMemSize;
+        createInfo.alignment = GpuMemByteAlign;
+        createInfo.vaRange   = VaRange::DescriptorTable;
+        createInfo.heaps[0]  = GpuHeapLocal;
+        createInfo.heaps[1]  = GpuHeapGartUswc;
+        createInfo.heapCount = 2;
+        createInfo.priority  = GpuMemPriority::High;
+
+        uint64 pagingFenceVal = 0;
+
+        GpuMemoryInternalCreateInfo internalInfo = { };
+        internalInfo.flags.alwaysResident = 1;
+        internalInfo.pPagingFence = &pagingFenceVal;
+
+        result = m_pDevice->MemMgr()->AllocateGpuMem(createInfo,
+                                                     internalInfo,
+                                                     false,
+                                                     &m_pRegGpuMemory,
+                                                     &m_regGpuMemOffset);
+
+        if (result == Result::Success)
+        {
+            m_pagingFenceVal = Max(m_pagingFenceVal, pagingFenceVal);
+
+            result = m_pRegGpuMemory->Map(&m_pMappedPtr);
+        }
+
+        if (result == Result::Success)
+        {
+            m_pMappedPtr = VoidPtrInc(m_pMappedPtr, static_cast<size_t>(m_regGpuMemOffset));
+            *ppMappedPtr = m_pMappedPtr;
+        }
+        else
+        {
+            m_pMappedPtr = nullptr;
+        }
     }
 
     return result;
@@ -989,8 +1232,8 @@ Result PipelineUploader::UploadUsingCpu(
 Result PipelineUploader::ApplyRelocations()
 {
     Result result = Result::Success;
-    // Apply relocations: Iterate through all REL sections
-    Util::ElfReader::SectionId numSections = m_abiReader.GetElfReader().GetNumSections();
+    // Apply relocations: Iterate through all REL sections. Shared code and data have been relocated already.
+    Util::ElfReader::SectionId numSections = m_sharedUpload ? 0 : m_abiReader.GetElfReader().GetNumSections();
     for (Util::ElfReader::SectionId i = 0; i < numSections; i++)
     {
         auto type = m_abiReader.GetElfReader().GetSectionType(i);
@@ -1151,7 +1394,18 @@ Result PipelineUploader::End(
         m_pCtxRegWritePtr = nullptr;
         m_pShRegWritePtr  = nullptr;
 
-        if (ShouldUploadUsingDma())
+        if (m_sharedUpload)
+        {
+            if (m_pRegGpuMemory != nullptr)
+            {
+                PAL_ASSERT(m_pMappedPtr != nullptr);
+                result = m_pRegGpuMemory->Unmap();
+            }
+
+            // The shared code and data can't be used before their original upload finishes.
+            *pCompletionFence = m_sharedUploadFence;
+        }
+        else if (ShouldUploadUsingDma())
         {
             const size_t dataRegisterAndPadding = static_cast<size_t>(m_gpuMemSize - m_heapInvisUploadOffset);
             if (dataRegisterAndPadding > 0)
@@ -1173,6 +1427,11 @@ Result PipelineUploader::End(
         }
 
         m_pMappedPtr = nullptr;
+
+        if ((result == Result::Success) && m_cachedUpload && (m_sharedUpload == false))
+        {
+            m_pUploadCache->Complete(m_uploadKey, *pCompletionFence);
+        }
     }
 
     return result;
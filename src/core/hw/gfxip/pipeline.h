@@ -112,6 +112,10 @@ typedef Util::Abi::PipelineAbiReader AbiReader;
 // Shorthand for the PAL code object metadata structure.
 typedef Util::Abi::PalCodeObjectMetadata  CodeObjectMetadata;
 
+// Shorthand for the lazily-decoded view of the PAL code object metadata.  Queries which need only a few stages should
+// use it.  Pipeline and library creation still decode the full metadata because HwlInit reads nearly every field.
+typedef Util::Abi::PipelineMetadataView  CodeObjectMetadataView;
+
 // =====================================================================================================================
 // Monolithic object containing all shaders and a large amount of "shader adjacent" state.  Separate concrete
 // implementations will support compute or graphics pipelines.
@@ -186,6 +190,8 @@ protected:
         const char*         pPrefix,
         const char*         pName) const;
 
+    void LogResourceBindEvents() const;
+
     size_t PerformanceDataSize(
         const CodeObjectMetadata& metadata) const;
 
@@ -196,6 +202,8 @@ protected:
 
     BoundGpuMemory  m_gpuMem;
     gpusize         m_gpuMemSize;
+    BoundGpuMemory  m_regGpuMem;        // Loaded register values, if they aren't stored in m_gpuMem.
+    gpusize         m_regGpuMemSize;
 
     void*   m_pPipelineBinary;      // Buffer containing the pipeline binary data (Pipeline ELF ABI).
     size_t  m_pipelineBinaryLen;    // Size of the pipeline binary data, in bytes.
@@ -213,7 +221,9 @@ private:
         {
             uint32  isInternal        :  1;  // True if this Pipeline object was created internally by PAL.
             uint32  reserved0         :  1;
-            uint32  reserved          : 30;
+            uint32  cachedUpload      :  1;  // True if m_gpuMem is owned by the device's PipelineUploadCache.
+            uint32  sharedUpload      :  1;  // True if m_gpuMem was uploaded by an earlier pipeline.
+            uint32  reserved          : 28;
         };
         uint32  value;  // Flags packed as a uint32.
     } m_flags;
@@ -221,6 +231,8 @@ private:
     BoundGpuMemory m_perfDataMem;
     gpusize        m_perfDataGpuMemSize;
 
+    PipelineUploadKey m_uploadKey;  // Identifies this pipeline's upload in the device's PipelineUploadCache.
+
     PAL_DISALLOW_DEFAULT_CTOR(Pipeline);
     PAL_DISALLOW_COPY_AND_ASSIGN(Pipeline);
 };
@@ -368,6 +380,8 @@ public:
         uint32           shRegisterCount);
     virtual ~PipelineUploader();
 
+    void EnableUploadCache(PipelineUploadCache* pUploadCache, const PipelineUploadKey& key);
+
     Result Begin(const CodeObjectMetadata& metadata, GpuHeap heap);
 
     Result ApplyRelocations();
@@ -383,6 +397,16 @@ public:
     gpusize GpuMemSize() const { return m_gpuMemSize; }
     gpusize GpuMemOffset() const { return m_baseOffset; }
 
+    // Returns true if the uploaded code and data are owned by the PipelineUploadCache rather than the caller.
+    bool IsUploadCached() const { return m_cachedUpload; }
+    // Returns true if the code and data were uploaded by an earlier pipeline created from the same binary.
+    bool IsUploadShared() const { return m_sharedUpload; }
+
+    // Memory holding the loaded register values when they aren't stored alongside shared code and data.
+    GpuMemory* RegGpuMem() const { return m_pRegGpuMemory; }
+    gpusize RegGpuMemOffset() const { return m_regGpuMemOffset; }
+    gpusize RegGpuMemSize() const { return m_regGpuMemSize; }
+
     uint64 PagingFenceVal() const { return m_pagingFenceVal; }
 
     gpusize CtxRegGpuVirtAddr() const { return m_ctxRegGpuVirtAddr; }
@@ -437,6 +461,7 @@ private:
 
     Result UploadUsingCpu(const SectionAddressCalculator& addressCalc, void** ppMappedPtr);
     Result UploadUsingDma(const SectionAddressCalculator& addressCalc, void** ppMappedPtr);
+    Result UseSharedUpload(const SectionAddressCalculator& addressCalc, void** ppMappedPtr);
 
     Device*const m_pDevice;
     const AbiReader& m_abiReader;
@@ -468,6 +493,15 @@ private:
     UploadRingSlot  m_slotId;
     gpusize         m_heapInvisUploadOffset;
 
+    PipelineUploadCache*  m_pUploadCache;       // Cache to share the upload through, or null if sharing is disabled.
+    PipelineUploadKey     m_uploadKey;
+    bool                  m_sharedUpload;       // True if the code and data were uploaded by an earlier pipeline.
+    bool                  m_cachedUpload;       // True if the code and data are owned by m_pUploadCache.
+    UploadFenceToken      m_sharedUploadFence;  // Upload fence of the shared code and data.
+    GpuMemory*            m_pRegGpuMemory;      // Loaded register values for a shared upload.
+    gpusize               m_regGpuMemOffset;
+    gpusize               m_regGpuMemSize;
+
     PAL_DISALLOW_DEFAULT_CTOR(PipelineUploader);
     PAL_DISALLOW_COPY_AND_ASSIGN(PipelineUploader);
 };
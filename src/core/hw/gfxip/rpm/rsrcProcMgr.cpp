@@ -45,6 +45,7 @@
 #include "palFormatInfo.h"
 #include "palMsaaState.h"
 #include "palInlineFuncs.h"
+#include "palThread.h"
 
 #include <float.h>
 #include <math.h>
@@ -192,6 +193,24 @@ Result RsrcProcMgr::EarlyInit()
     return Result::Success;
 }
 
+// Parameters and result of the worker thread which creates RPM's compute pipelines during LateInit.
+struct RpmComputeInitJob
+{
+    GfxDevice*        pDevice;
+    ComputePipeline** ppPipelines;
+    Result            result;
+};
+
+// =====================================================================================================================
+// Entry point for the worker thread which creates RPM's compute pipelines.
+static void CreateRpmComputePipelinesThread(
+    void* pParameter)   // Opaque pointer to an RpmComputeInitJob
+{
+    RpmComputeInitJob*const pJob = static_cast<RpmComputeInitJob*>(pParameter);
+
+    pJob->result = CreateRpmComputePipelines(pJob->pDevice, pJob->ppPipelines);
+}
+
 // =====================================================================================================================
 // Performs any late-stage initialization that can only be done after settings have been committed.
 Result RsrcProcMgr::LateInit()
@@ -200,18 +219,33 @@ Result RsrcProcMgr::LateInit()
 
     if (m_pDevice->Parent()->GetPublicSettings()->disableResourceProcessingManager == false)
     {
-        result = CreateRpmComputePipelines(m_pDevice, m_pComputePipelines);
+        // Pipeline creation is thread-safe and the compute and graphics pipelines are independent, so the compute
+        // pipelines are created on a worker thread while this thread creates everything else. If the worker can't be
+        // started, the compute pipelines are simply created here.
+        RpmComputeInitJob computeJob = { m_pDevice, m_pComputePipelines, Result::Success };
+        Thread            computeThread;
 
-        if (result == Result::Success)
+        if (computeThread.Begin(&CreateRpmComputePipelinesThread, &computeJob) != Result::Success)
         {
-            result = CreateRpmGraphicsPipelines(m_pDevice, m_pGraphicsPipelines);
+            CreateRpmComputePipelinesThread(&computeJob);
         }
 
+        result = CreateRpmGraphicsPipelines(m_pDevice, m_pGraphicsPipelines);
+
         if (result == Result::Success)
         {
             result = CreateCommonStateObjects();
         }
 
+        if (computeThread.IsCreated())
+        {
+            computeThread.Join();
+        }
+
+        if (result == Result::Success)
+        {
+            result = computeJob.result;
+        }
     }
 
     return result;
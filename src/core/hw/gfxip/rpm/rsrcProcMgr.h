@@ -96,6 +96,15 @@ public:
     Result LateInit();
     void Cleanup();
 
+    // The internal pipelines and MSAA states are also bound directly by tools which record PAL's own shaders.
+    const ComputePipeline* GetPipeline(RpmComputePipeline pipeline) const
+        { return m_pComputePipelines[static_cast<size_t>(pipeline)]; }
+
+    const GraphicsPipeline* GetGfxPipeline(RpmGfxPipeline pipeline) const
+        { return m_pGraphicsPipelines[pipeline]; }
+
+    const MsaaState* GetMsaaState(uint32 samples, uint32 fragments) const;
+
     void CmdCopyImage(
         GfxCmdBuffer*          pCmdBuffer,
         const Image&           srcImage,
@@ -338,14 +347,6 @@ protected:
         const IndirectCmdGenerator& generator,
         const CmdBuffer&            cmdBuffer) const = 0;
 
-    const ComputePipeline* GetPipeline(RpmComputePipeline pipeline) const
-        { return m_pComputePipelines[static_cast<size_t>(pipeline)]; }
-
-    const GraphicsPipeline* GetGfxPipeline(RpmGfxPipeline pipeline) const
-        { return m_pGraphicsPipelines[pipeline]; }
-
-    const MsaaState* GetMsaaState(uint32 samples, uint32 fragments) const;
-
     const GraphicsPipeline* GetCopyDepthStencilPipeline(bool isDepth,
                                                         bool isDepthStencil,
                                                         uint32 numSamples) const;
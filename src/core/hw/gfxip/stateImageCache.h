@@ -0,0 +1,234 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+
+#pragma once
+
+#include "core/platform.h"
+#include "palFlatHashMapImpl.h"
+#include "palMutex.h"
+
+namespace Pal
+{
+
+// =====================================================================================================================
+// Device-level cache which interns the hardware register images of small immutable state objects (MSAA, color blend
+// and depth/stencil state).  Every state object created from an identical create info shares a single reference
+// counted image, so repeated creates only cost a hash lookup.
+//
+// StateObject must provide:
+// - Image:         The type of the interned hardware image.
+// - CreateInfo:    The create info type the image is built from.
+// - BuildImageKey: Copies a create info into a zeroed key; keys are hashed and compared bytewise.
+// - InitImage:     Builds the hardware image for a create info.
+//
+// Unreferenced images stay cached until the device is cleaned up, since clients tend to destroy and recreate the same
+// states. Once MaxCachedImages images exist, images for new keys are no longer cached and are freed on their last
+// release instead.
+template <typename StateObject>
+class StateImageCache
+{
+public:
+    typedef typename StateObject::Image      Image;
+    typedef typename StateObject::CreateInfo CreateInfo;
+
+    explicit StateImageCache(Platform* pPlatform);
+    ~StateImageCache() { Reset(); }
+
+    Result Init();
+    void Reset();
+
+    bool IsEnabled() const { return m_enabled; }
+
+    template <typename HwlDevice>
+    const Image* Acquire(const HwlDevice& device, const CreateInfo& createInfo);
+    void Release(const Image* pImage);
+
+private:
+    struct Entry
+    {
+        Image  image;    // Must be first so an image pointer can be converted back to its entry.
+        uint32 refCount; // Number of state objects referencing this image.
+        bool   cached;   // False if this image isn't in the map and must be freed on its last release.
+    };
+
+    // Upper bound on the number of interned images.
+    static constexpr uint32 MaxCachedImages = 4096;
+
+    // Initial number of entries in the image table.
+    static constexpr uint32 ImageMapElements = 64;
+
+    typedef Util::FlatHashMap<CreateInfo, Entry*, Platform, Util::JenkinsHashFunc> ImageMap;
+
+    Platform*const  m_pPlatform;
+    Util::Mutex     m_lock;
+    ImageMap        m_images;
+    bool            m_mapInitialized;
+    bool            m_enabled;
+
+    PAL_DISALLOW_DEFAULT_CTOR(StateImageCache);
+    PAL_DISALLOW_COPY_AND_ASSIGN(StateImageCache);
+};
+
+// =====================================================================================================================
+template <typename StateObject>
+StateImageCache<StateObject>::StateImageCache(
+    Platform* pPlatform)
+    :
+    m_pPlatform(pPlatform),
+    m_images(ImageMapElements, pPlatform),
+    m_mapInitialized(false),
+    m_enabled(false)
+{
+}
+
+// =====================================================================================================================
+// Enables interning. State objects created before this call own their images.
+template <typename StateObject>
+Result StateImageCache<StateObject>::Init()
+{
+    Result result = m_lock.Init();
+
+    // The table keeps its memory across Reset(), so it only needs to be initialized the first time we're enabled.
+    if ((result == Result::Success) && (m_mapInitialized == false))
+    {
+        result           = m_images.Init();
+        m_mapInitialized = (result == Result::Success);
+    }
+
+    m_enabled = (result == Result::Success);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Frees every interned image and disables interning. All state objects referencing the images must have been
+// destroyed already.
+template <typename StateObject>
+void StateImageCache<StateObject>::Reset()
+{
+    for (auto iter = m_images.Begin(); iter.Get() != nullptr; iter.Next())
+    {
+        Entry*const pEntry = iter.Get()->value;
+
+        PAL_ALERT(pEntry->refCount != 0);
+        PAL_FREE(pEntry, m_pPlatform);
+    }
+
+    m_images.Reset();
+    m_enabled = false;
+}
+
+// =====================================================================================================================
+// Returns a referenced hardware image for the given create info, building it if no identical create info has been
+// seen before. Returns null if we ran out of memory.
+template <typename StateObject>
+template <typename HwlDevice>
+const typename StateObject::Image* StateImageCache<StateObject>::Acquire(
+    const HwlDevice&  device,
+    const CreateInfo& createInfo)
+{
+    PAL_ASSERT(m_enabled);
+
+    CreateInfo key;
+    memset(&key, 0, sizeof(key));
+    StateObject::BuildImageKey(createInfo, &key);
+
+    Util::MutexAuto lock(&m_lock);
+
+    bool    existed  = false;
+    Entry** ppEntry  = nullptr;
+    Result  result   = Result::Success;
+
+    if (m_images.GetNumEntries() < MaxCachedImages)
+    {
+        result = m_images.FindAllocate(key, &existed, &ppEntry);
+    }
+    else
+    {
+        ppEntry = m_images.FindKey(key);
+        existed = (ppEntry != nullptr);
+    }
+
+    Entry* pEntry = nullptr;
+
+    if (existed)
+    {
+        pEntry = *ppEntry;
+    }
+    else if (result == Result::Success)
+    {
+        pEntry = static_cast<Entry*>(PAL_MALLOC(sizeof(Entry), m_pPlatform, Util::AllocInternal));
+
+        if (pEntry != nullptr)
+        {
+            StateObject::InitImage(device, createInfo, &pEntry->image);
+            pEntry->refCount = 0;
+            pEntry->cached   = (ppEntry != nullptr);
+
+            if (ppEntry != nullptr)
+            {
+                *ppEntry = pEntry;
+            }
+        }
+        else if (ppEntry != nullptr)
+        {
+            m_images.Erase(key);
+        }
+    }
+
+    const Image* pImage = nullptr;
+
+    if (pEntry != nullptr)
+    {
+        pEntry->refCount++;
+        pImage = &pEntry->image;
+    }
+
+    return pImage;
+}
+
+// =====================================================================================================================
+// Drops a reference to an image returned by Acquire().
+template <typename StateObject>
+void StateImageCache<StateObject>::Release(
+    const Image* pImage)
+{
+    static_assert(offsetof(Entry, image) == 0, "Entry::image must be the first member.");
+
+    Entry*const pEntry = reinterpret_cast<Entry*>(const_cast<Image*>(pImage));
+
+    Util::MutexAuto lock(&m_lock);
+
+    PAL_ASSERT(pEntry->refCount > 0);
+    pEntry->refCount--;
+
+    if ((pEntry->refCount == 0) && (pEntry->cached == false))
+    {
+        PAL_FREE(pEntry, m_pPlatform);
+    }
+}
+
+} // Pal
@@ -73,6 +73,22 @@ UniversalCmdBuffer::UniversalCmdBuffer(
     SwitchCmdSetUserDataFunc(PipelineBindPoint::Graphics, &CmdSetUserDataGfx<true>);
 }
 
+// =====================================================================================================================
+Result UniversalCmdBuffer::Init(
+    const CmdBufferInternalCreateInfo& internalInfo)
+{
+    Result result = GfxCmdBuffer::Init(internalInfo);
+
+    if (result == Result::Success)
+    {
+        // The ACE command stream is created on demand, so it is configured when it is created.
+        m_pDeCmdStream->EnableChunkRetention(RetainsChunksOnReset());
+        m_pCeCmdStream->EnableChunkRetention(RetainsChunksOnReset());
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Resets the command buffer's previous contents and state, then puts it into a building state allowing new commands
 // to be recorded.
@@ -205,6 +205,8 @@ struct ValidateDrawInfo
 class UniversalCmdBuffer : public GfxCmdBuffer
 {
 public:
+    virtual Result Init(const CmdBufferInternalCreateInfo& internalInfo) override;
+
     virtual Result Begin(const CmdBufferBuildInfo& info) override;
     virtual Result End() override;
     virtual Result Reset(ICmdAllocator* pCmdAllocator, bool returnDataChunks) override;
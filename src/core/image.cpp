@@ -30,6 +30,7 @@
 #include "core/image.h"
 #include "core/platform.h"
 #include "addrinterface.h"
+#include "palCmdBuffer.h"
 #include "palFormatInfo.h"
 #include "palImage.h"
 
@@ -1009,6 +1010,92 @@ Result Image::GetSubresourceLayout(
     return ret;
 }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+// =====================================================================================================================
+// Swizzles linear texel data from CPU memory into a region of this Image's CPU-mapped memory.
+Result Image::CpuCopyMemoryToImage(
+    const MemoryImageCopyRegion& region,
+    const void*                  pLinearData,
+    void*                        pImageData,
+    gpusize                      imageDataSize
+    ) const
+{
+    // The linear data is only read when copying to the Image.
+    return CpuSwizzleCopy(region, pImageData, imageDataSize, const_cast<void*>(pLinearData), true);
+}
+
+// =====================================================================================================================
+// Unswizzles texel data from a region of this Image's CPU-mapped memory into linear CPU memory.
+Result Image::CpuCopyImageToMemory(
+    const MemoryImageCopyRegion& region,
+    const void*                  pImageData,
+    gpusize                      imageDataSize,
+    void*                        pLinearData
+    ) const
+{
+    // The Image data is only read when copying from the Image.
+    return CpuSwizzleCopy(region, const_cast<void*>(pImageData), imageDataSize, pLinearData, false);
+}
+#endif
+
+// =====================================================================================================================
+// Validates a CPU copy region against this Image and hands the copy off to the address manager.
+Result Image::CpuSwizzleCopy(
+    const MemoryImageCopyRegion& region,
+    void*                        pImageData,
+    gpusize                      imageDataSize,
+    void*                        pLinearData,
+    bool                         toImage
+    ) const
+{
+    Result result = Result::Success;
+
+    if ((pImageData == nullptr) || (pLinearData == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (imageDataSize < m_gpuMemSize)
+    {
+        // Every subresource and its swizzled padding lies within the Image's GPU memory size, so a mapping at least
+        // that large can't be overrun by any region.
+        result = Result::ErrorInvalidMemorySize;
+    }
+    else if ((IsSubresourceValid(region.imageSubres) == false) ||
+             ((m_createInfo.imageType != ImageType::Tex3d) &&
+              ((region.numSlices == 0) ||
+               ((region.imageSubres.arraySlice + region.numSlices) > m_createInfo.arraySize))))
+    {
+        result = Result::ErrorInvalidValue;
+    }
+    else if ((m_createInfo.samples > 1) ||
+             ((m_pGfxImage != nullptr) && m_pGfxImage->HasMaskRam()))
+    {
+        // The copy only writes the image data itself, any compression or fast-clear state in the mask-ram would
+        // describe stale contents.
+        result = Result::Unsupported;
+    }
+    else
+    {
+        const Extent3d& extent = SubresourceInfo(region.imageSubres)->extentTexels;
+
+        if ((region.imageOffset.x < 0) ||
+            (region.imageOffset.y < 0) ||
+            (region.imageOffset.z < 0) ||
+            ((static_cast<uint32>(region.imageOffset.x) + region.imageExtent.width)  > extent.width)  ||
+            ((static_cast<uint32>(region.imageOffset.y) + region.imageExtent.height) > extent.height) ||
+            ((static_cast<uint32>(region.imageOffset.z) + region.imageExtent.depth)  > extent.depth))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+        else
+        {
+            result = m_pDevice->GetAddrMgr()->CpuSwizzleCopy(*this, region, pImageData, pLinearData, toImage);
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 Result Image::BindGpuMemory(
     IGpuMemory* pGpuMemory,
@@ -286,6 +286,18 @@ public:
     void DestroyInternal();
 
     virtual Result GetSubresourceLayout(SubresId subresId, SubresLayout* pLayout) const override;
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    virtual Result CpuCopyMemoryToImage(
+        const MemoryImageCopyRegion& region,
+        const void*                  pLinearData,
+        void*                        pImageData,
+        gpusize                      imageDataSize) const override;
+    virtual Result CpuCopyImageToMemory(
+        const MemoryImageCopyRegion& region,
+        const void*                  pImageData,
+        gpusize                      imageDataSize,
+        void*                        pLinearData) const override;
+#endif
     virtual Result BindGpuMemory(IGpuMemory* pGpuMemory, gpusize offset) override;
 
     Device* GetDevice() const { return m_pDevice; }
@@ -508,6 +520,13 @@ protected:
 private:
     uint32 DegradeMipDimension(uint32  mipDimension) const;
 
+    Result CpuSwizzleCopy(
+        const MemoryImageCopyRegion& region,
+        void*                        pImageData,
+        gpusize                      imageDataSize,
+        void*                        pLinearData,
+        bool                         toImage) const;
+
     static Result CreatePrivateScreenImageMemoryObject(
         Device*      pDevice,
         IImage*      pImage,
@@ -28,6 +28,7 @@
 #include "core/internalMemMgr.h"
 #include "core/platform.h"
 #include "palBuddyAllocatorImpl.h"
+#include "palFlatHashMapImpl.h"
 #include "palGpuMemoryBindable.h"
 #include "palListImpl.h"
 #include "palSysMemory.h"
@@ -41,10 +42,13 @@ namespace Pal
 static constexpr gpusize PoolAllocationSize       = 1ull << 22; // 4 megabytes
 static constexpr gpusize PoolMinSuballocationSize = 1ull << 4;  // 16 bytes
 
+// Initial number of entries in the pool and slab lookup tables.
+static constexpr uint32 PoolMapElements = 16;
+static constexpr uint32 SlabMapElements = 64;
+
 // =====================================================================================================================
-// Determines whether a base allocation matches the requested parameters
-static PAL_INLINE bool IsMatchingPool(
-    const GpuMemoryPool&    pool,
+// Builds the key identifying the set of pools which can satisfy a suballocation with the requested parameters
+static PAL_INLINE GpuMemoryPoolKey BuildPoolKey(
     bool                    readOnly,
     GpuMemoryFlags          memFlags,
     size_t                  heapCount,
@@ -52,29 +56,35 @@ static PAL_INLINE bool IsMatchingPool(
     VaRange                 vaRange,
     MType                   mtype)
 {
-    bool matches = true;
+    GpuMemoryPoolKey key;
+    memset(&key, 0, sizeof(key));
 
-    if ((pool.memFlags.u64All == memFlags.u64All) &&
-        (pool.heapCount       == heapCount)       &&
-        (pool.readOnly        == readOnly)        &&
-        (pool.vaRange         == vaRange)         &&
-        (pool.mtype           == mtype))
-    {
-        for (uint32 h = 0; h < heapCount; ++h)
-        {
-            if (pool.heaps[h] != heaps[h])
-            {
-                matches = false;
-                break;
-            }
-        }
-    }
-    else
+    key.memFlags  = memFlags;
+    key.vaRange   = vaRange;
+    key.mtype     = mtype;
+    key.readOnly  = (readOnly ? 1 : 0);
+    key.heapCount = static_cast<uint32>(heapCount);
+
+    for (uint32 h = 0; h < heapCount; ++h)
     {
-        matches = false;
+        key.heaps[h] = heaps[h];
     }
 
-    return matches;
+    return key;
+}
+
+// =====================================================================================================================
+// Returns the slab size class which can hold a suballocation of the given size and alignment, or NumSlabSizeClasses if
+// the suballocation is too large for a slab.
+static PAL_INLINE uint32 GetSlabSizeClass(
+    gpusize size,
+    gpusize alignment)
+{
+    const gpusize slotSize = Pow2Pad(Max(Max(size, alignment), MinSlabSlotSize));
+
+    return (slotSize <= (MinSlabSlotSize << (NumSlabSizeClasses - 1)))
+           ? (Log2(slotSize) - Log2(MinSlabSlotSize))
+           : NumSlabSizeClasses;
 }
 
 // =====================================================================================================================
@@ -129,9 +139,13 @@ InternalMemMgr::InternalMemMgr(
     :
     m_pDevice(pDevice),
     m_poolList(pDevice->GetPlatform()),
+    m_poolMap(PoolMapElements, pDevice->GetPlatform()),
+    m_poolSetMap(PoolMapElements, pDevice->GetPlatform()),
+    m_slabMap(SlabMapElements, pDevice->GetPlatform()),
     m_references(pDevice->GetPlatform()),
     m_referenceWatermark(0)
 {
+    memset(&m_stats, 0, sizeof(m_stats));
 }
 
 // =====================================================================================================================
@@ -146,6 +160,21 @@ Result InternalMemMgr::Init()
         result = m_referenceLock.Init();
     }
 
+    if (result == Result::Success)
+    {
+        result = m_poolMap.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_poolSetMap.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_slabMap.Init();
+    }
+
     return result;
 }
 
@@ -168,6 +197,17 @@ void InternalMemMgr::FreeAllocations()
         m_references.Erase(&it);
     }
 
+    // Free the slab bookkeeping; the slabs themselves live inside the pools' base allocations.
+    for (auto it = m_slabMap.Begin(); it.Get() != nullptr; it.Next())
+    {
+        PAL_FREE(it.Get()->value, m_pDevice->GetPlatform());
+    }
+
+    m_slabMap.Reset();
+    m_poolSetMap.Reset();
+    m_poolMap.Reset();
+    memset(&m_stats, 0, sizeof(m_stats));
+
     while (m_poolList.NumElements() != 0)
     {
         auto it = m_poolList.Begin();
@@ -254,131 +294,117 @@ Result InternalMemMgr::AllocateGpuMemNoAllocLock(
         // Calculate GPU memory flags based on the creation information
         const GpuMemoryFlags requestedMemFlags = ConvertGpuMemoryFlags(localCreateInfo, internalInfo);
 
-        result = Result::ErrorOutOfMemory;
-        // Try to find a base allocation of the appropriate type that has sufficient enough space
-        for (auto it = m_poolList.Begin(); it.Get() != nullptr; it.Next())
+        const GpuMemoryPoolKey poolKey = BuildPoolKey(readOnly,
+                                                      requestedMemFlags,
+                                                      localCreateInfo.heapCount,
+                                                      localCreateInfo.heaps,
+                                                      localCreateInfo.vaRange,
+                                                      internalInfo.mtype);
+
+        const uint32 sizeClass = GetSlabSizeClass(localCreateInfo.size, localCreateInfo.alignment);
+
+        bool            existed     = false;
+        GpuMemoryPool** ppPoolSet   = nullptr;
+        GpuMemoryPool*  pFoundPool  = nullptr;
+
+        result = m_poolSetMap.FindAllocate(poolKey, &existed, &ppPoolSet);
+
+        if (result == Result::Success)
         {
-            GpuMemoryPool* pPool = it.Get();
-
-            if (IsMatchingPool(*pPool,
-                               readOnly,
-                               requestedMemFlags,
-                               localCreateInfo.heapCount,
-                               localCreateInfo.heaps,
-                               localCreateInfo.vaRange,
-                               internalInfo.mtype))
+            result = Result::ErrorOutOfMemory;
+
+            if (sizeClass < NumSlabSizeClasses)
             {
-                // If the base allocation matches the search criteria then try to allocate from it
-                result = pPool->pBuddyAllocator->Allocate(localCreateInfo.size, localCreateInfo.alignment, pOffset);
+                // Tiny allocations prefer a free slot in an existing slab of any matching pool, and only then carve a
+                // new slab out of a matching pool.
+                for (GpuMemoryPool* pPool = *ppPoolSet; pPool != nullptr; pPool = pPool->pNextInSet)
+                {
+                    if (pPool->pPartialSlabs[sizeClass] != nullptr)
+                    {
+                        result = AllocateFromSlab(pPool, sizeClass, false, pOffset);
+                        PAL_ASSERT(result == Result::Success);
 
-                if (result == Result::Success)
+                        pFoundPool = pPool;
+                        break;
+                    }
+                }
+
+                for (GpuMemoryPool* pPool = *ppPoolSet; (pPool != nullptr) && (pFoundPool == nullptr);
+                     pPool = pPool->pNextInSet)
                 {
-                    // If we found a free block, fill in the memory object pointer from the base allocation and
-                    // stop searching
-                    *ppGpuMemory = pPool->pGpuMemory;
-                    if (internalInfo.pPagingFence != nullptr)
+                    if (AllocateFromSlab(pPool, sizeClass, true, pOffset) == Result::Success)
                     {
-                        *internalInfo.pPagingFence = pPool->pagingFenceVal;
+                        result     = Result::Success;
+                        pFoundPool = pPool;
+                    }
+                }
+            }
+            else
+            {
+                // Try to find a base allocation of the appropriate type that has sufficient enough space
+                for (GpuMemoryPool* pPool = *ppPoolSet; pPool != nullptr; pPool = pPool->pNextInSet)
+                {
+                    if (pPool->pBuddyAllocator->Allocate(localCreateInfo.size,
+                                                         localCreateInfo.alignment,
+                                                         pOffset) == Result::Success)
+                    {
+                        m_stats.numBuddyAllocs++;
+
+                        result     = Result::Success;
+                        pFoundPool = pPool;
+                        break;
                     }
-                    break;
                 }
             }
         }
 
-        if (result != Result::Success)
+        if ((result != Result::Success) && (ppPoolSet != nullptr))
         {
             // None of the existing base allocations had a free block large enough for us so we need to create
             // a new base allocation
+            GpuMemoryPool* pNewPool = nullptr;
 
-            // Fix-up the GPU memory create info structures to suit the base allocation's needs
-            GpuMemoryInternalCreateInfo localInternalInfo  = internalInfo;
-
-            const gpusize localCreateInfoAlignment = localCreateInfo.alignment;
-            const gpusize localCreateInfoSize = localCreateInfo.size;
-
-            localCreateInfo.size = PoolAllocationSize;
-            localCreateInfo.alignment = PoolAllocationSize / 2;
-            localInternalInfo.flags.buddyAllocated = 1;
-
-            GpuMemory* pGpuMemory = nullptr;
-
-            // Issue the base memory allocation
-            result = AllocateBaseGpuMem(localCreateInfo, localInternalInfo, readOnly, &pGpuMemory);
-            localCreateInfo.size = localCreateInfoSize;
-            localCreateInfo.alignment = localCreateInfoAlignment;
+            result = CreatePool(localCreateInfo, internalInfo, readOnly, requestedMemFlags, &pNewPool);
 
             if (result == Result::Success)
             {
-                // We need to add the newly allocated base allocation to the list
-                GpuMemoryPool newPool = {};
-
-                newPool.pGpuMemory = pGpuMemory;
-                newPool.readOnly   = readOnly;
-                newPool.memFlags   = requestedMemFlags;
-                newPool.heapCount  = localCreateInfo.heapCount;
-                newPool.vaRange    = localCreateInfo.vaRange;
-                newPool.mtype      = internalInfo.mtype;
-                if (internalInfo.pPagingFence != nullptr)
-                {
-                    newPool.pagingFenceVal = *internalInfo.pPagingFence;
-                }
+                // Newer pools are more likely to have free space, so search them first.
+                pNewPool->pNextInSet = *ppPoolSet;
+                (*ppPoolSet)         = pNewPool;
 
-                for (uint32 h = 0; h < localCreateInfo.heapCount; ++h)
+                // NOTE: The sub-allocation should never fail here since we just obtained a fresh base allocation, the
+                // only possible case for failure is a low system memory situation
+                if (sizeClass < NumSlabSizeClasses)
                 {
-                    newPool.heaps[h] = localCreateInfo.heaps[h];
+                    result = AllocateFromSlab(pNewPool, sizeClass, true, pOffset);
                 }
-
-                // Create and initialize the buddy allocator
-                newPool.pBuddyAllocator = PAL_NEW(BuddyAllocator<Platform>, m_pDevice->GetPlatform(), AllocInternal)
-                                          (m_pDevice->GetPlatform(), PoolAllocationSize, PoolMinSuballocationSize);
-
-                if (newPool.pBuddyAllocator != nullptr)
+                else
                 {
-                    // Try to initialize the buddy allocator
-                    result = newPool.pBuddyAllocator->Init();
-
-                    gpusize localOffset = 0;
-
+                    result = pNewPool->pBuddyAllocator->Allocate(localCreateInfo.size,
+                                                                 localCreateInfo.alignment,
+                                                                 pOffset);
                     if (result == Result::Success)
                     {
-                        // ... and then sub-allocate from it
-                        // NOTE: The sub-allocation should never fail here since we just optained a fresh base
-                        // allocation, the only possible case for failure is a low system memory situation
-                        result = newPool.pBuddyAllocator->Allocate(localCreateInfo.size,
-                                                                   localCreateInfo.alignment,
-                                                                   &localOffset);
-                    }
-
-                    // If we successfully sub-allocated from the new buddy allocator, then attempt to add the new pool
-                    // to the list
-                    if (result == Result::Success)
-                    {
-                        result = m_poolList.PushFront(newPool);
-                    }
-
-                    // Finally, if absolutely everything succeeded, return values to caller
-                    if (result == Result::Success)
-                    {
-                        *ppGpuMemory = pGpuMemory;
-                        *pOffset     = localOffset;
+                        m_stats.numBuddyAllocs++;
                     }
                 }
-                else
-                {
-                    result = Result::ErrorOutOfMemory;
-                }
 
-                // Undo any allocations if something went wrong
-                if (result != Result::Success)
+                if (result == Result::Success)
                 {
-                    // Delete the buddy allocator if it exists.
-                    PAL_DELETE(newPool.pBuddyAllocator, m_pDevice->GetPlatform());
-
-                    // If there was a failure then release the base allocation
-                    FreeBaseGpuMem(pGpuMemory);
+                    pFoundPool = pNewPool;
                 }
             }
         }
+
+        // Finally, if absolutely everything succeeded, return values to caller
+        if (result == Result::Success)
+        {
+            *ppGpuMemory = pFoundPool->pGpuMemory;
+            if (internalInfo.pPagingFence != nullptr)
+            {
+                *internalInfo.pPagingFence = pFoundPool->pagingFenceVal;
+            }
+        }
     }
     else if (result == Result::Success)
     {
@@ -498,21 +524,25 @@ Result InternalMemMgr::FreeGpuMem(
     {
         MutexAuto allocatorLock(&m_allocatorLock); // Ensure thread-safety using the lock
 
-        // Try to find the allocation in the pool list
-        for (auto it = m_poolList.Begin(); it.Get() != nullptr; it.Next())
+        // Find the pool which owns the allocation
+        GpuMemoryPool*const* ppPool = m_poolMap.FindKey(pGpuMemory);
+
+        if (ppPool != nullptr)
         {
-            GpuMemoryPool* pPool = it.Get();
+            GpuMemoryPool* pPool = *ppPool;
 
-            PAL_ASSERT((pPool->pGpuMemory != nullptr) && (pPool->pBuddyAllocator != nullptr));
+            PAL_ASSERT((pPool->pGpuMemory == pGpuMemory) && (pPool->pBuddyAllocator != nullptr));
 
-            if (pPool->pGpuMemory == pGpuMemory)
+            // Tiny allocations live in slabs; everything else is released with the buddy allocator.
+            if (FreeToSlab(pPool, offset) == false)
             {
-                // If found then use the buddy allocator to release the block
                 pPool->pBuddyAllocator->Free(offset);
 
-                result = Result::Success;
-                break;
+                PAL_ASSERT(m_stats.numBuddyAllocs > 0);
+                m_stats.numBuddyAllocs--;
             }
+
+            result = Result::Success;
         }
 
         // If we didn't find the allocation in the pool list then something went wrong with the allocation scheme
@@ -529,6 +559,283 @@ Result InternalMemMgr::FreeGpuMem(
     return result;
 }
 
+// =====================================================================================================================
+// Creates a new base allocation suitable for suballocating memory with the given properties and adds it to the pool
+// list and the pool lookup table. The caller is responsible for linking the new pool into its pool set.
+Result InternalMemMgr::CreatePool(
+    const GpuMemoryCreateInfo&          createInfo,
+    const GpuMemoryInternalCreateInfo&  internalInfo,
+    bool                                readOnly,
+    GpuMemoryFlags                      memFlags,
+    GpuMemoryPool**                     ppPool)
+{
+    // Fix-up the GPU memory create info structures to suit the base allocation's needs
+    GpuMemoryCreateInfo         localCreateInfo   = createInfo;
+    GpuMemoryInternalCreateInfo localInternalInfo = internalInfo;
+
+    localCreateInfo.size                   = PoolAllocationSize;
+    localCreateInfo.alignment              = PoolAllocationSize / 2;
+    localInternalInfo.flags.buddyAllocated = 1;
+
+    GpuMemory* pGpuMemory = nullptr;
+
+    // Issue the base memory allocation
+    Result result = AllocateBaseGpuMem(localCreateInfo, localInternalInfo, readOnly, &pGpuMemory);
+
+    if (result == Result::Success)
+    {
+        // We need to add the newly allocated base allocation to the list
+        GpuMemoryPool newPool = {};
+
+        newPool.pGpuMemory = pGpuMemory;
+        newPool.readOnly   = readOnly;
+        newPool.memFlags   = memFlags;
+        newPool.heapCount  = createInfo.heapCount;
+        newPool.vaRange    = createInfo.vaRange;
+        newPool.mtype      = internalInfo.mtype;
+        if (internalInfo.pPagingFence != nullptr)
+        {
+            newPool.pagingFenceVal = *internalInfo.pPagingFence;
+        }
+
+        for (uint32 h = 0; h < createInfo.heapCount; ++h)
+        {
+            newPool.heaps[h] = createInfo.heaps[h];
+        }
+
+        // Create and initialize the buddy allocator
+        newPool.pBuddyAllocator = PAL_NEW(BuddyAllocator<Platform>, m_pDevice->GetPlatform(), AllocInternal)
+                                  (m_pDevice->GetPlatform(), PoolAllocationSize, PoolMinSuballocationSize);
+
+        result = (newPool.pBuddyAllocator != nullptr) ? newPool.pBuddyAllocator->Init() : Result::ErrorOutOfMemory;
+
+        if (result == Result::Success)
+        {
+            result = m_poolList.PushFront(newPool);
+        }
+
+        if (result == Result::Success)
+        {
+            GpuMemoryPool* pPool = m_poolList.Begin().Get();
+
+            result = m_poolMap.Insert(pGpuMemory, pPool);
+
+            if (result == Result::Success)
+            {
+                m_stats.numPools++;
+                m_stats.poolBytes += PoolAllocationSize;
+
+                *ppPool = pPool;
+            }
+            else
+            {
+                auto it = m_poolList.Begin();
+                m_poolList.Erase(&it);
+            }
+        }
+
+        // Undo any allocations if something went wrong
+        if (result != Result::Success)
+        {
+            // Delete the buddy allocator if it exists.
+            PAL_DELETE(newPool.pBuddyAllocator, m_pDevice->GetPlatform());
+
+            // If there was a failure then release the base allocation
+            FreeBaseGpuMem(pGpuMemory);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Allocates a slot of the given size class from one of the pool's partially-used slabs. If the pool has none and
+// allowNewSlab is set, a new slab is carved out of the pool's buddy allocator first.
+Result InternalMemMgr::AllocateFromSlab(
+    GpuMemoryPool* pPool,
+    uint32         sizeClass,
+    bool           allowNewSlab,
+    gpusize*       pOffset)
+{
+    PAL_ASSERT(sizeClass < NumSlabSizeClasses);
+
+    Result         result = Result::Success;
+    GpuMemorySlab* pSlab  = pPool->pPartialSlabs[sizeClass];
+
+    if (pSlab == nullptr)
+    {
+        gpusize slabOffset = 0;
+
+        result = allowNewSlab ? pPool->pBuddyAllocator->Allocate(SlabSize, SlabSize, &slabOffset)
+                              : Result::ErrorOutOfMemory;
+
+        if (result == Result::Success)
+        {
+            pSlab = static_cast<GpuMemorySlab*>(PAL_CALLOC(sizeof(GpuMemorySlab),
+                                                           m_pDevice->GetPlatform(),
+                                                           AllocInternal));
+
+            if (pSlab != nullptr)
+            {
+                GpuMemorySlabKey key = {};
+                key.pGpuMemory = pPool->pGpuMemory;
+                key.offset     = slabOffset;
+
+                result = m_slabMap.Insert(key, pSlab);
+            }
+            else
+            {
+                result = Result::ErrorOutOfMemory;
+            }
+
+            if (result == Result::Success)
+            {
+                const uint32 numSlots = static_cast<uint32>(SlabSize / (MinSlabSlotSize << sizeClass));
+
+                pSlab->pPool        = pPool;
+                pSlab->offset       = slabOffset;
+                pSlab->sizeClass    = sizeClass;
+                pSlab->numFreeSlots = numSlots;
+
+                for (uint32 slot = 0; slot < numSlots; ++slot)
+                {
+                    WideBitfieldSetBit(pSlab->freeMask, slot);
+                }
+
+                pSlab->pNext                    = nullptr;
+                pPool->pPartialSlabs[sizeClass] = pSlab;
+
+                m_stats.numSlabs++;
+            }
+            else
+            {
+                PAL_SAFE_FREE(pSlab, m_pDevice->GetPlatform());
+                pPool->pBuddyAllocator->Free(slabOffset);
+            }
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        uint32 slot = 0;
+
+        const bool found = WideBitMaskScanForward(&slot, pSlab->freeMask);
+        PAL_ASSERT(found && (pSlab->numFreeSlots > 0));
+
+        WideBitfieldClearBit(pSlab->freeMask, slot);
+        pSlab->numFreeSlots--;
+
+        // Full slabs leave the partial list until one of their slots is freed.
+        if (pSlab->numFreeSlots == 0)
+        {
+            pPool->pPartialSlabs[sizeClass] = pSlab->pNext;
+
+            if (pSlab->pNext != nullptr)
+            {
+                pSlab->pNext->pPrev = nullptr;
+            }
+
+            pSlab->pPrev = nullptr;
+            pSlab->pNext = nullptr;
+        }
+
+        const gpusize slotSize = (MinSlabSlotSize << sizeClass);
+
+        *pOffset = pSlab->offset + (slot * slotSize);
+
+        m_stats.numSlabAllocs++;
+        m_stats.slabBytesInUse += slotSize;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Returns the suballocation at the given offset to the slab containing it. Returns false if the offset doesn't belong
+// to a slab, in which case it must be released with the pool's buddy allocator instead.
+bool InternalMemMgr::FreeToSlab(
+    GpuMemoryPool* pPool,
+    gpusize        offset)
+{
+    GpuMemorySlabKey key = {};
+    key.pGpuMemory = pPool->pGpuMemory;
+    key.offset     = (offset & ~(SlabSize - 1));
+
+    GpuMemorySlab*const* ppSlab = m_slabMap.FindKey(key);
+    const bool           isSlab = (ppSlab != nullptr);
+
+    if (isSlab)
+    {
+        GpuMemorySlab* pSlab     = *ppSlab;
+        const uint32   sizeClass = pSlab->sizeClass;
+        const gpusize  slotSize  = (MinSlabSlotSize << sizeClass);
+        const uint32   slot      = static_cast<uint32>((offset - pSlab->offset) / slotSize);
+        const uint32   numSlots  = static_cast<uint32>(SlabSize / slotSize);
+
+        PAL_ASSERT(((offset - pSlab->offset) % slotSize) == 0);
+        PAL_ASSERT(WideBitfieldIsSet(pSlab->freeMask, slot) == false);
+
+        // A full slab isn't on the partial list, so it needs to be linked back in.
+        if (pSlab->numFreeSlots == 0)
+        {
+            pSlab->pPrev = nullptr;
+            pSlab->pNext = pPool->pPartialSlabs[sizeClass];
+
+            if (pSlab->pNext != nullptr)
+            {
+                pSlab->pNext->pPrev = pSlab;
+            }
+
+            pPool->pPartialSlabs[sizeClass] = pSlab;
+        }
+
+        WideBitfieldSetBit(pSlab->freeMask, slot);
+        pSlab->numFreeSlots++;
+
+        PAL_ASSERT((m_stats.numSlabAllocs > 0) && (m_stats.slabBytesInUse >= slotSize));
+        m_stats.numSlabAllocs--;
+        m_stats.slabBytesInUse -= slotSize;
+
+        // Give completely free slabs back to the buddy allocator so that the space can be used by any size.
+        if (pSlab->numFreeSlots == numSlots)
+        {
+            if (pSlab->pPrev != nullptr)
+            {
+                pSlab->pPrev->pNext = pSlab->pNext;
+            }
+            else
+            {
+                pPool->pPartialSlabs[sizeClass] = pSlab->pNext;
+            }
+
+            if (pSlab->pNext != nullptr)
+            {
+                pSlab->pNext->pPrev = pSlab->pPrev;
+            }
+
+            m_slabMap.Erase(key);
+            pPool->pBuddyAllocator->Free(pSlab->offset);
+            PAL_FREE(pSlab, m_pDevice->GetPlatform());
+
+            m_stats.numSlabs--;
+        }
+    }
+
+    return isSlab;
+}
+
+// =====================================================================================================================
+// Reports statistics describing the pools' usage and fragmentation.
+void InternalMemMgr::GetStats(
+    InternalMemMgrStats* pStats)
+{
+    PAL_ASSERT(pStats != nullptr);
+
+    MutexAuto allocatorLock(&m_allocatorLock);
+
+    *pStats = m_stats;
+}
+
 // =====================================================================================================================
 // Frees a base GPU memory object allocation that was created by the internal memory manager.
 Result InternalMemMgr::FreeBaseGpuMem(
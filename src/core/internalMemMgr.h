@@ -27,6 +27,7 @@
 
 #include "core/gpuMemory.h"
 #include "palBuddyAllocator.h"
+#include "palFlatHashMap.h"
 #include "palMutex.h"
 
 namespace Pal
@@ -42,6 +43,27 @@ struct GpuMemoryInfo
     bool            readOnly;
 };
 
+// Tiny allocations are served from slabs: SlabSize-byte blocks taken from a pool's buddy allocator and divided into
+// equal slots of one of NumSlabSizeClasses power-of-two sizes, starting at MinSlabSlotSize.
+constexpr gpusize SlabSize           = 4096;
+constexpr gpusize MinSlabSlotSize    = 16;
+constexpr uint32  NumSlabSizeClasses = 5;
+constexpr uint32  MaxSlabSlots       = static_cast<uint32>(SlabSize / MinSlabSlotSize);
+
+struct GpuMemoryPool;
+
+// Contains the information describing a slab of tiny suballocations
+struct GpuMemorySlab
+{
+    GpuMemoryPool*  pPool;                          // Pool whose base allocation contains this slab
+    gpusize         offset;                         // Offset of this slab within the pool's base allocation
+    uint32          sizeClass;                      // Index of this slab's slot size class
+    uint32          numFreeSlots;                   // Number of slots which are currently free
+    uint64          freeMask[MaxSlabSlots / 64];    // One bit per slot, set if the slot is free
+    GpuMemorySlab*  pPrev;                          // Previous slab in the pool's list of partially-used slabs
+    GpuMemorySlab*  pNext;                          // Next slab in the pool's list of partially-used slabs
+};
+
 // Contains the information describing a GPU memory chunk pool
 struct GpuMemoryPool
 {
@@ -56,6 +78,47 @@ struct GpuMemoryPool
     uint64                          pagingFenceVal;         // Paging fence value
 
     Util::BuddyAllocator<Platform>* pBuddyAllocator;        // Buddy allocator used for the suballocation
+
+    GpuMemoryPool*                  pNextInSet;             // Next pool with the same properties as this one
+    GpuMemorySlab*                  pPartialSlabs[NumSlabSizeClasses]; // Slabs with free slots, per size class
+};
+
+// Identifies the set of pools which can satisfy a suballocation request. This is hashed and compared bytewise, so it
+// must be zeroed before being filled out.
+struct GpuMemoryPoolKey
+{
+    GpuMemoryFlags  memFlags;
+    VaRange         vaRange;
+    MType           mtype;
+    uint32          readOnly;
+    uint32          heapCount;
+    GpuHeap         heaps[GpuHeapCount];
+};
+
+// Identifies a slab by the pool's GPU memory object and the slab's offset within it. The key is hashed and compared
+// bytewise, so it must not contain implicit padding and must be zero-initialized before it is filled in.
+struct GpuMemorySlabKey
+{
+    const GpuMemory*  pGpuMemory;
+#if (PAL_COMPILE_TYPE == 32)
+    uint32            padding;
+#endif
+    gpusize           offset;
+};
+
+static_assert(sizeof(GpuMemorySlabKey) == (sizeof(uint64) + sizeof(gpusize)),
+              "GpuMemorySlabKey must not contain implicit padding.");
+
+// Statistics describing how well the InternalMemMgr's pools are being used.
+struct InternalMemMgrStats
+{
+    uint32   numPools;          // Number of base allocations which are being suballocated
+    gpusize  poolBytes;         // Combined size of those base allocations
+    uint32   numBuddyAllocs;    // Number of live suballocations served directly by the pools' buddy allocators
+    uint32   numSlabs;          // Number of slabs carved out of the pools
+    uint32   numSlabAllocs;     // Number of live suballocations served from slabs
+    gpusize  slabBytesInUse;    // Combined size of the slab slots in use; the slabs' fragmentation is the remainder
+                                // of numSlabs * SlabSize
 };
 
 // =====================================================================================================================
@@ -78,6 +141,10 @@ public:
 
     typedef Util::List<GpuMemoryPool, Platform>         GpuMemoryPoolList;
 
+    typedef Util::FlatHashMap<const GpuMemory*, GpuMemoryPool*, Platform>                           GpuMemoryPoolMap;
+    typedef Util::FlatHashMap<GpuMemoryPoolKey, GpuMemoryPool*, Platform, Util::JenkinsHashFunc>    GpuMemoryPoolSetMap;
+    typedef Util::FlatHashMap<GpuMemorySlabKey, GpuMemorySlab*, Platform, Util::JenkinsHashFunc>    GpuMemorySlabMap;
+
     explicit InternalMemMgr(Device* pDevice);
     ~InternalMemMgr() { FreeAllocations(); }
 
@@ -116,6 +183,9 @@ public:
     // Number of all allocations in the reference list. Note that this function takes the reference list lock.
     uint32 GetReferencesCount();
 
+    // Returns statistics about the suballocation pools. Note that this function takes the allocator lock.
+    void GetStats(InternalMemMgrStats* pStats);
+
 private:
     Result AllocateBaseGpuMem(
         const GpuMemoryCreateInfo&          createInfo,
@@ -126,6 +196,23 @@ private:
     Result FreeBaseGpuMem(
         GpuMemory*  pGpuMemory);
 
+    Result CreatePool(
+        const GpuMemoryCreateInfo&          createInfo,
+        const GpuMemoryInternalCreateInfo&  internalInfo,
+        bool                                readOnly,
+        GpuMemoryFlags                      memFlags,
+        GpuMemoryPool**                     ppPool);
+
+    Result AllocateFromSlab(
+        GpuMemoryPool*  pPool,
+        uint32          sizeClass,
+        bool            allowNewSlab,
+        gpusize*        pOffset);
+
+    bool FreeToSlab(
+        GpuMemoryPool*  pPool,
+        gpusize         offset);
+
     Device*const        m_pDevice;
 
     // Serialize access to the memory manager to ensure thread-safety
@@ -134,6 +221,15 @@ private:
     // Maintain a list of GPU memory objects that are sub-allocated
     GpuMemoryPoolList   m_poolList;
 
+    // Index the pools by their GPU memory object, by the properties they were created with (each entry is the head of
+    // a chain linked through GpuMemoryPool::pNextInSet), and their slabs by GPU memory object and offset.
+    GpuMemoryPoolMap    m_poolMap;
+    GpuMemoryPoolSetMap m_poolSetMap;
+    GpuMemorySlabMap    m_slabMap;
+
+    // Suballocation statistics. Protected by the allocator lock.
+    InternalMemMgrStats m_stats;
+
     // Maintain a list of internal GPU memory references
     GpuMemoryList       m_references;
 
@@ -2387,6 +2387,22 @@ public:
         SubresLayout* pLayout) const override
         { return m_pNextLayer->GetSubresourceLayout(subresId, pLayout); }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    virtual Result CpuCopyMemoryToImage(
+        const MemoryImageCopyRegion& region,
+        const void*                  pLinearData,
+        void*                        pImageData,
+        gpusize                      imageDataSize) const override
+        { return m_pNextLayer->CpuCopyMemoryToImage(region, pLinearData, pImageData, imageDataSize); }
+
+    virtual Result CpuCopyImageToMemory(
+        const MemoryImageCopyRegion& region,
+        const void*                  pImageData,
+        gpusize                      imageDataSize,
+        void*                        pLinearData) const override
+        { return m_pNextLayer->CpuCopyImageToMemory(region, pImageData, imageDataSize, pLinearData); }
+#endif
+
     virtual void GetGpuMemoryRequirements(
         GpuMemoryRequirements* pGpuMemReqs) const override
         { m_pNextLayer->GetGpuMemoryRequirements(pGpuMemReqs); }
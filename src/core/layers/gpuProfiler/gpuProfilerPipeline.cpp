@@ -260,6 +260,41 @@ void Pipeline::Destroy()
     PipelineDecorator::Destroy();
 }
 
+// =====================================================================================================================
+// Fills out the API shader to hardware stage mapping from the pipeline metadata.  Only the API shaders present in the
+// pipeline are decoded.
+Result Pipeline::InitApiHwMapping(
+    const PipelineMetadataView& metadataView,
+    MsgPackReader*              pMetadataReader)
+{
+    Result result     = Result::Success;
+    bool   hasMapping = false;
+
+    for (uint32 s = 0; ((result == Result::Success) && (s < static_cast<uint32>(ApiShaderType::Count))); ++s)
+    {
+        const ApiShaderType shaderType = static_cast<ApiShaderType>(s);
+
+        if (metadataView.HasShader(shaderType))
+        {
+            ShaderMetadata shaderMetadata;
+            result = metadataView.GetShader(pMetadataReader, shaderType, &shaderMetadata);
+
+            if ((result == Result::Success) && shaderMetadata.hasEntry.hardwareMapping)
+            {
+                m_apiHwMapping.apiShaders[s] = static_cast<uint8>(shaderMetadata.hardwareMapping);
+                hasMapping                   = true;
+            }
+        }
+    }
+
+    if ((result == Result::Success) && (hasMapping == false))
+    {
+        result = Result::Unsupported;
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 Result Pipeline::InitGfx(
     const GraphicsPipelineCreateInfo& createInfo)
@@ -271,12 +306,12 @@ Result Pipeline::InitGfx(
         PipelineAbiReader abiReader(m_pDevice->GetPlatform(), createInfo.pPipelineBinary);
         result = abiReader.Init();
 
-        MsgPackReader              metadataReader;
-        Abi::PalCodeObjectMetadata metadata;
+        MsgPackReader        metadataReader;
+        PipelineMetadataView metadataView;
 
         if (result == Result::Success)
         {
-            result = abiReader.GetMetadata(&metadataReader, &metadata);
+            result = abiReader.GetMetadataView(&metadataReader, &metadataView);
         }
 
         if (result == Result::Success)
@@ -286,9 +321,12 @@ Result Pipeline::InitGfx(
                           "HardwareStage::Cs is not located at the end of the HardwareStage enum!");
 
             // We need to check if any graphics stage contains performance data.
-            for (uint32 i = 0; i < static_cast<uint32>(HardwareStage::Cs); i++)
+            for (uint32 i = 0; ((result == Result::Success) && (i < static_cast<uint32>(HardwareStage::Cs))); i++)
             {
-                if (metadata.pipeline.hardwareStage[i].hasEntry.perfDataBufferSize != 0)
+                HardwareStageMetadata stageMetadata;
+                result = metadataView.GetHardwareStage(&metadataReader, static_cast<HardwareStage>(i), &stageMetadata);
+
+                if ((result == Result::Success) && (stageMetadata.hasEntry.perfDataBufferSize != 0))
                 {
                     // If the ELF contains any of the performance data buffer size entries, then one of the stages
                     // contains performance data.
@@ -296,17 +334,11 @@ Result Pipeline::InitGfx(
                     break;
                 }
             }
+        }
 
-            result = Result::Unsupported;
-
-            for (uint32 s = 0; s < static_cast<uint32>(ApiShaderType::Count); ++s)
-            {
-                if (metadata.pipeline.shader[s].hasEntry.hardwareMapping)
-                {
-                    m_apiHwMapping.apiShaders[s] = static_cast<uint8>(metadata.pipeline.shader[s].hardwareMapping);
-                    result = Result::Success;
-                }
-            }
+        if (result == Result::Success)
+        {
+            result = InitApiHwMapping(metadataView, &metadataReader);
         }
     }
 
@@ -324,29 +356,25 @@ Result Pipeline::InitCompute(
         PipelineAbiReader abiReader(m_pDevice->GetPlatform(), createInfo.pPipelineBinary);
         result = abiReader.Init();
 
-        MsgPackReader              metadataReader;
-        Abi::PalCodeObjectMetadata metadata;
+        MsgPackReader        metadataReader;
+        PipelineMetadataView metadataView;
 
         if (result == Result::Success)
         {
-            result = abiReader.GetMetadata(&metadataReader, &metadata);
+            result = abiReader.GetMetadataView(&metadataReader, &metadataView);
         }
 
         if (result == Result::Success)
         {
-            static constexpr uint32 HwStageCs = static_cast<uint32>(HardwareStage::Cs);
-            m_hasPerformanceData = (metadata.pipeline.hardwareStage[HwStageCs].hasEntry.perfDataBufferSize != 0);
+            HardwareStageMetadata stageMetadata;
+            result = metadataView.GetHardwareStage(&metadataReader, HardwareStage::Cs, &stageMetadata);
 
-            result = Result::Unsupported;
+            m_hasPerformanceData = ((result == Result::Success) && (stageMetadata.hasEntry.perfDataBufferSize != 0));
+        }
 
-            for (uint32 s = 0; s < static_cast<uint32>(ApiShaderType::Count); ++s)
-            {
-                if (metadata.pipeline.shader[s].hasEntry.hardwareMapping)
-                {
-                    m_apiHwMapping.apiShaders[s] = static_cast<uint8>(metadata.pipeline.shader[s].hardwareMapping);
-                    result = Result::Success;
-                }
-            }
+        if (result == Result::Success)
+        {
+            result = InitApiHwMapping(metadataView, &metadataReader);
         }
     }
 
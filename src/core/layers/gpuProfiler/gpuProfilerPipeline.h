@@ -30,6 +30,7 @@
 #include "g_palPipelineAbiMetadataImpl.h"
 
 namespace Util { class File;  }
+namespace Util { namespace Abi { class PipelineMetadataView; } }
 
 namespace Pal
 {
@@ -71,6 +72,10 @@ private:
         void*                 pPerfData,
         size_t                perfDataSize) const;
 
+    Result InitApiHwMapping(
+        const Util::Abi::PipelineMetadataView& metadataView,
+        Util::MsgPackReader*                   pMetadataReader);
+
     const Device*                    m_pDevice;
     Platform*                        m_pPlatform;
     bool                             m_hasPerformanceData;
@@ -693,6 +693,13 @@ void LogContext::Struct(
         Value("realtimeComputeUnits");
     }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    if (value.flags.retainChunksOnReset)
+    {
+        Value("retainChunksOnReset");
+    }
+#endif
+
     EndList();
     KeyAndObject("cmdAllocator", value.pCmdAllocator);
     KeyAndEnum("queueType", value.queueType);
@@ -901,6 +908,13 @@ void LogContext::Struct(
         Value("internalGpuMemAutoPriority");
     }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    if (value.flags.internStateObjects)
+    {
+        Value("internStateObjects");
+    }
+#endif
+
     EndList();
 
     KeyAndBeginMap("requestedEngineCounts", false);
@@ -2444,6 +2458,13 @@ void LogContext::Struct(
         Value("windowedPriorBlit");
     }
 
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    if (value.submitThread)
+    {
+        Value("submitThread");
+    }
+#endif
+
     EndList();
     KeyAndEnum("queueType", value.queueType);
     KeyAndEnum("engineType", value.engineType);
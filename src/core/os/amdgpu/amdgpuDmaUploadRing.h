@@ -41,7 +41,7 @@ public:
     virtual ~DmaUploadRing() {};
     virtual Result WaitForPendingUpload(
         Pal::Queue* pWaiter,
-        UploadFenceToken fenceValue);
+        uint64      timestamp);
 private:
     PAL_DISALLOW_DEFAULT_CTOR(DmaUploadRing);
     PAL_DISALLOW_COPY_AND_ASSIGN(DmaUploadRing);
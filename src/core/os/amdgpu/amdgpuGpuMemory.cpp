@@ -647,12 +647,15 @@ Result GpuMemory::OpenPeerMemory()
 }
 
 // =====================================================================================================================
-// Changes the allocation's priority. This has no meaning on Linux because the amdgpu driver doesn't support it.
+// Changes the allocation's priority. The amdgpu driver only sees priorities through the bo lists built at submit time,
+// so the queues must rebuild their global resource lists to pick up the new value.
 Result GpuMemory::OsSetPriority(
     GpuMemPriority       priority,
     GpuMemPriorityOffset priorityOffset)
 {
-    return Result::Success; // Pretend everything worked!
+    static_cast<Device*>(m_pDevice)->DirtyGlobalReferences();
+
+    return Result::Success;
 }
 
 // =====================================================================================================================
@@ -39,7 +39,7 @@
 #include "palAutoBuffer.h"
 #include "palDequeImpl.h"
 #include "palListImpl.h"
-#include "palHashMapImpl.h"
+#include "palFlatHashMapImpl.h"
 #include "palVectorImpl.h"
 
 #include <climits>
@@ -62,6 +62,35 @@ static constexpr uint8 LnxResourcePriorityTable[] =
     5,  // VeryHigh
 };
 
+// =====================================================================================================================
+// Returns the resource list priority value of a GPU memory allocation.
+static uint8 GetResourcePriority(
+    const GpuMemory& gpuMemory)
+{
+    // Max priority that Os accepts is 32, see AMDGPU_BO_LIST_MAX_PRIORITY.
+    // We reserve 3 bits for priority while 2 bits for offset
+    const uint8 offsetBits = static_cast<uint8>(gpuMemory.PriorityOffset()) / 2;
+
+    static_assert(
+        (static_cast<uint32>(Pal::GpuMemPriority::Count) == 6) &&
+         static_cast<uint32>(Pal::GpuMemPriorityOffset::Count) == 8,
+        "Pal GpuMemPriority or GpuMemPriorityOffset values changed. Consider to update strategy to convert"
+        "Pal GpuMemPriority and GpuMemPriorityOffset to lnx resource priority");
+
+    return (LnxResourcePriorityTable[static_cast<size_t>(gpuMemory.Priority())] << 2) | offsetBits;
+}
+
+// =====================================================================================================================
+// Returns true if the GPU memory allocation belongs to a presentable image.  Such an allocation can't be added to the
+// resource list while the image is owned by the Window System, so it has to be checked on every list rebuild.
+static bool IsPresentableMemory(
+    const GpuMemory& gpuMemory)
+{
+    const Image*const pImage = static_cast<Image*>(gpuMemory.GetImage());
+
+    return (pImage != nullptr) && pImage->IsPresentable();
+}
+
 // =====================================================================================================================
 // Helper function to get the IP type from engine type
 static uint32 GetIpType(
@@ -191,6 +220,8 @@ Queue::Queue(
     m_globalRefMap(static_cast<Device*>(m_pDevice)->IsVmAlwaysValidSupported() ? MemoryRefMapElementsPerVmBo :
                    MemoryRefMapElements, m_pDevice->GetPlatform()),
     m_globalRefDirty(true),
+    m_globalRefList(pDevice->GetPlatform()),
+    m_presentableRefList(pDevice->GetPlatform()),
     m_appMemRefCount(0),
     m_pendingWait(false),
     m_pCmdUploadRing(nullptr),
@@ -236,7 +267,21 @@ Result Queue::Init(
     const QueueCreateInfo* pCreateInfo,
     void*                  pContextPlacementAddr)
 {
-    Result result = Pal::Queue::Init(pCreateInfo, pContextPlacementAddr);
+    Result result = Result::Success;
+
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    // With a submit thread every submit is batched, and timestamp fences have no way to wait on a batched submit.
+    if ((pCreateInfo->submitThread != 0) &&
+        (static_cast<Device*>(m_pDevice)->GetFenceType() != FenceType::SyncObj))
+    {
+        result = Result::ErrorInvalidFlags;
+    }
+#endif
+
+    if (result == Result::Success)
+    {
+        result = Pal::Queue::Init(pCreateInfo, pContextPlacementAddr);
+    }
 
     if (result == Result::Success)
     {
@@ -330,30 +375,64 @@ Result Queue::AddGpuMemoryReferences(
 
     for (uint32 idx = 0; (idx < gpuMemRefCount) && (result == Result::Success); ++idx)
     {
-        uint32*    pRefCount     = nullptr;
-        bool       alreadyExists = false;
-        GpuMemory* pGpuMemory    = reinterpret_cast<GpuMemory*>(pGpuMemoryRefs[idx].pGpuMemory);
+        GpuMemory* pGpuMemory = reinterpret_cast<GpuMemory*>(pGpuMemoryRefs[idx].pGpuMemory);
 
-        if (pGpuMemory->IsVmAlwaysValid())
+        if (pGpuMemory->IsVmAlwaysValid() == false)
         {
-            continue;
+            result = AddGlobalReference(pGpuMemory);
         }
+    }
 
-        result = m_globalRefMap.FindAllocate(pGpuMemory, &alreadyExists, &pRefCount);
+    return result;
+}
 
-        if (result == Result::Success)
+// =====================================================================================================================
+// Adds one reference to a GPU memory object in the per-queue global list.  The first reference also adds the object to
+// the persistent resource list.  The caller must hold m_globalRefLock for writing.
+Result Queue::AddGlobalReference(
+    GpuMemory* pGpuMemory)
+{
+    GlobalRef* pRef          = nullptr;
+    bool       alreadyExists = false;
+
+    Result result = m_globalRefMap.FindAllocate(pGpuMemory, &alreadyExists, &pRef);
+
+    if (result == Result::Success)
+    {
+        if (alreadyExists)
         {
-            if (alreadyExists)
+            // The reference is already in the map, increment the ref count.
+            pRef->refCount++;
+        }
+        else
+        {
+            // Initialize the new value with one reference and append it to the matching resource list.
+            pRef->refCount      = 1;
+            pRef->isPresentable = IsPresentableMemory(*pGpuMemory);
+
+            if (pRef->isPresentable)
             {
-                // The reference is already in the map, increment the ref count.
-                (*pRefCount)++;
+                pRef->listIndex = m_presentableRefList.NumElements();
+                result          = m_presentableRefList.PushBack(pGpuMemory);
             }
             else
             {
-                // Initialize the new value with one reference.
-                *pRefCount       = 1;
+                GlobalRefListEntry entry = {};
+                entry.pGpuMemory = pGpuMemory;
+                entry.hSurface   = pGpuMemory->SurfaceHandle();
+
+                pRef->listIndex = m_globalRefList.NumElements();
+                result          = m_globalRefList.PushBack(entry);
+            }
+
+            if (result == Result::Success)
+            {
                 m_globalRefDirty = true;
             }
+            else
+            {
+                m_globalRefMap.Erase(pGpuMemory);
+            }
         }
     }
 
@@ -371,22 +450,71 @@ void Queue::RemoveGpuMemoryReferences(
 
     for (uint32 idx = 0; idx < gpuMemoryCount; ++idx)
     {
-        uint32* pRefCount = m_globalRefMap.FindKey(ppGpuMemory[idx]);
+        GlobalRef* pRef = m_globalRefMap.FindKey(ppGpuMemory[idx]);
 
-        if (pRefCount != nullptr)
+        if (pRef != nullptr)
         {
-            PAL_ASSERT(*pRefCount > 0);
-            (*pRefCount)--;
+            PAL_ASSERT(pRef->refCount > 0);
+            pRef->refCount--;
 
-            if ((*pRefCount == 0) || forceRemove)
+            if ((pRef->refCount == 0) || forceRemove)
             {
-                m_globalRefMap.Erase(ppGpuMemory[idx]);
-                m_globalRefDirty = true;
+                RemoveGlobalReference(ppGpuMemory[idx]);
             }
         }
     }
 }
 
+// =====================================================================================================================
+// Removes a GPU memory object from the per-queue global list and the persistent resource list.  The last entry of the
+// resource list takes the removed entry's place, so only that entry's list index needs to be updated.  The caller must
+// hold m_globalRefLock for writing.
+void Queue::RemoveGlobalReference(
+    IGpuMemory* pGpuMemory)
+{
+    const GlobalRef* const pRef      = m_globalRefMap.FindKey(pGpuMemory);
+    const uint32           listIndex = pRef->listIndex;
+    const GpuMemory*       pMoved    = nullptr;
+
+    // Don't look at the memory's image here: this can be reached from ~GpuMemory after the image is gone.
+    if (pRef->isPresentable)
+    {
+        PAL_ASSERT(m_presentableRefList.At(listIndex) == pGpuMemory);
+
+        m_presentableRefList.PopBack(&pMoved);
+
+        if (listIndex < m_presentableRefList.NumElements())
+        {
+            m_presentableRefList.At(listIndex) = pMoved;
+        }
+        else
+        {
+            pMoved = nullptr;
+        }
+    }
+    else
+    {
+        PAL_ASSERT(m_globalRefList.At(listIndex).pGpuMemory == pGpuMemory);
+
+        GlobalRefListEntry lastEntry = {};
+        m_globalRefList.PopBack(&lastEntry);
+
+        if (listIndex < m_globalRefList.NumElements())
+        {
+            m_globalRefList.At(listIndex) = lastEntry;
+            pMoved                        = lastEntry.pGpuMemory;
+        }
+    }
+
+    if (pMoved != nullptr)
+    {
+        m_globalRefMap.FindKey(const_cast<GpuMemory*>(pMoved))->listIndex = listIndex;
+    }
+
+    m_globalRefMap.Erase(pGpuMemory);
+    m_globalRefDirty = true;
+}
+
 // =====================================================================================================================
 // Remapping the physical memory with new virtual address.
 Result Queue::OsRemapVirtualMemoryPages(
@@ -1119,29 +1247,17 @@ Result Queue::UpdateResourceList(
             {
                 // If the global memory references haven't been modified since the last submit,
                 // the resources in our UMD-side list (m_pResourceList) should be up to date.
-                // So, there is no need to re-walk through m_memList.
+                // So, there is no need to copy them in again.
                 if (m_globalRefDirty == false)
                 {
                     m_numResourcesInList += m_memListResourcesInList;
                 }
                 else
                 {
-                    m_globalRefDirty = false;
-
-                    for (auto iter = m_globalRefMap.Begin(); iter.Get() != nullptr; iter.Next())
-                    {
-                        const auto*const pGpuMemory = static_cast<const GpuMemory*>(iter.Get()->key);
-
-                        result = AppendResourceToList(pGpuMemory);
-
-                        if (result != Result::_Success)
-                        {
-                            // We didn't rebuild the whole list so keep it marked as dirty.
-                            m_globalRefDirty = true;
-                            break;
-                        }
-                    }
+                    result = AppendGlobalResourcesToList();
 
+                    // If we didn't rebuild the whole list keep it marked as dirty.
+                    m_globalRefDirty         = (result != Result::Success);
                     m_memListResourcesInList = m_numResourcesInList;
                 }
             }
@@ -1168,6 +1284,45 @@ Result Queue::UpdateResourceList(
     return result;
 }
 
+// =====================================================================================================================
+// Appends all global memory references to the list of buffer objects which get submitted with a set of command
+// buffers.  The bo handles of the persistent part of the list are copied as is, but priorities are read again since
+// they may have changed; only presentable images need to be checked again.
+Result Queue::AppendGlobalResourcesToList()
+{
+    Result       result     = Result::ErrorTooManyMemoryReferences;
+    const uint32 numEntries = m_globalRefList.NumElements();
+
+    if ((m_numResourcesInList + numEntries) <= m_resourceListSize)
+    {
+        const GlobalRefListEntry*const pEntries = m_globalRefList.Data();
+
+        for (uint32 idx = 0; idx < numEntries; ++idx)
+        {
+            m_pResourceList[m_numResourcesInList + idx] = pEntries[idx].hSurface;
+        }
+
+        if (m_pResourcePriorityList != nullptr)
+        {
+            for (uint32 idx = 0; idx < numEntries; ++idx)
+            {
+                m_pResourcePriorityList[m_numResourcesInList + idx] = GetResourcePriority(*pEntries[idx].pGpuMemory);
+            }
+        }
+
+        m_numResourcesInList += numEntries;
+
+        result = Result::Success;
+    }
+
+    for (uint32 idx = 0; (idx < m_presentableRefList.NumElements()) && (result == Result::Success); ++idx)
+    {
+        result = AppendResourceToList(m_presentableRefList.At(idx));
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Appends a bo to the list of buffer objects which get submitted with a set of command buffers.
 Result Queue::AppendResourceToList(
@@ -1190,17 +1345,7 @@ Result Queue::AppendResourceToList(
 
             if (m_pResourcePriorityList != nullptr)
             {
-                // Max priority that Os accepts is 32, see AMDGPU_BO_LIST_MAX_PRIORITY.
-                // We reserve 3 bits for priority while 2 bits for offset
-                const uint8 offsetBits = static_cast<uint8>(pGpuMemory->PriorityOffset()) / 2;
-
-                static_assert(
-                    (static_cast<uint32>(Pal::GpuMemPriority::Count) == 6) &&
-                     static_cast<uint32>(Pal::GpuMemPriorityOffset::Count) == 8,
-                    "Pal GpuMemPriority or GpuMemPriorityOffset values changed. Consider to update strategy to convert"
-                    "Pal GpuMemPriority and GpuMemPriorityOffset to lnx resource priority");
-                m_pResourcePriorityList[m_numResourcesInList] =
-                    (LnxResourcePriorityTable[static_cast<size_t>(pGpuMemory->Priority())] << 2) | offsetBits;
+                m_pResourcePriorityList[m_numResourcesInList] = GetResourcePriority(*pGpuMemory);
             }
 
             ++m_numResourcesInList;
@@ -27,7 +27,7 @@
 
 #include "core/queue.h"
 #include "core/os/amdgpu/amdgpuHeaders.h"
-#include "palHashMap.h"
+#include "palFlatHashMap.h"
 #include "palVector.h"
 
 // It is a temporary solution while we are waiting for open source promotion.
@@ -65,9 +65,9 @@ enum class CommandListType : uint32
 // Maximum number of IB's we will specify in a single submission to the GPU.
 constexpr uint32 MaxIbsPerSubmit = 16;
 
-// Initial size of m_globalRefMap, the size of hashmap affects the performance of traversing the hashmap badly. When
-// perVmBo enabled, there is usually less than 3 presentable image in the m_globalRefMap. So set it 16 is enough for
-// most of the games when perVmBo enabled. When perVmBo disabled, set it 1024.
+// Initial capacity of m_globalRefMap; the map grows as needed. When perVmBo enabled, there is usually less than 3
+// presentable image in the m_globalRefMap. So set it 16 is enough for most of the games when perVmBo enabled. When
+// perVmBo disabled, set it 1024.
 constexpr uint32 MemoryRefMapElementsPerVmBo = 16;
 constexpr uint32 MemoryRefMapElements        = 1024;
 
@@ -183,6 +183,14 @@ private:
     Result AppendResourceToList(
         const GpuMemory* pGpuMemory);
 
+    Result AppendGlobalResourcesToList();
+
+    Result AddGlobalReference(
+        GpuMemory* pGpuMemory);
+
+    void RemoveGlobalReference(
+        IGpuMemory* pGpuMemory);
+
     Result AddCmdStream(
         const CmdStream& cmdStream,
         bool             isDummySubmission,
@@ -224,8 +232,26 @@ private:
         const MultiSubmitInfo&    submitInfo,
         const InternalSubmitInfo& internalSubmitInfo);
 
-    // Tracks global memory references for this queue. Each key is a GPU memory object and each value is a refcount.
-    typedef Util::HashMap<IGpuMemory*, uint32, Pal::Platform> MemoryRefMap;
+    // Value of a global memory reference: its refcount and its index in m_globalRefList or m_presentableRefList.
+    // Whether the memory is presentable is recorded when it is added, since the bound image may already be destroyed
+    // by the time the reference is removed.
+    struct GlobalRef
+    {
+        uint32 refCount;
+        uint32 listIndex;
+        bool   isPresentable;
+    };
+
+    // Tracks global memory references for this queue. Each key is a GPU memory object.
+    typedef Util::FlatHashMap<IGpuMemory*, GlobalRef, Pal::Platform> MemoryRefMap;
+
+    // A global memory reference along with the bo handle it contributes to the resource list.  The priority isn't
+    // cached because the client can change it at any time with IGpuMemory::SetPriority().
+    struct GlobalRefListEntry
+    {
+        const GpuMemory* pGpuMemory;
+        amdgpu_bo_handle hSurface;
+    };
 
     // Kernel object representing a list of GPU memory allocations referenced by a submit.
     // Stored as a member variable to prevent re-creating the kernel object on every submit
@@ -235,6 +261,13 @@ private:
     Pal::CmdStream*       m_pDummyCmdStream;      // The dummy command stream used by dummy submission.
     MemoryRefMap          m_globalRefMap;         // A hashmap acting as a refcounted list of memory references.
     bool                  m_globalRefDirty;       // Indicates m_globalRefMap has changed since the last submit.
+
+    // The entries of m_globalRefMap in resource list form, kept up to date as references are added and removed so that
+    // a submit after a change only has to copy them instead of walking the map.  Presentable images are kept apart
+    // since whether they are added depends on their idle state at submit time.
+    Util::Vector<GlobalRefListEntry, 16, Platform> m_globalRefList;
+    Util::Vector<const GpuMemory*, 4, Platform>    m_presentableRefList;
+
     Util::RWLock          m_globalRefLock;        // Protect m_globalRefMap from muli-thread access.
     uint32                m_appMemRefCount;       // Store count of application's submission memory references.
     bool                  m_pendingWait;          // Queue needs a dummy submission between wait and signal.
@@ -46,7 +46,8 @@ SyncobjFence::SyncobjFence(
     const Device&    device)
     :
     m_fenceSyncObject(0),
-    m_device(device)
+    m_device(device),
+    m_pContext(nullptr)
 {
 }
 
@@ -57,6 +58,12 @@ SyncobjFence::~SyncobjFence()
 
     result = m_device.DestroySyncObject(m_fenceSyncObject);
     PAL_ASSERT(result == Result::Success);
+
+    if (m_pContext != nullptr)
+    {
+        m_pContext->ReleaseReference();
+        m_pContext = nullptr;
+    }
 }
 
 // =====================================================================================================================
@@ -122,6 +129,14 @@ Result SyncobjFence::WaitForFences(
 
             const auto*const pSyncobjFence = static_cast<const SyncobjFence*>(ppFenceList[fence]);
 
+            // A fence whose submit thread failed may never be signaled, so don't wait for it.
+            if ((pSyncobjFence->SubmitError() != Result::Success) &&
+                (pSyncobjFence->IsSyncobjSignaled(pSyncobjFence->m_fenceSyncObject) == false))
+            {
+                result = pSyncobjFence->SubmitError();
+                break;
+            }
+
             fenceList[count] = pSyncobjFence->m_fenceSyncObject;
             count++;
         }
@@ -242,6 +257,22 @@ OsExternalHandle SyncobjFence::ExportExternalHandle(
 void SyncobjFence::AssociateWithContext(
     Pal::SubmissionContext* pContext)
 {
+    // The sync object itself tracks the submission; the context is only kept to see errors from its submit thread.
+    if (pContext != m_pContext)
+    {
+        if (m_pContext != nullptr)
+        {
+            m_pContext->ReleaseReference();
+        }
+
+        m_pContext = pContext;
+
+        if (m_pContext != nullptr)
+        {
+            m_pContext->TakeReference();
+        }
+    }
+
     m_fenceState.neverSubmitted = 0;
 }
 
@@ -258,6 +289,13 @@ Result SyncobjFence::Reset()
     // the initial signal state should be reset to false even though it is created as signaled at the first place.
     m_fenceState.initialSignalState = 0;
 
+    // Errors from the last submitting queue don't apply to the fence's next submission.
+    if (m_pContext != nullptr)
+    {
+        m_pContext->ReleaseReference();
+        m_pContext = nullptr;
+    }
+
     result = m_device.ResetSyncObject(&m_fenceSyncObject, 1);
 
     return result;
@@ -303,7 +341,8 @@ Result SyncobjFence::GetStatus() const
     // After we start removing ErrorFenceNeverSubmitted in another changelist, I will remove the second the if block.
     if ((IsSyncobjSignaled(m_fenceSyncObject) == false) && (WasNeverSubmitted() == false))
     {
-        result = Result::NotReady;
+        // The submission may never happen if the submit thread of the queue which took this fence has failed.
+        result = (SubmitError() != Result::Success) ? SubmitError() : Result::NotReady;
     }
     else if ((IsSyncobjSignaled(m_fenceSyncObject) == false) && (WasNeverSubmitted() == true))
     {
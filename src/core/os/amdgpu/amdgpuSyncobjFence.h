@@ -80,8 +80,13 @@ private:
     bool IsSyncobjSignaled(
         amdgpu_syncobj_handle    syncObj) const;
 
+    Result SubmitError() const
+        { return (m_pContext != nullptr) ? m_pContext->SubmitError() : Result::Success; }
+
     amdgpu_syncobj_handle        m_fenceSyncObject;
     const Device&                m_device;
+    Pal::SubmissionContext*      m_pContext; // Context of the queue which last submitted this fence, if any. Only
+                                             // used to report errors latched by the queue's submit thread.
 
     PAL_DISALLOW_COPY_AND_ASSIGN(SyncobjFence);
 };
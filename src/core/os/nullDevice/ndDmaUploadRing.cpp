@@ -41,7 +41,7 @@ DmaUploadRing::DmaUploadRing(Device* pDevice)
 
 Result DmaUploadRing::WaitForPendingUpload(
     Pal::Queue* pWaiter,
-    UploadFenceToken fenceValue)
+    uint64      timestamp)
 {
     return Result::Success;
 }
@@ -41,7 +41,7 @@ class DmaUploadRing : public Pal::DmaUploadRing
 public:
     explicit DmaUploadRing(Device* pDevice);
     virtual ~DmaUploadRing() {};
-    virtual Result WaitForPendingUpload(Pal::Queue* pWaiter, UploadFenceToken fenceValue);
+    virtual Result WaitForPendingUpload(Pal::Queue* pWaiter, uint64 timestamp);
 private:
     PAL_DISALLOW_DEFAULT_CTOR(DmaUploadRing);
     PAL_DISALLOW_COPY_AND_ASSIGN(DmaUploadRing);
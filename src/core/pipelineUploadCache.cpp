@@ -0,0 +1,177 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+
+#include "core/device.h"
+#include "core/pipelineUploadCache.h"
+#include "core/platform.h"
+#include "palFlatHashMapImpl.h"
+
+using namespace Util;
+
+namespace Pal
+{
+
+// Initial number of entries in the upload table.
+static constexpr uint32 UploadMapElements = 64;
+
+// =====================================================================================================================
+PipelineUploadCache::PipelineUploadCache(
+    Device* pDevice)
+    :
+    m_pDevice(pDevice),
+    m_uploads(UploadMapElements, pDevice->GetPlatform())
+{
+}
+
+// =====================================================================================================================
+Result PipelineUploadCache::Init()
+{
+    Result result = m_lock.Init();
+
+    if (result == Result::Success)
+    {
+        result = m_uploads.Init();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Forgets all cached uploads. The GPU memory is owned by the InternalMemMgr, which frees it during device cleanup.
+void PipelineUploadCache::Reset()
+{
+    MutexAuto lock(&m_lock);
+
+    // Every pipeline should have been destroyed by now.
+    PAL_ALERT(m_uploads.GetNumEntries() != 0);
+
+    m_uploads.Reset();
+}
+
+// =====================================================================================================================
+// Looks for a completed upload of the given pipeline binary. If one is found, a reference to it is added and its
+// description is returned through pEntry.
+bool PipelineUploadCache::Acquire(
+    const PipelineUploadKey& key,
+    PipelineUploadEntry*     pEntry)
+{
+    PAL_ASSERT(pEntry != nullptr);
+
+    MutexAuto lock(&m_lock);
+
+    PipelineUploadEntry*const pUpload = m_uploads.FindKey(key);
+    const bool                found   = ((pUpload != nullptr) && pUpload->complete);
+
+    if (found)
+    {
+        pUpload->refCount++;
+        *pEntry = *pUpload;
+    }
+
+    return found;
+}
+
+// =====================================================================================================================
+// Adds a new upload of the given pipeline binary, referenced once by its creator. The entry can't be shared until the
+// creator calls Complete(). Returns false if the binary is already cached or the entry couldn't be added; the caller
+// then keeps sole ownership of its upload.
+bool PipelineUploadCache::Insert(
+    const PipelineUploadKey&   key,
+    const PipelineUploadEntry& entry)
+{
+    MutexAuto lock(&m_lock);
+
+    bool                 existed = false;
+    PipelineUploadEntry* pUpload = nullptr;
+
+    const bool inserted = ((m_uploads.FindAllocate(key, &existed, &pUpload) == Result::Success) && (existed == false));
+
+    if (inserted)
+    {
+        *pUpload          = entry;
+        pUpload->refCount = 1;
+        pUpload->complete = false;
+    }
+
+    return inserted;
+}
+
+// =====================================================================================================================
+// Marks an upload added by Insert() as submitted, allowing other pipelines to share it.
+void PipelineUploadCache::Complete(
+    const PipelineUploadKey& key,
+    UploadFenceToken         uploadFence)
+{
+    MutexAuto lock(&m_lock);
+
+    PipelineUploadEntry*const pUpload = m_uploads.FindKey(key);
+    PAL_ASSERT((pUpload != nullptr) && (pUpload->complete == false));
+
+    pUpload->uploadFence = uploadFence;
+    pUpload->complete    = true;
+}
+
+// =====================================================================================================================
+// Drops a reference to a cached upload, freeing its GPU memory once no pipeline uses it.
+void PipelineUploadCache::Release(
+    const PipelineUploadKey& key)
+{
+    GpuMemory*       pGpuMemory  = nullptr;
+    gpusize          offset      = 0;
+    UploadFenceToken uploadFence = 0;
+
+    {
+        MutexAuto lock(&m_lock);
+
+        PipelineUploadEntry*const pUpload = m_uploads.FindKey(key);
+        PAL_ASSERT((pUpload != nullptr) && (pUpload->refCount > 0));
+
+        pUpload->refCount--;
+
+        if (pUpload->refCount == 0)
+        {
+            pGpuMemory  = pUpload->pGpuMemory;
+            offset      = pUpload->offset;
+            uploadFence = pUpload->uploadFence;
+
+            m_uploads.Erase(key);
+        }
+    }
+
+    if (pGpuMemory != nullptr)
+    {
+        // The upload may still be in flight on the DMA upload ring.
+        if (uploadFence > 0)
+        {
+            const Result result = m_pDevice->WaitForPendingUpload(nullptr, uploadFence);
+            PAL_ALERT(result != Result::Success);
+        }
+
+        m_pDevice->MemMgr()->FreeGpuMem(pGpuMemory, offset);
+    }
+}
+
+} // Pal
@@ -0,0 +1,92 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+
+#pragma once
+
+#include "core/dmaUploadRing.h"
+#include "palFlatHashMap.h"
+#include "palMetroHash.h"
+#include "palMutex.h"
+
+namespace Pal
+{
+
+class Device;
+class GpuMemory;
+class Platform;
+
+// Identifies a pipeline upload: the hash of the pipeline ELF binary plus the remaining inputs which affect the uploaded
+// code and data. This is hashed and compared bytewise, so it must be zeroed before being filled out.
+struct PipelineUploadKey
+{
+    Util::MetroHash::Hash  elfHash;  // 128-bit hash of the pipeline ELF binary
+    uint64                 elfSize;  // Size of the pipeline ELF binary, in bytes
+    GpuHeap                heap;     // Client-preferred upload heap
+    uint32                 reserved;
+};
+
+// Describes a pipeline's uploaded code and data which can be shared by other pipelines created from the same binary.
+struct PipelineUploadEntry
+{
+    GpuMemory*        pGpuMemory;      // GPU memory holding the uploaded ELF sections
+    gpusize           offset;          // Offset of the uploaded ELF sections within pGpuMemory
+    gpusize           gpuMemSize;      // Size of the suballocation
+    uint64            pagingFenceVal;  // Paging fence value of the suballocation
+    UploadFenceToken  uploadFence;     // Fence to wait on before the uploaded code can be executed
+    uint32            refCount;        // Number of pipelines referencing this upload
+    bool              complete;        // Set once the upload has been submitted; incomplete entries can't be shared
+};
+
+// =====================================================================================================================
+// Device-wide cache of uploaded pipeline code and data, keyed on the pipeline ELF binary. Pipelines created from a
+// binary which has already been uploaded share the existing relocated code and data instead of uploading a new copy.
+// Entries are reference-counted and their GPU memory is freed when the last pipeline using them is destroyed.
+class PipelineUploadCache
+{
+public:
+    explicit PipelineUploadCache(Device* pDevice);
+    ~PipelineUploadCache() { }
+
+    Result Init();
+    void Reset();
+
+    bool Acquire(const PipelineUploadKey& key, PipelineUploadEntry* pEntry);
+    bool Insert(const PipelineUploadKey& key, const PipelineUploadEntry& entry);
+    void Complete(const PipelineUploadKey& key, UploadFenceToken uploadFence);
+    void Release(const PipelineUploadKey& key);
+
+private:
+    typedef Util::FlatHashMap<PipelineUploadKey, PipelineUploadEntry, Platform, Util::JenkinsHashFunc> UploadMap;
+
+    Device*const  m_pDevice;
+    Util::Mutex   m_lock;
+    UploadMap     m_uploads;
+
+    PAL_DISALLOW_DEFAULT_CTOR(PipelineUploadCache);
+    PAL_DISALLOW_COPY_AND_ASSIGN(PipelineUploadCache);
+};
+
+} // Pal
@@ -40,7 +40,6 @@
 #include "core/hw/gfxip/gfxCmdBuffer.h"
 #include "core/hw/gfxip/rpm/rsrcProcMgr.h"
 #include "core/hw/gfxip/pipeline.h"
-#include "palDequeImpl.h"
 #include "palSysUtil.h"
 #include "palAutoBuffer.h"
 
@@ -49,6 +48,8 @@ using namespace Util;
 namespace Pal
 {
 
+BatchedQueueCmdNode Queue::s_closedBatchedCmds = { };
+
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 555
 // Struct for passing the log file and pal setting pointers to the command buffer dump callback.
 struct CmdDumpToFilePayload
@@ -241,10 +242,12 @@ Queue::Queue(
     m_ifhMode(IfhModeDisabled),
     m_pQueueInfos(nullptr),
     m_queueCount(queueCount),
-    m_stalled(false),
     m_pWaitingSemaphore(nullptr),
     m_batchedSubmissionCount(0),
-    m_batchedCmds(pDevice->GetPlatform()),
+    m_pBatchedCmdsHead(ClosedBatchedCmds()),
+    m_pPendingCmds(nullptr),
+    m_stalledOnSemaphore(false),
+    m_submitThreadEnd(false),
     m_deviceMembershipNode(this),
     m_lastFrameCnt(0),
     m_submitIdPerFrame(0)
@@ -269,8 +272,43 @@ Queue::~Queue()
 // queues' virtual functions.
 void Queue::Destroy()
 {
-    // NOTE: If there are still outstanding batched commands for this Queue, something has gone very wrong!
-    PAL_ASSERT(m_batchedCmds.NumElements() == 0);
+    if (m_submitThread.IsCreated())
+    {
+        // Let the submit thread flush whatever is still batched-up before it exits.
+        PAL_ASSERT(m_submitThread.IsNotCurrentThread());
+
+        m_submitThreadEnd = true;
+        m_submitThreadNotify.Post();
+        m_submitThread.Join();
+
+        // The batched command list is always open when submits are offloaded, so close it now. The submit thread
+        // drained it before exiting unless a batched-up Semaphore wait was never satisfied. Whatever is stuck behind
+        // that wait can never execute, so it gets freed below.
+        AppendPendingCmds(static_cast<BatchedQueueCmdNode*>(
+            AtomicExchangePointer(reinterpret_cast<void*volatile*>(&m_pBatchedCmdsHead), ClosedBatchedCmds())));
+
+        PAL_ALERT(m_pPendingCmds != nullptr);
+    }
+    else
+    {
+        // NOTE: If there are still outstanding batched commands for this Queue, something has gone very wrong!
+        PAL_ASSERT((m_pBatchedCmdsHead == ClosedBatchedCmds()) && (m_pPendingCmds == nullptr));
+    }
+
+    if (m_pBatchedCmdsHead != ClosedBatchedCmds())
+    {
+        AppendPendingCmds(m_pBatchedCmdsHead);
+        m_pBatchedCmdsHead = ClosedBatchedCmds();
+    }
+
+    while (m_pPendingCmds != nullptr)
+    {
+        BatchedQueueCmdNode*const pNode = m_pPendingCmds;
+        m_pPendingCmds = pNode->pNext;
+
+        FreeBatchedCmd(&pNode->data);
+        PAL_FREE(pNode, m_pDevice->GetPlatform());
+    }
 
     // There are some CmdStreams which are created with UntrackedCmdAllocator, then the CmdStreamChunks in those
     // CmdStreams will have race condition when CmdStreams are destructed. Only CPU side reference count is used to
@@ -319,6 +357,14 @@ void Queue::Destroy()
     this->~Queue();
 }
 
+// =====================================================================================================================
+// Callback for executing the submit thread.
+static void SubmitThreadCallback(
+    void* pParameter)   // Opaque pointer to a Queue
+{
+    static_cast<Queue*>(pParameter)->RunSubmitThread();
+}
+
 // =====================================================================================================================
 // Initializes this Queue object's QueueContext and batched-command Mutex objects.
 Result Queue::Init(
@@ -406,6 +452,27 @@ Result Queue::Init(
         result = m_batchedCmdsLock.Init();
     }
 
+    if ((result == Result::Success) && UsesSubmitThread())
+    {
+        result = m_submitThreadNotify.Init(Semaphore::MaximumCountLimit, 0);
+
+        if (result == Result::Success)
+        {
+            result = m_batchedCmdsDrained.Init();
+        }
+
+        if (result == Result::Success)
+        {
+            result = m_submitThread.Begin(&SubmitThreadCallback, this);
+        }
+
+        if (result == Result::Success)
+        {
+            // Open the batched command list for good: from now on every command is executed by the submit thread.
+            m_pBatchedCmdsHead = nullptr;
+        }
+    }
+
     if (result == Result::Success)
     {
         GfxDevice*  pGfxDevice = m_pDevice->GetGfxDevice();
@@ -531,11 +598,14 @@ Result Queue::GfxIpWaitPipelineUploading(
 {
     Result result = Result::Success;
     UploadFenceToken maxUploadFenceToken = 0;
+    bool             usesPipelines       = false;
     for (uint32 qIdx = 0; qIdx < submitInfo.perSubQueueInfoCount; qIdx++)
     {
         QueueType qType = m_pQueueInfos[qIdx].createInfo.queueType;
         if ((qType == QueueTypeUniversal) || (qType == QueueTypeCompute))
         {
+            usesPipelines = true;
+
             uint32 cmdBufferCount = submitInfo.pPerSubQueueInfo[qIdx].cmdBufferCount;
 
             for (uint32 cmdIdx = 0; cmdIdx < cmdBufferCount; cmdIdx++)
@@ -550,6 +620,11 @@ Result Queue::GfxIpWaitPipelineUploading(
     {
         result = m_pDevice->WaitForPendingUpload(this, maxUploadFenceToken);
     }
+    else if (usesPipelines)
+    {
+        // Nothing here needs an upload, but use this submission to start any upload batch which has waited too long.
+        result = m_pDevice->SubmitExpiredUploads();
+    }
     return result;
 }
 
@@ -559,9 +634,10 @@ Result Queue::SubmitInternal(
     const MultiSubmitInfo& submitInfo,
     bool                   postBatching)
 {
-    Result result = Result::Success;
+    // Once the submit thread has failed, report that instead of queueing more work behind it.
+    Result result = SubmitThreadError();
 
-    if (submitInfo.pPerSubQueueInfo == nullptr)
+    if ((result == Result::Success) && (submitInfo.pPerSubQueueInfo == nullptr))
     {
         PAL_ASSERT(submitInfo.perSubQueueInfoCount == 0);
         result = Result::ErrorInvalidPointer;
@@ -599,101 +675,165 @@ Result Queue::SubmitInternal(
 
         if (result == Result::Success)
         {
-            if (submitInfo.perSubQueueInfoCount > 0)
+            if (UsesSubmitThread() && (postBatching == false))
             {
-                for (uint32 qIndex = 0;
-                     (qIndex < submitInfo.perSubQueueInfoCount) && (result == Result::Success);
-                     qIndex++)
-                {
-                    uint32 cmdBufferCount = submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount;
-                    QueueContext* pQueueContext = m_pQueueInfos[qIndex].pQueueContext;
-                    result = pQueueContext->PreProcessSubmit(&internalSubmitInfos[qIndex], cmdBufferCount);
-                }
+                // Everything which touches QueueContext state or the OS happens on the submit thread, in submission
+                // order. Only the bookkeeping which the caller may depend on as soon as Submit() returns stays here.
+                TrackSubmission(submitInfo);
+
+                result = EnqueueSubmit(submitInfo, &internalSubmitInfos[0]);
             }
             else
             {
-                result = m_pQueueInfos[0].pQueueContext->PreProcessSubmit(&internalSubmitInfos[0], 0);
+                result = PrepareSubmit(submitInfo, &internalSubmitInfos[0]);
+
+                if (result == Result::Success)
+                {
+                    TrackSubmission(submitInfo);
+
+                    // Either execute the submission immediately, or enqueue it for later, depending on whether or not
+                    // we are stalled and/or the caller is a function after the batching logic and thus must execute
+                    // immediately.
+                    if (postBatching || (IsStalled() == false))
+                    {
+                        result = OsSubmit(submitInfo, &internalSubmitInfos[0]);
+                    }
+                    else
+                    {
+                        result = EnqueueSubmit(submitInfo, &internalSubmitInfos[0]);
+                    }
+                }
+
+                if (result == Result::Success)
+                {
+                    for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
+                    {
+                        m_pQueueInfos[qIndex].pQueueContext->PostProcessSubmit();
+                    }
+                }
             }
         }
+    }
 
-#if PAL_ENABLE_PRINTS_ASSERTS
-        if (result == Result::Success)
+    return result;
+}
+
+// =====================================================================================================================
+// Lets each QueueContext pre-process a submission, then dumps its command buffers if requested.
+Result Queue::PrepareSubmit(
+    const MultiSubmitInfo& submitInfo,
+    InternalSubmitInfo*    pInternalSubmitInfos)
+{
+    Result result = Result::Success;
+
+    if (submitInfo.perSubQueueInfoCount > 0)
+    {
+        for (uint32 qIndex = 0;
+             (qIndex < submitInfo.perSubQueueInfoCount) && (result == Result::Success);
+             qIndex++)
         {
+            uint32 cmdBufferCount = submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount;
+            QueueContext* pQueueContext = m_pQueueInfos[qIndex].pQueueContext;
+            result = pQueueContext->PreProcessSubmit(&pInternalSubmitInfos[qIndex], cmdBufferCount);
+        }
+    }
+    else
+    {
+        result = m_pQueueInfos[0].pQueueContext->PreProcessSubmit(&pInternalSubmitInfos[0], 0);
+    }
+
+#if PAL_ENABLE_PRINTS_ASSERTS
+    if (result == Result::Success)
+    {
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 555
-            if (IsCmdDumpEnabled())
-            {
-                Util::File logFile;
-                // Open file for write depending on the settings
-                const Result openResult = OpenCommandDumpFile(submitInfo, internalSubmitInfos[0], &logFile);
+        if (IsCmdDumpEnabled())
+        {
+            Util::File logFile;
+            // Open file for write depending on the settings
+            const Result openResult = OpenCommandDumpFile(submitInfo, pInternalSubmitInfos[0], &logFile);
 
-                if (openResult == Result::Success) // file opened correctly
-                {
-                    MultiSubmitInfo submitInfoCopy = submitInfo;
+            if (openResult == Result::Success) // file opened correctly
+            {
+                MultiSubmitInfo submitInfoCopy = submitInfo;
 
-                    CmdDumpToFilePayload payload = {};
-                    payload.pLogFile = &logFile;
-                    payload.pSettings = &m_pDevice->Settings();
+                CmdDumpToFilePayload payload = {};
+                payload.pLogFile = &logFile;
+                payload.pSettings = &m_pDevice->Settings();
 
-                    submitInfoCopy.pfnCmdDumpCb = WriteCmdDumpToFile;
-                    submitInfoCopy.pUserData = &payload;
+                submitInfoCopy.pfnCmdDumpCb = WriteCmdDumpToFile;
+                submitInfoCopy.pUserData = &payload;
 
-                    DumpCmdBuffers(submitInfoCopy, internalSubmitInfos[0]);
-                }
+                DumpCmdBuffers(submitInfoCopy, pInternalSubmitInfos[0]);
             }
+        }
 #else // PAL_CLIENT_INTERFACE_MAJOR_VERSION < 555
-            // Dump command buffer
-            DumpCmdToFile(submitInfo, internalSubmitInfos[0]);
+        // Dump command buffer
+        DumpCmdToFile(submitInfo, pInternalSubmitInfos[0]);
 #endif
-        }
+    }
 #endif
 
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 555
-        if ((submitInfo.pfnCmdDumpCb != nullptr) && (result == Result::Success))
-        {
-            DumpCmdBuffers(submitInfo, internalSubmitInfos[0]);
-        }
+    if ((submitInfo.pfnCmdDumpCb != nullptr) && (result == Result::Success))
+    {
+        DumpCmdBuffers(submitInfo, pInternalSubmitInfos[0]);
+    }
 #endif
 
-        if (result == Result::Success)
+    return result;
+}
+
+// =====================================================================================================================
+// Notifies the submitted command buffers and fences about a submission. This must happen on the submitting thread so
+// that command buffer and fence state is up to date as soon as Submit() returns.
+void Queue::TrackSubmission(
+    const MultiSubmitInfo& submitInfo)
+{
+    if (m_ifhMode == IfhModeDisabled)
+    {
+        for (uint32 qIndex = 0; (qIndex < submitInfo.perSubQueueInfoCount); qIndex++)
         {
-            if (m_ifhMode == IfhModeDisabled)
+            for (uint32 idx = 0; idx < submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount; ++idx)
             {
-                for (uint32 qIndex = 0; (qIndex < submitInfo.perSubQueueInfoCount); qIndex++)
-                {
-                    for (uint32 idx = 0; idx < submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount; ++idx)
-                    {
-                        // Each command buffer being submitted needs to be notified about it, so
-                        // the command stream(s) can manage their GPU-completion tracking.
-                        auto*const pCmdBuffer = static_cast<CmdBuffer*>(
-                            submitInfo.pPerSubQueueInfo[qIndex].ppCmdBuffers[idx]);
-                        pCmdBuffer->IncrementSubmitCount();
-                    }
-                }
+                // Each command buffer being submitted needs to be notified about it, so
+                // the command stream(s) can manage their GPU-completion tracking.
+                auto*const pCmdBuffer = static_cast<CmdBuffer*>(
+                    submitInfo.pPerSubQueueInfo[qIndex].ppCmdBuffers[idx]);
+                pCmdBuffer->IncrementSubmitCount();
             }
+        }
+    }
 
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
-            for (uint32 idx = 0; idx < submitInfo.fenceCount; idx++)
-            {
-                PAL_ASSERT(submitInfo.ppFences[idx] != nullptr);
-                static_cast<Fence*>(submitInfo.ppFences[idx])->AssociateWithContext(m_pSubmissionContext);
-            }
+    for (uint32 idx = 0; idx < submitInfo.fenceCount; idx++)
+    {
+        PAL_ASSERT(submitInfo.ppFences[idx] != nullptr);
+        static_cast<Fence*>(submitInfo.ppFences[idx])->AssociateWithContext(m_pSubmissionContext);
+    }
 #else
-            if (submitInfo.pFence != nullptr)
-            {
-                static_cast<Fence*>(submitInfo.pFence)->AssociateWithContext(m_pSubmissionContext);
-            }
+    if (submitInfo.pFence != nullptr)
+    {
+        static_cast<Fence*>(submitInfo.pFence)->AssociateWithContext(m_pSubmissionContext);
+    }
 #endif
+}
 
-            // Either execute the submission immediately, or enqueue it for later, depending on whether or not we are
-            // stalled and/or the caller is a function after the batching logic and thus must execute immediately.
-            if (postBatching || (m_stalled == false))
-            {
-                result = OsSubmit(submitInfo, &internalSubmitInfos[0]);
-            }
-            else
-            {
-                result = EnqueueSubmit(submitInfo, &internalSubmitInfos[0]);
-            }
+// =====================================================================================================================
+// Executes a batched-up submission. Submissions handed to the submit thread skipped all QueueContext work on the
+// calling thread, so it happens here instead.
+Result Queue::ExecuteBatchedSubmit(
+    const MultiSubmitInfo& submitInfo,
+    InternalSubmitInfo*    pInternalSubmitInfos)
+{
+    Result result = Result::Success;
+
+    if (UsesSubmitThread())
+    {
+        result = PrepareSubmit(submitInfo, pInternalSubmitInfos);
+
+        if (result == Result::Success)
+        {
+            result = OsSubmit(submitInfo, pInternalSubmitInfos);
         }
 
         if (result == Result::Success)
@@ -704,6 +844,10 @@ Result Queue::SubmitInternal(
             }
         }
     }
+    else
+    {
+        result = OsSubmit(submitInfo, pInternalSubmitInfos);
+    }
 
     return result;
 }
@@ -1128,22 +1272,52 @@ void Queue::DumpCmdToFile(
 // =====================================================================================================================
 // Waits for all requested submissions on this Queue to finish, including any batched-up submissions. This call never
 // fails, but may wait awhile if the command buffers are long-running, or forever if the GPU is hung.) We do not wait
-// for pending semaphore waits or delay operations.
+// for pending semaphore waits or delay operations. Queues with a submit thread return its latched error, if any.
 // NOTE: Part of the public IQueue interface.
 Result Queue::WaitIdle()
 {
     Result result = Result::Success;
 
-    // If this queue is blocked by a semaphore, this will spin loop until all batched submissions have been processed.
-    while (m_batchedSubmissionCount > 0)
+    if (UsesSubmitThread())
+    {
+        // The submit thread calls this itself when a ring resize needs the queue to be idle. Everything before the
+        // current command has been handed to the OS by then, and it already holds m_batchedCmdsLock.
+        if (m_submitThread.IsNotCurrentThread())
+        {
+            MutexAuto lock(&m_batchedCmdsLock);
+
+            // The submit thread holds m_batchedCmdsLock while it executes commands and wakes us whenever it runs out
+            // of them. Batched submissions stuck behind a Semaphore wait are waited for, like on a stalled queue; any
+            // other commands following a blocked wait are not.
+            while ((m_batchedSubmissionCount > 0) ||
+                   ((m_stalledOnSemaphore == false) &&
+                    ((m_pBatchedCmdsHead != nullptr) || (m_pPendingCmds != nullptr))))
+            {
+                m_batchedCmdsDrained.Wait(&m_batchedCmdsLock, UINT32_MAX);
+            }
+        }
+
+        result = SubmitThreadError();
+    }
+    else
     {
-        // Yield this CPU to give other threads a chance to run and so we don't burn too much power.
-        YieldThread();
+        // If this queue is blocked by a semaphore, this will spin loop until all batched submissions have been
+        // processed.
+        while (m_batchedSubmissionCount > 0)
+        {
+            // Yield this CPU to give other threads a chance to run and so we don't burn too much power.
+            YieldThread();
+        }
     }
 
     // When we get here, all batched operations (if there were any) have been processed, so wait for the OS-specific
     // Queue to become idle.
-    return OsWaitIdle();
+    if (result == Result::Success)
+    {
+        result = OsWaitIdle();
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -1161,7 +1335,7 @@ Result Queue::SignalQueueSemaphoreInternal(
 
     // Either signal the semaphore immediately, or enqueue it for later, depending on whether or not we are stalled
     // and/or the caller is a function after the batching logic and thus must execute immediately.
-    if (postBatching || (m_stalled == false))
+    if (postBatching || (IsStalled() == false))
     {
         // The Semaphore object is responsible for notifying any stalled Queues which may get released by this signal
         // operation.
@@ -1169,20 +1343,17 @@ Result Queue::SignalQueueSemaphoreInternal(
     }
     else
     {
-        // After taking the lock, check again to see if we're stalled. The original check which brought us down
-        // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-        // from the stalled state before we were able to get into this method.
-        MutexAuto lock(&m_batchedCmdsLock);
-        if (m_stalled)
-        {
-            BatchedQueueCmdData cmdData  = { };
-            cmdData.command              = BatchedQueueCmd::SignalSemaphore;
-            cmdData.semaphore.pSemaphore = pQueueSemaphore;
-            cmdData.semaphore.value      = value;
+        BatchedQueueCmdData cmdData  = { };
+        cmdData.command              = BatchedQueueCmd::SignalSemaphore;
+        cmdData.semaphore.pSemaphore = pQueueSemaphore;
+        cmdData.semaphore.value      = value;
 
-            result = m_batchedCmds.PushBack(cmdData);
-        }
-        else
+        // The check which brought us down this path was racy, so it's possible that another thread released this
+        // Queue from the stalled state before we were able to enqueue the command.
+        bool enqueued = false;
+        result = EnqueueBatchedCmd(cmdData, &enqueued);
+
+        if ((result == Result::Success) && (enqueued == false))
         {
             result = pSemaphore->Signal(this, value);
         }
@@ -1207,30 +1378,49 @@ Result Queue::WaitQueueSemaphoreInternal(
 
     // Either wait on the semaphore immediately, or enqueue it for later, depending on whether or not we are stalled
     // and/or the caller is a function after the batching logic and thus must execute immediately.
-    if (postBatching || (m_stalled == false))
+    if (postBatching)
     {
-        // If this Queue isn't stalled yet, we can execute the wait immediately (which, of course, could stall
-        // this Queue).
-        result = pSemaphore->Wait(this, value, &m_stalled);
+        // The caller guarantees that this wait can't stall the Queue.
+        volatile bool stalled = false;
+        result = pSemaphore->Wait(this, value, &stalled);
+        PAL_ASSERT(stalled == false);
     }
     else
     {
-        // After taking the lock, check again to see if we're stalled. The original check which brought us down
-        // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-        // from the stalled state before we were able to get into this method.
-        MutexAuto lock(&m_batchedCmdsLock);
-        if (m_stalled)
-        {
-            BatchedQueueCmdData cmdData  = { };
-            cmdData.command              = BatchedQueueCmd::WaitSemaphore;
-            cmdData.semaphore.pSemaphore = pQueueSemaphore;
-            cmdData.semaphore.value      = value;
+        bool done = false;
 
-            result = m_batchedCmds.PushBack(cmdData);
-        }
-        else
+        while (done == false)
         {
-            result = pSemaphore->Wait(this, value, &m_stalled);
+            if (TryStall())
+            {
+                // If this Queue isn't stalled yet, we can execute the wait immediately (which, of course, could
+                // stall this Queue). We mark the Queue as stalled beforehand so that the Semaphore can release it as
+                // soon as it becomes blocked, while commands from other threads get batched-up behind the wait.
+                volatile bool stalled = false;
+                result = pSemaphore->Wait(this, value, &stalled);
+
+                if (stalled == false)
+                {
+                    // The wait didn't block this Queue after all: flush anything batched-up in the meantime.
+                    const Result releaseResult = ReleaseFromStalledState();
+                    result = (result == Result::Success) ? releaseResult : result;
+                }
+
+                done = true;
+            }
+            else
+            {
+                BatchedQueueCmdData cmdData  = { };
+                cmdData.command              = BatchedQueueCmd::WaitSemaphore;
+                cmdData.semaphore.pSemaphore = pQueueSemaphore;
+                cmdData.semaphore.value      = value;
+
+                // If another thread released this Queue from the stalled state before we could enqueue the wait, go
+                // around again and try to execute it immediately.
+                bool enqueued = false;
+                result = EnqueueBatchedCmd(cmdData, &enqueued);
+                done   = (enqueued || (result != Result::Success));
+            }
         }
     }
 
@@ -1266,25 +1456,22 @@ Result Queue::PresentDirectInternal(
         {
             // Either execute the present immediately, or enqueue it for later, depending on whether or not we are
             // stalled.
-            if (m_stalled == false)
+            if (IsStalled() == false)
             {
                 result = OsPresentDirect(presentInfo);
             }
             else
             {
-                // After taking the lock, check again to see if we're stalled. The original check which brought us down
-                // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-                // from the stalled state before we were able to get into this method.
-                MutexAuto lock(&m_batchedCmdsLock);
-                if (m_stalled)
-                {
-                    BatchedQueueCmdData cmdData = {};
-                    cmdData.command             = BatchedQueueCmd::PresentDirect;
-                    cmdData.presentDirect.info  = presentInfo;
+                BatchedQueueCmdData cmdData = {};
+                cmdData.command             = BatchedQueueCmd::PresentDirect;
+                cmdData.presentDirect.info  = presentInfo;
 
-                    result = m_batchedCmds.PushBack(cmdData);
-                }
-                else
+                // The check which brought us down this path was racy, so it's possible that another thread released
+                // this Queue from the stalled state before we were able to enqueue the command.
+                bool enqueued = false;
+                result = EnqueueBatchedCmd(cmdData, &enqueued);
+
+                if ((result == Result::Success) && (enqueued == false))
                 {
                     result = OsPresentDirect(presentInfo);
                 }
@@ -1358,25 +1545,22 @@ Result Queue::Delay(
     if (Type() == QueueTypeTimer)
     {
         // Either execute the delay immediately, or enqueue it for later, depending on whether or not we are stalled.
-        if (m_stalled == false)
+        if (IsStalled() == false)
         {
             result = OsDelay(delay, nullptr);
         }
         else
         {
-            // After taking the lock, check again to see if we're stalled. The original check which brought us down
-            // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-            // from the stalled state before we were able to get into this method.
-            MutexAuto lock(&m_batchedCmdsLock);
-            if (m_stalled)
-            {
-                BatchedQueueCmdData cmdData = { };
-                cmdData.command    = BatchedQueueCmd::Delay;
-                cmdData.delay.time = delay;
+            BatchedQueueCmdData cmdData = { };
+            cmdData.command    = BatchedQueueCmd::Delay;
+            cmdData.delay.time = delay;
 
-                result = m_batchedCmds.PushBack(cmdData);
-            }
-            else
+            // The check which brought us down this path was racy, so it's possible that another thread released this
+            // Queue from the stalled state before we were able to enqueue the command.
+            bool enqueued = false;
+            result = EnqueueBatchedCmd(cmdData, &enqueued);
+
+            if ((result == Result::Success) && (enqueued == false))
             {
                 result = OsDelay(delay, nullptr);
             }
@@ -1398,28 +1582,17 @@ Result Queue::DelayAfterVsync(
     if (Type() == QueueTypeTimer)
     {
         // Either execute the delay immediately, or enqueue it for later, depending on whether or not we are stalled.
-        if (m_stalled == false)
+        if (IsStalled() == false)
         {
             result = OsDelay(delayInUs, pScreen);
         }
         else
         {
-            // After taking the lock, check again to see if we're stalled. The original check which brought us down
-            // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-            // from the stalled state before we were able to get into this method.
-            MutexAuto lock(&m_batchedCmdsLock);
-            if (m_stalled == false)
-            {
-                result = OsDelay(delayInUs, pScreen);
-            }
-            else
-            {
-                // NOTE: Currently there shouldn't be a use case that queue is blocked as external semaphore is used to
-                // synchronize submissions in DX and timer queue delays in Mantle, thus application is responsible for
-                // correct pairing. Even in case the queue is stalled (in future), we don't want to queue a delay-after-
-                // vsync but simply returns an error code to the application.
-                PAL_ALERT_ALWAYS();
-            }
+            // NOTE: Currently there shouldn't be a use case that queue is blocked as external semaphore is used to
+            // synchronize submissions in DX and timer queue delays in Mantle, thus application is responsible for
+            // correct pairing. Even in case the queue is stalled (in future), we don't want to queue a delay-after-
+            // vsync but simply returns an error code to the application.
+            PAL_ALERT_ALWAYS();
         }
     }
 
@@ -1435,44 +1608,46 @@ Result Queue::CopyVirtualMemoryPageMappings(
     Result result = Result::ErrorUnavailable;
 
     // Either execute the delay immediately, or enqueue it for later, depending on whether or not we are stalled.
-    if (m_stalled == false)
+    if (IsStalled() == false)
     {
         result = OsCopyVirtualMemoryPageMappings(rangeCount, pRanges, doNotWait);
     }
     else
     {
-        // After taking the lock, check again to see if we're stalled. The original check which brought us down
-        // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-        // from the stalled state before we were able to get into this method.
-        MutexAuto lock(&m_batchedCmdsLock);
-        if (m_stalled)
-        {
-            BatchedQueueCmdData cmdData = { };
-            cmdData.command    = BatchedQueueCmd::CopyVirtualMemoryPageMappings;
-            cmdData.copyVirtualMemoryPageMappings.rangeCount  = rangeCount;
-            cmdData.copyVirtualMemoryPageMappings.doNotWait   = doNotWait;
-            if (rangeCount > 0)
-            {
-                cmdData.copyVirtualMemoryPageMappings.pRanges = PAL_NEW_ARRAY(VirtualMemoryCopyPageMappingsRange,
-                    rangeCount, m_pDevice->GetPlatform(), AllocInternal);
-                if (cmdData.copyVirtualMemoryPageMappings.pRanges == nullptr)
-                {
-                    result = Result::ErrorOutOfMemory;
-                }
-                else
-                {
-                    memcpy(cmdData.copyVirtualMemoryPageMappings.pRanges, pRanges,
-                        rangeCount * sizeof(VirtualMemoryCopyPageMappingsRange));
-                }
+        BatchedQueueCmdData cmdData = { };
+        cmdData.command    = BatchedQueueCmd::CopyVirtualMemoryPageMappings;
+        cmdData.copyVirtualMemoryPageMappings.rangeCount  = rangeCount;
+        cmdData.copyVirtualMemoryPageMappings.doNotWait   = doNotWait;
+        if (rangeCount > 0)
+        {
+            cmdData.copyVirtualMemoryPageMappings.pRanges = PAL_NEW_ARRAY(VirtualMemoryCopyPageMappingsRange,
+                rangeCount, m_pDevice->GetPlatform(), AllocInternal);
+            if (cmdData.copyVirtualMemoryPageMappings.pRanges == nullptr)
+            {
+                result = Result::ErrorOutOfMemory;
             }
-            if (result != Result::ErrorOutOfMemory)
+            else
             {
-                result = m_batchedCmds.PushBack(cmdData);
+                memcpy(cmdData.copyVirtualMemoryPageMappings.pRanges, pRanges,
+                    rangeCount * sizeof(VirtualMemoryCopyPageMappingsRange));
             }
         }
-        else
+        if (result != Result::ErrorOutOfMemory)
         {
-            result = OsCopyVirtualMemoryPageMappings(rangeCount, pRanges, doNotWait);
+            // The check which brought us down this path was racy, so it's possible that another thread released this
+            // Queue from the stalled state before we were able to enqueue the command.
+            bool enqueued = false;
+            result = EnqueueBatchedCmd(cmdData, &enqueued);
+
+            if (enqueued == false)
+            {
+                FreeBatchedCmd(&cmdData);
+
+                if (result == Result::Success)
+                {
+                    result = OsCopyVirtualMemoryPageMappings(rangeCount, pRanges, doNotWait);
+                }
+            }
         }
     }
 
@@ -1491,44 +1666,46 @@ Result Queue::RemapVirtualMemoryPages(
     Result result = Result::ErrorUnavailable;
 
     // Either execute the delay immediately, or enqueue it for later, depending on whether or not we are stalled.
-    if (m_stalled == false)
+    if (IsStalled() == false)
     {
         result = OsRemapVirtualMemoryPages(rangeCount, pRanges, doNotWait, pFence);
     }
     else
     {
-        // After taking the lock, check again to see if we're stalled. The original check which brought us down
-        // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-        // from the stalled state before we were able to get into this method.
-        MutexAuto lock(&m_batchedCmdsLock);
-        if (m_stalled)
-        {
-            BatchedQueueCmdData cmdData = { };
-            cmdData.command    = BatchedQueueCmd::RemapVirtualMemoryPages;
-            cmdData.remapVirtualMemoryPages.rangeCount  = rangeCount;
-            cmdData.remapVirtualMemoryPages.doNotWait   = doNotWait;
-            cmdData.remapVirtualMemoryPages.pFence      = pFence;
-            if (rangeCount > 0)
-            {
-                cmdData.remapVirtualMemoryPages.pRanges = PAL_NEW_ARRAY(VirtualMemoryRemapRange, rangeCount,
-                    m_pDevice->GetPlatform(), AllocInternal);
-                if (cmdData.remapVirtualMemoryPages.pRanges == nullptr)
-                {
-                    result = Result::ErrorOutOfMemory;
-                }
-                else
-                {
-                    memcpy(cmdData.remapVirtualMemoryPages.pRanges, pRanges, rangeCount * sizeof(VirtualMemoryRemapRange));
-                }
+        BatchedQueueCmdData cmdData = { };
+        cmdData.command    = BatchedQueueCmd::RemapVirtualMemoryPages;
+        cmdData.remapVirtualMemoryPages.rangeCount  = rangeCount;
+        cmdData.remapVirtualMemoryPages.doNotWait   = doNotWait;
+        cmdData.remapVirtualMemoryPages.pFence      = pFence;
+        if (rangeCount > 0)
+        {
+            cmdData.remapVirtualMemoryPages.pRanges = PAL_NEW_ARRAY(VirtualMemoryRemapRange, rangeCount,
+                m_pDevice->GetPlatform(), AllocInternal);
+            if (cmdData.remapVirtualMemoryPages.pRanges == nullptr)
+            {
+                result = Result::ErrorOutOfMemory;
             }
-            if (result != Result::ErrorOutOfMemory)
+            else
             {
-                result = m_batchedCmds.PushBack(cmdData);
+                memcpy(cmdData.remapVirtualMemoryPages.pRanges, pRanges, rangeCount * sizeof(VirtualMemoryRemapRange));
             }
         }
-        else
+        if (result != Result::ErrorOutOfMemory)
         {
-            result = OsRemapVirtualMemoryPages(rangeCount, pRanges, doNotWait, pFence);
+            // The check which brought us down this path was racy, so it's possible that another thread released this
+            // Queue from the stalled state before we were able to enqueue the command.
+            bool enqueued = false;
+            result = EnqueueBatchedCmd(cmdData, &enqueued);
+
+            if (enqueued == false)
+            {
+                FreeBatchedCmd(&cmdData);
+
+                if (result == Result::Success)
+                {
+                    result = OsRemapVirtualMemoryPages(rangeCount, pRanges, doNotWait, pFence);
+                }
+            }
         }
     }
 
@@ -1551,26 +1728,22 @@ Result Queue::AssociateFenceWithLastSubmit(
         pCoreFence->AssociateWithContext(m_pSubmissionContext);
 
         // Either associate the fence timestamp immediately or later, depending on whether or not we are stalled.
-        if (m_stalled == false)
+        if (IsStalled() == false)
         {
             result = DoAssociateFenceWithLastSubmit(pCoreFence);
         }
         else
         {
-            // After taking the lock, check again to see if we're stalled. The original check which brought us down
-            // this path didn't take the lock beforehand, so its possible that another thread released this Queue
-            // from the stalled state before we were able to get into this method.
-            MutexAuto lock(&m_batchedCmdsLock);
+            BatchedQueueCmdData cmdData = { };
+            cmdData.command               = BatchedQueueCmd::AssociateFenceWithLastSubmit;
+            cmdData.associateFence.pFence = pCoreFence;
 
-            if (m_stalled)
-            {
-                BatchedQueueCmdData cmdData = { };
-                cmdData.command               = BatchedQueueCmd::AssociateFenceWithLastSubmit;
-                cmdData.associateFence.pFence = pCoreFence;
+            // The check which brought us down this path was racy, so it's possible that another thread released this
+            // Queue from the stalled state before we were able to enqueue the command.
+            bool enqueued = false;
+            result = EnqueueBatchedCmd(cmdData, &enqueued);
 
-                result = m_batchedCmds.PushBack(cmdData);
-            }
-            else
+            if ((result == Result::Success) && (enqueued == false))
             {
                 result = DoAssociateFenceWithLastSubmit(pCoreFence);
             }
@@ -1649,86 +1822,320 @@ Result Queue::LateInit()
 //
 // NOTE: This method is invoked whenever a QueueSemaphore which was blocking this Queue becomes signaled, and needs
 // "wake up" the blocked Queue. Since the blocking Semaphore can be signaled on a separate thread from threads which
-// are batching-up more Queue commands, a race condition can exist while accessing the list of batched-up commands.
-// (which is why we need m_batchedCmdsLock).
+// are batching-up more Queue commands, producers may keep pushing onto the batched command list while we drain it.
 Result Queue::ReleaseFromStalledState()
 {
     Result result = Result::Success;
 
+    MutexAuto lock(&m_batchedCmdsLock);
+
+    m_stalledOnSemaphore = false;
+
+    if (UsesSubmitThread())
+    {
+        // Hand the rest of the work back to the submit thread rather than doing it on the signaling thread.
+        m_submitThreadNotify.Post();
+    }
+    else
+    {
+        result = DrainBatchedCmds();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Executes batched-up commands until the list is empty or one of them stalls this Queue again. The Queue only leaves
+// the stalled state once a compare-and-swap observes the list empty, so no command can be stranded. The caller must
+// hold m_batchedCmdsLock, which serializes consumers and is never taken by producers.
+Result Queue::DrainBatchedCmds()
+{
+    Result result = Result::Success;
+
     bool stalledAgain = false; // It is possible for one of the batched-up commands to be a Semaphore wait which
                                // may cause this Queue to become stalled once more.
+    bool released     = false;
 
-    MutexAuto lock(&m_batchedCmdsLock);
+    // The submit thread has nobody to report errors to, so it keeps going after a failed command rather than leave
+    // the rest of the list behind.
+    const bool stopOnError = (UsesSubmitThread() == false);
+
+    PAL_ASSERT(IsStalled());
 
     // Execute all of the batched-up commands as long as we don't become stalled again and don't encounter an error.
-    while ((m_batchedCmds.NumElements() > 0) && (stalledAgain == false) && (result == Result::Success))
+    while ((released == false) && (stalledAgain == false) && ((result == Result::Success) || (stopOnError == false)))
     {
-        BatchedQueueCmdData cmdData = { };
+        if (m_pPendingCmds == nullptr)
+        {
+            // Take every command batched-up so far, leaving an empty list behind so producers keep batching.
+            BatchedQueueCmdNode*const pList = static_cast<BatchedQueueCmdNode*>(
+                AtomicExchangePointer(reinterpret_cast<void*volatile*>(&m_pBatchedCmdsHead), nullptr));
 
-        result = m_batchedCmds.PopFront(&cmdData);
-        PAL_ASSERT(result == Result::Success);
+            if (pList != nullptr)
+            {
+                AppendPendingCmds(pList);
+            }
+            else if (UsesSubmitThread())
+            {
+                // The list stays open when submits are offloaded; the next push will wake the submit thread.
+                released = true;
+            }
+            else
+            {
+                // Nothing is left, so try to leave the stalled state. This fails if a producer got in first, in which
+                // case we go around again to pick up its command.
+                released = (AtomicCompareAndSwapPointer(reinterpret_cast<void*volatile*>(&m_pBatchedCmdsHead),
+                                                        nullptr,
+                                                        ClosedBatchedCmds()) == nullptr);
+            }
+        }
+        else
+        {
+            BatchedQueueCmdNode*const pNode = m_pPendingCmds;
+            m_pPendingCmds = pNode->pNext;
+
+            const Result cmdResult = ExecuteBatchedCmd(&pNode->data, &stalledAgain);
+            PAL_FREE(pNode, m_pDevice->GetPlatform());
+
+            result = (result == Result::Success) ? cmdResult : result;
+        }
+    }
+
+    if ((released == false) && (stalledAgain == false))
+    {
+        // We hit an error: leave the stalled state anyway rather than batch up commands forever. Whatever is left
+        // over is stranded and gets cleaned up when the Queue is destroyed.
+        AppendPendingCmds(static_cast<BatchedQueueCmdNode*>(
+            AtomicExchangePointer(reinterpret_cast<void*volatile*>(&m_pBatchedCmdsHead), ClosedBatchedCmds())));
+    }
+
+    m_stalledOnSemaphore = stalledAgain;
+
+    if (UsesSubmitThread())
+    {
+        m_batchedCmdsDrained.WakeAll();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Returns the first error hit by this Queue's submit thread, or Success if it has none or never failed.
+Result Queue::SubmitThreadError() const
+{
+    return (UsesSubmitThread() && (m_pSubmissionContext != nullptr)) ? m_pSubmissionContext->SubmitError()
+                                                                     : Result::Success;
+}
+
+// =====================================================================================================================
+// Executes the submit thread used to offload this Queue's commands from the threads which call into it.
+void Queue::RunSubmitThread()
+{
+    while (true)
+    {
+        const Result waitResult = m_submitThreadNotify.Wait(UINT32_MAX);
+        PAL_ASSERT(waitResult == Result::Success);
 
-        switch (cmdData.command)
         {
-        case BatchedQueueCmd::Submit:
-            result = OsSubmit(cmdData.submit.submitInfo, cmdData.submit.pInternalSubmitInfo);
+            MutexAuto lock(&m_batchedCmdsLock);
 
-            // Once we've executed the submission, we need to free the submission's dynamic arrays. They are all stored
-            // in the same memory allocation which was saved in pDynamicMem for convenience.
-            PAL_SAFE_FREE(cmdData.submit.pDynamicMem, m_pDevice->GetPlatform());
+            // While a batched-up wait blocks this Queue, its Semaphore resumes draining once it is signaled.
+            if (m_stalledOnSemaphore == false)
+            {
+                const Result result = DrainBatchedCmds();
 
-            // Decrement this count to permit WaitIdle to query the status of the queue's submissions.
-            PAL_ASSERT(m_batchedSubmissionCount > 0);
-            AtomicDecrement(&m_batchedSubmissionCount);
-            break;
+                // Nobody is waiting on this call, so latch the error for the next Submit, WaitIdle or fence query.
+                if ((result != Result::Success) && (m_pSubmissionContext != nullptr))
+                {
+                    m_pSubmissionContext->LatchSubmitError(result);
+                }
+            }
+        }
 
-        case BatchedQueueCmd::SignalSemaphore:
-            result = static_cast<QueueSemaphore*>(cmdData.semaphore.pSemaphore)->Signal(this, cmdData.semaphore.value);
-            break;
+        if (m_submitThreadEnd)
+        {
+            m_submitThread.End();
+        }
+    }
 
-        case BatchedQueueCmd::WaitSemaphore:
-            result = static_cast<QueueSemaphore*>(cmdData.semaphore.pSemaphore)->Wait(this, cmdData.semaphore.value,
-                                                                                      &stalledAgain);
-            break;
+    PAL_NEVER_CALLED(); // This area should be unreachable.
+}
 
-        case BatchedQueueCmd::PresentDirect:
-            result = OsPresentDirect(cmdData.presentDirect.info);
-            break;
+// =====================================================================================================================
+// Attempts to move this Queue from the unstalled into the stalled state ahead of executing a Semaphore wait. Returns
+// false if the Queue is stalled already, in which case the wait must be batched-up instead.
+bool Queue::TryStall()
+{
+    return (AtomicCompareAndSwapPointer(reinterpret_cast<void*volatile*>(&m_pBatchedCmdsHead),
+                                        ClosedBatchedCmds(),
+                                        nullptr) == ClosedBatchedCmds());
+}
 
-        case BatchedQueueCmd::Delay:
-            PAL_ASSERT(Type() == QueueTypeTimer);
-            result = OsDelay(cmdData.delay.time, nullptr);
-            break;
+// =====================================================================================================================
+// Pushes a copy of the given command onto the lock-free batched command list. If this Queue has been released from
+// the stalled state in the meantime, nothing is enqueued and the caller is responsible for executing the command
+// immediately (and for freeing any memory it allocated for cmdData).
+Result Queue::EnqueueBatchedCmd(
+    const BatchedQueueCmdData& cmdData,
+    bool*                      pEnqueued)
+{
+    Result result = Result::Success;
 
-        case BatchedQueueCmd::RemapVirtualMemoryPages:
-            result = OsRemapVirtualMemoryPages(cmdData.remapVirtualMemoryPages.rangeCount,
-                                               cmdData.remapVirtualMemoryPages.pRanges,
-                                               cmdData.remapVirtualMemoryPages.doNotWait,
-                                               cmdData.remapVirtualMemoryPages.pFence);
-            PAL_SAFE_DELETE_ARRAY(cmdData.remapVirtualMemoryPages.pRanges, m_pDevice->GetPlatform());
-            break;
+    (*pEnqueued) = false;
 
-        case BatchedQueueCmd::CopyVirtualMemoryPageMappings:
-            result = OsCopyVirtualMemoryPageMappings(cmdData.copyVirtualMemoryPageMappings.rangeCount,
-                                               cmdData.copyVirtualMemoryPageMappings.pRanges,
-                                               cmdData.copyVirtualMemoryPageMappings.doNotWait);
-            PAL_SAFE_DELETE_ARRAY(cmdData.copyVirtualMemoryPageMappings.pRanges, m_pDevice->GetPlatform());
-            break;
+    // Don't bother allocating a node if we can see that this Queue isn't stalled anymore.
+    BatchedQueueCmdNode* pHead = m_pBatchedCmdsHead;
 
-        case BatchedQueueCmd::AssociateFenceWithLastSubmit:
-            result = DoAssociateFenceWithLastSubmit(cmdData.associateFence.pFence);
-            break;
+    if (pHead != ClosedBatchedCmds())
+    {
+        auto*const pNode = static_cast<BatchedQueueCmdNode*>(PAL_MALLOC(sizeof(BatchedQueueCmdNode),
+                                                                        m_pDevice->GetPlatform(),
+                                                                        AllocInternal));
+        if (pNode == nullptr)
+        {
+            result = Result::ErrorOutOfMemory;
+        }
+        else
+        {
+            pNode->data = cmdData;
+
+            while ((*pEnqueued == false) && (pHead != ClosedBatchedCmds()))
+            {
+                pNode->pNext = pHead;
+
+                BatchedQueueCmdNode*const pPrevHead = static_cast<BatchedQueueCmdNode*>(
+                    AtomicCompareAndSwapPointer(reinterpret_cast<void*volatile*>(&m_pBatchedCmdsHead), pHead, pNode));
+
+                (*pEnqueued) = (pPrevHead == pHead);
+                pHead        = pPrevHead;
+            }
 
+            if (*pEnqueued == false)
+            {
+                PAL_FREE(pNode, m_pDevice->GetPlatform());
+            }
+            else if (UsesSubmitThread())
+            {
+                m_submitThreadNotify.Post();
+            }
         }
     }
 
-    // Update our stalled status: either we've completely drained all batched-up commands and are not stalled, or
-    // one of the batched-up commands caused this Queue to become stalled again.
-    m_stalled = stalledAgain;
+    return result;
+}
+
+// =====================================================================================================================
+// Executes a single batched-up command on behalf of ReleaseFromStalledState() and frees its dynamic memory.
+Result Queue::ExecuteBatchedCmd(
+    BatchedQueueCmdData* pCmdData,
+    bool*                pStalledAgain)
+{
+    Result result = Result::Success;
+
+    switch (pCmdData->command)
+    {
+    case BatchedQueueCmd::Submit:
+        result = ExecuteBatchedSubmit(pCmdData->submit.submitInfo, pCmdData->submit.pInternalSubmitInfo);
+        break;
+
+    case BatchedQueueCmd::SignalSemaphore:
+        result = static_cast<QueueSemaphore*>(pCmdData->semaphore.pSemaphore)->Signal(this, pCmdData->semaphore.value);
+        break;
+
+    case BatchedQueueCmd::WaitSemaphore:
+        result = static_cast<QueueSemaphore*>(pCmdData->semaphore.pSemaphore)->Wait(this,
+                                                                                    pCmdData->semaphore.value,
+                                                                                    pStalledAgain);
+        break;
+
+    case BatchedQueueCmd::PresentDirect:
+        result = OsPresentDirect(pCmdData->presentDirect.info);
+        break;
+
+    case BatchedQueueCmd::Delay:
+        PAL_ASSERT(Type() == QueueTypeTimer);
+        result = OsDelay(pCmdData->delay.time, nullptr);
+        break;
+
+    case BatchedQueueCmd::RemapVirtualMemoryPages:
+        result = OsRemapVirtualMemoryPages(pCmdData->remapVirtualMemoryPages.rangeCount,
+                                           pCmdData->remapVirtualMemoryPages.pRanges,
+                                           pCmdData->remapVirtualMemoryPages.doNotWait,
+                                           pCmdData->remapVirtualMemoryPages.pFence);
+        break;
+
+    case BatchedQueueCmd::CopyVirtualMemoryPageMappings:
+        result = OsCopyVirtualMemoryPageMappings(pCmdData->copyVirtualMemoryPageMappings.rangeCount,
+                                                 pCmdData->copyVirtualMemoryPageMappings.pRanges,
+                                                 pCmdData->copyVirtualMemoryPageMappings.doNotWait);
+        break;
+
+    case BatchedQueueCmd::AssociateFenceWithLastSubmit:
+        result = DoAssociateFenceWithLastSubmit(pCmdData->associateFence.pFence);
+        break;
+    }
+
+    FreeBatchedCmd(pCmdData);
 
     return result;
 }
 
+// =====================================================================================================================
+// Frees any dynamic memory owned by a batched-up command.
+void Queue::FreeBatchedCmd(
+    BatchedQueueCmdData* pCmdData)
+{
+    switch (pCmdData->command)
+    {
+    case BatchedQueueCmd::Submit:
+        // The submission's dynamic arrays are all stored in the same memory allocation which was saved in pDynamicMem
+        // for convenience.
+        PAL_SAFE_FREE(pCmdData->submit.pDynamicMem, m_pDevice->GetPlatform());
+
+        // Decrement this count to permit WaitIdle to query the status of the queue's submissions.
+        PAL_ASSERT(m_batchedSubmissionCount > 0);
+        AtomicDecrement(&m_batchedSubmissionCount);
+        break;
+
+    case BatchedQueueCmd::RemapVirtualMemoryPages:
+        PAL_SAFE_DELETE_ARRAY(pCmdData->remapVirtualMemoryPages.pRanges, m_pDevice->GetPlatform());
+        break;
+
+    case BatchedQueueCmd::CopyVirtualMemoryPageMappings:
+        PAL_SAFE_DELETE_ARRAY(pCmdData->copyVirtualMemoryPageMappings.pRanges, m_pDevice->GetPlatform());
+        break;
+
+    default:
+        break;
+    }
+}
+
+// =====================================================================================================================
+// Appends a list of batched-up commands taken from the head of the lock-free list to the end of m_pPendingCmds. The
+// lock-free list is in LIFO order, so it gets reversed into submission order along the way.
+void Queue::AppendPendingCmds(
+    BatchedQueueCmdNode* pList)
+{
+    BatchedQueueCmdNode* pReversed = nullptr;
+
+    while ((pList != nullptr) && (pList != ClosedBatchedCmds()))
+    {
+        BatchedQueueCmdNode*const pNext = pList->pNext;
+        pList->pNext = pReversed;
+        pReversed    = pList;
+        pList        = pNext;
+    }
+
+    BatchedQueueCmdNode** ppTail = &m_pPendingCmds;
+
+    while (*ppTail != nullptr)
+    {
+        ppTail = &(*ppTail)->pNext;
+    }
+
+    (*ppTail) = pReversed;
+}
+
 // =====================================================================================================================
 // Validates that the inputs to a Submit() call are legal according to the conditions defined in palQueue.h.
 Result Queue::ValidateSubmit(
@@ -1856,192 +2263,185 @@ Result Queue::ValidateSubmit(
 // =====================================================================================================================
 // Enqueues a command buffer submission for later execution, once this Queue is no longer blocked by any Semaphores.
 Result Queue::EnqueueSubmit(
-    const MultiSubmitInfo&    submitInfo,
-    const InternalSubmitInfo* pInternalSubmitInfo)
+    const MultiSubmitInfo& submitInfo,
+    InternalSubmitInfo*    pInternalSubmitInfo)
 {
     Result result = Result::Success;
 
-    // After taking the lock, check again to see if we're stalled. The original check which brought us down this path
-    // didn't take the lock beforehand, so its possible that another thread released this Queue from the stalled state
-    // before we were able to get into this method.
-    MutexAuto lock(&m_batchedCmdsLock);
-    if (m_stalled)
-    {
-        BatchedQueueCmdData cmdData;
-        cmdData.command                    = BatchedQueueCmd::Submit;
-        cmdData.submit.submitInfo          = submitInfo;
-        cmdData.submit.pInternalSubmitInfo = pInternalSubmitInfo;
-        cmdData.submit.pDynamicMem         = nullptr;
+    BatchedQueueCmdData cmdData;
+    cmdData.command                    = BatchedQueueCmd::Submit;
+    cmdData.submit.submitInfo          = submitInfo;
+    cmdData.submit.pInternalSubmitInfo = pInternalSubmitInfo;
+    cmdData.submit.pDynamicMem         = nullptr;
 
-        // The submitInfo structure we are batching-up needs to have its own copies of the command buffer and memory
-        // reference lists, because there's no guarantee those user arrays will remain valid once we become unstalled.
-        size_t totalCmdBufBytes     = 0;
-        size_t totalCmdBufInfoBytes = 0;
-        const size_t totalPerSubQueueInfoBytes = sizeof(PerSubQueueSubmitInfo) * submitInfo.perSubQueueInfoCount;
-        // The submitInfo structure we are batching-up needs to have its own copies of the command buffer and memory
-        // reference lists, because there's no guarantee those user arrays will remain valid once we become unstalled.
+    // The submitInfo structure we are batching-up needs to have its own copies of the command buffer and memory
+    // reference lists, because there's no guarantee those user arrays will remain valid once we become unstalled.
+    size_t totalCmdBufBytes     = 0;
+    size_t totalCmdBufInfoBytes = 0;
+    const size_t totalPerSubQueueInfoBytes = sizeof(PerSubQueueSubmitInfo) * submitInfo.perSubQueueInfoCount;
+    // The submitInfo structure we are batching-up needs to have its own copies of the command buffer and memory
+    // reference lists, because there's no guarantee those user arrays will remain valid once we become unstalled.
 
-        AutoBuffer<size_t, 8, Platform> cmdBufListBytes(submitInfo.perSubQueueInfoCount, m_pDevice->GetPlatform());
-        AutoBuffer<size_t, 8, Platform> cmdBufInfoListBytes(submitInfo.perSubQueueInfoCount, m_pDevice->GetPlatform());
+    AutoBuffer<size_t, 8, Platform> cmdBufListBytes(submitInfo.perSubQueueInfoCount, m_pDevice->GetPlatform());
+    AutoBuffer<size_t, 8, Platform> cmdBufInfoListBytes(submitInfo.perSubQueueInfoCount, m_pDevice->GetPlatform());
 
-        for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
-        {
-            cmdBufListBytes[qIndex] = (sizeof(ICmdBuffer*) * submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount);
-            totalCmdBufBytes += cmdBufListBytes[qIndex];
+    for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
+    {
+        cmdBufListBytes[qIndex] = (sizeof(ICmdBuffer*) * submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount);
+        totalCmdBufBytes += cmdBufListBytes[qIndex];
 
-            cmdBufInfoListBytes[qIndex] = 0;
-            if ((submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList != nullptr) &&
-                (submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount > 0))
-            {
-                cmdBufInfoListBytes[qIndex] =
-                    (sizeof(CmdBufInfo) * submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount);
-            }
-            totalCmdBufInfoBytes += cmdBufInfoListBytes[qIndex];
+        cmdBufInfoListBytes[qIndex] = 0;
+        if ((submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList != nullptr) &&
+            (submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount > 0))
+        {
+            cmdBufInfoListBytes[qIndex] =
+                (sizeof(CmdBufInfo) * submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount);
         }
-        const size_t memRefListBytes  = (sizeof(GpuMemoryRef) * submitInfo.gpuMemRefCount);
-        const size_t blkIfFlipBytes   = (sizeof(IGpuMemory*)  * submitInfo.blockIfFlippingCount);
-        const size_t doppRefListBytes = (sizeof(DoppRef) * submitInfo.doppRefCount);
+        totalCmdBufInfoBytes += cmdBufInfoListBytes[qIndex];
+    }
+    const size_t memRefListBytes  = (sizeof(GpuMemoryRef) * submitInfo.gpuMemRefCount);
+    const size_t blkIfFlipBytes   = (sizeof(IGpuMemory*)  * submitInfo.blockIfFlippingCount);
+    const size_t doppRefListBytes = (sizeof(DoppRef) * submitInfo.doppRefCount);
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
-        const size_t fenceListBytes   = (sizeof(IFence*) * submitInfo.fenceCount);
+    const size_t fenceListBytes   = (sizeof(IFence*) * submitInfo.fenceCount);
 #endif
-        const size_t internalSubmitInfoListBytes = (sizeof(InternalSubmitInfo) * submitInfo.perSubQueueInfoCount);
-
-        const size_t totalBytes = (
-                            totalPerSubQueueInfoBytes +
-                            totalCmdBufBytes +
-                            memRefListBytes +
-                            doppRefListBytes +
-                            blkIfFlipBytes +
-                            totalCmdBufInfoBytes
+    const size_t internalSubmitInfoListBytes = (sizeof(InternalSubmitInfo) * submitInfo.perSubQueueInfoCount);
+
+    const size_t totalBytes = (
+                        totalPerSubQueueInfoBytes +
+                        totalCmdBufBytes +
+                        memRefListBytes +
+                        doppRefListBytes +
+                        blkIfFlipBytes +
+                        totalCmdBufInfoBytes
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
-                            +fenceListBytes
+                        +fenceListBytes
 #endif
-                            + internalSubmitInfoListBytes
-                            );
+                        + internalSubmitInfoListBytes
+                        );
 
-        if (totalBytes > 0)
+    if (totalBytes > 0)
+    {
+        cmdData.submit.pDynamicMem = PAL_MALLOC(totalBytes, m_pDevice->GetPlatform(), AllocInternal);
+
+        if (cmdData.submit.pDynamicMem == nullptr)
         {
-            cmdData.submit.pDynamicMem = PAL_MALLOC(totalBytes, m_pDevice->GetPlatform(), AllocInternal);
+            result = Result::ErrorOutOfMemory;
+        }
+        else
+        {
+            void* pNextBuffer = cmdData.submit.pDynamicMem;
 
-            if (cmdData.submit.pDynamicMem == nullptr)
-            {
-                result = Result::ErrorOutOfMemory;
-            }
-            else
-            {
-                void* pNextBuffer = cmdData.submit.pDynamicMem;
+            PerSubQueueSubmitInfo* pPerSubQueueInfoList = static_cast<PerSubQueueSubmitInfo*>(pNextBuffer);
+            cmdData.submit.submitInfo.pPerSubQueueInfo = pPerSubQueueInfoList;
+            pNextBuffer = VoidPtrInc(pNextBuffer, totalPerSubQueueInfoBytes);
 
-                PerSubQueueSubmitInfo* pPerSubQueueInfoList = static_cast<PerSubQueueSubmitInfo*>(pNextBuffer);
-                cmdData.submit.submitInfo.pPerSubQueueInfo = pPerSubQueueInfoList;
-                pNextBuffer = VoidPtrInc(pNextBuffer, totalPerSubQueueInfoBytes);
+            for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
+            {
+                pPerSubQueueInfoList[qIndex].cmdBufferCount = submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount;
 
-                for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
+                if (pPerSubQueueInfoList[qIndex].cmdBufferCount > 0)
                 {
-                    pPerSubQueueInfoList[qIndex].cmdBufferCount = submitInfo.pPerSubQueueInfo[qIndex].cmdBufferCount;
-
-                    if (pPerSubQueueInfoList[qIndex].cmdBufferCount > 0)
-                    {
-                        auto**const ppBatchedCmdBuffers = reinterpret_cast<ICmdBuffer**>(pNextBuffer);
-                        memcpy(ppBatchedCmdBuffers,
-                               submitInfo.pPerSubQueueInfo[qIndex].ppCmdBuffers,
-                               cmdBufListBytes[qIndex]);
-                        pPerSubQueueInfoList[qIndex].ppCmdBuffers = ppBatchedCmdBuffers;
-                        pNextBuffer = VoidPtrInc(pNextBuffer, cmdBufListBytes[qIndex]);
-                    }
-                    else
-                    {
-                        pPerSubQueueInfoList[qIndex].ppCmdBuffers = submitInfo.pPerSubQueueInfo[qIndex].ppCmdBuffers;
-                    }
+                    auto**const ppBatchedCmdBuffers = reinterpret_cast<ICmdBuffer**>(pNextBuffer);
+                    memcpy(ppBatchedCmdBuffers,
+                           submitInfo.pPerSubQueueInfo[qIndex].ppCmdBuffers,
+                           cmdBufListBytes[qIndex]);
+                    pPerSubQueueInfoList[qIndex].ppCmdBuffers = ppBatchedCmdBuffers;
+                    pNextBuffer = VoidPtrInc(pNextBuffer, cmdBufListBytes[qIndex]);
                 }
-
-                if (submitInfo.gpuMemRefCount > 0)
+                else
                 {
-                    auto*const pBatchedGpuMemoryRefs = static_cast<GpuMemoryRef*>(pNextBuffer);
-                    memcpy(pBatchedGpuMemoryRefs, submitInfo.pGpuMemoryRefs, memRefListBytes);
-
-                    cmdData.submit.submitInfo.pGpuMemoryRefs = pBatchedGpuMemoryRefs;
-                    pNextBuffer                              = VoidPtrInc(pNextBuffer, memRefListBytes);
+                    pPerSubQueueInfoList[qIndex].ppCmdBuffers = submitInfo.pPerSubQueueInfo[qIndex].ppCmdBuffers;
                 }
+            }
 
-                if (submitInfo.doppRefCount > 0)
-                {
-                    auto*const pBatchedDoppRefs = static_cast<DoppRef*>(pNextBuffer);
-                    memcpy(pBatchedDoppRefs, submitInfo.pDoppRefs, doppRefListBytes);
+            if (submitInfo.gpuMemRefCount > 0)
+            {
+                auto*const pBatchedGpuMemoryRefs = static_cast<GpuMemoryRef*>(pNextBuffer);
+                memcpy(pBatchedGpuMemoryRefs, submitInfo.pGpuMemoryRefs, memRefListBytes);
 
-                    cmdData.submit.submitInfo.pDoppRefs = pBatchedDoppRefs;
-                    pNextBuffer                         = VoidPtrInc(pNextBuffer, doppRefListBytes);
-                }
+                cmdData.submit.submitInfo.pGpuMemoryRefs = pBatchedGpuMemoryRefs;
+                pNextBuffer                              = VoidPtrInc(pNextBuffer, memRefListBytes);
+            }
 
-                if (submitInfo.blockIfFlippingCount > 0)
-                {
-                    auto**const ppBatchedBlockIfFlipping = static_cast<IGpuMemory**>(pNextBuffer);
-                    memcpy(ppBatchedBlockIfFlipping, submitInfo.ppBlockIfFlipping, blkIfFlipBytes);
+            if (submitInfo.doppRefCount > 0)
+            {
+                auto*const pBatchedDoppRefs = static_cast<DoppRef*>(pNextBuffer);
+                memcpy(pBatchedDoppRefs, submitInfo.pDoppRefs, doppRefListBytes);
 
-                    cmdData.submit.submitInfo.ppBlockIfFlipping = ppBatchedBlockIfFlipping;
-                    pNextBuffer                                 = VoidPtrInc(pNextBuffer, blkIfFlipBytes);
-                }
+                cmdData.submit.submitInfo.pDoppRefs = pBatchedDoppRefs;
+                pNextBuffer                         = VoidPtrInc(pNextBuffer, doppRefListBytes);
+            }
 
-                for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
+            if (submitInfo.blockIfFlippingCount > 0)
+            {
+                auto**const ppBatchedBlockIfFlipping = static_cast<IGpuMemory**>(pNextBuffer);
+                memcpy(ppBatchedBlockIfFlipping, submitInfo.ppBlockIfFlipping, blkIfFlipBytes);
+
+                cmdData.submit.submitInfo.ppBlockIfFlipping = ppBatchedBlockIfFlipping;
+                pNextBuffer                                 = VoidPtrInc(pNextBuffer, blkIfFlipBytes);
+            }
+
+            for (uint32 qIndex = 0; qIndex < submitInfo.perSubQueueInfoCount; qIndex++)
+            {
+                // It's possible that pCmdBufInfoList is nullptr, while cmdBufferCount is larger than 0.
+                if ((submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList != nullptr) &&
+                    (pPerSubQueueInfoList[qIndex].cmdBufferCount > 0))
                 {
-                    // It's possible that pCmdBufInfoList is nullptr, while cmdBufferCount is larger than 0.
-                    if ((submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList != nullptr) &&
-                        (pPerSubQueueInfoList[qIndex].cmdBufferCount > 0))
-                    {
-                        auto*const pBatchedCmdBufInfoList = static_cast<CmdBufInfo*>(pNextBuffer);
-                        memcpy(pBatchedCmdBufInfoList,
-                               submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList,
-                               cmdBufInfoListBytes[qIndex]);
-                        pPerSubQueueInfoList[qIndex].pCmdBufInfoList = pBatchedCmdBufInfoList;
-                        pNextBuffer = VoidPtrInc(pNextBuffer, cmdBufInfoListBytes[qIndex]);
-                    }
-                    else
-                    {
-                        pPerSubQueueInfoList[qIndex].pCmdBufInfoList =
-                            submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList;
-                    }
+                    auto*const pBatchedCmdBufInfoList = static_cast<CmdBufInfo*>(pNextBuffer);
+                    memcpy(pBatchedCmdBufInfoList,
+                           submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList,
+                           cmdBufInfoListBytes[qIndex]);
+                    pPerSubQueueInfoList[qIndex].pCmdBufInfoList = pBatchedCmdBufInfoList;
+                    pNextBuffer = VoidPtrInc(pNextBuffer, cmdBufInfoListBytes[qIndex]);
                 }
+                else
+                {
+                    pPerSubQueueInfoList[qIndex].pCmdBufInfoList =
+                        submitInfo.pPerSubQueueInfo[qIndex].pCmdBufInfoList;
+                }
+            }
 
 #if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 568
-                if (submitInfo.fenceCount > 0)
-                {
-                    auto**const ppBatchedFences = static_cast<IFence**>(pNextBuffer);
-                    memcpy(ppBatchedFences, submitInfo.ppFences, fenceListBytes);
+            if (submitInfo.fenceCount > 0)
+            {
+                auto**const ppBatchedFences = static_cast<IFence**>(pNextBuffer);
+                memcpy(ppBatchedFences, submitInfo.ppFences, fenceListBytes);
 
-                    cmdData.submit.submitInfo.ppFences = ppBatchedFences;
-                    pNextBuffer = VoidPtrInc(pNextBuffer, fenceListBytes);
-                }
+                cmdData.submit.submitInfo.ppFences = ppBatchedFences;
+                pNextBuffer = VoidPtrInc(pNextBuffer, fenceListBytes);
+            }
 #endif
 
-                PAL_ASSERT(submitInfo.perSubQueueInfoCount > 0);
-                auto*const pBatchedInternalSubmitInfos = static_cast<InternalSubmitInfo*>(pNextBuffer);
-                memcpy(pBatchedInternalSubmitInfos, pInternalSubmitInfo, internalSubmitInfoListBytes);
-                cmdData.submit.pInternalSubmitInfo = pBatchedInternalSubmitInfos;
-                pNextBuffer = VoidPtrInc(pNextBuffer, internalSubmitInfoListBytes);
+            PAL_ASSERT(submitInfo.perSubQueueInfoCount > 0);
+            auto*const pBatchedInternalSubmitInfos = static_cast<InternalSubmitInfo*>(pNextBuffer);
+            memcpy(pBatchedInternalSubmitInfos, pInternalSubmitInfo, internalSubmitInfoListBytes);
+            cmdData.submit.pInternalSubmitInfo = pBatchedInternalSubmitInfos;
+            pNextBuffer = VoidPtrInc(pNextBuffer, internalSubmitInfoListBytes);
 
-            } // Space of cmdData.submit.pDynamicMem is allocated successfully.
-        }
+        } // Space of cmdData.submit.pDynamicMem is allocated successfully.
+    }
 
-        if (result == Result::Success)
+    if (result == Result::Success)
+    {
+        // We must track the number of batched submissions to make WaitIdle spin until all submissions have been
+        // submitted to the OS layer. This has to happen before ReleaseFromStalledState() can see the command.
+        AtomicIncrement(&m_batchedSubmissionCount);
+
+        bool enqueued = false;
+        result = EnqueueBatchedCmd(cmdData, &enqueued);
+
+        if (enqueued == false)
         {
-            result = m_batchedCmds.PushBack(cmdData);
+            FreeBatchedCmd(&cmdData);
 
             if (result == Result::Success)
             {
-                // We must track the number of batched submissions to make WaitIdle spin until all submissions have been
-                // submitted to the OS layer.
-                AtomicIncrement(&m_batchedSubmissionCount);
-            }
-            else
-            {
-                PAL_SAFE_FREE(cmdData.submit.pDynamicMem, m_pDevice->GetPlatform());
+                // We had a false-positive and aren't really stalled. Submit immediately.
+                result = ExecuteBatchedSubmit(submitInfo, pInternalSubmitInfo);
             }
         }
     }
-    else
-    {
-        // We had a false-positive and aren't really stalled. Submit immediately.
-        result = OsSubmit(submitInfo, pInternalSubmitInfo);
-    }
 
     return result;
 }
@@ -27,9 +27,12 @@
 
 #include "core/platform.h"
 #include "palQueue.h"
+#include "palConditionVariable.h"
 #include "palDeque.h"
 #include "palIntrusiveList.h"
 #include "palMutex.h"
+#include "palSemaphore.h"
+#include "palThread.h"
 
 namespace Pal
 {
@@ -123,7 +126,7 @@ struct BatchedQueueCmdData
         struct
         {
             MultiSubmitInfo           submitInfo;
-            const InternalSubmitInfo* pInternalSubmitInfo;
+            InternalSubmitInfo*       pInternalSubmitInfo;
             void*                     pDynamicMem;
         } submit;
 
@@ -165,6 +168,13 @@ struct BatchedQueueCmdData
     };
 };
 
+// A batched-up Queue command, linked into the Queue's lock-free list of commands deferred while it is stalled.
+struct BatchedQueueCmdNode
+{
+    BatchedQueueCmdNode* pNext;
+    BatchedQueueCmdData  data;
+};
+
 // =====================================================================================================================
 // A submission context holds queue state and logic that must persist after the queue itself has been destroyed. That
 // requires all submission contexts to be internally allocated and referenced counted.
@@ -189,8 +199,21 @@ public:
 
     uint64 LastTimestamp() const { return m_lastTimestamp; }
 
+    // A queue's submit thread has nobody to return errors to, so the first one is latched here for the queue's later
+    // calls and for the fences submitted on it.
+    void LatchSubmitError(Result result)
+        { Util::AtomicCompareAndSwap(&m_submitError, 0, static_cast<uint32>(result)); }
+
+    Result SubmitError() const { return static_cast<Result>(m_submitError); }
+
 protected:
-    SubmissionContext(Platform* pPlatform) : m_lastTimestamp(0), m_pPlatform(pPlatform), m_refCount(1) {}
+    SubmissionContext(Platform* pPlatform)
+        :
+        m_lastTimestamp(0),
+        m_pPlatform(pPlatform),
+        m_refCount(1),
+        m_submitError(0)
+    {}
     virtual ~SubmissionContext() {}
 
     uint64 m_lastTimestamp; // The last fence timestamp which has been submitted to the OS.
@@ -198,6 +221,8 @@ protected:
 private:
     Platform*const  m_pPlatform;
     volatile uint32 m_refCount;
+    volatile uint32 m_submitError; // First failed Result hit by the owning queue's submit thread, zero (Success) if
+                                   // it has never failed.
 
     PAL_DISALLOW_DEFAULT_CTOR(SubmissionContext);
     PAL_DISALLOW_COPY_AND_ASSIGN(SubmissionContext);
@@ -300,12 +325,20 @@ public:
 
     Result ReleaseFromStalledState();
 
+    void RunSubmitThread();
+    Result SubmitThreadError() const;
+
     virtual uint32 EngineId() const { return m_pQueueInfos[0].createInfo.engineIndex; }
     virtual QueuePriority Priority() const { return m_pQueueInfos[0].createInfo.priority; }
     CmdBuffer*    DummyCmdBuffer() const { return m_pDummyCmdBuffer; }
     Result        DummySubmit(bool postBatching);
 
     virtual bool UsesDispatchTunneling() const { return (m_pQueueInfos[0].createInfo.dispatchTunneling != 0); }
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 636
+    bool UsesSubmitThread()              const { return (m_pQueueInfos[0].createInfo.submitThread != 0); }
+#else
+    bool UsesSubmitThread()              const { return false; }
+#endif
     virtual bool IsWindowedPriorBlit()   const { return (m_pQueueInfos[0].createInfo.windowedPriorBlit != 0); }
     bool UsesPhysicalModeSubmission() const;
     bool IsPreemptionSupported()      const;
@@ -320,7 +353,7 @@ public:
 
     Device*const GetDevice() { return m_pDevice; }
 
-    bool IsStalled() const { return m_stalled; }
+    bool IsStalled() const { return (m_pBatchedCmdsHead != ClosedBatchedCmds()); }
 
     void IncFrameCount();
 
@@ -396,14 +429,28 @@ private:
 
     virtual Result ValidateSubmit(const MultiSubmitInfo& submitInfo) const;
 
+    Result PrepareSubmit(const MultiSubmitInfo& submitInfo, InternalSubmitInfo* pInternalSubmitInfos);
+    void   TrackSubmission(const MultiSubmitInfo& submitInfo);
+    Result ExecuteBatchedSubmit(const MultiSubmitInfo& submitInfo, InternalSubmitInfo* pInternalSubmitInfos);
+
     Result EnqueueSubmit(
-        const MultiSubmitInfo&    submitInfo,
-        const InternalSubmitInfo* pInternalSubmitInfo);
+        const MultiSubmitInfo& submitInfo,
+        InternalSubmitInfo*    pInternalSubmitInfo);
 
     Result WaitQueueSemaphoreNoChecks(
         IQueueSemaphore* pQueueSemaphore,
         volatile bool*   pIsStalled);
 
+    // The head of the batched command list holds this sentinel whenever the Queue is not stalled.
+    static BatchedQueueCmdNode* ClosedBatchedCmds() { return &s_closedBatchedCmds; }
+
+    bool   TryStall();
+    Result DrainBatchedCmds();
+    Result EnqueueBatchedCmd(const BatchedQueueCmdData& cmdData, bool* pEnqueued);
+    Result ExecuteBatchedCmd(BatchedQueueCmdData* pCmdData, bool* pStalledAgain);
+    void   FreeBatchedCmd(BatchedQueueCmdData* pCmdData);
+    void   AppendPendingCmds(BatchedQueueCmdNode* pList);
+
 #if PAL_ENABLE_PRINTS_ASSERTS
     void DumpCmdToFile(
         const MultiSubmitInfo&    submitInfo,
@@ -429,15 +476,28 @@ private:
         void*                    pUserData) const;
 #endif
 
-    // Tracks whether or not this Queue is stalled by a Queue Semaphore, and if so, the Semaphore which is blocking
-    // this Queue.
-    volatile bool     m_stalled;
+    // The Semaphore which is blocking this Queue, if any.
     IQueueSemaphore*  m_pWaitingSemaphore;
 
     volatile uint32   m_batchedSubmissionCount; // How many batched submissions will be sent to OS layer later on.
 
-    Util::Deque<BatchedQueueCmdData, Platform>  m_batchedCmds;
-    Util::Mutex                                 m_batchedCmdsLock;
+    // Commands batched-up while this Queue is stalled form a lock-free LIFO list: producers push onto the head with a
+    // single compare-and-swap and never block each other. The head holds ClosedBatchedCmds() whenever the Queue is not
+    // stalled, which sends producers down the immediate path instead. Only DrainBatchedCmds() consumes the list; it
+    // moves the nodes into m_pPendingCmds in submission order and only closes the list once it is empty. When the
+    // Queue uses a submit thread the list is never closed, so every command is handed to m_submitThread.
+    BatchedQueueCmdNode*volatile  m_pBatchedCmdsHead;
+    BatchedQueueCmdNode*          m_pPendingCmds;
+    Util::Mutex                   m_batchedCmdsLock;    // Serializes DrainBatchedCmds(); producers never take it.
+    bool                          m_stalledOnSemaphore; // A batched-up wait blocked this Queue. Protected by
+                                                        // m_batchedCmdsLock.
+
+    Util::Thread                  m_submitThread;       // Executes batched-up commands if submits are offloaded.
+    Util::Semaphore               m_submitThreadNotify; // Signaled whenever a command is batched-up.
+    Util::ConditionVariable       m_batchedCmdsDrained; // Woken by the submit thread whenever it runs out of work.
+    volatile bool                 m_submitThreadEnd;    // Tells m_submitThread to exit.
+
+    static BatchedQueueCmdNode    s_closedBatchedCmds;
 
     // Each queue must register itself with its device and engine so that they can manage their internal lists.
     Util::IntrusiveListNode<Queue>              m_deviceMembershipNode;
@@ -190,6 +190,11 @@ void SettingsLoader::ValidateSettings()
             sizeof(pPlatformSettings->eventLogDirectory),
             "%s/%s", pRootPath, subDir);
 
+        Strncpy(subDir, pPlatformSettings->rmtTraceDirectory, sizeof(subDir));
+        Snprintf(pPlatformSettings->rmtTraceDirectory,
+                 sizeof(pPlatformSettings->rmtTraceDirectory),
+                 "%s/%s", pRootPath, subDir);
+
     }
 
     m_state = SettingsLoaderState::Final;
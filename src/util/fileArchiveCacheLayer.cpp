@@ -32,6 +32,8 @@
 #include "palVectorImpl.h"
 #include "core/platform.h"
 
+#include "lz4.h"
+
 namespace Util
 {
 
@@ -41,16 +43,23 @@ FileArchiveCacheLayer::FileArchiveCacheLayer(
     const AllocCallbacks& callbacks,
     IArchiveFile*         pArchiveFile,
     IHashContext*         pBaseContext,
-    void*                 pTempContextMem)
+    void*                 pTempContextMem,
+    bool                  useCompression,
+    size_t                preloadSize)
     :
-    CacheLayerBase     { callbacks },
-    m_pArchivefile     { pArchiveFile },
-    m_pBaseContext     { pBaseContext },
-    m_pTempContextMem  { pTempContextMem },
-    m_archiveFileMutex {},
-    m_hashContextMutex {},
-    m_entryMapLock     {},
-    m_entries          { HashTableBucketCount, Allocator() }
+    CacheLayerBase       { callbacks },
+    m_pArchivefile       { pArchiveFile },
+    m_pBaseContext       { pBaseContext },
+    m_pTempContextMem    { pTempContextMem },
+    m_archiveSupportsLz4 { (pArchiveFile != nullptr) && (pArchiveFile->GetMinorVersion() >= MinLz4MinorVersion) },
+    m_useCompression     { useCompression && m_archiveSupportsLz4 },
+    m_preloadSize        { preloadSize },
+    m_archiveFileMutex   {},
+    m_hashContextMutex   {},
+    m_entryMapLock       {},
+    m_entries            { HashTableBucketCount, Allocator() },
+    m_indexedEntryCount  { 0 },
+    m_nextHeaderIndex    { 0 }
 {
     PAL_ASSERT(m_pArchivefile != nullptr);
     PAL_ASSERT(m_pBaseContext != nullptr);
@@ -89,6 +98,23 @@ Result FileArchiveCacheLayer::Init()
         result = m_entries.Init();
     }
 
+    // Entries covered by the archive's index are looked up there directly and never added to our own table.
+    if (result == Result::Success)
+    {
+        m_indexedEntryCount = m_pArchivefile->GetIndexedEntryCount();
+        m_nextHeaderIndex   = m_indexedEntryCount;
+    }
+
+    // With async file I/O the preload streams in on the archive's loader thread while we start serving requests.
+    // Archives which can't preload (or are still empty) work the same without it, so its failure isn't ours.
+    if ((result == Result::Success) && (m_preloadSize > 0))
+    {
+        const Result preloadResult = m_pArchivefile->Preload(0, m_preloadSize);
+
+        PAL_ALERT((preloadResult != Result::Success) && (preloadResult != Result::Unsupported) &&
+                  (m_pArchivefile->GetEntryCount() > 0));
+    }
+
     // Collapse all results other than success
     if (result != Result::Success)
     {
@@ -117,18 +143,14 @@ Result FileArchiveCacheLayer::QueryInternal(
     }
     else
     {
-        EntryKey     key;
-        const Entry* pEntry;
+        EntryKey key;
+        Entry    entry;
 
         ConvertToEntryKey(pHashId, &key);
 
-        {
-            RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
-
-            pEntry = m_entries.FindKey(key);
-        }
+        result = FindEntry(key, &entry);
 
-        if (pEntry == nullptr)
+        if (result == Result::NotFound)
         {
             MutexAuto                     archiveFileLock { &m_archiveFileMutex };
             RWLockAuto<RWLock::ReadWrite> entryMapLock { &m_entryMapLock };
@@ -141,22 +163,22 @@ Result FileArchiveCacheLayer::QueryInternal(
             // If the refresh picked up any new header, search again
             if (oldEntryCount != m_entries.GetNumEntries())
             {
-                pEntry = m_entries.FindKey(key);
+                const Entry* pEntry = FindMappedEntry(key);
+
+                if (pEntry != nullptr)
+                {
+                    entry  = *pEntry;
+                    result = Result::Success;
+                }
             }
         }
 
-        if (pEntry != nullptr)
+        if (result == Result::Success)
         {
             pQuery->pLayer          = this;
             pQuery->hashId          = *pHashId;
-            pQuery->dataSize        = pEntry->dataSize;
-            pQuery->context.entryId = pEntry->ordinalId;
-
-            result = Result::Success;
-        }
-        else
-        {
-            result = Result::NotFound;
+            pQuery->dataSize        = entry.dataSize;
+            pQuery->context.entryId = entry.ordinalId;
         }
     }
 
@@ -184,48 +206,68 @@ Result FileArchiveCacheLayer::StoreInternal(
     }
     else
     {
+        Entry entry;
+
         ConvertToEntryKey(pHashId, &key);
 
+        if (FindEntry(key, &entry) == Result::Success)
         {
-            RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
-
-            if (m_entries.FindKey(key) != nullptr)
-            {
-                result = Result::AlreadyExists;
-            }
+            result = Result::AlreadyExists;
         }
     }
 
     if (result == Result::NotFound)
     {
-        ArchiveEntryHeader header         = {};
-        const size_t       writeDataSize  = dataSize;
-        void* const        pMem           = PAL_MALLOC(writeDataSize, Allocator(), AllocInternalTemp);
+        ArchiveEntryHeader header     = {};
+        const void*        pWriteData = pData;
+        void*              pMem       = nullptr;
 
-        PAL_ALERT(pMem == nullptr);
+        header.dataSize  = static_cast<uint32>(dataSize);
+        header.metaValue = static_cast<uint32>(dataSize);
 
-        if (pMem != nullptr)
-        {
-            result = Result::Success;
-        }
-        else
+        memcpy(header.entryKey, key.value, sizeof(EntryKey));
+
+        result = Result::Success;
+
+        // Compress into a scratch buffer, keeping the compressed data only if it's actually smaller.
+        if (m_useCompression)
         {
-            result = Result::ErrorOutOfMemory;
+            const int32 maxCompressedSize = LZ4_compressBound(static_cast<int32>(dataSize));
+
+            pMem = PAL_MALLOC(maxCompressedSize, Allocator(), AllocInternalTemp);
+
+            PAL_ALERT(pMem == nullptr);
+
+            if (pMem != nullptr)
+            {
+                const int32 compressedSize = LZ4_compress_default(static_cast<const char*>(pData),
+                                                                  static_cast<char*>(pMem),
+                                                                  static_cast<int32>(dataSize),
+                                                                  maxCompressedSize);
+
+                if ((compressedSize > 0) &&
+                    (static_cast<size_t>(compressedSize) < dataSize))
+                {
+                    pWriteData       = pMem;
+                    header.dataSize  = static_cast<uint32>(compressedSize);
+                    header.dataType |= ArchiveLz4DataFlag;
+
+                    EntryKey lz4Key;
+                    GetLz4EntryKey(key, &lz4Key);
+                    memcpy(header.entryKey, lz4Key.value, sizeof(EntryKey));
+                }
+            }
+            else
+            {
+                result = Result::ErrorOutOfMemory;
+            }
         }
 
-        // Write the scratch buffer to the file
         if (result == Result::Success)
         {
             MutexAuto archiveFileLock { &m_archiveFileMutex };
 
-            void* const pDataMem = pMem;
-            header.dataSize      = static_cast<uint32>(writeDataSize);
-            header.metaValue     = static_cast<uint32>(dataSize);
-
-            memcpy(pDataMem, pData, dataSize);
-            memcpy(header.entryKey, key.value, sizeof(EntryKey));
-
-            result = m_pArchivefile->Write(&header, pMem);
+            result = m_pArchivefile->Write(&header, pWriteData);
         }
 
         // Only insert this entry into our lookup table if everything succeeded
@@ -234,6 +276,12 @@ Result FileArchiveCacheLayer::StoreInternal(
             RWLockAuto<RWLock::ReadWrite> entryMapLock { &m_entryMapLock };
 
             result = AddHeaderToTable(header);
+
+            // Don't read back the header we just wrote on the next refresh
+            if (header.ordinalId == m_nextHeaderIndex)
+            {
+                m_nextHeaderIndex += 1;
+            }
         }
 
         if (pMem != nullptr)
@@ -274,17 +322,16 @@ Result FileArchiveCacheLayer::LoadInternal(
 #if DEBUG
     if (result == Result::Success)
     {
-        RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
-
         EntryKey key;
+        Entry    entry;
         ConvertToEntryKey(&pQuery->hashId, &key);
 
-        const Entry* pEntry = m_entries.FindKey(key);
+        const Result findResult = FindEntry(key, &entry);
 
         // Should be safe to have these in order, if alerts are enabled then the first will be hit,
         // if they are disabled then neither will be.
-        PAL_ALERT(pEntry == nullptr);
-        PAL_ALERT(pEntry->ordinalId != pQuery->context.entryId);
+        PAL_ALERT(findResult != Result::Success);
+        PAL_ALERT(entry.ordinalId != pQuery->context.entryId);
     }
 #endif
 
@@ -292,22 +339,38 @@ Result FileArchiveCacheLayer::LoadInternal(
 
     if (result == Result::Success)
     {
-        MutexAuto archiveFileLock { &m_archiveFileMutex };
-
-        size_t entryId = static_cast<size_t>(pQuery->context.entryId);
-        result         = m_pArchivefile->GetEntryByIndex(entryId, &header);
+        result = GetQueryHeader(pQuery, &header);
     }
 
+    // Copy straight out of the archive's mapping when it has one, this avoids both the temporary buffer and the
+    // archive's own read buffers.
+    bool loaded = false;
+
     if (result == Result::Success)
     {
-        PAL_ALERT(header.ordinalId != pQuery->context.entryId);
-        PAL_ALERT(header.metaValue > pQuery->dataSize);
+        const void* pMappedData = nullptr;
+        Result      readResult  = Result::Unsupported;
+
+        {
+            MutexAuto archiveFileLock { &m_archiveFileMutex };
 
-        const size_t readSize      = header.dataSize;
-        const size_t dataSize      = header.metaValue;
+            readResult = m_pArchivefile->ReadMapped(&header, &pMappedData);
+        }
+
+        // The mapping stays valid after the lock is released, only the archive file object itself needs it
+        if (readResult == Result::Success)
+        {
+            result = CopyEntryData(header, pMappedData, pBuffer);
+            loaded = true;
+        }
+    }
+
+    if ((result == Result::Success) &&
+        (loaded == false))
+    {
+        const size_t readSize = header.dataSize;
 
         void* const pReadMem = PAL_MALLOC(readSize, Allocator(), AllocInternalTemp);
-        void* const pDataMem = pReadMem;
 
         if (pReadMem == nullptr)
         {
@@ -316,22 +379,30 @@ Result FileArchiveCacheLayer::LoadInternal(
 
         if (result == Result::Success)
         {
-            MutexAuto archiveFileLock { &m_archiveFileMutex };
-
-            result = m_pArchivefile->Read(&header, pReadMem);
-
-            // In the case that AsyncIO is not ready, signal Result::NotFound
-            if (result == Result::NotReady)
+            do
             {
-                result = Result::NotFound;
-            }
+                {
+                    MutexAuto archiveFileLock { &m_archiveFileMutex };
+
+                    result = m_pArchivefile->Read(&header, pReadMem);
+                }
+
+                // The entry is still being streamed in by a preload. Wait on just the part of the file holding it,
+                // without the archive lock so other entries can be used meanwhile. The pages may have been recycled
+                // by the time we are woken, so go around and read again.
+                if (result == Result::NotReady)
+                {
+                    result = m_pArchivefile->WaitForData(&header);
+                    result = (result == Result::Success) ? Result::NotReady : result;
+                }
+            } while (result == Result::NotReady);
 
             PAL_ALERT(IsErrorResult(result));
         }
 
         if (result == Result::Success)
         {
-            memcpy(pBuffer, pDataMem, dataSize);
+            result = CopyEntryData(header, pReadMem, pBuffer);
         }
 
         if (pReadMem != nullptr)
@@ -345,6 +416,199 @@ Result FileArchiveCacheLayer::LoadInternal(
     return result;
 }
 
+// =====================================================================================================================
+// Wait for an entry that is still being streamed in by a preload of the archive file
+Result FileArchiveCacheLayer::WaitForEntry(
+    const Hash128* pHashId)
+{
+    Result result = Result::Success;
+
+    if (pHashId == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else
+    {
+        EntryKey key;
+        Entry    entry;
+
+        ConvertToEntryKey(pHashId, &key);
+
+        result = FindEntry(key, &entry);
+
+        if (result == Result::Success)
+        {
+            ArchiveEntryHeader header;
+
+            {
+                MutexAuto archiveFileLock { &m_archiveFileMutex };
+
+                result = m_pArchivefile->GetEntryByIndex(static_cast<size_t>(entry.ordinalId), &header);
+            }
+
+            // Waiting doesn't need the archive lock, so only this entry's callers are held up
+            if (result == Result::Success)
+            {
+                result = m_pArchivefile->WaitForData(&header);
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Check if we know how to interpret an entry's data. Compressed entries found in an archive whose version predates
+// compression were not written by a reader that agrees with us on the format, so they are skipped as if not present.
+bool FileArchiveCacheLayer::IsEntryUsable(
+    const ArchiveEntryHeader& header
+    ) const
+{
+    const bool usable = (TestAnyFlagSet(header.dataType, ArchiveLz4DataFlag) == false) || m_archiveSupportsLz4;
+
+    PAL_ALERT(usable == false);
+
+    return usable;
+}
+
+// =====================================================================================================================
+// Produce an entry's data in the client's buffer from the data stored in the archive, decompressing it if needed
+Result FileArchiveCacheLayer::CopyEntryData(
+    const ArchiveEntryHeader& header,
+    const void*               pSrc,
+    void*                     pDst)
+{
+    PAL_ASSERT(pSrc != nullptr);
+    PAL_ASSERT(pDst != nullptr);
+
+    Result result = Result::Success;
+
+    if (TestAnyFlagSet(header.dataType, ArchiveLz4DataFlag))
+    {
+        const int32 decompressedSize = LZ4_decompress_safe(static_cast<const char*>(pSrc),
+                                                           static_cast<char*>(pDst),
+                                                           static_cast<int32>(header.dataSize),
+                                                           static_cast<int32>(header.metaValue));
+
+        // The data passed the CRC check, so this means it was written by something other than us
+        if (decompressedSize != static_cast<int32>(header.metaValue))
+        {
+            PAL_ALERT_ALWAYS();
+            result = Result::ErrorUnknown;
+        }
+    }
+    else
+    {
+        memcpy(pDst, pSrc, header.metaValue);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Look up the archive entry header for an entry found by QueryInternal()
+Result FileArchiveCacheLayer::GetQueryHeader(
+    const QueryResult*  pQuery,
+    ArchiveEntryHeader* pHeader)
+{
+    PAL_ASSERT(pQuery != nullptr);
+    PAL_ASSERT(pHeader != nullptr);
+
+    MutexAuto archiveFileLock { &m_archiveFileMutex };
+
+    const size_t entryId = static_cast<size_t>(pQuery->context.entryId);
+    const Result result  = m_pArchivefile->GetEntryByIndex(entryId, pHeader);
+
+    if (result == Result::Success)
+    {
+        PAL_ALERT(pHeader->ordinalId != pQuery->context.entryId);
+        PAL_ALERT(pHeader->metaValue > pQuery->dataSize);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Entries are never removed from an archive file, so any entry we responded to a query with stays available.
+Result FileArchiveCacheLayer::AcquireCacheRef(
+    const QueryResult* pQuery)
+{
+    Result result = Result::Success;
+
+    if (pQuery == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (pQuery->pLayer != this)
+    {
+        result = Result::ErrorInvalidValue;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Nothing to release, see AcquireCacheRef()
+Result FileArchiveCacheLayer::ReleaseCacheRef(
+    const QueryResult* pQuery)
+{
+    Result result = Result::Success;
+
+    if (pQuery == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (pQuery->pLayer != this)
+    {
+        result = Result::ErrorInvalidValue;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Return a pointer to the entry's data inside the archive file's read-only mapping. This is only possible if the
+// archive was opened with mapped reads.
+Result FileArchiveCacheLayer::GetCacheData(
+    const QueryResult* pQuery,
+    const void**       ppData)
+{
+    Result result = Result::Success;
+
+    if ((pQuery == nullptr) || (ppData == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (pQuery->pLayer != this)
+    {
+        result = Result::ErrorInvalidValue;
+    }
+    else
+    {
+        *ppData = nullptr;
+
+        ArchiveEntryHeader header;
+
+        result = GetQueryHeader(pQuery, &header);
+
+        // Compressed data is in an internal format which can't be handed out as-is
+        if ((result == Result::Success) &&
+            (TestAnyFlagSet(header.dataType, ArchiveLz4DataFlag) || (header.metaValue != header.dataSize)))
+        {
+            result = Result::Unsupported;
+        }
+
+        if (result == Result::Success)
+        {
+            MutexAuto archiveFileLock { &m_archiveFileMutex };
+
+            result = m_pArchivefile->ReadMapped(&header, ppData);
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Get the size needed to construct the base context for the layer depending on if an existing platform key is passed
 static size_t GetBaseContextSizeFromCreateInfo(
@@ -362,6 +626,8 @@ static size_t GetBaseContextSizeFromCreateInfo(
         Result          result = GetHashContextInfo(HashAlgorithm::Sha1, &info);
 
         PAL_ALERT(IsErrorResult(result));
+
+        contextSize = info.contextObjectSize;
     }
 
     return contextSize;
@@ -428,7 +694,9 @@ Result CreateArchiveFileCacheLayer(
             (pCreateInfo->baseInfo.pCallbacks == nullptr) ? callbacks : *pCreateInfo->baseInfo.pCallbacks,
             pCreateInfo->pFile,
             pBaseContext,
-            pTempContextMem);
+            pTempContextMem,
+            pCreateInfo->useCompression,
+            pCreateInfo->preloadSize);
 
         result = pLayer->Init();
 
@@ -464,18 +732,114 @@ Result FileArchiveCacheLayer::AddHeaderToTable(
     return m_entries.Insert(key, {header.ordinalId, header.metaValue});
 }
 
+// =====================================================================================================================
+// Compressed entries are stored under a variant of their key. Readers which predate compression never look for it, so
+// they can't mistake compressed data for the real thing; they simply miss and may store an uncompressed copy.
+void FileArchiveCacheLayer::GetLz4EntryKey(
+    const EntryKey& key,
+    EntryKey*       pLz4Key)
+{
+    static constexpr uint8 Lz4KeyMask[] = { 'L', 'Z', '4', 'C' };
+
+    *pLz4Key = key;
+
+    for (uint32 i = 0; i < sizeof(Lz4KeyMask); ++i)
+    {
+        pLz4Key->value[i] ^= Lz4KeyMask[i];
+    }
+}
+
+// =====================================================================================================================
+// Look up an entry in the entries we have read or written ourselves, under either of its keys. The caller must hold
+// m_entryMapLock.
+const FileArchiveCacheLayer::Entry* FileArchiveCacheLayer::FindMappedEntry(
+    const EntryKey& key)
+{
+    const Entry* pFound = m_entries.FindKey(key);
+
+    if ((pFound == nullptr) && m_archiveSupportsLz4)
+    {
+        EntryKey lz4Key;
+        GetLz4EntryKey(key, &lz4Key);
+
+        pFound = m_entries.FindKey(lz4Key);
+    }
+
+    return pFound;
+}
+
+// =====================================================================================================================
+// Look up an entry under either of its keys
+Result FileArchiveCacheLayer::FindEntry(
+    const EntryKey& key,
+    Entry*          pEntry)
+{
+    Result result = FindIndexedEntry(key, pEntry);
+
+    if ((result == Result::NotFound) && m_archiveSupportsLz4)
+    {
+        EntryKey lz4Key;
+        GetLz4EntryKey(key, &lz4Key);
+
+        result = FindIndexedEntry(lz4Key, pEntry);
+    }
+
+    if (result == Result::NotFound)
+    {
+        RWLockAuto<RWLock::ReadOnly> entryMapLock { &m_entryMapLock };
+
+        const Entry* pFound = FindMappedEntry(key);
+
+        if (pFound != nullptr)
+        {
+            *pEntry = *pFound;
+            result  = Result::Success;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Look up one key of an entry in the archive file's index
+Result FileArchiveCacheLayer::FindIndexedEntry(
+    const EntryKey& key,
+    Entry*          pEntry)
+{
+    Result result = Result::NotFound;
+
+    if (m_indexedEntryCount > 0)
+    {
+        // The archive's index never changes once loaded, so it can be searched without taking the archive file lock.
+        ArchiveEntryHeader header;
+        const Result       indexResult = m_pArchivefile->FindIndexedEntry(key.value, &header);
+
+        // Stale copies of the archive's own index are covered by the index too, but never hold cache data.
+        if ((indexResult == Result::Success) &&
+            (header.dataType != ArchiveIndexDataType) &&
+            IsEntryUsable(header))
+        {
+            pEntry->ordinalId = header.ordinalId;
+            pEntry->dataSize  = header.metaValue;
+
+            result = Result::Success;
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Reload entry headers from the archive file
 Result FileArchiveCacheLayer::RefreshHeaders()
 {
     Result       result        = Result::Success;
     const size_t newEntryCount = m_pArchivefile->GetEntryCount();
-    size_t       curEntryCount = m_entries.GetNumEntries();
 
-    while (curEntryCount < newEntryCount)
+    while (m_nextHeaderIndex < newEntryCount)
     {
         ArchiveEntryHeader header;
-        result = m_pArchivefile->GetEntryByIndex(curEntryCount, &header);
+        result = m_pArchivefile->GetEntryByIndex(m_nextHeaderIndex, &header);
 
         if (result != Result::Success)
         {
@@ -483,9 +847,21 @@ Result FileArchiveCacheLayer::RefreshHeaders()
             break;
         }
 
-        PAL_ALERT(header.ordinalId != curEntryCount);
+        PAL_ALERT(header.ordinalId != m_nextHeaderIndex);
 
-        result = AddHeaderToTable(header);
+        if (header.dataType == ArchiveIndexDataType)
+        {
+            // The archive's own index doesn't hold cache data. While it is the last entry it will be replaced by the
+            // next write to the archive, so don't move past it.
+            if ((m_nextHeaderIndex + 1) == newEntryCount)
+            {
+                break;
+            }
+        }
+        else if (IsEntryUsable(header))
+        {
+            result = AddHeaderToTable(header);
+        }
 
         if (IsErrorResult(result))
         {
@@ -493,7 +869,7 @@ Result FileArchiveCacheLayer::RefreshHeaders()
             break;
         }
 
-        curEntryCount += 1;
+        m_nextHeaderIndex += 1;
     }
 
     return result;
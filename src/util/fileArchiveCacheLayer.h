@@ -45,11 +45,18 @@ public:
         const AllocCallbacks& callbacks,
         IArchiveFile*         pArchiveFile,
         IHashContext*         pBaseContext,
-        void*                 pTemContextMem);
+        void*                 pTemContextMem,
+        bool                  useCompression,
+        size_t                preloadSize);
     virtual ~FileArchiveCacheLayer();
 
     virtual Result Init() override;
 
+    virtual Result AcquireCacheRef(const QueryResult* pQuery) override;
+    virtual Result ReleaseCacheRef(const QueryResult* pQuery) override;
+    virtual Result GetCacheData(const QueryResult* pQuery, const void** ppData) override;
+    virtual Result WaitForEntry(const Hash128* pHashId) override;
+
 protected:
 
     virtual Result QueryInternal(
@@ -94,17 +101,33 @@ private:
     Result AddHeaderToTable(const ArchiveEntryHeader& header);
     Result RefreshHeaders();
 
+    // Entry lookup
+    static void  GetLz4EntryKey(const EntryKey& key, EntryKey* pLz4Key);
+    const Entry* FindMappedEntry(const EntryKey& key);
+    Result       FindIndexedEntry(const EntryKey& key, Entry* pEntry);
+    Result       FindEntry(const EntryKey& key, Entry* pEntry);
+    Result GetQueryHeader(const QueryResult* pQuery, ArchiveEntryHeader* pHeader);
+
+    // Entry data
+    bool          IsEntryUsable(const ArchiveEntryHeader& header) const;
+    static Result CopyEntryData(const ArchiveEntryHeader& header, const void* pSrc, void* pDst);
+
     // Invariants that must be passed in by ctor
     IArchiveFile* const  m_pArchivefile;
     IHashContext* const  m_pBaseContext;
     void* const          m_pTempContextMem;
+    const bool           m_archiveSupportsLz4; // Archive version allows LZ4 compressed entries
+    const bool           m_useCompression;
+    const size_t         m_preloadSize;        // Bytes of the archive to preload when the layer is initialized
 
     Mutex                m_archiveFileMutex;
     Mutex                m_hashContextMutex;
     RWLock               m_entryMapLock;
 
     // Data Members
-    EntryMap m_entries;
+    EntryMap m_entries;            // Entries not covered by the archive file's index
+    size_t   m_indexedEntryCount;  // Number of entries covered by the archive file's index
+    size_t   m_nextHeaderIndex;    // Ordinal of the next archive entry header to add to m_entries
 };
 
 } //namespace Util
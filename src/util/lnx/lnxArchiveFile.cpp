@@ -39,6 +39,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -133,34 +134,22 @@ static Result ReadDirect(
     struct stat statBuf;
     Result result    = Result::ErrorUnknown;
 
-    if (fstat(fd, &statBuf) == 0)
+    if ((fstat(fd, &statBuf) == 0) &&
+        (static_cast<size_t>(statBuf.st_size) >= fileOffset))
     {
-        result = Result::Success;
-    }
+        // Reads near the end of the file (e.g. of a whole cache page) only get what the file has left
+        const size_t exactSize = Min(readSize, static_cast<size_t>(statBuf.st_size) - fileOffset);
 
-    if (result == Result::Success)
-    {
-        if (lseek(fd, fileOffset, SEEK_SET) == InvalidSysCall)
+        // pread() leaves the file position alone so the page loader thread can read while other reads and writes
+        // are made through the same file descriptor.
+        if (pread(fd, pBuffer, exactSize, fileOffset) == static_cast<ssize_t>(exactSize))
         {
-            result = Result::ErrorUnknown;
+            result = Result::Success;
         }
-
     }
 
-    size_t alreadyReadSize = 0;
-    size_t exactSize = Min(readSize, static_cast<size_t>(statBuf.st_size));
-
-    if (result == Result::Success)
-    {
-        alreadyReadSize = read(fd, pBuffer, exactSize);
-    }
-    if (alreadyReadSize == exactSize)
-    {
-        result = Result::Success;
-    }
-    else
+    if (result != Result::Success)
     {
-        result = Result::ErrorUnknown;
         PAL_ALERT_ALWAYS();
     }
 
@@ -453,21 +442,63 @@ ArchiveFile::ArchiveFile(
     m_cachedFooter      (),
     m_curFooterOffset   (0),
     m_entries           (Allocator()),
+    // Entry index
+    m_index             (Allocator()),
+    m_indexHeaderOffset (0),
+    m_indexDirty        (false),
     // Write Access
     m_haveWriteAccess   (haveWriteAccess),
+    // Mapped reads
+    m_useMappedReads    (false),
+    m_fileMapping       (),
+    m_mappedViews       (Allocator()),
+    m_mappedVerified    (Allocator()),
     // Read memory buffering
     m_useBufferedMemory (false),
     m_bufferMemory      (memoryBufferMax),
     m_recentList        (),
     m_pages             (),
     m_pageCount         (0),
-    m_pageSize          (MinPageSize)
+    m_pageSize          (MinPageSize),
+    // Background page loader
+    m_useAsyncIo        (false),
+    m_loaderThread      (),
+    m_loaderSemaphore   (),
+    m_loaderMutex       (),
+    m_pageLoaded        (),
+    m_loadQueue         (),
+    m_loadQueueHead     (0),
+    m_loadQueueCount    (0),
+    m_pLoadingPage      (nullptr)
 {
 }
 
 // =====================================================================================================================
 ArchiveFile::~ArchiveFile()
 {
+    // Stop the loader first, the index write below goes through the cached pages. An empty queue tells it to stop once
+    // everything queued before has been loaded.
+    if (m_useAsyncIo)
+    {
+        m_loaderSemaphore.Post();
+        m_loaderThread.Join();
+    }
+
+    // Leave an up to date index behind so the next open doesn't need to walk every entry header.
+    if (m_indexDirty)
+    {
+        Result result = WriteIndex();
+        PAL_ALERT(IsErrorResult(result));
+    }
+
+    for (uint32 i = 0; i < m_mappedViews.NumElements(); ++i)
+    {
+        m_mappedViews.At(i)->UnMap(false);
+        PAL_DELETE(m_mappedViews.At(i), Allocator());
+    }
+
+    m_fileMapping.Close();
+
     close(m_hFile);
 }
 
@@ -478,14 +509,36 @@ Result ArchiveFile::Init(
 {
     Result result = Result::Success;
 
+    // Mapped reads take the place of the internal memory buffers. If the mapping can't be created we fall back to
+    // whatever else was requested.
+    if (pInfo->useMemoryMappedReads)
+    {
+        char fullPath[MaxPathLength + MaxFilenameLength + 1] = {};
+
+        GenerateFullPath(fullPath, sizeof(fullPath), pInfo);
+
+        m_useMappedReads = (m_fileMapping.Create(fullPath, false, 0, nullptr) == Result::Success);
+        PAL_ALERT(m_useMappedReads == false);
+    }
+
     // Init internal memory buffers
-    if ((result == Result::Success) &&
+    if ((result == Result::Success)   &&
+        (m_useMappedReads == false) &&
         (pInfo->useBufferedReadMemory))
     {
         m_useBufferedMemory = true;
         result              = InitPages();
     }
 
+    // Async reads stream pages into the buffer from a background thread. Without one, reads are simply synchronous.
+    if ((result == Result::Success) &&
+        m_useBufferedMemory         &&
+        (pInfo->allowAsyncFileIo))
+    {
+        Result loaderResult = InitLoader();
+        PAL_ALERT(IsErrorResult(loaderResult));
+    }
+
     // Read the footer of the file directly
     if (result == Result::Success)
     {
@@ -495,6 +548,16 @@ Result ArchiveFile::Init(
         }
     }
 
+    // Write an index on close if the file supports one but it is missing or doesn't cover all entries.
+    if ((result == Result::Success)                              &&
+        m_haveWriteAccess                                        &&
+        (m_archiveHeader.minorVersion >= MinIndexedMinorVersion) &&
+        (m_indexHeaderOffset == 0)                               &&
+        (m_entries.IsEmpty() == false))
+    {
+        m_indexDirty = true;
+    }
+
     return result;
 }
 
@@ -517,13 +580,57 @@ Result ArchiveFile::Preload(
     {
         if (startLocation < m_fileSize)
         {
-            // Round up the page count division
-            const size_t readSize = Min((maxReadSize - startLocation), static_cast<size_t>(m_fileSize));
-            result                = ReadCached(startLocation, nullptr, readSize, false);
+            if (m_useAsyncIo)
+            {
+                // Queue no more than the buffer can hold at once, anything past that would only recycle pages queued
+                // earlier in this same call.
+                const size_t endOffset = Min(Min(startLocation + maxReadSize, static_cast<size_t>(m_fileSize)),
+                                             startLocation + (MaxPageCount * m_pageSize));
+
+                size_t curOffset = startLocation;
 
-            if (IsErrorResult(result))
+                while (curOffset < endOffset)
+                {
+                    FindPage(curOffset, true, false, true);
+                    curOffset = CalcNextPageBoundary(curOffset);
+                }
+
+                result = Result::Success;
+            }
+            else
             {
-                result = Result::ErrorUnknown;
+                // Round up the page count division
+                const size_t readSize = Min((maxReadSize - startLocation), static_cast<size_t>(m_fileSize));
+                result                = ReadCached(startLocation, nullptr, readSize, false);
+
+                if (IsErrorResult(result))
+                {
+                    result = Result::ErrorUnknown;
+                }
+            }
+        }
+        else
+        {
+            result = Result::ErrorInvalidValue;
+        }
+    }
+    else if (m_useMappedReads)
+    {
+        if (startLocation < m_curFooterOffset)
+        {
+            const size_t readSize = Min(maxReadSize, m_curFooterOffset - startLocation);
+            const void*  pData    = MapFileRange(startLocation, readSize);
+
+            if (pData != nullptr)
+            {
+                // Views always begin at the start of the file, so aligning the offset down aligns the address too.
+                const size_t alignedStart = Pow2AlignDown<size_t>(startLocation, sysconf(_SC_PAGE_SIZE));
+                void* const  pAligned     = const_cast<void*>(VoidPtrDec(pData, startLocation - alignedStart));
+
+                // This is only a hint to start paging the range in, the data is still read on first access otherwise.
+                madvise(pAligned, readSize + (startLocation - alignedStart), MADV_WILLNEED);
+
+                result = Result::Success;
             }
         }
         else
@@ -605,7 +712,24 @@ Result ArchiveFile::Read(
         if ((pHeader->ordinalId <= GetEntryCount()) &&
             ((pHeader->dataPosition + pHeader->dataSize) <= m_curFooterOffset))
         {
-            result = ReadInternal(pHeader->dataPosition, pDataBuffer, pHeader->dataSize, false);
+            const void* pMappedData = m_useMappedReads ? MapFileRange(pHeader->dataPosition, pHeader->dataSize)
+                                                       : nullptr;
+
+            if (pMappedData != nullptr)
+            {
+                memcpy(pDataBuffer, pMappedData, pHeader->dataSize);
+                result = Result::Success;
+            }
+            // Rather than reading the data a second time, let the caller decide whether to wait for the loader
+            else if (m_useAsyncIo &&
+                     IsRangeLoading(pHeader->dataPosition, pHeader->dataSize))
+            {
+                result = Result::NotReady;
+            }
+            else
+            {
+                result = ReadInternal(pHeader->dataPosition, pDataBuffer, pHeader->dataSize, false);
+            }
         }
         else
         {
@@ -632,6 +756,100 @@ Result ArchiveFile::Read(
     return result;
 }
 
+// =====================================================================================================================
+// Point at the value corresponding to the entry header passed in within our read-only mapping of the archive
+Result ArchiveFile::ReadMapped(
+    const ArchiveEntryHeader* pHeader,
+    const void**              ppData)
+{
+    PAL_ASSERT(pHeader != nullptr);
+    PAL_ASSERT(ppData != nullptr);
+
+    Result result = Result::ErrorUnknown;
+
+    if ((pHeader == nullptr) ||
+        (ppData == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (m_useMappedReads == false)
+    {
+        result = Result::Unsupported;
+    }
+    else
+    {
+        Result refreshResult = RefreshFile(false);
+
+        // We can still attempt to read from the file using our cached header
+        PAL_ALERT(IsErrorResult(refreshResult));
+
+        // Sanity check our arguments before attempting to map the data
+        if ((pHeader->ordinalId <= GetEntryCount()) &&
+            ((pHeader->dataPosition + pHeader->dataSize) <= m_curFooterOffset))
+        {
+            *ppData = MapFileRange(pHeader->dataPosition, pHeader->dataSize);
+            result  = (*ppData != nullptr) ? Result::Success : Result::ErrorUnknown;
+
+            PAL_ALERT(IsErrorResult(result));
+        }
+        else
+        {
+            result = Result::ErrorInvalidValue;
+        }
+    }
+
+    // Hold the mapped data to the same standard as data copied out by Read(). Entries are never rewritten, so the
+    // check is only made the first time each of our own entries is mapped.
+    if (result == Result::Success)
+    {
+        const uint32 ordinalId  = pHeader->ordinalId;
+        const bool   knownEntry = (ordinalId < m_entries.NumElements())                          &&
+                                  (m_entries.At(ordinalId).dataPosition == pHeader->dataPosition) &&
+                                  (m_entries.At(ordinalId).dataSize     == pHeader->dataSize)     &&
+                                  (m_entries.At(ordinalId).dataCrc64    == pHeader->dataCrc64);
+
+        if (knownEntry && (ordinalId < m_mappedVerified.NumElements()) && (m_mappedVerified.At(ordinalId) != 0))
+        {
+            // Already verified
+        }
+        else if (Crc64(*ppData, pHeader->dataSize) != pHeader->dataCrc64)
+        {
+            PAL_ALERT_ALWAYS();
+
+            *ppData = nullptr;
+            result  = Result::ErrorUnknown;
+        }
+        else if (knownEntry && ((ordinalId < m_mappedVerified.NumElements()) ||
+                                (m_mappedVerified.Resize(ordinalId + 1, 0) == Result::Success)))
+        {
+            m_mappedVerified.At(ordinalId) = 1;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Block until no part of an entry's data is still being loaded in the background
+Result ArchiveFile::WaitForData(
+    const ArchiveEntryHeader* pHeader)
+{
+    PAL_ASSERT(pHeader != nullptr);
+
+    Result result = Result::Success;
+
+    if (pHeader == nullptr)
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (m_useAsyncIo)
+    {
+        WaitForRange(pHeader->dataPosition, pHeader->dataSize);
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Write a header+data pair to the archive
 Result ArchiveFile::Write(
@@ -650,11 +868,15 @@ Result ArchiveFile::Write(
     }
     else if (m_haveWriteAccess)
     {
+        // While the entry index is the last entry in the file, new data takes over its place and ordinal. A new index
+        // will be written when the file is closed.
+        const bool replaceIndex = (m_indexHeaderOffset != 0);
+
         // cache off the write location
-        uint32 curOffset = m_curFooterOffset;
+        uint32 curOffset = replaceIndex ? m_indexHeaderOffset : m_curFooterOffset;
 
         FastMemCpy(pHeader->entryMarker, MagicEntryMarker, sizeof(MagicEntryMarker));
-        pHeader->ordinalId    = m_cachedFooter.entryCount;
+        pHeader->ordinalId    = replaceIndex ? (m_cachedFooter.entryCount - 1) : m_cachedFooter.entryCount;
         pHeader->nextBlock    = curOffset + sizeof(ArchiveEntryHeader) + pHeader->dataSize;
         pHeader->dataPosition = curOffset + sizeof(ArchiveEntryHeader);
         pHeader->dataCrc64    = Crc64(pData, pHeader->dataSize);
@@ -673,18 +895,41 @@ Result ArchiveFile::Write(
             memcpy(pOutFooter, &m_cachedFooter, sizeof(ArchiveFileFooter));
 
             // Correct the footer we're about to attempt to write
-            static_cast<ArchiveFileFooter*>(pOutFooter)->entryCount += 1;
+            if (replaceIndex == false)
+            {
+                static_cast<ArchiveFileFooter*>(pOutFooter)->entryCount += 1;
+            }
 
             result = WriteInternal(curOffset, pBuffer, writeSize);
 
+            // The replaced index may have been larger than what we just wrote, drop whatever is left of it.
+            if ((result == Result::Success) &&
+                replaceIndex                &&
+                (ftruncate(m_hFile, curOffset + writeSize) == InvalidSysCall))
+            {
+                PAL_ALERT_ALWAYS();
+                result = Result::ErrorUnknown;
+            }
+
             PAL_SAFE_FREE(pBuffer, Allocator());
             if (result == Result::Success)
             {
                 // Update our internal cache to reflect the result of the write
                 m_curFooterOffset = pHeader->nextBlock;
-                m_cachedFooter.entryCount += 1;
 
-                result = m_entries.PushBack(*pHeader);
+                if (replaceIndex)
+                {
+                    m_entries.Back()    = *pHeader;
+                    m_indexHeaderOffset = 0;
+                }
+                else
+                {
+                    m_cachedFooter.entryCount += 1;
+
+                    result = m_entries.PushBack(*pHeader);
+                }
+
+                m_indexDirty = (m_archiveHeader.minorVersion >= MinIndexedMinorVersion);
 
                 PAL_ALERT(IsErrorResult(result));
             }
@@ -771,6 +1016,15 @@ Result ArchiveFile::RefreshFile(
         }
     }
 
+    // The first time through, try to pick up all of the headers at once from the entry index
+    if ((result == Result::Success) &&
+        m_entries.IsEmpty()         &&
+        (m_cachedFooter.entryCount > 0))
+    {
+        // Failure is expected for files without an index, or when entries were appended after it by an older writer.
+        LoadIndex();
+    }
+
     // Repopulate our headers if we need to
     if (result == Result::Success)
     {
@@ -851,6 +1105,253 @@ Result ArchiveFile::ReadNextEntry(
     return result;
 }
 
+// =====================================================================================================================
+// Orders index records by entry key, for use with qsort()
+static int CompareIndexEntries(
+    const void* pLhs,
+    const void* pRhs)
+{
+    return memcmp(static_cast<const ArchiveIndexEntry*>(pLhs)->entryKey,
+                  static_cast<const ArchiveIndexEntry*>(pRhs)->entryKey,
+                  sizeof(ArchiveIndexEntry::entryKey));
+}
+
+// =====================================================================================================================
+// Attempt to populate our entry headers from the index stored at the end of the archive, using a single read. On any
+// failure the entry headers are left empty so that the caller falls back to walking the entry chain.
+Result ArchiveFile::LoadIndex()
+{
+    PAL_ASSERT(m_entries.IsEmpty());
+
+    Result             result      = Result::Unsupported;
+    ArchiveIndexFooter indexFooter = {};
+
+    if ((m_archiveHeader.minorVersion >= MinIndexedMinorVersion) &&
+        (m_curFooterOffset >= (m_archiveHeader.firstBlock + sizeof(ArchiveEntryHeader) + sizeof(indexFooter))))
+    {
+        result = ReadInternal(m_curFooterOffset - sizeof(indexFooter), &indexFooter, sizeof(indexFooter), false);
+    }
+
+    const uint32 indexCount = indexFooter.entryCount;
+    const uint64 dataSize   = (static_cast<uint64>(indexCount) * sizeof(ArchiveIndexEntry)) + sizeof(indexFooter);
+
+    // The index is only usable if it is the last entry of the archive and ends right in front of the footer.
+    if ((result == Result::Success) &&
+        ((memcmp(indexFooter.indexMarker, MagicIndexMarker, sizeof(MagicIndexMarker)) != 0) ||
+         ((static_cast<uint64>(indexCount) + 1) != m_cachedFooter.entryCount)               ||
+         (indexFooter.headerPosition < m_archiveHeader.firstBlock)                          ||
+         ((indexFooter.headerPosition + sizeof(ArchiveEntryHeader) + dataSize) != m_curFooterOffset)))
+    {
+        result = Result::ErrorInvalidValue;
+    }
+
+    void* pMem = nullptr;
+
+    if (result == Result::Success)
+    {
+        pMem = PAL_MALLOC(sizeof(ArchiveEntryHeader) + dataSize, Allocator(), AllocInternalTemp);
+
+        result = (pMem != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        result = ReadInternal(indexFooter.headerPosition, pMem, sizeof(ArchiveEntryHeader) + dataSize, false);
+    }
+
+    const ArchiveEntryHeader* const pIndexHeader = static_cast<const ArchiveEntryHeader*>(pMem);
+    const ArchiveIndexEntry* const  pRecords     =
+        static_cast<const ArchiveIndexEntry*>(VoidPtrInc(pMem, sizeof(ArchiveEntryHeader)));
+
+    if ((result == Result::Success) &&
+        ((memcmp(pIndexHeader->entryMarker, MagicEntryMarker, sizeof(MagicEntryMarker)) != 0)      ||
+         (pIndexHeader->dataType     != ArchiveIndexDataType)                                      ||
+         (pIndexHeader->ordinalId    != indexCount)                                                ||
+         (pIndexHeader->dataSize     != dataSize)                                                  ||
+         (pIndexHeader->dataPosition != (indexFooter.headerPosition + sizeof(ArchiveEntryHeader))) ||
+         (pIndexHeader->nextBlock    != m_curFooterOffset)                                         ||
+         (pIndexHeader->dataCrc64    != Crc64(pRecords, static_cast<size_t>(dataSize)))))
+    {
+        result = Result::ErrorInvalidValue;
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_index.Reserve(indexCount);
+    }
+
+    if (result == Result::Success)
+    {
+        // Headers are stored by ordinal, the index is sorted by key. Anything left with a zero entry marker after
+        // the loop below was not covered by the index.
+        result = m_entries.Resize(indexCount + 1, ArchiveEntryHeader{});
+    }
+
+    for (uint32 i = 0; (result == Result::Success) && (i < indexCount); ++i)
+    {
+        const ArchiveIndexEntry& record = pRecords[i];
+
+        if ((record.ordinalId >= indexCount)                                                        ||
+            (m_entries.At(record.ordinalId).entryMarker[0] != 0)                                    ||
+            ((static_cast<uint64>(record.dataPosition) + record.dataSize) > indexFooter.headerPosition) ||
+            ((i > 0) && (CompareIndexEntries(&pRecords[i - 1], &record) > 0)))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+        else
+        {
+            ExpandIndexEntry(record, &m_entries.At(record.ordinalId));
+
+            result = m_index.PushBack(record);
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        m_entries.Back()    = *pIndexHeader;
+        m_indexHeaderOffset = indexFooter.headerPosition;
+    }
+    else
+    {
+        m_entries.Clear();
+        m_index.Clear();
+    }
+
+    if (pMem != nullptr)
+    {
+        PAL_FREE(pMem, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Append an index covering every entry in the archive. Must only be called when the index isn't already the last entry.
+Result ArchiveFile::WriteIndex()
+{
+    PAL_ASSERT(m_indexHeaderOffset == 0);
+
+    // Every preceding entry is covered, including any stale index that is no longer the last entry, so that the
+    // headers can be rebuilt from the index alone.
+    const uint32 indexCount = m_entries.NumElements();
+    const size_t dataSize   = (indexCount * sizeof(ArchiveIndexEntry)) + sizeof(ArchiveIndexFooter);
+    void* const  pMem       = PAL_MALLOC(dataSize, Allocator(), AllocInternalTemp);
+
+    Result result = (pMem != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        ArchiveIndexEntry* const pRecords = static_cast<ArchiveIndexEntry*>(pMem);
+
+        for (uint32 i = 0; i < indexCount; ++i)
+        {
+            const ArchiveEntryHeader& header  = m_entries.At(i);
+            ArchiveIndexEntry* const  pRecord = &pRecords[i];
+
+            memcpy(pRecord->entryKey, header.entryKey, sizeof(pRecord->entryKey));
+            pRecord->ordinalId    = header.ordinalId;
+            pRecord->dataSize     = header.dataSize;
+            pRecord->dataPosition = header.dataPosition;
+            pRecord->dataCrc64    = header.dataCrc64;
+            pRecord->dataType     = header.dataType;
+            pRecord->metaValue    = header.metaValue;
+        }
+
+        qsort(pRecords, indexCount, sizeof(ArchiveIndexEntry), &CompareIndexEntries);
+
+        // Write() places the new entry at the current footer, so that's where our header ends up.
+        ArchiveIndexFooter* const pIndexFooter =
+            static_cast<ArchiveIndexFooter*>(VoidPtrInc(pMem, dataSize - sizeof(ArchiveIndexFooter)));
+        memcpy(pIndexFooter->indexMarker, MagicIndexMarker, sizeof(MagicIndexMarker));
+        pIndexFooter->entryCount     = indexCount;
+        pIndexFooter->headerPosition = m_curFooterOffset;
+
+        ArchiveEntryHeader header = {};
+        header.dataSize  = static_cast<uint32>(dataSize);
+        header.dataType  = ArchiveIndexDataType;
+        header.metaValue = static_cast<uint32>(dataSize);
+
+        result = Write(&header, pMem);
+
+        if (result == Result::Success)
+        {
+            m_indexHeaderOffset = pIndexFooter->headerPosition;
+            m_indexDirty        = false;
+        }
+
+        PAL_FREE(pMem, Allocator());
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Binary search the entry index for the given key
+Result ArchiveFile::FindIndexedEntry(
+    const uint8*        pEntryKey,
+    ArchiveEntryHeader* pHeader)
+{
+    PAL_ASSERT(pEntryKey != nullptr);
+    PAL_ASSERT(pHeader != nullptr);
+
+    Result result = Result::NotFound;
+
+    if ((pEntryKey == nullptr) ||
+        (pHeader == nullptr))
+    {
+        result = Result::ErrorInvalidPointer;
+    }
+    else if (m_index.IsEmpty())
+    {
+        result = Result::Unsupported;
+    }
+    else
+    {
+        uint32 low  = 0;
+        uint32 high = m_index.NumElements();
+
+        while (low < high)
+        {
+            const uint32 mid     = low + ((high - low) / 2);
+            const int    compare = memcmp(m_index.At(mid).entryKey, pEntryKey, sizeof(ArchiveIndexEntry::entryKey));
+
+            if (compare < 0)
+            {
+                low = mid + 1;
+            }
+            else if (compare > 0)
+            {
+                high = mid;
+            }
+            else
+            {
+                ExpandIndexEntry(m_index.At(mid), pHeader);
+                result = Result::Success;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Rebuild the entry header described by an index record
+void ArchiveFile::ExpandIndexEntry(
+    const ArchiveIndexEntry& record,
+    ArchiveEntryHeader*      pHeader)
+{
+    memcpy(pHeader->entryMarker, MagicEntryMarker, sizeof(MagicEntryMarker));
+    memcpy(pHeader->entryKey, record.entryKey, sizeof(pHeader->entryKey));
+    pHeader->ordinalId    = record.ordinalId;
+    pHeader->nextBlock    = record.dataPosition + record.dataSize;
+    pHeader->dataSize     = record.dataSize;
+    pHeader->dataPosition = record.dataPosition;
+    pHeader->dataCrc64    = record.dataCrc64;
+    pHeader->dataType     = record.dataType;
+    pHeader->metaValue    = record.metaValue;
+}
+
 // =====================================================================================================================
 // Select and call the appropriate read method for this file
 Result ArchiveFile::ReadInternal(
@@ -900,6 +1401,52 @@ Result ArchiveFile::WriteInternal(
     return result;
 }
 
+// =====================================================================================================================
+// Get a pointer to a range of the file within a read-only view, mapping a new view if the range isn't covered yet.
+// Returns nullptr if the range can't be mapped.
+const void* ArchiveFile::MapFileRange(
+    size_t fileOffset,
+    size_t size)
+{
+    PAL_ASSERT(m_useMappedReads == true);
+
+    const size_t endOffset = fileOffset + size;
+    FileView*    pView     = m_mappedViews.IsEmpty() ? nullptr : m_mappedViews.Back();
+
+    // Data handed out from older views must stay valid, so rather than remapping we add a view of the whole file.
+    // Every view starts at the beginning of the file which leaves the latest view covering all the others. Views are
+    // sized to the next power of two so a growing file only needs a logarithmic number of them; callers never ask
+    // for anything past the footer so the part of the view beyond the end of the file is never touched.
+    if ((pView == nullptr) ||
+        (pView->Size() < endOffset))
+    {
+        pView = PAL_NEW(FileView, Allocator(), AllocInternal);
+
+        if (pView != nullptr)
+        {
+            const size_t viewSize = Pow2Pad<size_t>(Max<size_t>(m_curFooterOffset, endOffset));
+
+            if ((pView->Map(m_fileMapping, false, 0, viewSize) == nullptr) ||
+                (m_mappedViews.PushBack(pView) != Result::Success))
+            {
+                pView->UnMap(false);
+                PAL_DELETE(pView, Allocator());
+                pView = nullptr;
+            }
+        }
+    }
+
+    const void* pData = nullptr;
+
+    if ((pView != nullptr) &&
+        (endOffset <= pView->Size()))
+    {
+        pData = VoidPtrInc(pView->Ptr(), fileOffset);
+    }
+
+    return pData;
+}
+
 // =====================================================================================================================
 // Copy data from cached memory pages
 Result ArchiveFile::ReadCached(
@@ -988,6 +1535,9 @@ Result ArchiveFile::WriteCached(
         // If we don't find our page in memory, that's okay our changes will be pulled in next time
         if (pPage != nullptr)
         {
+            // Don't let the loader overwrite our changes with what was on disk before
+            WaitForPage(pPage);
+
             void* const       pDst = pPage->Contains(curOffset);
             const void* const pSrc = VoidPtrInc(pData, curOffset - fileOffset);
             memcpy(pDst, pSrc, curEnd - curOffset);
@@ -1024,9 +1574,13 @@ Result ArchiveFile::InitPages()
 ArchiveFile::PageInfo* ArchiveFile::FindPage(
     size_t fileOffset,
     bool   loadOnMiss,
-    bool   forceReload)
+    bool   forceReload,
+    bool   queueLoad)   // Hand the load on a miss to the loader thread instead of reading the page right away
 {
+    PAL_ASSERT(m_useAsyncIo || (queueLoad == false));
+
     PageInfo* pFoundPage = nullptr;
+    Result    loadResult = Result::Success;
 
     // Find the existing page first.
     for (PageInfo::Iter i = m_recentList.Begin(); i.IsValid(); i.Next())
@@ -1060,7 +1614,9 @@ ArchiveFile::PageInfo* ArchiveFile::FindPage(
             {
                 m_pages[m_pageCount].Init(pMem, m_pageSize);
 
-                if (m_pages[m_pageCount].Load(m_hFile, pageBaseAddress, false) == Result::Success)
+                loadResult = m_pages[m_pageCount].Load(m_hFile, pageBaseAddress, queueLoad);
+
+                if (IsErrorResult(loadResult) == false)
                 {
                     pFoundPage   = &m_pages[m_pageCount];
                     m_pageCount += 1;
@@ -1077,7 +1633,13 @@ ArchiveFile::PageInfo* ArchiveFile::FindPage(
         if ((pFoundPage == nullptr) && (m_recentList.IsEmpty() != true))
         {
             PageInfo* pRecyclePage = m_recentList.Back();
-            if (pRecyclePage->Load(m_hFile, pageBaseAddress, false) == Result::Success)
+
+            // The loader may still be writing into the page
+            WaitForPage(pRecyclePage);
+
+            loadResult = pRecyclePage->Load(m_hFile, pageBaseAddress, queueLoad);
+
+            if (IsErrorResult(loadResult) == false)
             {
                 pFoundPage = pRecyclePage;
             }
@@ -1098,11 +1660,194 @@ ArchiveFile::PageInfo* ArchiveFile::FindPage(
         }
 
         m_recentList.PushFront(pNode);
+
+        // A page we just started loading is waiting on the loader
+        if (loadResult == Result::NotReady)
+        {
+            QueuePageLoad(pFoundPage);
+        }
     }
 
     return pFoundPage;
 }
 
+// =====================================================================================================================
+// Check whether any part of a file range is still being loaded by the loader thread
+bool ArchiveFile::IsRangeLoading(
+    size_t fileOffset,
+    size_t size)
+{
+    PAL_ASSERT(m_useAsyncIo == true);
+
+    bool         isLoading = false;
+    const size_t endOffset = fileOffset + size;
+
+    for (size_t curOffset = fileOffset; curOffset < endOffset; curOffset = CalcNextPageBoundary(curOffset))
+    {
+        const PageInfo* const pPage = FindPage(curOffset, false, false);
+
+        if ((pPage != nullptr) &&
+            (pPage->IsLoaded() == false))
+        {
+            isLoading = true;
+            break;
+        }
+    }
+
+    return isLoading;
+}
+
+// =====================================================================================================================
+// Wait for the loader thread to finish every page covering a file range. This only looks at the load queue, never at
+// the page list, so it doesn't need the caller's serialization and can block without holding up other archive calls.
+void ArchiveFile::WaitForRange(
+    size_t fileOffset,
+    size_t size)
+{
+    PAL_ASSERT(m_useAsyncIo == true);
+
+    MutexAuto lock { &m_loaderMutex };
+
+    while (IsRangeQueued(fileOffset, size))
+    {
+        m_pageLoaded.Wait(&m_loaderMutex, UINT32_MAX);
+    }
+}
+
+// =====================================================================================================================
+// Check if a page queued for or being read by the loader thread overlaps a file range. The caller must hold
+// m_loaderMutex, which keeps the location of those pages from changing.
+bool ArchiveFile::IsRangeQueued(
+    size_t fileOffset,
+    size_t size
+    ) const
+{
+    bool queued = (m_pLoadingPage != nullptr) && m_pLoadingPage->Overlaps(fileOffset, size);
+
+    for (uint32 idx = 0; (idx < m_loadQueueCount) && (queued == false); ++idx)
+    {
+        queued = m_loadQueue[(m_loadQueueHead + idx) % MaxPageCount]->Overlaps(fileOffset, size);
+    }
+
+    return queued;
+}
+
+// =====================================================================================================================
+// Start the thread which streams queued pages in from the file
+Result ArchiveFile::InitLoader()
+{
+    Result result = m_loaderMutex.Init();
+
+    if (result == Result::Success)
+    {
+        result = m_pageLoaded.Init();
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_loaderSemaphore.Init(MaxPageCount + 1, 0);
+    }
+
+    if (result == Result::Success)
+    {
+        result = m_loaderThread.Begin(&LoaderThreadCallback, this);
+    }
+
+    m_useAsyncIo = (result == Result::Success);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Hand a page which Load() has marked as pending over to the loader thread
+void ArchiveFile::QueuePageLoad(
+    PageInfo* pPage)
+{
+    PAL_ASSERT(m_useAsyncIo == true);
+    PAL_ASSERT(pPage->IsLoaded() == false);
+
+    m_loaderMutex.Lock();
+
+    // A page is only ever queued once at a time so there's always room for all of them
+    PAL_ASSERT(m_loadQueueCount < MaxPageCount);
+
+    m_loadQueue[(m_loadQueueHead + m_loadQueueCount) % MaxPageCount] = pPage;
+    m_loadQueueCount += 1;
+
+    m_loaderMutex.Unlock();
+
+    // Post after we unlock the mutex to prevent the loader thread from blocking if it wakes up too quickly.
+    m_loaderSemaphore.Post();
+}
+
+// =====================================================================================================================
+// Block until the loader thread is done with a page. Returns immediately for pages that aren't pending.
+void ArchiveFile::WaitForPage(
+    PageInfo* pPage)
+{
+    if (pPage->IsLoaded() == false)
+    {
+        MutexAuto lock { &m_loaderMutex };
+
+        while (pPage->IsLoaded() == false)
+        {
+            m_pageLoaded.Wait(&m_loaderMutex, UINT32_MAX);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Callback for executing the archive file's loader thread.
+void ArchiveFile::LoaderThreadCallback(
+    void* pParameter)   // Opaque pointer to an ArchiveFile object
+{
+    static_cast<ArchiveFile*>(pParameter)->RunLoaderThread();
+}
+
+// =====================================================================================================================
+// Executes the background thread which loads queued pages. The loader only ever touches pages that are pending, the
+// page list and everything else belongs to the thread(s) calling into the archive.
+void ArchiveFile::RunLoaderThread()
+{
+    while (true)
+    {
+        // Sleep until we have a page to load.
+        const Result result = m_loaderSemaphore.Wait(UINT32_MAX);
+        PAL_ASSERT(IsErrorResult(result) == false);
+
+        if (result == Result::Success)
+        {
+            PageInfo* pPage = nullptr;
+
+            m_loaderMutex.Lock();
+
+            if (m_loadQueueCount > 0)
+            {
+                pPage             = m_loadQueue[m_loadQueueHead];
+                m_loadQueueHead   = (m_loadQueueHead + 1) % MaxPageCount;
+                m_loadQueueCount -= 1;
+                m_pLoadingPage    = pPage;
+            }
+
+            m_loaderMutex.Unlock();
+
+            // We get posted without a page when the archive is closing.
+            if (pPage == nullptr)
+            {
+                break;
+            }
+
+            pPage->LoadPending(m_hFile);
+
+            m_loaderMutex.Lock();
+            m_pLoadingPage = nullptr;
+            pPage->MarkLoaded();
+            m_pageLoaded.WakeAll();
+            m_loaderMutex.Unlock();
+        }
+    }
+}
+
 // =====================================================================================================================
 // Determin an a given offset is inside out page and return a pointer to the backing memory
 void* ArchiveFile::PageInfo::Contains(
@@ -1113,7 +1858,8 @@ void* ArchiveFile::PageInfo::Contains(
     const size_t endOffset = m_beginOffset + m_memSize;
     void*        pMem      = nullptr;
 
-    if ((offset >= m_beginOffset) &&
+    if ((m_loadFailed == 0)       &&
+        (offset >= m_beginOffset) &&
         (offset < endOffset))
     {
         pMem = VoidPtrInc(m_pMem, offset - m_beginOffset);
@@ -1129,9 +1875,47 @@ Result ArchiveFile::PageInfo::Load(
     size_t fileOffset,
     bool   useAsyncIo)
 {
+    PAL_ASSERT(IsLoaded());
+
+    Result result = Result::NotReady;
+
     m_beginOffset = fileOffset;
+    AtomicExchange(&m_loadFailed, 0);
+
+    // The caller is responsible for queuing the page for the loader thread which will call LoadPending()
+    if (useAsyncIo)
+    {
+        m_loadPending = 1;
+    }
+    else
+    {
+        result = ReadDirect(hFile, fileOffset, m_pMem, m_memSize);
+        AtomicExchange(&m_loadFailed, (result != Result::Success) ? 1 : 0);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Pull in a page queued by Load() on the loader thread
+void ArchiveFile::PageInfo::LoadPending(
+    int32 hFile)
+{
+    PAL_ASSERT(IsLoaded() == false);
+
+    const Result result = ReadDirect(hFile, m_beginOffset, m_pMem, m_memSize);
+    AtomicExchange(&m_loadFailed, (result != Result::Success) ? 1 : 0);
+}
+
+// =====================================================================================================================
+// Hand a page read by LoadPending() back to the other threads. The loader must hold its mutex, so that IsRangeQueued()
+// never sees the page change location while it still counts as being loaded.
+void ArchiveFile::PageInfo::MarkLoaded()
+{
+    PAL_ASSERT(IsLoaded() == false);
 
-    return ReadDirect(hFile, fileOffset, m_pMem, m_memSize);
+    // This must be the last thing we touch, the page belongs to the other threads again once it reads as loaded.
+    AtomicExchange(&m_loadPending, 0);
 }
 
 // =====================================================================================================================
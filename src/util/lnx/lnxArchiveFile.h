@@ -24,8 +24,13 @@
  **********************************************************************************************************************/
 #include "palArchiveFile.h"
 #include "palArchiveFileFmt.h"
+#include "palFileMap.h"
 #include "palIntrusiveList.h"
 #include "palLinearAllocator.h"
+#include "palConditionVariable.h"
+#include "palMutex.h"
+#include "palSemaphore.h"
+#include "palThread.h"
 #include "palVector.h"
 
 namespace Util
@@ -71,6 +76,21 @@ public:
         ArchiveEntryHeader* pHeader,
         const void*         pData) override;
 
+    virtual Result ReadMapped(
+        const ArchiveEntryHeader*   pHeader,
+        const void**                ppData) override;
+
+    virtual Result WaitForData(
+        const ArchiveEntryHeader*   pHeader) override;
+
+    virtual uint32 GetMinorVersion() const override { return m_archiveHeader.minorVersion; }
+
+    virtual size_t GetIndexedEntryCount() const override { return m_index.NumElements(); }
+
+    virtual Result FindIndexedEntry(
+        const uint8*        pEntryKey,
+        ArchiveEntryHeader* pHeader) override;
+
     virtual void   Destroy() override { this->~ArchiveFile(); }
 
 private:
@@ -90,6 +110,8 @@ private:
             m_beginOffset   { 0 },
             m_pMem          { nullptr },
             m_memSize       { 0 },
+            m_loadPending   { 0 },
+            m_loadFailed    { 0 },
             m_node          { this }
             {}
         void Init(void* pMem, size_t memSize) { m_pMem = pMem; m_memSize = memSize; }
@@ -100,8 +122,11 @@ private:
         // I/O Control
         Result Load(int32 fd, size_t fileOffset, bool useAsyncIo);
         Result Reload(int32 fd, bool useAsyncIo) { return Load(fd, m_beginOffset, useAsyncIo); }
-        bool   IsLoaded() { return true; }
-        void   Wait() {}
+        void   LoadPending(int32 fd);
+        void   MarkLoaded();
+        bool   IsLoaded() const { return (m_loadPending == 0); }
+        bool   Overlaps(size_t offset, size_t size) const
+            { return (offset < (m_beginOffset + m_memSize)) && (m_beginOffset < (offset + size)); }
 
         // LRU list node
         Node* ListNode() { return &m_node; }
@@ -109,26 +134,48 @@ private:
     private:
         PAL_DISALLOW_COPY_AND_ASSIGN(PageInfo);
 
-        size_t       m_beginOffset; // Location in file where page begins
-        void*        m_pMem;        // Memory backing this page
-        size_t       m_memSize;     // Size of memory page
-        Node         m_node;        // Page's position in an LRU chain
+        size_t          m_beginOffset; // Location in file where page begins
+        void*           m_pMem;        // Memory backing this page
+        size_t          m_memSize;     // Size of memory page
+        volatile uint32 m_loadPending; // Non-zero while the page is queued for or being read by the loader thread
+        volatile uint32 m_loadFailed;  // The last load failed, the page holds nothing useful until it is reused.
+                                       // Written by the loader thread, so it is accessed atomically like m_loadPending
+        Node            m_node;        // Page's position in an LRU chain
     };
 
     Result RefreshFile(bool forceRefresh);
 
     Result ReadNextEntry(const ArchiveEntryHeader* pCurheader, ArchiveEntryHeader* pNextHeader);
 
+    // Entry index
+    Result LoadIndex();
+    Result WriteIndex();
+
+    static void ExpandIndexEntry(const ArchiveIndexEntry& record, ArchiveEntryHeader* pHeader);
+
     Result ReadInternal(size_t fileOffset, void* pBuffer, size_t readSize, bool forceCacheReload);
     Result WriteInternal(size_t fileOffset, const void* pData, size_t writeSize);
 
+    // Memory mapped I/O
+    const void* MapFileRange(size_t fileOffset, size_t size);
+
     // "Cached" I/O API
     Result ReadCached(size_t fileOffset, void* pBuffer, size_t readSize, bool forceReload);
     Result WriteCached(size_t fileOffset, const void* pData, size_t writeSize);
 
     // Page management
     Result    InitPages();
-    PageInfo* FindPage(size_t fileOffset, bool loadOnMiss, bool forceReload);
+    PageInfo* FindPage(size_t fileOffset, bool loadOnMiss, bool forceReload, bool queueLoad = false);
+    bool      IsRangeLoading(size_t fileOffset, size_t size);
+    void      WaitForRange(size_t fileOffset, size_t size);
+
+    // Background page loader
+    Result      InitLoader();
+    void        QueuePageLoad(PageInfo* pPage);
+    void        WaitForPage(PageInfo* pPage);
+    bool        IsRangeQueued(size_t fileOffset, size_t size) const;
+    static void LoaderThreadCallback(void* pParameter);
+    void        RunLoaderThread();
     int32     CalcPageIndex(size_t fileOffset) const        { return static_cast<int32>(fileOffset / m_pageSize); }
     size_t    CalcNextPageBoundary(size_t fileOffset) const { return (CalcPageIndex(fileOffset) + 1) * m_pageSize; }
 
@@ -138,6 +185,9 @@ private:
     static constexpr size_t MinPageSize  = 256 * 1024;
 
     using EntryVector = Vector<ArchiveEntryHeader, 16, ForwardAllocator>;
+    using IndexVector = Vector<ArchiveIndexEntry, 16, ForwardAllocator>;
+    using ViewVector  = Vector<FileView*, 4, ForwardAllocator>;
+    using FlagVector  = Vector<uint8, 16, ForwardAllocator>;
 
     // Allocator
     ForwardAllocator*       Allocator() { return &m_allocator; }
@@ -151,9 +201,21 @@ private:
     uint32                  m_curFooterOffset;
     EntryVector             m_entries;
 
+    // Entry index
+    IndexVector             m_index;             // Sorted entry index read from the file, may be empty. Never
+                                                 // changes once loaded, so lookups need no lock.
+    uint32                  m_indexHeaderOffset; // Location of the index entry while it is the last entry, else zero
+    bool                    m_indexDirty;        // Entries exist which are not covered by the index on disk
+
     // Write components: MAY NOT BE INITIALIZED IF WE DON'T HAVE WRITE ACCESS
     const bool              m_haveWriteAccess;
 
+    // Read-only file mapping: MAY NOT BE INITIALIZED IF WE AREN'T USING MAPPED READS
+    bool                    m_useMappedReads;
+    FileMapping             m_fileMapping;
+    ViewVector              m_mappedViews;       // Views are only ever added so handed out pointers stay valid
+    FlagVector              m_mappedVerified;    // Non-zero for each ordinal ID whose mapped data passed its CRC check
+
     // Internal memory buffer: MAY NOT BE INITIALIZED IF WE AREN'T USING A MEMORY BUFFER
     bool                    m_useBufferedMemory;
     VirtualLinearAllocator  m_bufferMemory;
@@ -161,6 +223,17 @@ private:
     PageInfo                m_pages[MaxPageCount];
     size_t                  m_pageCount;
     size_t                  m_pageSize;
+
+    // Background page loader: MAY NOT BE INITIALIZED IF WE AREN'T USING ASYNC FILE IO
+    bool                    m_useAsyncIo;
+    Thread                  m_loaderThread;
+    Semaphore               m_loaderSemaphore;   // Posted once per queued page, and once more to stop the loader
+    Mutex                   m_loaderMutex;       // Protects the load queue and waits on page loads
+    ConditionVariable       m_pageLoaded;        // Signaled whenever the loader finishes a page
+    PageInfo*               m_loadQueue[MaxPageCount];
+    uint32                  m_loadQueueHead;
+    uint32                  m_loadQueueCount;
+    PageInfo*               m_pLoadingPage;      // The page the loader thread is reading, protected by m_loaderMutex
 };
 
 } //namespace Util
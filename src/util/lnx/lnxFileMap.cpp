@@ -77,7 +77,8 @@ Result FileMapping::Create(
 
     if (m_fileHandle != -1)
     {
-        if (ftruncate(m_fileHandle, maximumSize) == 0)
+        // A read-only mapping views the file as it is, there's no way to resize it.
+        if ((allowWrite == false) || (ftruncate(m_fileHandle, maximumSize) == 0))
         {
             result = Result::Success;
         }
@@ -109,6 +110,7 @@ void FileMapping::Close()
     if (IsValid())
     {
         close(m_fileHandle);
+        m_fileHandle = InvalidFd;
     }
 }
 
@@ -143,9 +145,11 @@ void* FileView::Map(
     // offset should be aligned to page
     const int pageSize = sysconf(_SC_PAGE_SIZE);
     m_offestIntoView = offset - offset / pageSize * pageSize;
-    m_requestedSize = (size + m_offestIntoView - 1);
+    m_requestedSize = (size + m_offestIntoView);
 
-    m_pMappedMem = mmap(nullptr, m_requestedSize, PROT_READ|PROT_WRITE, MAP_SHARED,
+    const int prot = writeAccess ? (PROT_READ | PROT_WRITE) : PROT_READ;
+
+    m_pMappedMem = mmap(nullptr, m_requestedSize, prot, MAP_SHARED,
                         mappedFile.GetHandle(), offset / pageSize * pageSize );
     if (m_pMappedMem == MAP_FAILED)
     {
@@ -32,39 +32,76 @@
 namespace Util
 {
 
+// Total number of lookup buckets, divided among the shards.
+static constexpr uint32 TotalLookupBuckets = 2048;
+// Minimum number of lookup buckets in each shard.
+static constexpr uint32 MinShardLookupBuckets = 64;
+// Upper bound on the number of shards; beyond this the per-shard lookup tables become too small to be useful.
+static constexpr uint32 MaxNumShards = 256;
+
 // =====================================================================================================================
 MemoryCacheLayer::MemoryCacheLayer(
     const AllocCallbacks& callbacks,
     size_t                maxMemorySize,
     size_t                maxObjectCount,
     bool                  evictOnFull,
-    bool                  evictDuplicates)
+    bool                  evictDuplicates,
+    uint32                numShards)
     :
     CacheLayerBase    { callbacks },
     m_maxSize         { maxMemorySize },
     m_maxCount        { maxObjectCount },
     m_evictOnFull     { evictOnFull },
     m_evictDuplicates { evictDuplicates },
-    m_lock            {},
+    m_numShards       { ClampNumShards(numShards) },
+    m_clockLru        { m_numShards > 1 },
     m_curSize         { 0 },
     m_curCount        { 0 },
-    m_recentEntryList {},
-    m_entryLookup     { 2048, Allocator() }
+    m_pShards         { reinterpret_cast<Shard*>(this + 1) }
 {
+    const uint32 numBuckets = Max(TotalLookupBuckets / m_numShards, MinShardLookupBuckets);
+
+    for (uint32 i = 0; i < m_numShards; ++i)
+    {
+        PAL_PLACEMENT_NEW(&m_pShards[i]) Shard(numBuckets, Allocator());
+    }
 }
 
 // =====================================================================================================================
 MemoryCacheLayer::~MemoryCacheLayer()
 {
-    while (m_recentEntryList.IsEmpty() == false)
+    for (uint32 i = 0; i < m_numShards; ++i)
     {
-        Entry* pEntry = m_recentEntryList.Front();
-        m_entryLookup.Erase(*pEntry->HashId());
-        m_recentEntryList.Erase(pEntry->ListNode());
-        pEntry->Destroy();
+        Shard* const pShard = &m_pShards[i];
+
+        while (pShard->recentEntryList.IsEmpty() == false)
+        {
+            Entry* pEntry = pShard->recentEntryList.Front();
+            pShard->entryLookup.Erase(*pEntry->HashId());
+            pShard->recentEntryList.Erase(pEntry->ListNode());
+            pEntry->Destroy();
+        }
+
+        pShard->~Shard();
     }
 }
 
+// =====================================================================================================================
+// Returns the number of shards actually used for the requested shard count.
+uint32 MemoryCacheLayer::ClampNumShards(
+    uint32 numShards)
+{
+    return Pow2Pad(Min(Max(numShards, 1u), MaxNumShards));
+}
+
+// =====================================================================================================================
+// Returns the placement size of a cache layer split into the given number of shards.
+size_t MemoryCacheLayer::GetSize(
+    uint32 numShards)
+{
+    return sizeof(MemoryCacheLayer) + (ClampNumShards(numShards) * sizeof(Shard));
+}
+
 // =====================================================================================================================
 // Initialize the cache layer
 Result MemoryCacheLayer::Init()
@@ -81,14 +118,14 @@ Result MemoryCacheLayer::Init()
         result = m_conditionVariable.Init();
     }
 
-    if (result == Result::Success)
+    for (uint32 i = 0; (result == Result::Success) && (i < m_numShards); ++i)
     {
-        result = m_lock.Init();
-    }
+        result = m_pShards[i].lock.Init();
 
-    if (result == Result::Success)
-    {
-        result = m_entryLookup.Init();
+        if (result == Result::Success)
+        {
+            result = m_pShards[i].entryLookup.Init();
+        }
     }
 
     return result;
@@ -104,9 +141,19 @@ Result MemoryCacheLayer::QueryInternal(
 
     Entry** ppFound = nullptr;
 
-    RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+    Shard* const pShard = GetShard(*pHashId);
+
+    if (m_clockLru)
+    {
+        // A hit only sets the entry's reference bit, so a shared lock is sufficient.
+        pShard->lock.LockForRead();
+    }
+    else
+    {
+        pShard->lock.LockForWrite();
+    }
 
-    ppFound = m_entryLookup.FindKey(*pHashId);
+    ppFound = pShard->entryLookup.FindKey(*pHashId);
 
     if (ppFound == nullptr)
     {
@@ -114,9 +161,16 @@ Result MemoryCacheLayer::QueryInternal(
     }
     else if (*ppFound != nullptr)
     {
-        Entry::Node* pNode = (*ppFound)->ListNode();
-        m_recentEntryList.Erase(pNode);
-        m_recentEntryList.PushBack(pNode);
+        if (m_clockLru)
+        {
+            (*ppFound)->MarkReferenced();
+        }
+        else
+        {
+            Entry::Node* pNode = (*ppFound)->ListNode();
+            pShard->recentEntryList.Erase(pNode);
+            pShard->recentEntryList.PushBack(pNode);
+        }
 
         pQuery->hashId             = *pHashId;
         pQuery->pLayer             = this;
@@ -132,6 +186,15 @@ Result MemoryCacheLayer::QueryInternal(
         result = Result::ErrorUnknown;
     }
 
+    if (m_clockLru)
+    {
+        pShard->lock.UnlockForRead();
+    }
+    else
+    {
+        pShard->lock.UnlockForWrite();
+    }
+
     return result;
 }
 
@@ -155,14 +218,16 @@ Result MemoryCacheLayer::StoreInternal(
         result = Result::ErrorInvalidValue;
     }
 
+    Shard* const pShard = (result == Result::Success) ? GetShard(*pHashId) : nullptr;
+
     bool setData = false;
     if (result == Result::Success)
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+        RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
 
         if (ppFound != nullptr)
         {
@@ -170,7 +235,7 @@ Result MemoryCacheLayer::StoreInternal(
             {
                 if ((*ppFound)->Data() == nullptr)
                 {
-                    result = SetDataToEntry(*ppFound, pData, dataSize);
+                    result = SetDataToEntry(pShard, *ppFound, pData, dataSize);
                     if (result == Result::Success)
                     {
                         setData = true;
@@ -179,7 +244,7 @@ Result MemoryCacheLayer::StoreInternal(
                 }
                 else if (m_evictDuplicates)
                 {
-                    result = EvictEntryFromCache(*ppFound);
+                    result = EvictEntryFromCache(pShard, *ppFound);
                 }
                 else
                 {
@@ -195,9 +260,7 @@ Result MemoryCacheLayer::StoreInternal(
 
     if ((result == Result::Success) && (setData == false))
     {
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
-
-        result = EnsureAvailableSpace(dataSize, 1);
+        result = EnsureAvailableSpace(pShard, dataSize, 1);
     }
 
     if ((result == Result::Success) && (setData == false))
@@ -206,9 +269,9 @@ Result MemoryCacheLayer::StoreInternal(
 
         if (pEntry != nullptr)
         {
-            RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+            RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-            result = AddEntryToCache(pEntry);
+            result = AddEntryToCache(pShard, pEntry);
 
             if (result != Result::Success)
             {
@@ -242,9 +305,11 @@ Result MemoryCacheLayer::LoadInternal(
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        Shard* const pShard = GetShard(pQuery->hashId);
+
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
         if (ppFound != nullptr)
         {
             if ((*ppFound)->Data())
@@ -280,9 +345,11 @@ Result MemoryCacheLayer::AcquireCacheRef(
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        Shard* const pShard = GetShard(pQuery->hashId);
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
+
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
         if (ppFound != nullptr)
         {
             (*ppFound)->IncreaseRef();
@@ -309,23 +376,31 @@ Result MemoryCacheLayer::ReleaseCacheRef(
     else
     {
         Entry** ppFound = nullptr;
+        bool    isBad   = false;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        Shard* const pShard = GetShard(pQuery->hashId);
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
-        if (ppFound != nullptr)
         {
-            (*ppFound)->DecreaseRef();
-            if ((*ppFound)->IsBad())
+            RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
+
+            ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
+            if (ppFound != nullptr)
             {
-                Evict(&pQuery->hashId);
+                (*ppFound)->DecreaseRef();
+                isBad = (*ppFound)->IsBad();
+            }
+            else
+            {
+                PAL_ASSERT_ALWAYS();
+                // This should never happen, ReleaseCacheRef is after AcquireCacheRef.
+                result = Result::NotFound;
             }
         }
-        else
+
+        // Evict() needs exclusive access to the shard, so it must be called after the shared lock is dropped.
+        if (isBad)
         {
-            PAL_ASSERT_ALWAYS();
-            // This should never happen, ReleaseCacheRef is after AcquireCacheRef.
-            result = Result::NotFound;
+            Evict(&pQuery->hashId);
         }
     }
 
@@ -347,9 +422,11 @@ Result MemoryCacheLayer::GetCacheData(
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        Shard* const pShard = GetShard(pQuery->hashId);
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
+
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
         if (ppFound != nullptr)
         {
             if ((*ppFound)->Data())
@@ -387,12 +464,14 @@ Result MemoryCacheLayer::WaitForEntry(
     {
         Entry** ppFound = nullptr;
 
+        Shard* const pShard = GetShard(*pHashId);
+
         m_conditionMutex.Lock();
         for (;;)
         {
             {
-                RWLockAuto<RWLock::ReadOnly> lock{ &m_lock };
-                ppFound = m_entryLookup.FindKey(*pHashId);
+                RWLockAuto<RWLock::ReadOnly> lock{ &pShard->lock };
+                ppFound = pShard->entryLookup.FindKey(*pHashId);
                 if (ppFound == nullptr)
                 {
                     result = Result::NotFound;
@@ -432,11 +511,13 @@ Result MemoryCacheLayer::Evict(
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        Shard* const pShard = GetShard(*pHashId);
+
+        RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
         if (ppFound != nullptr)
         {
-            result = EvictEntryFromCache(*ppFound);
+            result = EvictEntryFromCache(pShard, *ppFound);
         }
         else
         {
@@ -462,8 +543,10 @@ Result MemoryCacheLayer::MarkEntryBad(
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        Shard* const pShard = GetShard(*pHashId);
+
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
         if (ppFound != nullptr)
         {
             (*ppFound)->SetIsBad(true);
@@ -480,74 +563,69 @@ Result MemoryCacheLayer::MarkEntryBad(
 }
 
 // =====================================================================================================================
-// Evict entries until a specified count is reached
-Result MemoryCacheLayer::EvictEntryByCount(
-    size_t numToEvict)
+// Select the next entry to be evicted from a shard. With clock LRU, entries that were hit since the last time the
+// eviction hand passed them are given a second chance and moved to the back of the list. The caller must hold the
+// shard's lock for write.
+MemoryCacheLayer::Entry* MemoryCacheLayer::GetEvictionCandidate(
+    Shard* pShard)
 {
-    Result result = Result::Success;
+    Entry* pEntry = pShard->recentEntryList.Front();
 
-    size_t numEvicted = 0;
-
-    while ((result == Result::Success) &&
-           (numEvicted < numToEvict))
+    if (m_clockLru)
     {
-        Entry* const pEntry = m_recentEntryList.Front();
-
-        if (pEntry != nullptr)
+        // After curCount rotations every reference bit has been cleared, so this always terminates.
+        for (size_t i = 0; (pEntry != nullptr) && (i < pShard->curCount) && pEntry->ClearReferenced(); ++i)
         {
-            result = EvictEntryFromCache(pEntry);
+            Entry::Node* pNode = pEntry->ListNode();
+            pShard->recentEntryList.Erase(pNode);
+            pShard->recentEntryList.PushBack(pNode);
 
-            if (result == Result::Success)
-            {
-                ++numEvicted;
-            }
-        }
-        else
-        {
-            result = Result::ErrorShaderCacheFull;
+            pEntry = pShard->recentEntryList.Front();
         }
     }
 
-    return result;
+    return pEntry;
 }
 
 // =====================================================================================================================
-// Evict entries until a specified size is reached
-Result MemoryCacheLayer::EvictEntryBySize(
-    size_t minSizeToEvict)
+// Returns true if the cache's size and count budgets have room for the given entries.
+bool MemoryCacheLayer::HasAvailableSpace(
+    size_t entrySize,
+    size_t entryCount) const
 {
-    Result result = Result::Success;
+    return ((m_curCount + entryCount) <= m_maxCount) && ((m_curSize + entrySize) <= m_maxSize);
+}
 
-    size_t evictedSize = 0;
+// =====================================================================================================================
+// Evict entries from a shard until the cache has room for the given entries or the shard runs out of entries which
+// can be evicted. Returns the number of entries evicted. The caller must hold the shard's lock for write.
+size_t MemoryCacheLayer::EvictEntriesFromShard(
+    Shard* pShard,
+    size_t entrySize,
+    size_t entryCount)
+{
+    size_t numEvicted = 0;
+    bool   canEvict   = true;
 
-    while ((result == Result::Success) &&
-           (evictedSize < minSizeToEvict))
+    while (canEvict && (HasAvailableSpace(entrySize, entryCount) == false))
     {
-        Entry* const pEntry = m_recentEntryList.Front();
-
-        if (pEntry != nullptr)
-        {
-            const size_t dataSize = pEntry->DataSize();
+        Entry* const pEntry = GetEvictionCandidate(pShard);
 
-            result = EvictEntryFromCache(pEntry);
+        canEvict = (pEntry != nullptr) && (EvictEntryFromCache(pShard, pEntry) == Result::Success);
 
-            if (result == Result::Success)
-            {
-                evictedSize += dataSize;
-            }
-        }
-        else
+        if (canEvict)
         {
-            result = Result::ErrorShaderCacheFull;
+            numEvicted++;
         }
     }
 
-    return result;
+    return numEvicted;
 }
 
 // =====================================================================================================================
 // Remove an entry from the cache table, list, and metrics.
 Result MemoryCacheLayer::EvictEntryFromCache(
+    Shard* pShard,
     Entry* pEntry)
 {
     PAL_ASSERT(pEntry != nullptr);
@@ -556,13 +634,16 @@ Result MemoryCacheLayer::EvictEntryFromCache(
 
     if (pEntry->CanEvict())
     {
-        if (m_entryLookup.Erase(*pEntry->HashId()))
+        if (pShard->entryLookup.Erase(*pEntry->HashId()))
         {
             result = Result::Success;
 
-            m_recentEntryList.Erase(pEntry->ListNode());
-            m_curSize -= pEntry->DataSize();
-            m_curCount -= 1;
+            pShard->recentEntryList.Erase(pEntry->ListNode());
+            pShard->curCount -= 1;
+
+            AtomicAdd64(&m_curSize, 0 - static_cast<uint64>(pEntry->DataSize()));
+            AtomicAdd64(&m_curCount, 0 - static_cast<uint64>(1));
+
             pEntry->Destroy();
         }
     }
@@ -573,17 +654,20 @@ Result MemoryCacheLayer::EvictEntryFromCache(
 // =====================================================================================================================
 // Insert the entry into our cache lookup table and LRU list
 Result MemoryCacheLayer::AddEntryToCache(
+    Shard* pShard,
     Entry* pEntry)
 {
     PAL_ASSERT(pEntry != nullptr);
 
-    Result result = m_entryLookup.Insert(*pEntry->HashId(), pEntry);
+    Result result = pShard->entryLookup.Insert(*pEntry->HashId(), pEntry);
 
     if (result == Result::Success)
     {
-        m_recentEntryList.PushBack(pEntry->ListNode());
-        m_curSize += pEntry->DataSize();
-        m_curCount++;
+        pShard->recentEntryList.PushBack(pEntry->ListNode());
+        pShard->curCount++;
+
+        AtomicAdd64(&m_curSize, pEntry->DataSize());
+        AtomicIncrement64(&m_curCount);
     }
 
     return result;
@@ -592,6 +676,7 @@ Result MemoryCacheLayer::AddEntryToCache(
 // =====================================================================================================================
 // Set data to Entry
 Result MemoryCacheLayer::SetDataToEntry(
+    Shard*      pShard,
     Entry*      pEntry,
     const void* pData,
     size_t      dataSize)
@@ -605,7 +690,7 @@ Result MemoryCacheLayer::SetDataToEntry(
 
         if (result == Result::Success)
         {
-            m_curSize += pEntry->DataSize();
+            AtomicAdd64(&m_curSize, pEntry->DataSize());
         }
     }
 
@@ -613,38 +698,36 @@ Result MemoryCacheLayer::SetDataToEntry(
 }
 
 // =====================================================================================================================
-// Ensure size requested is available within the cache, may evict data
+// Ensure size requested is available within the cache, may evict data. The size and count budgets are shared by all
+// shards, so entries are evicted from the entry's own shard first and then from the others. Only one shard's lock is
+// held at a time, so the caller must not hold any. Other threads may take the space freed by an eviction, so the
+// shards are swept until the entry fits or a full sweep finds nothing left to evict.
 Result MemoryCacheLayer::EnsureAvailableSpace(
+    Shard* pShard,
     size_t entrySize,
     size_t entryCount)
 {
-    PAL_ASSERT(entrySize <= m_maxSize);
-    PAL_ASSERT(entryCount <= m_maxCount);
-
-    Result result = Result::Success;
+    // An entry which can never fit would otherwise evict everything else trying to make room for it.
+    Result result = ((entrySize <= m_maxSize) && (entryCount <= m_maxCount)) ? Result::Success
+                                                                              : Result::ErrorShaderCacheFull;
 
-    const size_t availableCount = m_maxCount - m_curCount;
+    uint32 shardIdx   = static_cast<uint32>(pShard - m_pShards);
+    uint32 idleShards = 0;   // Consecutive shards which had nothing to evict
 
-    if (entryCount > availableCount)
+    while ((result == Result::Success) && (HasAvailableSpace(entrySize, entryCount) == false))
     {
-        result = Result::ErrorShaderCacheFull;
-
-        if (m_evictOnFull)
+        if (m_evictOnFull && (idleShards < m_numShards))
         {
-            result = EvictEntryByCount(entryCount - availableCount);
-        }
-    }
+            Shard* const pEvictShard = &m_pShards[shardIdx];
 
-    const size_t availableSize = m_maxSize - m_curSize;
-
-    if ((result == Result::Success) &&
-        (entrySize > availableSize))
-    {
-        result = Result::ErrorShaderCacheFull;
+            RWLockAuto<RWLock::ReadWrite> lock { &pEvictShard->lock };
 
-        if (m_evictOnFull)
+            idleShards = (EvictEntriesFromShard(pEvictShard, entrySize, entryCount) > 0) ? 0 : (idleShards + 1);
+            shardIdx   = (shardIdx + 1) & (m_numShards - 1);
+        }
+        else
         {
-            result = EvictEntryBySize(entrySize - availableSize);
+            result = Result::ErrorShaderCacheFull;
         }
     }
 
@@ -675,10 +758,12 @@ Result MemoryCacheLayer::PromoteData(
 
     Entry** ppFound = nullptr;
 
+    Shard* const pShard = GetShard(pQuery->hashId);
+
     {
-        RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+        RWLockAuto<RWLock::ReadOnly> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(pQuery->hashId);
+        ppFound = pShard->entryLookup.FindKey(pQuery->hashId);
     }
 
     if (ppFound != nullptr)
@@ -688,9 +773,7 @@ Result MemoryCacheLayer::PromoteData(
 
     if (result == Result::Success)
     {
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
-
-        result = EnsureAvailableSpace(pQuery->dataSize, 1);
+        result = EnsureAvailableSpace(pShard, pQuery->dataSize, 1);
     }
 
     if (result == Result::Success)
@@ -703,10 +786,9 @@ Result MemoryCacheLayer::PromoteData(
 
             if (result == Result::Success)
             {
-                RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+                RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-                result = AddEntryToCache(pEntry);
-                m_entryLookup.Insert(pQuery->hashId, pEntry);
+                result = AddEntryToCache(pShard, pEntry);
             }
 
             if (result == Result::Success)
@@ -743,13 +825,15 @@ Result MemoryCacheLayer::Reserve(
         result = Result::ErrorInvalidPointer;
     }
 
+    Shard* const pShard = (result == Result::Success) ? GetShard(*pHashId) : nullptr;
+
     if (result == Result::Success)
     {
         Entry** ppFound = nullptr;
 
-        RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
+        RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
 
-        ppFound = m_entryLookup.FindKey(*pHashId);
+        ppFound = pShard->entryLookup.FindKey(*pHashId);
         if (ppFound != nullptr)
         {
             if (*ppFound != nullptr)
@@ -768,8 +852,8 @@ Result MemoryCacheLayer::Reserve(
         Entry* pEntry = Entry::Create(Allocator(), pHashId, nullptr, 0);
         if (pEntry != nullptr)
         {
-            RWLockAuto<RWLock::ReadWrite> lock { &m_lock };
-            result = AddEntryToCache(pEntry);
+            RWLockAuto<RWLock::ReadWrite> lock { &pShard->lock };
+            result = AddEntryToCache(pShard, pEntry);
             if (result != Result::Success)
             {
                 pEntry->Destroy();
@@ -790,7 +874,7 @@ Result MemoryCacheLayer::Reserve(
 size_t GetMemoryCacheLayerSize(
     const MemoryCacheCreateInfo* pCreateInfo)
 {
-    return sizeof(MemoryCacheLayer);
+    return MemoryCacheLayer::GetSize((pCreateInfo != nullptr) ? pCreateInfo->numShards : 1);
 }
 
 // =====================================================================================================================
@@ -827,7 +911,8 @@ Result CreateMemoryCacheLayer(
             pCreateInfo->maxMemorySize,
             pCreateInfo->maxObjectCount,
             pCreateInfo->evictOnFull,
-            pCreateInfo->evictDuplicates);
+            pCreateInfo->evictDuplicates,
+            pCreateInfo->numShards);
 
         result = pLayer->Init();
 
@@ -862,17 +947,31 @@ Result MemoryCacheLayer::GetMemoryCacheHashIds(
 {
     Result result = Result::Success;
 
-    RWLockAuto<RWLock::ReadOnly> lock { &m_lock };
+    // Hold every shard's lock (always in index order) so the entry count can't change while we copy.
+    for (uint32 i = 0; i < m_numShards; ++i)
+    {
+        m_pShards[i].lock.LockForRead();
+    }
+
+    size_t totalCount = 0;
+    for (uint32 i = 0; i < m_numShards; ++i)
+    {
+        totalCount += m_pShards[i].curCount;
+    }
+
     // Iterate through all Entries and copy their hash ID to pHashIds array.
-    if (curCount == m_curCount)
+    if (curCount == totalCount)
     {
         uint32 i = 0;
 
-        for (auto iter = m_recentEntryList.Begin(); iter.IsValid(); iter.Next())
+        for (uint32 shard = 0; shard < m_numShards; ++shard)
         {
-            Entry* pEntry = iter.Get();
+            for (auto iter = m_pShards[shard].recentEntryList.Begin(); iter.IsValid(); iter.Next())
+            {
+                Entry* pEntry = iter.Get();
 
-            pHashIds[i++] = *pEntry->HashId();
+                pHashIds[i++] = *pEntry->HashId();
+            }
         }
     }
     else
@@ -880,6 +979,11 @@ Result MemoryCacheLayer::GetMemoryCacheHashIds(
         result = Result::ErrorInvalidMemorySize;
     }
 
+    for (uint32 i = 0; i < m_numShards; ++i)
+    {
+        m_pShards[i].lock.UnlockForRead();
+    }
+
     return result;
 }
 
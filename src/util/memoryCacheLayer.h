@@ -35,6 +35,11 @@ namespace Util
 
 // =====================================================================================================================
 // An ICacheLayer implementation that operates on fixed memory limits but not a fixed memory space
+//
+// The cache is split into one or more shards, each with its own lock, lookup table and LRU list. Entries are assigned
+// to a shard by bits of their hash so that concurrent operations on different entries rarely contend. With more than
+// one shard, recency is tracked with a per-entry reference bit (clock/second-chance) instead of reordering the LRU
+// list, so cache hits only require a shared lock.
 class MemoryCacheLayer : public CacheLayerBase
 {
 public:
@@ -43,15 +48,19 @@ public:
         size_t                maxMemorySize,
         size_t                maxObjectCount,
         bool                  evictOnFull,
-        bool                  evictDuplicates);
+        bool                  evictDuplicates,
+        uint32                numShards);
     virtual ~MemoryCacheLayer();
 
     virtual Result Init() override;
 
+    static size_t GetSize(uint32 numShards);
+    static uint32 ClampNumShards(uint32 numShards);
+
     Result GetMemoryCacheSize(size_t* pCurCount, size_t* pCurSize) const
     {
-        *pCurCount = m_curCount;
-        *pCurSize  = m_curSize;
+        *pCurCount = static_cast<size_t>(m_curCount);
+        *pCurSize  = static_cast<size_t>(m_curSize);
 
         return Result::Success;
     }
@@ -89,14 +98,19 @@ private:
     PAL_DISALLOW_COPY_AND_ASSIGN(MemoryCacheLayer);
     PAL_DISALLOW_DEFAULT_CTOR(MemoryCacheLayer);
     class Entry;
+    struct Shard;
+
+    Shard* GetShard(const Hash128& hashId) const
+        { return &m_pShards[hashId.dwords[0] & (m_numShards - 1)]; }
 
-    Result SetDataToEntry(Entry* pEntry, const void* pData, size_t dataSize);
-    Result AddEntryToCache(Entry* pEntry);
-    Result EvictEntryFromCache(Entry* pEntry);
+    Result SetDataToEntry(Shard* pShard, Entry* pEntry, const void* pData, size_t dataSize);
+    Result AddEntryToCache(Shard* pShard, Entry* pEntry);
+    Result EvictEntryFromCache(Shard* pShard, Entry* pEntry);
 
-    Result EnsureAvailableSpace(size_t entrySize, size_t entryCount);
-    Result EvictEntryByCount(size_t numToEvict = 1);
-    Result EvictEntryBySize(size_t minSizeToEvict);
+    Entry* GetEvictionCandidate(Shard* pShard);
+    bool HasAvailableSpace(size_t entrySize, size_t entryCount) const;
+    Result EnsureAvailableSpace(Shard* pShard, size_t entrySize, size_t entryCount);
+    size_t EvictEntriesFromShard(Shard* pShard, size_t entrySize, size_t entryCount);
 
     // IntrusiveList capable cache entry data structure
     class Entry
@@ -127,6 +141,17 @@ private:
         void SetIsBad(bool isBad) { m_isBad = isBad; }
         bool IsBad() { return m_isBad; }
 
+        // Clock LRU support: a hit sets the reference bit (skipping the store if it's already set to avoid bouncing
+        // the cache line between readers) and eviction clears it to give the entry a second chance.
+        void MarkReferenced()
+        {
+            if (m_referenced == 0)
+            {
+                AtomicExchange(&m_referenced, 1);
+            }
+        }
+        bool ClearReferenced() { return (AtomicExchange(&m_referenced, 0) != 0); }
+
         Node* ListNode() { return &m_node; }
 
         void Destroy();
@@ -142,6 +167,7 @@ private:
             m_hashId     {},
             m_pData      { nullptr },
             m_dataSize   { 0 },
+            m_referenced { 0 },
             m_isBad      { false }
         {
             PAL_ASSERT(m_pAllocator != nullptr);
@@ -155,21 +181,40 @@ private:
         void*                   m_pData;
         size_t                  m_dataSize;
         volatile uint32         m_zeroCopyCount;
+        volatile uint32         m_referenced;
         bool                    m_isBad;
     };
 
+    // One independently locked partition of the cache. Shards are placed directly after the layer object in the
+    // memory provided to CreateMemoryCacheLayer(). The size and count budgets are tracked for the whole cache.
+    struct Shard
+    {
+        Shard(uint32 numBuckets, ForwardAllocator* pAllocator)
+            :
+            lock            {},
+            curCount        { 0 },
+            recentEntryList {},
+            entryLookup     { numBuckets, pAllocator }
+        {
+        }
+
+        RWLock       lock;
+        size_t       curCount;    // Number of entries in this shard
+        Entry::List  recentEntryList;
+        Entry::Map   entryLookup;
+    };
+
     const size_t m_maxSize;
     const size_t m_maxCount;
     const bool   m_evictOnFull;
     const bool   m_evictDuplicates;
+    const uint32 m_numShards;
+    const bool   m_clockLru;    // Use approximate (clock) LRU rather than reordering the LRU list on every hit.
 
-    RWLock       m_lock;
-
-    size_t       m_curSize;
-    size_t       m_curCount;
+    volatile uint64 m_curSize;  // Data size of all shards, updated atomically under any one shard's lock
+    volatile uint64 m_curCount; // Entry count of all shards, updated atomically under any one shard's lock
 
-    Entry::List  m_recentEntryList;
-    Entry::Map   m_entryLookup;
+    Shard* const m_pShards;
 
     Mutex              m_conditionMutex;      // Mutex that will be used with the condition variable
     ConditionVariable  m_conditionVariable;   // used for waiting on Entry::ready
@@ -103,15 +103,21 @@ Result PipelineAbiReader::Init()
 }
 
 // =====================================================================================================================
-Result PipelineAbiReader::GetMetadata(
-    MsgPackReader*         pReader,
-    PalCodeObjectMetadata* pMetadata
+// Locates the PAL metadata note in the first .note section and reads its version.
+Result PipelineAbiReader::FindMetadata(
+    MsgPackReader* pReader,
+    const void**   ppRawMetadata,
+    uint32*        pMetadataSize,
+    uint32*        pMetadataMajorVer,
+    uint32*        pMetadataMinorVer
     ) const
 {
-    Result result = Result::Success;
-    bool foundMetadata = false;
+    Result result = Result::ErrorInvalidPipelineElf;
 
-    memset(pMetadata, 0, sizeof(PalCodeObjectMetadata));
+    *ppRawMetadata     = nullptr;
+    *pMetadataSize     = 0;
+    *pMetadataMajorVer = 0;
+    *pMetadataMinorVer = 1;
 
     for (ElfReader::SectionId sectionIndex = 0; sectionIndex < m_elfReader.GetNumSections(); sectionIndex++)
     {
@@ -122,14 +128,9 @@ Result PipelineAbiReader::GetMetadata(
             continue;
         }
 
-        uint32 metadataMajorVer = 0;
-        uint32 metadataMinorVer = 1;
-
-        const void* pRawMetadata = nullptr;
-        uint32      metadataSize = 0;
+        result = Result::Success;
 
         ElfReader::Notes notes(m_elfReader, sectionIndex);
-        ElfReader::NoteIterator notesEnd = notes.End();
         for (ElfReader::NoteIterator note = notes.Begin(); note.IsValid(); note.Next())
         {
             const void* pDesc    = note.GetDescriptor();
@@ -139,10 +140,10 @@ Result PipelineAbiReader::GetMetadata(
             {
             case MetadataNoteType:
             {
-                pRawMetadata = pDesc;
-                metadataSize = descSize;
+                *ppRawMetadata = pDesc;
+                *pMetadataSize = descSize;
 
-                result = GetPalMetadataVersion(pReader, pDesc, descSize, &metadataMajorVer, &metadataMinorVer);
+                result = GetPalMetadataVersion(pReader, pDesc, descSize, pMetadataMajorVer, pMetadataMinorVer);
 
                 break;
             }
@@ -152,22 +153,53 @@ Result PipelineAbiReader::GetMetadata(
             }
         }
 
-        if (result != Result::Success)
-        {
-            break;
-        }
+        // Quit after the first .note section
+        break;
+    }
+
+    return result;
+}
 
+// =====================================================================================================================
+Result PipelineAbiReader::GetMetadata(
+    MsgPackReader*         pReader,
+    PalCodeObjectMetadata* pMetadata
+    ) const
+{
+    const void* pRawMetadata     = nullptr;
+    uint32      metadataSize     = 0;
+    uint32      metadataMajorVer = 0;
+    uint32      metadataMinorVer = 0;
+
+    memset(pMetadata, 0, sizeof(PalCodeObjectMetadata));
+
+    Result result = FindMetadata(pReader, &pRawMetadata, &metadataSize, &metadataMajorVer, &metadataMinorVer);
+
+    if (result == Result::Success)
+    {
         result = DeserializePalCodeObjectMetadata(pReader, pMetadata, pRawMetadata, metadataSize,
             metadataMajorVer, metadataMinorVer);
-        foundMetadata = true;
-
-        // Quit after the first .note section
-        break;
     }
 
-    if (result == Result::Success && !foundMetadata)
+    return result;
+}
+
+// =====================================================================================================================
+Result PipelineAbiReader::GetMetadataView(
+    MsgPackReader*        pReader,
+    PipelineMetadataView* pView
+    ) const
+{
+    const void* pRawMetadata     = nullptr;
+    uint32      metadataSize     = 0;
+    uint32      metadataMajorVer = 0;
+    uint32      metadataMinorVer = 0;
+
+    Result result = FindMetadata(pReader, &pRawMetadata, &metadataSize, &metadataMajorVer, &metadataMinorVer);
+
+    if (result == Result::Success)
     {
-        result = Result::ErrorInvalidPipelineElf;
+        result = pView->Init(pReader, pRawMetadata, metadataSize, metadataMajorVer, metadataMinorVer);
     }
 
     return result;
@@ -220,5 +252,190 @@ const Elf::SymbolTableEntry* PipelineAbiReader::GetGenericSymbol(
     return pSymbol;
 }
 
+// =====================================================================================================================
+// Records the offset of each entry of a map keyed by a stage enum (e.g. the .hardware_stages or .shaders maps).  The
+// reader is expected to be positioned on the map itself.
+template <typename StageEnum>
+static Result IndexStageMap(
+    MsgPackReader* pReader,
+    uint32*        pOffsets)
+{
+    constexpr uint32 NumOffsets = static_cast<uint32>(StageEnum::Count);
+
+    Result result = ((pReader->Type() == CWP_ITEM_MAP) && (pReader->Get().as.map.size <= NumOffsets)) ?
+                    Result::Success : Result::ErrorInvalidValue;
+
+    for (uint32 i = pReader->Get().as.map.size; ((result == Result::Success) && (i > 0)); --i)
+    {
+        StageEnum key = StageEnum::Count;
+        result = Metadata::DeserializeEnum(pReader, &key);
+
+        if (result == Result::Success)
+        {
+            pOffsets[static_cast<uint32>(key)] = pReader->Tell();
+            result = pReader->Skip(1);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+void PipelineMetadataView::Reset()
+{
+    m_registersOffset       = InvalidOffset;
+    m_shaderFunctionsOffset = InvalidOffset;
+
+    memset(&m_hwStageOffset[0], 0xFF, sizeof(m_hwStageOffset));
+    memset(&m_shaderOffset[0],  0xFF, sizeof(m_shaderOffset));
+}
+
+// =====================================================================================================================
+Result PipelineMetadataView::Init(
+    MsgPackReader* pReader,
+    const void*    pRawMetadata,
+    uint32         metadataSize,
+    uint32         metadataMajorVer,
+    uint32         metadataMinorVer)
+{
+    Reset();
+
+    Result result = Result::ErrorUnsupportedPipelineElfAbiVersion;
+    if (metadataMajorVer == PipelineMetadataMajorVersion)
+    {
+        result = pReader->InitFromBuffer(pRawMetadata, metadataSize);
+    }
+
+    if ((result == Result::Success) && (pReader->Type() != CWP_ITEM_MAP))
+    {
+        result = Result::ErrorInvalidValue;
+    }
+
+    for (uint32 i = pReader->Get().as.map.size; ((result == Result::Success) && (i > 0)); --i)
+    {
+        result = pReader->Next(CWP_ITEM_STR);
+
+        if (result == Result::Success)
+        {
+            const auto&  str     = pReader->Get().as.str;
+            const uint32 keyHash = HashString(static_cast<const char*>(str.start), str.length);
+
+            result = (keyHash == HashLiteralString(PalCodeObjectMetadataKey::Pipelines)) ? IndexPipeline(pReader)
+                                                                                          : pReader->Skip(1);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Walks the keys of the pipeline map once, recording the offsets of the entries which can be queried later and
+// skipping over everything else without decoding it.
+Result PipelineMetadataView::IndexPipeline(
+    MsgPackReader* pReader)
+{
+    Result result = pReader->Next(CWP_ITEM_ARRAY);
+
+    if (result == Result::Success)
+    {
+        PAL_ASSERT(pReader->Get().as.array.size == 1);
+        result = pReader->Next(CWP_ITEM_MAP);
+    }
+
+    for (uint32 i = pReader->Get().as.map.size; ((result == Result::Success) && (i > 0)); --i)
+    {
+        result = pReader->Next(CWP_ITEM_STR);
+
+        if (result == Result::Success)
+        {
+            const auto&  str     = pReader->Get().as.str;
+            const uint32 keyHash = HashString(static_cast<const char*>(str.start), str.length);
+
+            switch (keyHash)
+            {
+            case HashLiteralString(PipelineMetadataKey::Shaders):
+                result = pReader->Next();
+                if (result == Result::Success)
+                {
+                    result = IndexStageMap<ApiShaderType>(pReader, &m_shaderOffset[0]);
+                }
+                break;
+
+            case HashLiteralString(PipelineMetadataKey::HardwareStages):
+                result = pReader->Next();
+                if (result == Result::Success)
+                {
+                    result = IndexStageMap<HardwareStage>(pReader, &m_hwStageOffset[0]);
+                }
+                break;
+
+            case HashLiteralString(PipelineMetadataKey::ShaderFunctions):
+                m_shaderFunctionsOffset = pReader->Tell();
+                result = pReader->Skip(1);
+                break;
+
+            case HashLiteralString(PipelineMetadataKey::Registers):
+                m_registersOffset = pReader->Tell();
+                result = pReader->Skip(1);
+                break;
+
+            default:
+                result = pReader->Skip(1);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+Result PipelineMetadataView::GetHardwareStage(
+    MsgPackReader*         pReader,
+    HardwareStage          stage,
+    HardwareStageMetadata* pMetadata
+    ) const
+{
+    Result result = Result::Success;
+
+    memset(pMetadata, 0, sizeof(HardwareStageMetadata));
+
+    if (HasHardwareStage(stage))
+    {
+        result = pReader->Seek(m_hwStageOffset[static_cast<uint32>(stage)]);
+
+        if (result == Result::Success)
+        {
+            result = Metadata::DeserializeHardwareStageMetadata(pReader, pMetadata);
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+Result PipelineMetadataView::GetShader(
+    MsgPackReader*  pReader,
+    ApiShaderType   shaderType,
+    ShaderMetadata* pMetadata
+    ) const
+{
+    Result result = Result::Success;
+
+    memset(pMetadata, 0, sizeof(ShaderMetadata));
+
+    if (HasShader(shaderType))
+    {
+        result = pReader->Seek(m_shaderOffset[static_cast<uint32>(shaderType)]);
+
+        if (result == Result::Success)
+        {
+            result = Metadata::DeserializeShaderMetadata(pReader, pMetadata);
+        }
+    }
+
+    return result;
+}
+
 } // Abi
 } // Util
@@ -0,0 +1,365 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  archiveCompressionBench.cpp
+ * @brief Archive cache layer compression benchmark. Stores the same entries into one archive with LZ4 compression and
+ *        one without, then reopens each and loads every entry back, reporting the archive size and the load
+ *        throughput. Entry data is taken from the given file (e.g. a pipeline ELF) or generated if none is given.
+ *
+ * Usage: palArchiveCompressionBench [entryCount] [directory] [dataFile]
+ ***********************************************************************************************************************
+ */
+
+#include "palArchiveFile.h"
+#include "palCacheLayer.h"
+#include "palDbgPrint.h"
+#include "palInlineFuncs.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultEntryCount = 1000;
+constexpr size_t GeneratedDataSize = 32 * 1024;  // Size of each entry when no data file is given
+constexpr uint32 LoadRepeats       = 5;          // Every entry is loaded this many times, the fastest pass is reported
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMemory)
+{
+    free(pMemory);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// An archive file with a cache layer on top of it.
+struct ArchiveCache
+{
+    IArchiveFile* pArchive;
+    ICacheLayer*  pLayer;
+    void*         pArchiveMem;
+    void*         pLayerMem;
+};
+
+// =====================================================================================================================
+void CloseCache(
+    ArchiveCache* pCache)
+{
+    if (pCache->pLayer != nullptr)
+    {
+        pCache->pLayer->Destroy();
+    }
+
+    if (pCache->pArchive != nullptr)
+    {
+        pCache->pArchive->Destroy();
+    }
+
+    free(pCache->pLayerMem);
+    free(pCache->pArchiveMem);
+
+    memset(pCache, 0, sizeof(*pCache));
+}
+
+// =====================================================================================================================
+// Opens (and optionally creates) one of the benchmark's archives and puts a cache layer on top of it.
+Result OpenCache(
+    const char*   pDirectory,
+    const char*   pFileName,
+    bool          create,
+    bool          useCompression,
+    ArchiveCache* pCache)
+{
+    memset(pCache, 0, sizeof(*pCache));
+
+    ArchiveFileOpenInfo openInfo = {};
+    openInfo.pMemoryCallbacks = &g_callbacks;
+    openInfo.allowCreateFile  = create;
+    openInfo.allowWriteAccess = true;
+    Strncpy(openInfo.filePath, pDirectory, sizeof(openInfo.filePath));
+    Strncpy(openInfo.fileName, pFileName, sizeof(openInfo.fileName));
+
+    pCache->pArchiveMem = malloc(GetArchiveFileObjectSize(&openInfo));
+
+    Result result = (pCache->pArchiveMem != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = OpenArchiveFile(&openInfo, pCache->pArchiveMem, &pCache->pArchive);
+    }
+
+    ArchiveFileCacheCreateInfo createInfo = {};
+    createInfo.baseInfo.pCallbacks = &g_callbacks;
+    createInfo.pFile               = pCache->pArchive;
+    createInfo.useCompression      = useCompression;
+
+    if (result == Result::Success)
+    {
+        pCache->pLayerMem = malloc(GetArchiveFileCacheLayerSize(&createInfo));
+        result            = (pCache->pLayerMem != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        result = CreateArchiveFileCacheLayer(&createInfo, pCache->pLayerMem, &pCache->pLayer);
+    }
+
+    if (result != Result::Success)
+    {
+        CloseCache(pCache);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Reads the whole data file, or generates shader-like data (repetitive but not trivially so) when none is given.
+void* LoadEntryData(
+    const char* pDataFile,
+    size_t*     pDataSize)
+{
+    void* pData = nullptr;
+
+    if (pDataFile != nullptr)
+    {
+        FILE* const pFile = fopen(pDataFile, "rb");
+
+        if ((pFile != nullptr) && (fseek(pFile, 0, SEEK_END) == 0))
+        {
+            const long fileSize = ftell(pFile);
+
+            if ((fileSize > 0) && (fseek(pFile, 0, SEEK_SET) == 0))
+            {
+                *pDataSize = static_cast<size_t>(fileSize);
+                pData      = malloc(*pDataSize);
+
+                if ((pData != nullptr) && (fread(pData, 1, *pDataSize, pFile) != *pDataSize))
+                {
+                    free(pData);
+                    pData = nullptr;
+                }
+            }
+        }
+
+        if (pFile != nullptr)
+        {
+            fclose(pFile);
+        }
+    }
+    else
+    {
+        *pDataSize = GeneratedDataSize;
+        pData      = malloc(*pDataSize);
+
+        if (pData != nullptr)
+        {
+            uint32* const pDwords = static_cast<uint32*>(pData);
+            uint32        state   = 1;
+
+            // Mostly a small set of opcodes with varying operands, like an instruction stream.
+            for (size_t i = 0; i < (*pDataSize / sizeof(uint32)); ++i)
+            {
+                state      = (state * 1103515245u) + 12345u;
+                pDwords[i] = (((state >> 16) & 0x7) << 24) | ((state >> 20) & 0xFF);
+            }
+        }
+    }
+
+    return pData;
+}
+
+// =====================================================================================================================
+// Makes the hash of an entry; the entry index is also written into its data so every entry is distinct.
+Hash128 MakeHash(
+    uint32 index)
+{
+    Hash128 hash = {};
+    hash.dwords[0] = index + 1;
+    hash.dwords[1] = index * 2654435761u;
+
+    return hash;
+}
+
+// =====================================================================================================================
+// Stores entryCount entries into a new archive, then reopens it and measures loading them back.
+Result RunArchive(
+    const char* pDirectory,
+    bool        useCompression,
+    uint32      entryCount,
+    void*       pData,
+    size_t      dataSize)
+{
+    const char* const pFileName = useCompression ? "palCompressionBenchLz4.bin" : "palCompressionBenchRaw.bin";
+
+    char path[MaxPathLength];
+    Snprintf(path, sizeof(path), "%s/%s", pDirectory, pFileName);
+    remove(path);
+
+    ArchiveCache cache  = {};
+    Result       result = OpenCache(pDirectory, pFileName, true, useCompression, &cache);
+
+    const int64 storeStart = GetPerfCpuTime();
+
+    for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+    {
+        const Hash128 hash = MakeHash(i);
+
+        memcpy(pData, &i, Min(sizeof(i), dataSize));
+
+        result = cache.pLayer->Store(&hash, pData, dataSize);
+    }
+
+    const int64 storeTicks = GetPerfCpuTime() - storeStart;
+
+    CloseCache(&cache);
+
+    if (result == Result::Success)
+    {
+        result = OpenCache(pDirectory, pFileName, false, useCompression, &cache);
+    }
+
+    void* const pLoadBuffer = malloc(dataSize);
+    int64       loadTicks   = INT64_MAX;
+
+    result = ((result == Result::Success) && (pLoadBuffer == nullptr)) ? Result::ErrorOutOfMemory : result;
+
+    for (uint32 repeat = 0; (repeat < LoadRepeats) && (result == Result::Success); ++repeat)
+    {
+        const int64 loadStart = GetPerfCpuTime();
+
+        for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+        {
+            const Hash128 hash  = MakeHash(i);
+            QueryResult   query = {};
+
+            result = cache.pLayer->Query(&hash, 0, 0, &query);
+
+            if (result == Result::Success)
+            {
+                result = cache.pLayer->Load(&query, pLoadBuffer);
+            }
+
+            if ((result == Result::Success) && (memcmp(pLoadBuffer, &i, Min(sizeof(i), dataSize)) != 0))
+            {
+                result = Result::ErrorInvalidValue;
+            }
+        }
+
+        loadTicks = Min(loadTicks, GetPerfCpuTime() - loadStart);
+    }
+
+    CloseCache(&cache);
+    free(pLoadBuffer);
+
+    FILE* const pFile       = fopen(path, "rb");
+    long        archiveSize = 0;
+
+    if ((pFile != nullptr) && (fseek(pFile, 0, SEEK_END) == 0))
+    {
+        archiveSize = ftell(pFile);
+    }
+
+    if (pFile != nullptr)
+    {
+        fclose(pFile);
+    }
+
+    if (result == Result::Success)
+    {
+        const double secondsPerTick = 1.0 / static_cast<double>(GetPerfFrequency());
+        const double totalMb        = (static_cast<double>(dataSize) * entryCount) / (1024.0 * 1024.0);
+
+        printf("%-12s %12.1f %12.1f %14.1f %14.1f\n",
+               useCompression ? "lz4" : "uncompressed",
+               totalMb,
+               static_cast<double>(archiveSize) / (1024.0 * 1024.0),
+               totalMb / (static_cast<double>(storeTicks) * secondsPerTick),
+               totalMb / (static_cast<double>(loadTicks) * secondsPerTick));
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32      entryCount = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultEntryCount;
+    const char* const pDirectory = (argc > 2) ? argv[2] : ".";
+    const char* const pDataFile  = (argc > 3) ? argv[3] : nullptr;
+
+    size_t      dataSize = 0;
+    void* const pData    = (entryCount > 0) ? LoadEntryData(pDataFile, &dataSize) : nullptr;
+
+    if (pData == nullptr)
+    {
+        fprintf(stderr, "Usage: %s [entryCount] [directory] [dataFile]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-12s %12s %12s %14s %14s\n", "archive", "data MB", "file MB", "store MB/s", "load MB/s");
+
+    Result result = RunArchive(pDirectory, false, entryCount, pData, dataSize);
+
+    if (result == Result::Success)
+    {
+        result = RunArchive(pDirectory, true, entryCount, pData, dataSize);
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    free(pData);
+
+    return (result == Result::Success) ? 0 : 1;
+}
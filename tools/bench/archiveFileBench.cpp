@@ -0,0 +1,320 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  archiveFileBench.cpp
+ * @brief Archive file open benchmark. Writes an archive with the requested number of entries, then compares opening
+ *        it through its entry index against opening a copy whose index is unusable, which takes the header chain walk
+ *        of archives written before the index existed. Also reports the cost of an indexed lookup.
+ *
+ * Usage: palArchiveFileBench [entryCount] [entrySize] [directory]
+ ***********************************************************************************************************************
+ */
+
+#include "palArchiveFile.h"
+#include "palArchiveFileFmt.h"
+#include "palDbgPrint.h"
+#include "palInlineFuncs.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultEntryCount = 20000;
+constexpr uint32 DefaultEntrySize  = 1024;
+constexpr uint32 OpenRepeats       = 10;         // Each archive is opened this many times, the fastest is reported
+constexpr char   IndexedName[]     = "palArchiveBench.bin";
+constexpr char   UnindexedName[]   = "palArchiveBenchUnindexed.bin";
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMemory)
+{
+    free(pMemory);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+// Builds a well-distributed entry key for the given entry index.
+void MakeKey(
+    uint32 index,
+    uint8* pKey)
+{
+    const uint32 hash = (index + 1) * 2654435761u;
+
+    memset(pKey, 0, sizeof(ArchiveEntryHeader::entryKey));
+    memcpy(pKey, &hash, sizeof(hash));
+    memcpy(pKey + sizeof(hash), &index, sizeof(index));
+}
+
+// =====================================================================================================================
+// Opens (and optionally creates) one of the benchmark's archives. The placement memory is freed by CloseArchive().
+IArchiveFile* OpenArchive(
+    const char* pDirectory,
+    const char* pFileName,
+    bool        create)
+{
+    ArchiveFileOpenInfo openInfo = {};
+    openInfo.pMemoryCallbacks = &g_callbacks;
+    openInfo.allowCreateFile  = create;
+    openInfo.allowWriteAccess = create;
+    Strncpy(openInfo.filePath, pDirectory, sizeof(openInfo.filePath));
+    Strncpy(openInfo.fileName, pFileName, sizeof(openInfo.fileName));
+
+    IArchiveFile* pArchive = nullptr;
+    void*         pMemory  = malloc(GetArchiveFileObjectSize(&openInfo));
+
+    if ((pMemory == nullptr) || (OpenArchiveFile(&openInfo, pMemory, &pArchive) != Result::Success))
+    {
+        free(pMemory);
+        pArchive = nullptr;
+    }
+
+    return pArchive;
+}
+
+// =====================================================================================================================
+void CloseArchive(
+    IArchiveFile* pArchive)
+{
+    if (pArchive != nullptr)
+    {
+        pArchive->Destroy();
+        free(pArchive);
+    }
+}
+
+// =====================================================================================================================
+// Writes a fresh archive. Closing it with write access appends the entry index.
+Result WriteArchive(
+    const char* pDirectory,
+    uint32      entryCount,
+    uint32      entrySize)
+{
+    char path[MaxPathLength];
+    Snprintf(path, sizeof(path), "%s/%s", pDirectory, IndexedName);
+    remove(path);
+
+    IArchiveFile* const pArchive = OpenArchive(pDirectory, IndexedName, true);
+    void* const         pData    = calloc(1, entrySize);
+    Result              result   = ((pArchive != nullptr) && (pData != nullptr)) ? Result::Success
+                                                                                 : Result::ErrorInitializationFailed;
+
+    for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+    {
+        ArchiveEntryHeader header = {};
+        MakeKey(i, header.entryKey);
+        header.dataSize  = entrySize;
+        header.metaValue = entrySize;
+
+        result = pArchive->Write(&header, pData);
+    }
+
+    free(pData);
+    CloseArchive(pArchive);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Copies the indexed archive and overwrites the copy's index marker so that opening it has to walk the header chain.
+Result WriteUnindexedCopy(
+    const char* pDirectory)
+{
+    char srcPath[MaxPathLength];
+    char dstPath[MaxPathLength];
+    Snprintf(srcPath, sizeof(srcPath), "%s/%s", pDirectory, IndexedName);
+    Snprintf(dstPath, sizeof(dstPath), "%s/%s", pDirectory, UnindexedName);
+
+    FILE* const pSrc   = fopen(srcPath, "rb");
+    FILE* const pDst   = fopen(dstPath, "w+b");
+    Result      result = ((pSrc != nullptr) && (pDst != nullptr)) ? Result::Success : Result::ErrorInvalidValue;
+
+    char   buffer[64 * 1024];
+    size_t readSize = 0;
+
+    while ((result == Result::Success) && ((readSize = fread(buffer, 1, sizeof(buffer), pSrc)) > 0))
+    {
+        result = (fwrite(buffer, 1, readSize, pDst) == readSize) ? Result::Success : Result::ErrorInvalidValue;
+    }
+
+    if ((result == Result::Success) &&
+        (fseek(pDst, -static_cast<long>(sizeof(ArchiveFileFooter) + sizeof(ArchiveIndexFooter)), SEEK_END) == 0))
+    {
+        const uint8 badMarker[sizeof(ArchiveIndexFooter::indexMarker)] = {};
+
+        result = (fwrite(badMarker, 1, sizeof(badMarker), pDst) == sizeof(badMarker)) ? Result::Success
+                                                                                       : Result::ErrorInvalidValue;
+    }
+
+    if (pSrc != nullptr)
+    {
+        fclose(pSrc);
+    }
+
+    if (pDst != nullptr)
+    {
+        fclose(pDst);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Opens an archive read-only OpenRepeats times and prints the fastest open. For indexed archives, also looks up every
+// entry through the index.
+Result MeasureOpen(
+    const char* pDirectory,
+    const char* pFileName,
+    const char* pLabel,
+    uint32      entryCount)
+{
+    const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+
+    Result result        = Result::Success;
+    int64  bestOpenTicks = INT64_MAX;
+    int64  lookupTicks   = 0;
+    size_t indexedCount  = 0;
+
+    for (uint32 repeat = 0; (repeat < OpenRepeats) && (result == Result::Success); ++repeat)
+    {
+        const int64         startTicks = GetPerfCpuTime();
+        IArchiveFile* const pArchive   = OpenArchive(pDirectory, pFileName, false);
+        const int64         openTicks  = GetPerfCpuTime() - startTicks;
+
+        result = (pArchive != nullptr) ? Result::Success : Result::ErrorInvalidValue;
+
+        if (result == Result::Success)
+        {
+            bestOpenTicks = Min(bestOpenTicks, openTicks);
+            indexedCount  = pArchive->GetIndexedEntryCount();
+        }
+
+        if ((result == Result::Success) && (indexedCount > 0) && (repeat == 0))
+        {
+            const int64 lookupStart = GetPerfCpuTime();
+
+            for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+            {
+                uint8              key[sizeof(ArchiveEntryHeader::entryKey)];
+                ArchiveEntryHeader header;
+                MakeKey(i, key);
+
+                result = pArchive->FindIndexedEntry(key, &header);
+            }
+
+            lookupTicks = GetPerfCpuTime() - lookupStart;
+        }
+
+        CloseArchive(pArchive);
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%-10s %10u %10zu %12.3f",
+               pLabel,
+               entryCount,
+               indexedCount,
+               (static_cast<double>(bestOpenTicks) * nsPerTick) / 1000000.0);
+
+        if (indexedCount > 0)
+        {
+            printf(" %14.1f\n", (static_cast<double>(lookupTicks) * nsPerTick) / entryCount);
+        }
+        else
+        {
+            printf(" %14s\n", "n/a");
+        }
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32      entryCount = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultEntryCount;
+    const uint32      entrySize  = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultEntrySize;
+    const char* const pDirectory = (argc > 3) ? argv[3] : ".";
+
+    if ((entryCount == 0) || (entrySize == 0))
+    {
+        fprintf(stderr, "Usage: %s [entryCount] [entrySize] [directory]\n", argv[0]);
+        return 1;
+    }
+
+    Result result = WriteArchive(pDirectory, entryCount, entrySize);
+
+    if (result == Result::Success)
+    {
+        result = WriteUnindexedCopy(pDirectory);
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%-10s %10s %10s %12s %14s\n", "archive", "entries", "indexed", "open ms", "ns/lookup");
+
+        result = MeasureOpen(pDirectory, IndexedName, "indexed", entryCount);
+    }
+
+    if (result == Result::Success)
+    {
+        result = MeasureOpen(pDirectory, UnindexedName, "chain walk", entryCount);
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,363 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  cmdAllocatorBench.cpp
+ * @brief Command allocator scaling benchmark. Records command buffers which span many small chunks from 1 to N threads
+ *        on a null device, once with every thread sharing a thread-safe allocator and once with a private allocator
+ *        per thread. The gap between the two is the cost of sharing the allocator, which the per-thread chunk caches
+ *        are meant to hide.
+ *
+ * Usage: palCmdAllocatorBench [maxThreadCount] [iterationCount] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "pal.h"
+#include "palCmdAllocator.h"
+#include "palCmdBuffer.h"
+#include "palDevice.h"
+#include "palLib.h"
+#include "palPlatform.h"
+#include "palSysUtil.h"
+#include "palThread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 MaxThreads         = 64;
+constexpr uint32 DefaultThreadCount = 8;
+constexpr uint32 DefaultIterations  = 500;
+constexpr uint32 CmdsPerCmdBuffer   = 1024;        // Barriers recorded per command buffer
+constexpr uint32 AllocSize          = 256 * 1024;
+constexpr uint32 SuballocSize       = 4 * 1024;    // Small chunks, so that recording keeps asking for new ones
+
+// State owned by one recording thread.
+struct ThreadContext
+{
+    IDevice*       pDevice;
+    ICmdAllocator* pCmdAllocator;   // Either shared with every other thread or private to this one
+    Thread         thread;
+    uint32         iterations;
+    uint64         usedBytes;       // Command data recorded, summed over all iterations
+    Result         result;
+};
+
+// =====================================================================================================================
+ICmdAllocator* CreateCmdAllocator(
+    IDevice* pDevice,
+    bool     threadSafe)
+{
+    CmdAllocatorCreateInfo createInfo = {};
+    createInfo.flags.threadSafe      = threadSafe ? 1 : 0;
+    createInfo.flags.autoMemoryReuse = 1;
+
+    for (uint32 type = 0; type < CmdAllocatorTypeCount; ++type)
+    {
+        createInfo.allocInfo[type].allocHeap    = (type == GpuScratchMemAlloc) ? GpuHeapInvisible : GpuHeapGartUswc;
+        createInfo.allocInfo[type].allocSize    = AllocSize;
+        createInfo.allocInfo[type].suballocSize = SuballocSize;
+    }
+
+    Result         result        = Result::Success;
+    ICmdAllocator* pCmdAllocator = nullptr;
+    void*          pMemory       = malloc(pDevice->GetCmdAllocatorSize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory != nullptr))
+    {
+        result = pDevice->CreateCmdAllocator(createInfo, pMemory, &pCmdAllocator);
+    }
+
+    if (result != Result::Success)
+    {
+        free(pMemory);
+        pCmdAllocator = nullptr;
+    }
+
+    return pCmdAllocator;
+}
+
+// =====================================================================================================================
+void DestroyCmdAllocator(
+    ICmdAllocator* pCmdAllocator)
+{
+    if (pCmdAllocator != nullptr)
+    {
+        pCmdAllocator->Destroy();
+        free(pCmdAllocator);
+    }
+}
+
+// =====================================================================================================================
+// Body of each recording thread: records a barrier-only command buffer iterations times over.
+void RecordingThread(
+    void* pParameter)
+{
+    ThreadContext* const pThread = static_cast<ThreadContext*>(pParameter);
+
+    CmdBufferCreateInfo createInfo = {};
+    createInfo.pCmdAllocator = pThread->pCmdAllocator;
+    createInfo.queueType     = QueueTypeUniversal;
+    createInfo.engineType    = EngineTypeUniversal;
+
+    ICmdBuffer* pCmdBuffer = nullptr;
+    void*       pMemory    = malloc(pThread->pDevice->GetCmdBufferSize(createInfo, &pThread->result));
+
+    pThread->result = ((pThread->result == Result::Success) && (pMemory == nullptr)) ? Result::ErrorOutOfMemory
+                                                                                     : pThread->result;
+
+    if (pThread->result == Result::Success)
+    {
+        pThread->result = pThread->pDevice->CreateCmdBuffer(createInfo, pMemory, &pCmdBuffer);
+    }
+
+    const HwPipePoint postCs = HwPipePostCs;
+
+    BarrierInfo barrier = {};
+    barrier.waitPoint          = HwPipePreCs;
+    barrier.pipePointWaitCount = 1;
+    barrier.pPipePoints        = &postCs;
+    barrier.globalSrcCacheMask = CoherShader;
+    barrier.globalDstCacheMask = CoherShader;
+
+    CmdBufferBuildInfo buildInfo = {};
+    buildInfo.flags.optimizeOneTimeSubmit = 1;
+
+    for (uint32 iter = 0; (iter < pThread->iterations) && (pThread->result == Result::Success); ++iter)
+    {
+        pThread->result = pCmdBuffer->Reset(nullptr, true);
+
+        if (pThread->result == Result::Success)
+        {
+            pThread->result = pCmdBuffer->Begin(buildInfo);
+        }
+
+        if (pThread->result == Result::Success)
+        {
+            for (uint32 cmdIdx = 0; cmdIdx < CmdsPerCmdBuffer; ++cmdIdx)
+            {
+                pCmdBuffer->CmdBarrier(barrier);
+            }
+
+            pThread->result = pCmdBuffer->End();
+        }
+
+        if (pThread->result == Result::Success)
+        {
+            pThread->usedBytes += pCmdBuffer->GetUsedSize(CommandDataAlloc);
+        }
+    }
+
+    if (pCmdBuffer != nullptr)
+    {
+        pCmdBuffer->Destroy();
+    }
+
+    free(pMemory);
+}
+
+// =====================================================================================================================
+// Runs threadCount recording threads to completion and prints their throughput. If pSharedAllocator is null, each
+// thread gets its own single-threaded allocator.
+Result RunThreads(
+    IDevice*       pDevice,
+    ICmdAllocator* pSharedAllocator,
+    uint32         threadCount,
+    uint32         iterations)
+{
+    ThreadContext* const pThreads = new ThreadContext[threadCount]();
+    Result               result   = Result::Success;
+
+    for (uint32 threadIdx = 0; (threadIdx < threadCount) && (result == Result::Success); ++threadIdx)
+    {
+        pThreads[threadIdx].pDevice       = pDevice;
+        pThreads[threadIdx].iterations    = iterations;
+        pThreads[threadIdx].pCmdAllocator = (pSharedAllocator != nullptr) ? pSharedAllocator
+                                                                          : CreateCmdAllocator(pDevice, false);
+
+        result = (pThreads[threadIdx].pCmdAllocator != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    const int64 startTicks = GetPerfCpuTime();
+    uint32      started    = 0;
+
+    for (; (started < threadCount) && (result == Result::Success); ++started)
+    {
+        result = pThreads[started].thread.Begin(&RecordingThread, &pThreads[started]);
+    }
+
+    for (uint32 threadIdx = 0; threadIdx < started; ++threadIdx)
+    {
+        pThreads[threadIdx].thread.Join();
+        result = (result == Result::Success) ? pThreads[threadIdx].result : result;
+    }
+
+    const int64 ticks = GetPerfCpuTime() - startTicks;
+
+    if (result == Result::Success)
+    {
+        const double seconds    = static_cast<double>(ticks) / static_cast<double>(GetPerfFrequency());
+        const double cmdBuffers = static_cast<double>(threadCount) * iterations;
+        uint64       usedBytes  = 0;
+
+        for (uint32 threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+        {
+            usedBytes += pThreads[threadIdx].usedBytes;
+        }
+
+        // Every SuballocSize bytes of command data is one more chunk taken from the allocator.
+        printf("%-8s %8u %16.0f %16.0f\n",
+               (pSharedAllocator != nullptr) ? "shared" : "private",
+               threadCount,
+               cmdBuffers / seconds,
+               (static_cast<double>(usedBytes) / SuballocSize) / seconds);
+    }
+
+    for (uint32 threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+    {
+        if (pThreads[threadIdx].pCmdAllocator != pSharedAllocator)
+        {
+            DestroyCmdAllocator(pThreads[threadIdx].pCmdAllocator);
+        }
+    }
+
+    delete[] pThreads;
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 maxThreads = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultThreadCount;
+    const uint32 iterations = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultIterations;
+    const uint32 nullGpuId  = (argc > 3) ? static_cast<uint32>(strtoul(argv[3], nullptr, 0))
+                                         : static_cast<uint32>(NullGpuId::Navi10);
+
+    if ((maxThreads == 0) || (maxThreads > MaxThreads) || (iterations == 0))
+    {
+        fprintf(stderr, "Usage: %s [maxThreadCount (1-%u)] [iterationCount] [nullGpuId]\n", argv[0], MaxThreads);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    IPlatform* pPlatform       = nullptr;
+    void*      pPlatformMemory = malloc(GetPlatformSize());
+    Result     result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = CreatePlatform(platformInfo, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    IDevice* const pDevice = (result == Result::Success) ? pDevices[0] : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%u command buffers of %u barriers per thread, %u byte chunks\n\n",
+               iterations,
+               CmdsPerCmdBuffer,
+               SuballocSize);
+        printf("%-8s %8s %16s %16s\n", "alloc", "threads", "cmdbufs/s", "chunks/s");
+    }
+
+    for (uint32 threadCount = 1; (threadCount <= maxThreads) && (result == Result::Success); threadCount *= 2)
+    {
+        // A fresh shared allocator for every thread count, so earlier runs don't leave it pre-populated.
+        ICmdAllocator* const pSharedAllocator = CreateCmdAllocator(pDevice, true);
+
+        result = (pSharedAllocator != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+        if (result == Result::Success)
+        {
+            result = RunThreads(pDevice, pSharedAllocator, threadCount, iterations);
+        }
+
+        DestroyCmdAllocator(pSharedAllocator);
+
+        if (result == Result::Success)
+        {
+            result = RunThreads(pDevice, nullptr, threadCount, iterations);
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,757 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  cmdBufferBench.cpp
+ * @brief Command buffer recording benchmark. Brings up a null device and records draw, dispatch, barrier, copy, fill
+ *        and nested command buffer workloads on the universal and compute engines from several threads at once,
+ *        reporting the CPU time per recorded command and the PM4 bytes emitted. All threads share one thread-safe
+ *        command allocator, whose lock contention is reported at the end.
+ *
+ *        Draws and dispatches use PAL's own RPM pipelines, and the lock statistics live on the internal allocator, so
+ *        this creates the core platform directly rather than through CreatePlatform(), which would wrap the devices in
+ *        layer decorators.
+ *
+ * Usage: palCmdBufferBench [threadCount] [iterationCount] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "core/cmdAllocator.h"
+#include "core/device.h"
+#include "core/platform.h"
+#include "core/hw/gfxip/computePipeline.h"
+#include "core/hw/gfxip/gfxDevice.h"
+#include "core/hw/gfxip/graphicsPipeline.h"
+#include "core/hw/gfxip/msaaState.h"
+#include "core/hw/gfxip/rpm/rsrcProcMgr.h"
+#include "palCmdBuffer.h"
+#include "palColorBlendState.h"
+#include "palDepthStencilState.h"
+#include "palGpuMemory.h"
+#include "palLib.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+#include "palThread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32  MaxThreads          = 64;
+constexpr uint32  DefaultThreadCount  = 4;
+constexpr uint32  DefaultIterations   = 200;
+constexpr uint32  CmdsPerCmdBuffer    = 256;     // Commands recorded per command buffer in every workload
+constexpr gpusize ScratchMemSize      = 64 * 1024;
+constexpr gpusize CopySize            = 4 * 1024;
+constexpr uint32  AllocSize           = 2 * 1024 * 1024;
+constexpr uint32  SuballocSize        = 64 * 1024;
+
+// Workloads recorded by every thread, on every engine which supports them.
+enum class Workload : uint32
+{
+    Draws = 0,      // CmdSetUserData and CmdDraw with an RPM graphics pipeline, universal engine only
+    Dispatches,     // CmdSetUserData and CmdDispatch with an RPM compute pipeline
+    Barriers,       // CmdBarrier between shader and copy work
+    CopyMemory,     // CmdCopyMemory between two parts of the thread's scratch memory
+    FillMemory,     // CmdFillMemory through the RPM
+    Nested,         // CmdExecuteNestedCmdBuffers of a small pre-recorded nested command buffer
+    Count
+};
+
+constexpr const char* WorkloadNames[] =
+{
+    "draws",
+    "dispatches",
+    "barriers",
+    "copy-memory",
+    "fill-memory",
+    "nested",
+};
+
+static_assert(sizeof(WorkloadNames) / sizeof(WorkloadNames[0]) == static_cast<uint32>(Workload::Count),
+              "WorkloadNames doesn't match the Workload enum.");
+
+constexpr EngineType  Engines[]     = { EngineTypeUniversal, EngineTypeCompute };
+constexpr QueueType   QueueTypes[]  = { QueueTypeUniversal,  QueueTypeCompute  };
+constexpr const char* EngineNames[] = { "universal",         "compute"         };
+constexpr uint32      EngineCount   = sizeof(Engines) / sizeof(Engines[0]);
+
+// Results measured by one thread for one engine and workload.
+struct Measurement
+{
+    int64  ticks;      // Perf counter ticks spent between Begin() and End(), summed over all iterations
+    uint64 pm4Bytes;   // PM4 bytes emitted, summed over all iterations
+    uint32 cmdCount;   // Commands recorded, summed over all iterations
+};
+
+// State shared by all recording threads.
+struct BenchContext
+{
+    IDevice*            pDevice;
+    ICmdAllocator*      pCmdAllocator;   // Thread-safe allocator shared by all threads so that they contend for it
+    const IPipeline*    pGfxPipeline;
+    const IPipeline*    pComputePipeline;
+    const IMsaaState*   pMsaaState;
+    IColorBlendState*   pColorBlendState;
+    IDepthStencilState* pDepthStencilState;
+    uint32              iterations;
+    volatile bool       failed;
+};
+
+// State owned by one recording thread.
+struct ThreadContext
+{
+    BenchContext* pBench;
+    Thread        thread;
+    IGpuMemory*   pScratchMem;
+    Measurement   results[EngineCount][static_cast<uint32>(Workload::Count)];
+};
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMem)
+{
+    free(pMem);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+// Creates a command buffer on the shared allocator. The placement memory is freed by DestroyCmdBuffer().
+ICmdBuffer* CreateCmdBuffer(
+    const BenchContext& bench,
+    uint32              engineIdx,
+    bool                nested)
+{
+    CmdBufferCreateInfo createInfo = {};
+    createInfo.pCmdAllocator = bench.pCmdAllocator;
+    createInfo.queueType     = QueueTypes[engineIdx];
+    createInfo.engineType    = Engines[engineIdx];
+    createInfo.flags.nested  = nested ? 1 : 0;
+
+    Result      result     = Result::Success;
+    ICmdBuffer* pCmdBuffer = nullptr;
+    void*       pMemory    = malloc(bench.pDevice->GetCmdBufferSize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory != nullptr))
+    {
+        result = bench.pDevice->CreateCmdBuffer(createInfo, pMemory, &pCmdBuffer);
+    }
+
+    if (result != Result::Success)
+    {
+        free(pMemory);
+        pCmdBuffer = nullptr;
+    }
+
+    return pCmdBuffer;
+}
+
+// =====================================================================================================================
+void DestroyCmdBuffer(
+    ICmdBuffer* pCmdBuffer)
+{
+    if (pCmdBuffer != nullptr)
+    {
+        pCmdBuffer->Destroy();
+        free(pCmdBuffer);
+    }
+}
+
+// =====================================================================================================================
+// Records one barrier between shader and copy work.
+void RecordBarrier(
+    ICmdBuffer* pCmdBuffer)
+{
+    const HwPipePoint postCs = HwPipePostCs;
+
+    BarrierInfo barrier = {};
+    barrier.waitPoint          = HwPipePreCs;
+    barrier.pipePointWaitCount = 1;
+    barrier.pPipePoints        = &postCs;
+    barrier.globalSrcCacheMask = CoherShader | CoherCopy;
+    barrier.globalDstCacheMask = CoherShader | CoherCopy;
+
+    pCmdBuffer->CmdBarrier(barrier);
+}
+
+// =====================================================================================================================
+// Returns true if the given workload can be recorded on the given engine.
+bool IsSupported(
+    Workload workload,
+    uint32   engineIdx)
+{
+    return (workload != Workload::Draws) || (Engines[engineIdx] == EngineTypeUniversal);
+}
+
+// =====================================================================================================================
+// Binds the pipeline and state the given workload needs at the start of each command buffer.
+void BindWorkloadState(
+    const BenchContext& bench,
+    Workload            workload,
+    ICmdBuffer*         pCmdBuffer)
+{
+    if (workload == Workload::Draws)
+    {
+        PipelineBindParams bindParams = {};
+        bindParams.pipelineBindPoint = PipelineBindPoint::Graphics;
+        bindParams.pPipeline         = bench.pGfxPipeline;
+
+        InputAssemblyStateParams inputAssemblyState = {};
+        inputAssemblyState.topology = PrimitiveTopology::TriangleList;
+
+        TriangleRasterStateParams triangleRasterState = {};
+        triangleRasterState.frontFillMode   = FillMode::Solid;
+        triangleRasterState.backFillMode    = FillMode::Solid;
+        triangleRasterState.cullMode        = CullMode::_None;
+        triangleRasterState.frontFace       = FaceOrientation::Cw;
+        triangleRasterState.provokingVertex = ProvokingVertex::First;
+
+        ViewportParams viewports = {};
+        viewports.count                 = 1;
+        viewports.viewports[0].width    = 256.0f;
+        viewports.viewports[0].height   = 256.0f;
+        viewports.viewports[0].maxDepth = 1.0f;
+        viewports.viewports[0].origin   = PointOrigin::UpperLeft;
+        viewports.horzClipRatio         = 1.0f;
+        viewports.horzDiscardRatio      = 1.0f;
+        viewports.vertClipRatio         = 1.0f;
+        viewports.vertDiscardRatio      = 1.0f;
+        viewports.depthRange            = DepthRange::ZeroToOne;
+
+        ScissorRectParams scissors = {};
+        scissors.count                     = 1;
+        scissors.scissors[0].extent.width  = 256;
+        scissors.scissors[0].extent.height = 256;
+
+        pCmdBuffer->CmdBindPipeline(bindParams);
+        pCmdBuffer->CmdBindMsaaState(bench.pMsaaState);
+        pCmdBuffer->CmdBindColorBlendState(bench.pColorBlendState);
+        pCmdBuffer->CmdBindDepthStencilState(bench.pDepthStencilState);
+        pCmdBuffer->CmdSetInputAssemblyState(inputAssemblyState);
+        pCmdBuffer->CmdSetTriangleRasterState(triangleRasterState);
+        pCmdBuffer->CmdSetViewports(viewports);
+        pCmdBuffer->CmdSetScissorRects(scissors);
+    }
+    else if (workload == Workload::Dispatches)
+    {
+        PipelineBindParams bindParams = {};
+        bindParams.pipelineBindPoint = PipelineBindPoint::Compute;
+        bindParams.pPipeline         = bench.pComputePipeline;
+
+        pCmdBuffer->CmdBindPipeline(bindParams);
+    }
+}
+
+// =====================================================================================================================
+// Records one command of the given workload, returns the number of commands it counts as.
+uint32 RecordCmd(
+    Workload          workload,
+    ICmdBuffer*       pCmdBuffer,
+    ICmdBuffer*       pNestedCmdBuffer,
+    const IGpuMemory& scratchMem,
+    uint32            cmdIdx)
+{
+    const gpusize offset = (cmdIdx * CopySize) % (ScratchMemSize / 2);
+
+    switch (workload)
+    {
+    case Workload::Draws:
+        // Apps typically change a few root constants between draws, which makes every draw revalidate user data.
+        pCmdBuffer->CmdSetUserData(PipelineBindPoint::Graphics, 0, 1, &cmdIdx);
+        pCmdBuffer->CmdDraw(0, 3, 0, 1, 0);
+        break;
+    case Workload::Dispatches:
+        pCmdBuffer->CmdSetUserData(PipelineBindPoint::Compute, 0, 1, &cmdIdx);
+        pCmdBuffer->CmdDispatch(1, 1, 1);
+        break;
+    case Workload::Barriers:
+        RecordBarrier(pCmdBuffer);
+        break;
+    case Workload::CopyMemory:
+    {
+        MemoryCopyRegion region = {};
+        region.srcOffset = offset;
+        region.dstOffset = offset + (ScratchMemSize / 2);
+        region.copySize  = CopySize;
+
+        pCmdBuffer->CmdCopyMemory(scratchMem, scratchMem, 1, &region);
+        break;
+    }
+    case Workload::FillMemory:
+        pCmdBuffer->CmdFillMemory(scratchMem, offset, CopySize, cmdIdx);
+        break;
+    case Workload::Nested:
+        pCmdBuffer->CmdExecuteNestedCmdBuffers(1, &pNestedCmdBuffer);
+        break;
+    default:
+        break;
+    }
+
+    return 1;
+}
+
+// =====================================================================================================================
+// Body of each recording thread: records every workload on every engine, iterations times over.
+void RecordingThread(
+    void* pParameter)
+{
+    ThreadContext* const pThread = static_cast<ThreadContext*>(pParameter);
+    BenchContext*  const pBench  = pThread->pBench;
+
+    CmdBufferBuildInfo buildInfo = {};
+    buildInfo.flags.optimizeOneTimeSubmit = 1;
+
+    for (uint32 engineIdx = 0; (engineIdx < EngineCount) && (pBench->failed == false); ++engineIdx)
+    {
+        ICmdBuffer* const pCmdBuffer       = CreateCmdBuffer(*pBench, engineIdx, false);
+        ICmdBuffer* const pNestedCmdBuffer = CreateCmdBuffer(*pBench, engineIdx, true);
+
+        // The nested command buffer is recorded once and then executed by the nested workload.
+        Result result = ((pCmdBuffer != nullptr) && (pNestedCmdBuffer != nullptr)) ? Result::Success
+                                                                                    : Result::ErrorOutOfMemory;
+        if (result == Result::Success)
+        {
+            result = pNestedCmdBuffer->Begin(buildInfo);
+        }
+
+        if (result == Result::Success)
+        {
+            RecordBarrier(pNestedCmdBuffer);
+            result = pNestedCmdBuffer->End();
+        }
+
+        for (uint32 workloadIdx = 0;
+             (workloadIdx < static_cast<uint32>(Workload::Count)) && (result == Result::Success);
+             ++workloadIdx)
+        {
+            const Workload workload = static_cast<Workload>(workloadIdx);
+            Measurement*   pResult  = &pThread->results[engineIdx][workloadIdx];
+
+            for (uint32 iter = 0;
+                 (iter < pBench->iterations) && IsSupported(workload, engineIdx) && (result == Result::Success);
+                 ++iter)
+            {
+                result = pCmdBuffer->Reset(nullptr, true);
+
+                const int64 startTicks = GetPerfCpuTime();
+
+                if (result == Result::Success)
+                {
+                    result = pCmdBuffer->Begin(buildInfo);
+                }
+
+                if (result == Result::Success)
+                {
+                    BindWorkloadState(*pBench, workload, pCmdBuffer);
+
+                    for (uint32 cmdIdx = 0; cmdIdx < CmdsPerCmdBuffer; ++cmdIdx)
+                    {
+                        pResult->cmdCount += RecordCmd(workload,
+                                                       pCmdBuffer,
+                                                       pNestedCmdBuffer,
+                                                       *pThread->pScratchMem,
+                                                       cmdIdx);
+                    }
+
+                    result = pCmdBuffer->End();
+                }
+
+                pResult->ticks    += (GetPerfCpuTime() - startTicks);
+                pResult->pm4Bytes += pCmdBuffer->GetUsedSize(CommandDataAlloc);
+            }
+        }
+
+        if (result != Result::Success)
+        {
+            fprintf(stderr,
+                    "Recording on the %s engine failed (%d).\n",
+                    EngineNames[engineIdx],
+                    static_cast<int32>(result));
+            pBench->failed = true;
+        }
+
+        DestroyCmdBuffer(pCmdBuffer);
+        DestroyCmdBuffer(pNestedCmdBuffer);
+    }
+}
+
+// =====================================================================================================================
+IGpuMemory* CreateScratchMemory(
+    IDevice* pDevice)
+{
+    GpuMemoryCreateInfo createInfo = {};
+    createInfo.size      = ScratchMemSize;
+    createInfo.vaRange   = VaRange::Default;
+    createInfo.heapCount = 1;
+    createInfo.heaps[0]  = GpuHeapLocal;
+    createInfo.priority  = GpuMemPriority::Normal;
+
+    Result      result  = Result::Success;
+    IGpuMemory* pGpuMem = nullptr;
+    void*       pMemory = malloc(pDevice->GetGpuMemorySize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory != nullptr))
+    {
+        result = pDevice->CreateGpuMemory(createInfo, pMemory, &pGpuMem);
+    }
+
+    if (result != Result::Success)
+    {
+        free(pMemory);
+        pGpuMem = nullptr;
+    }
+
+    return pGpuMem;
+}
+
+// =====================================================================================================================
+ICmdAllocator* CreateCmdAllocator(
+    IDevice* pDevice)
+{
+    CmdAllocatorCreateInfo createInfo = {};
+    createInfo.flags.threadSafe      = 1;
+    createInfo.flags.autoMemoryReuse = 1;
+
+    for (uint32 type = 0; type < CmdAllocatorTypeCount; ++type)
+    {
+        createInfo.allocInfo[type].allocHeap    = (type == GpuScratchMemAlloc) ? GpuHeapInvisible : GpuHeapGartUswc;
+        createInfo.allocInfo[type].allocSize    = AllocSize;
+        createInfo.allocInfo[type].suballocSize = SuballocSize;
+    }
+
+    Result         result        = Result::Success;
+    ICmdAllocator* pCmdAllocator = nullptr;
+    void*          pMemory       = malloc(pDevice->GetCmdAllocatorSize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory != nullptr))
+    {
+        result = pDevice->CreateCmdAllocator(createInfo, pMemory, &pCmdAllocator);
+    }
+
+    if (result != Result::Success)
+    {
+        free(pMemory);
+        pCmdAllocator = nullptr;
+    }
+
+    return pCmdAllocator;
+}
+
+// =====================================================================================================================
+// Picks the RPM pipelines the draw and dispatch workloads bind and creates the state objects the draws need.
+Result CreateDrawState(
+    Device*       pDevice,
+    BenchContext* pBench)
+{
+    const RsrcProcMgr& rsrcProcMgr = pDevice->GetGfxDevice()->RsrcProcMgr();
+
+    pBench->pGfxPipeline     = rsrcProcMgr.GetGfxPipeline(SlowColorClear0_32ABGR);
+    pBench->pComputePipeline = rsrcProcMgr.GetPipeline(RpmComputePipeline::FillMem4xDword);
+    pBench->pMsaaState       = rsrcProcMgr.GetMsaaState(1, 1);
+
+    Result result = ((pBench->pGfxPipeline     != nullptr) &&
+                     (pBench->pComputePipeline != nullptr) &&
+                     (pBench->pMsaaState       != nullptr)) ? Result::Success : Result::ErrorUnavailable;
+
+    // Blending and depth testing are left disabled.
+    const ColorBlendStateCreateInfo   blendInfo = {};
+    const DepthStencilStateCreateInfo depthInfo = {};
+
+    void* pBlendMemory = nullptr;
+    void* pDepthMemory = nullptr;
+
+    if (result == Result::Success)
+    {
+        pBlendMemory = malloc(pDevice->GetColorBlendStateSize(blendInfo, &result));
+        result       = ((result == Result::Success) && (pBlendMemory == nullptr)) ? Result::ErrorOutOfMemory : result;
+    }
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CreateColorBlendState(blendInfo, pBlendMemory, &pBench->pColorBlendState);
+    }
+
+    if (result == Result::Success)
+    {
+        pDepthMemory = malloc(pDevice->GetDepthStencilStateSize(depthInfo, &result));
+        result       = ((result == Result::Success) && (pDepthMemory == nullptr)) ? Result::ErrorOutOfMemory : result;
+    }
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CreateDepthStencilState(depthInfo, pDepthMemory, &pBench->pDepthStencilState);
+    }
+
+    // The state objects live at the start of their placement memory, so they are freed through them.
+    if (pBench->pColorBlendState == nullptr)
+    {
+        free(pBlendMemory);
+    }
+
+    if (pBench->pDepthStencilState == nullptr)
+    {
+        free(pDepthMemory);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+void DestroyDrawState(
+    BenchContext* pBench)
+{
+    if (pBench->pColorBlendState != nullptr)
+    {
+        pBench->pColorBlendState->Destroy();
+        free(pBench->pColorBlendState);
+    }
+
+    if (pBench->pDepthStencilState != nullptr)
+    {
+        pBench->pDepthStencilState->Destroy();
+        free(pBench->pDepthStencilState);
+    }
+}
+
+// =====================================================================================================================
+// Prints the per-engine, per-workload results summed over all threads, then how often the threads found one of the
+// shared allocator's locks already held.
+void PrintResults(
+    const ThreadContext* pThreads,
+    uint32               threadCount,
+    const CmdAllocator&  cmdAllocator)
+{
+    const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+
+    printf("%-10s %-12s %14s %14s %14s\n", "engine", "workload", "commands", "ns/command", "PM4 bytes/cmd");
+
+    for (uint32 engineIdx = 0; engineIdx < EngineCount; ++engineIdx)
+    {
+        for (uint32 workloadIdx = 0; workloadIdx < static_cast<uint32>(Workload::Count); ++workloadIdx)
+        {
+            Measurement total = {};
+
+            for (uint32 threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+            {
+                const Measurement& result = pThreads[threadIdx].results[engineIdx][workloadIdx];
+
+                total.ticks    += result.ticks;
+                total.pm4Bytes += result.pm4Bytes;
+                total.cmdCount += result.cmdCount;
+            }
+
+            if (total.cmdCount > 0)
+            {
+                printf("%-10s %-12s %14u %14.1f %14.1f\n",
+                       EngineNames[engineIdx],
+                       WorkloadNames[workloadIdx],
+                       total.cmdCount,
+                       (static_cast<double>(total.ticks) * nsPerTick) / total.cmdCount,
+                       static_cast<double>(total.pm4Bytes) / total.cmdCount);
+            }
+        }
+    }
+
+    const CmdAllocator::LockStats* const pLockStats[] =
+    {
+        &cmdAllocator.ChunkLockStats(),
+        &cmdAllocator.LinearAllocLockStats(),
+    };
+    constexpr const char* LockNames[] = { "chunk", "linear-alloc" };
+
+    printf("\n%-14s %14s %14s %14s\n", "allocator lock", "acquires", "contended", "contended %");
+
+    for (uint32 lockIdx = 0; lockIdx < ArrayLen(LockNames); ++lockIdx)
+    {
+        const CmdAllocator::LockStats& stats = *pLockStats[lockIdx];
+
+        printf("%-14s %14llu %14llu %14.2f\n",
+               LockNames[lockIdx],
+               static_cast<unsigned long long>(stats.acquires),
+               static_cast<unsigned long long>(stats.contended),
+               (stats.acquires > 0) ? ((100.0 * stats.contended) / stats.acquires) : 0.0);
+    }
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 threadCount = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultThreadCount;
+    const uint32 iterations  = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultIterations;
+    const uint32 nullGpuId   = (argc > 3) ? static_cast<uint32>(strtoul(argv[3], nullptr, 0))
+                                          : static_cast<uint32>(NullGpuId::Navi10);
+
+    if ((threadCount == 0) || (threadCount > MaxThreads) || (iterations == 0))
+    {
+        fprintf(stderr, "Usage: %s [threadCount (1-%u)] [iterationCount] [nullGpuId]\n", argv[0], MaxThreads);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.pAllocCb               = &g_callbacks;
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    Platform* pPlatform       = nullptr;
+    void*     pPlatformMemory = malloc(GetPlatformSize());
+    Result    result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = Platform::Create(platformInfo, g_callbacks, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    Device* const pDevice = (result == Result::Success) ? static_cast<Device*>(pDevices[0]) : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+        finalizeInfo.requestedEngineCounts[EngineTypeCompute].engines   = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    BenchContext bench = {};
+    bench.pDevice    = pDevice;
+    bench.iterations = iterations;
+
+    if (result == Result::Success)
+    {
+        bench.pCmdAllocator = CreateCmdAllocator(pDevice);
+        result              = (bench.pCmdAllocator != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        result = CreateDrawState(pDevice, &bench);
+    }
+
+    // Value-initialize so that threads which were never set up have no scratch memory or results.
+    ThreadContext* const pThreads = new ThreadContext[threadCount]();
+    uint32               started  = 0;
+
+    for (uint32 threadIdx = 0; (threadIdx < threadCount) && (result == Result::Success); ++threadIdx)
+    {
+        pThreads[threadIdx].pBench      = &bench;
+        pThreads[threadIdx].pScratchMem = CreateScratchMemory(pDevice);
+
+        result = (pThreads[threadIdx].pScratchMem != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    for (; (started < threadCount) && (result == Result::Success); ++started)
+    {
+        result = pThreads[started].thread.Begin(&RecordingThread, &pThreads[started]);
+    }
+
+    for (uint32 threadIdx = 0; threadIdx < started; ++threadIdx)
+    {
+        pThreads[threadIdx].thread.Join();
+    }
+
+    if ((result == Result::Success) && (bench.failed == false))
+    {
+        printf("%u threads, %u iterations of %u commands per workload\n\n", threadCount, iterations, CmdsPerCmdBuffer);
+        PrintResults(pThreads, threadCount, *static_cast<CmdAllocator*>(bench.pCmdAllocator));
+    }
+    else
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    for (uint32 threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+    {
+        if (pThreads[threadIdx].pScratchMem != nullptr)
+        {
+            pThreads[threadIdx].pScratchMem->Destroy();
+            free(pThreads[threadIdx].pScratchMem);
+        }
+    }
+
+    delete[] pThreads;
+
+    DestroyDrawState(&bench);
+
+    if (bench.pCmdAllocator != nullptr)
+    {
+        bench.pCmdAllocator->Destroy();
+        free(bench.pCmdAllocator);
+    }
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return ((result == Result::Success) && (bench.failed == false)) ? 0 : 1;
+}
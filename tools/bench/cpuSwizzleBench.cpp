@@ -0,0 +1,551 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  cpuSwizzleBench.cpp
+ * @brief CPU swizzle copy verification and benchmark. Creates a set of optimal and linear images on a null device and
+ *        round-trips every subresource through IImage::CpuCopyMemoryToImage() and IImage::CpuCopyImageToMemory()
+ *        using a system memory stand-in for the mapped image. Each copy must touch exactly as many image bytes as the
+ *        region holds and must stay within the image's memory size. Afterwards the upload and download throughput of
+ *        a large image is reported.
+ *
+ * Usage: palCpuSwizzleBench [iterations] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "palFormatInfo.h"
+#include "palImage.h"
+#include "palLib.h"
+#include "palPlatform.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultIterations = 20;
+constexpr size_t GuardBytes        = 4096;  // Bytes past the end of the image memory which must never be written.
+constexpr uint32 BenchImageSize    = 2048;  // Width and height of the throughput benchmark images.
+
+// Describes one image the round trip is verified on.
+struct ImageConfig
+{
+    const char* pName;
+    ImageType   imageType;
+    ChNumFormat format;
+    ImageTiling tiling;
+    Extent3d    extent;
+    uint32      mipLevels;
+    uint32      arraySize;
+};
+
+// The odd sizes give partial swizzle blocks at the image edges and send the smaller mip levels into the mip tail.
+const ImageConfig VerifyConfigs[] =
+{
+    { "2d r8",        ImageType::Tex2d, ChNumFormat::X8_Unorm,           ImageTiling::Optimal, { 130, 17, 1 }, 8, 1 },
+    { "2d rgba8",     ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     ImageTiling::Optimal, {  67, 45, 1 }, 7, 3 },
+    { "2d rgba16f",   ImageType::Tex2d, ChNumFormat::X16Y16Z16W16_Float, ImageTiling::Optimal, {  33, 70, 1 }, 7, 2 },
+    { "2d rgba32",    ImageType::Tex2d, ChNumFormat::X32Y32Z32W32_Uint,  ImageTiling::Optimal, {  29, 31, 1 }, 5, 1 },
+    { "2d bc1",       ImageType::Tex2d, ChNumFormat::Bc1_Unorm,          ImageTiling::Optimal, {  60, 36, 1 }, 6, 2 },
+    { "3d rgba8",     ImageType::Tex3d, ChNumFormat::X8Y8Z8W8_Unorm,     ImageTiling::Optimal, {  19, 23, 9 }, 5, 1 },
+    { "2d rgba8 lin", ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     ImageTiling::Linear,  {  67, 45, 1 }, 7, 2 },
+    { "2d rgb32 lin", ImageType::Tex2d, ChNumFormat::X32Y32Z32_Float,    ImageTiling::Linear,  {  21, 13, 1 }, 1, 1 },
+};
+
+const ImageConfig BenchConfigs[] =
+{
+    { "rgba8",     ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm, ImageTiling::Optimal,
+      { BenchImageSize, BenchImageSize, 1 }, 1, 1 },
+    { "rgba8 lin", ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm, ImageTiling::Linear,
+      { BenchImageSize, BenchImageSize, 1 }, 1, 1 },
+    { "bc1",       ImageType::Tex2d, ChNumFormat::Bc1_Unorm,      ImageTiling::Optimal,
+      { BenchImageSize, BenchImageSize, 1 }, 1, 1 },
+};
+
+// An image created from an ImageConfig along with the system memory which stands in for its mapped GPU memory.
+struct TestImage
+{
+    IImage* pImage;
+    void*   pImageData;     // imageSize bytes followed by GuardBytes guard bytes.
+    gpusize imageSize;
+};
+
+// =====================================================================================================================
+// Creates the image described by the given config and allocates the memory its data is copied to and from.
+Result CreateTestImage(
+    IDevice*           pDevice,
+    const ImageConfig& config,
+    TestImage*         pTestImage)
+{
+    ImageCreateInfo createInfo = {};
+    createInfo.usageFlags.shaderRead = 1;
+    createInfo.imageType             = config.imageType;
+    createInfo.swizzledFormat.format = config.format;
+    createInfo.swizzledFormat.swizzle = { ChannelSwizzle::X, ChannelSwizzle::Y, ChannelSwizzle::Z, ChannelSwizzle::W };
+    createInfo.extent                = config.extent;
+    createInfo.mipLevels             = config.mipLevels;
+    createInfo.arraySize             = config.arraySize;
+    createInfo.samples               = 1;
+    createInfo.fragments             = 1;
+    createInfo.tiling                = config.tiling;
+    createInfo.metadataMode          = MetadataMode::Disabled;
+
+    Result       result        = Result::Success;
+    const size_t objectSize    = pDevice->GetImageSize(createInfo, &result);
+    void*        pObjectMemory = nullptr;
+
+    if (result == Result::Success)
+    {
+        pObjectMemory = malloc(objectSize);
+        result        = (pObjectMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CreateImage(createInfo, pObjectMemory, &pTestImage->pImage);
+    }
+
+    if (result == Result::Success)
+    {
+        GpuMemoryRequirements memReqs = {};
+        pTestImage->pImage->GetGpuMemoryRequirements(&memReqs);
+
+        pTestImage->imageSize  = memReqs.size;
+        pTestImage->pImageData = malloc(static_cast<size_t>(memReqs.size) + GuardBytes);
+        result                 = (pTestImage->pImageData != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+    else
+    {
+        free(pObjectMemory);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+void DestroyTestImage(
+    TestImage* pTestImage)
+{
+    if (pTestImage->pImage != nullptr)
+    {
+        pTestImage->pImage->Destroy();
+        free(pTestImage->pImage);
+    }
+
+    free(pTestImage->pImageData);
+}
+
+// =====================================================================================================================
+// Builds a copy region covering the given part of a subresource with tightly packed linear data. Returns the linear
+// data size in bytes.
+size_t MakeRegion(
+    const ImageCreateInfo& createInfo,
+    SubresId               subresId,
+    const Offset3d&        offset,
+    const Extent3d&        extent,
+    MemoryImageCopyRegion* pRegion)
+{
+    const ChNumFormat format = createInfo.swizzledFormat.format;
+
+    Extent3d elements = extent;
+
+    if (Formats::IsBlockCompressed(format))
+    {
+        elements = Formats::CompressedTexelsToBlocks(format, extent.width, extent.height, extent.depth);
+    }
+
+    const bool   is3d     = (createInfo.imageType == ImageType::Tex3d);
+    const uint32 numDepth = is3d ? extent.depth : 1;
+
+    memset(pRegion, 0, sizeof(*pRegion));
+    pRegion->imageSubres         = subresId;
+    pRegion->imageOffset         = offset;
+    pRegion->imageExtent         = extent;
+    pRegion->numSlices           = 1;
+    pRegion->gpuMemoryRowPitch   = elements.width * Formats::BytesPerPixel(format);
+    pRegion->gpuMemoryDepthPitch = pRegion->gpuMemoryRowPitch * elements.height;
+
+    return static_cast<size_t>(pRegion->gpuMemoryDepthPitch * numDepth);
+}
+
+// =====================================================================================================================
+// Fills the given buffer with a pseudo-random pattern.
+void FillPattern(
+    void*  pData,
+    size_t size,
+    uint32 seed)
+{
+    uint8* const pBytes = static_cast<uint8*>(pData);
+    uint32       state  = (seed * 2654435761u) | 1;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        // Xorshift32
+        state    ^= (state << 13);
+        state    ^= (state >> 17);
+        state    ^= (state << 5);
+        pBytes[i] = static_cast<uint8>(state >> 24);
+    }
+}
+
+// =====================================================================================================================
+// Returns the number of non-zero bytes in the given buffer.
+size_t CountNonZero(
+    const void* pData,
+    size_t      size)
+{
+    const uint8* const pBytes = static_cast<const uint8*>(pData);
+    size_t             count  = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        count += (pBytes[i] != 0) ? 1 : 0;
+    }
+
+    return count;
+}
+
+// =====================================================================================================================
+// Verifies one region of a test image. Writing an all-ones region into zeroed image memory must set exactly as many
+// image bytes as the region holds, which proves that no two elements share an address, and the guard bytes past the
+// image must stay zero. A random pattern must then survive the trip into the image and back.
+Result VerifyRegion(
+    const TestImage&             testImage,
+    const MemoryImageCopyRegion& region,
+    size_t                       linearSize,
+    void*                        pLinear,
+    void*                        pReadback)
+{
+    const IImage& image     = *testImage.pImage;
+    const size_t  imageSize = static_cast<size_t>(testImage.imageSize);
+
+    memset(testImage.pImageData, 0, imageSize + GuardBytes);
+    memset(pLinear, 0xFF, linearSize);
+
+    Result result = image.CpuCopyMemoryToImage(region, pLinear, testImage.pImageData, testImage.imageSize);
+
+    if ((result == Result::Success) &&
+        ((CountNonZero(testImage.pImageData, imageSize) != linearSize) ||
+         (CountNonZero(VoidPtrInc(testImage.pImageData, imageSize), GuardBytes) != 0)))
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    if (result == Result::Success)
+    {
+        FillPattern(pLinear, linearSize, region.imageSubres.mipLevel ^ (region.imageSubres.arraySlice << 8));
+        memset(pReadback, 0, linearSize);
+
+        result = image.CpuCopyMemoryToImage(region, pLinear, testImage.pImageData, testImage.imageSize);
+    }
+
+    if (result == Result::Success)
+    {
+        result = image.CpuCopyImageToMemory(region, testImage.pImageData, testImage.imageSize, pReadback);
+    }
+
+    if ((result == Result::Success) && (memcmp(pLinear, pReadback, linearSize) != 0))
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    // A mapping which is too small for the image must be rejected before anything is written.
+    if ((result == Result::Success) &&
+        (image.CpuCopyMemoryToImage(region, pLinear, testImage.pImageData, testImage.imageSize - 1) !=
+         Result::ErrorInvalidMemorySize))
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Round-trips every subresource of the image described by the given config, once in full and once through a region
+// which starts at an offset. Returns the number of regions verified through pRegionCount.
+Result VerifyImage(
+    IDevice*           pDevice,
+    const ImageConfig& config,
+    uint32*            pRegionCount)
+{
+    TestImage testImage = {};
+    Result    result    = CreateTestImage(pDevice, config, &testImage);
+
+    const ImageCreateInfo* pCreateInfo = (result == Result::Success) ? &testImage.pImage->GetImageCreateInfo()
+                                                                     : nullptr;
+
+    // The whole first mip level is the largest region.
+    MemoryImageCopyRegion region    = {};
+    const size_t          maxSize   = (result == Result::Success)
+                                      ? MakeRegion(*pCreateInfo, {}, {}, config.extent, &region) : 0;
+    void* const           pLinear   = malloc(maxSize);
+    void* const           pReadback = malloc(maxSize);
+
+    if ((pLinear == nullptr) || (pReadback == nullptr))
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    const bool     is3d     = (config.imageType == ImageType::Tex3d);
+    const Extent3d blockDim = Formats::IsBlockCompressed(config.format) ? Formats::CompressedBlockDim(config.format)
+                                                                        : Extent3d { 1, 1, 1 };
+
+    for (uint32 mip = 0; (mip < config.mipLevels) && (result == Result::Success); ++mip)
+    {
+        const Extent3d mipExtent =
+        {
+            Max(config.extent.width  >> mip, 1u),
+            Max(config.extent.height >> mip, 1u),
+            is3d ? Max(config.extent.depth >> mip, 1u) : 1u
+        };
+
+        for (uint32 slice = 0; (slice < config.arraySize) && (result == Result::Success); ++slice)
+        {
+            const SubresId subresId = { ImageAspect::Color, mip, slice };
+
+            // The offset region starts one element in and a third of the way down and covers the rest.
+            const Offset3d offset =
+            {
+                static_cast<int32>((mipExtent.width > blockDim.width) ? blockDim.width : 0),
+                static_cast<int32>(RoundDownToMultiple(mipExtent.height / 3, blockDim.height)),
+                static_cast<int32>(mipExtent.depth / 2)
+            };
+            const Extent3d offsetExtent =
+            {
+                mipExtent.width  - static_cast<uint32>(offset.x),
+                mipExtent.height - static_cast<uint32>(offset.y),
+                mipExtent.depth  - static_cast<uint32>(offset.z)
+            };
+
+            size_t linearSize = MakeRegion(*pCreateInfo, subresId, {}, mipExtent, &region);
+            result            = VerifyRegion(testImage, region, linearSize, pLinear, pReadback);
+
+            if (result == Result::Success)
+            {
+                linearSize = MakeRegion(*pCreateInfo, subresId, offset, offsetExtent, &region);
+                result     = VerifyRegion(testImage, region, linearSize, pLinear, pReadback);
+            }
+
+            if (result == Result::Success)
+            {
+                *pRegionCount += 2;
+            }
+            else
+            {
+                fprintf(stderr, "%s: mip %u slice %u failed (%d)\n", config.pName, mip, slice,
+                        static_cast<int32>(result));
+            }
+        }
+    }
+
+    free(pLinear);
+    free(pReadback);
+    DestroyTestImage(&testImage);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Measures the upload and download throughput of the first mip level of the image described by the given config, in
+// megabytes of linear data per second.
+Result MeasureImage(
+    IDevice*           pDevice,
+    const ImageConfig& config,
+    uint32             iterations,
+    double*            pUploadMbps,
+    double*            pDownloadMbps)
+{
+    TestImage testImage = {};
+    Result    result    = CreateTestImage(pDevice, config, &testImage);
+
+    const ImageCreateInfo* pCreateInfo = (result == Result::Success) ? &testImage.pImage->GetImageCreateInfo()
+                                                                     : nullptr;
+
+    MemoryImageCopyRegion region     = {};
+    const size_t          linearSize = (result == Result::Success)
+                                       ? MakeRegion(*pCreateInfo, {}, {}, config.extent, &region) : 0;
+    void* const           pLinear    = malloc(linearSize);
+
+    if (pLinear == nullptr)
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+    else
+    {
+        FillPattern(pLinear, linearSize, 1);
+    }
+
+    int64 uploadTicks   = 0;
+    int64 downloadTicks = 0;
+
+    for (uint32 iter = 0; (iter < iterations) && (result == Result::Success); ++iter)
+    {
+        const int64 startTicks = GetPerfCpuTime();
+
+        result = testImage.pImage->CpuCopyMemoryToImage(region, pLinear, testImage.pImageData, testImage.imageSize);
+
+        const int64 midTicks = GetPerfCpuTime();
+
+        if (result == Result::Success)
+        {
+            result = testImage.pImage->CpuCopyImageToMemory(region,
+                                                            testImage.pImageData,
+                                                            testImage.imageSize,
+                                                            pLinear);
+        }
+
+        const int64 endTicks = GetPerfCpuTime();
+
+        uploadTicks   += (midTicks - startTicks);
+        downloadTicks += (endTicks - midTicks);
+    }
+
+    const double bytes   = static_cast<double>(linearSize) * iterations;
+    const double seconds = 1.0 / static_cast<double>(GetPerfFrequency());
+
+    *pUploadMbps   = bytes / (static_cast<double>(uploadTicks)   * seconds * 1024.0 * 1024.0);
+    *pDownloadMbps = bytes / (static_cast<double>(downloadTicks) * seconds * 1024.0 * 1024.0);
+
+    free(pLinear);
+    DestroyTestImage(&testImage);
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 iterations = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultIterations;
+    const uint32 nullGpuId  = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0))
+                                         : static_cast<uint32>(NullGpuId::Navi10);
+
+    if (iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations] [nullGpuId]\n", argv[0]);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    IPlatform* pPlatform       = nullptr;
+    void*      pPlatformMemory = malloc(GetPlatformSize());
+    Result     result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = CreatePlatform(platformInfo, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    IDevice* const pDevice = (result == Result::Success) ? pDevices[0] : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    for (uint32 i = 0; (i < ArrayLen(VerifyConfigs)) && (result == Result::Success); ++i)
+    {
+        uint32 regionCount = 0;
+
+        result = VerifyImage(pDevice, VerifyConfigs[i], &regionCount);
+
+        if (result == Result::Success)
+        {
+            printf("%-14s %4u regions round-tripped\n", VerifyConfigs[i].pName, regionCount);
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        printf("\n%ux%u images, %u iterations; MiB/s of linear data\n\n", BenchImageSize, BenchImageSize, iterations);
+        printf("%-14s %10s %10s\n", "image", "upload", "download");
+    }
+
+    for (uint32 i = 0; (i < ArrayLen(BenchConfigs)) && (result == Result::Success); ++i)
+    {
+        double uploadMbps   = 0.0;
+        double downloadMbps = 0.0;
+
+        result = MeasureImage(pDevice, BenchConfigs[i], iterations, &uploadMbps, &downloadMbps);
+
+        if (result == Result::Success)
+        {
+            printf("%-14s %10.1f %10.1f\n", BenchConfigs[i].pName, uploadMbps, downloadMbps);
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
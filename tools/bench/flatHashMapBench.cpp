@@ -0,0 +1,195 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  flatHashMapBench.cpp
+ * @brief Hash map benchmark. Compares HashMap against FlatHashMap with 64-bit keys at several sizes, reporting the cost
+ *        of inserts, lookups that hit, lookups that miss and erases. Both maps are created with the same initial
+ *        size, so maps which outgrow it show how each container copes.
+ *
+ * Usage: palFlatHashMapBench [initialSize]
+ ***********************************************************************************************************************
+ */
+
+#include "palFlatHashMapImpl.h"
+#include "palHashMapImpl.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultInitialSize = 1024;
+constexpr uint32 EntryCounts[]      = { 1000, 100000, 1000000 };
+
+// Time taken by one map for each kind of operation, in nanoseconds per operation.
+struct Measurement
+{
+    double insert;
+    double hit;
+    double miss;
+    double erase;
+};
+
+// =====================================================================================================================
+// Builds the key of an entry. Odd keys are never inserted, so they are used for misses.
+uint64 MakeKey(
+    uint32 index)
+{
+    uint64 key = (static_cast<uint64>(index) << 1) * 0x9E3779B97F4A7C15ull;
+
+    return key & ~1ull;
+}
+
+// =====================================================================================================================
+// Runs every operation over entryCount entries on a freshly initialized map.
+template <typename MapType>
+Result MeasureMap(
+    MapType*     pMap,
+    uint32       entryCount,
+    Measurement* pMeasurement)
+{
+    const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+
+    Result result = pMap->Init();
+    uint64 found  = 0;
+
+    int64 startTicks = GetPerfCpuTime();
+
+    for (uint32 i = 0; (i < entryCount) && (result == Result::Success); ++i)
+    {
+        result = pMap->Insert(MakeKey(i), i);
+    }
+
+    pMeasurement->insert = (static_cast<double>(GetPerfCpuTime() - startTicks) * nsPerTick) / entryCount;
+
+    // Look keys up in a different order than they were inserted in.
+    startTicks = GetPerfCpuTime();
+
+    for (uint32 i = 0; i < entryCount; ++i)
+    {
+        found += (pMap->FindKey(MakeKey((i * 7919u) % entryCount)) != nullptr) ? 1 : 0;
+    }
+
+    pMeasurement->hit = (static_cast<double>(GetPerfCpuTime() - startTicks) * nsPerTick) / entryCount;
+
+    startTicks = GetPerfCpuTime();
+
+    for (uint32 i = 0; i < entryCount; ++i)
+    {
+        found += (pMap->FindKey(MakeKey(i) | 1) != nullptr) ? 1 : 0;
+    }
+
+    pMeasurement->miss = (static_cast<double>(GetPerfCpuTime() - startTicks) * nsPerTick) / entryCount;
+
+    startTicks = GetPerfCpuTime();
+
+    for (uint32 i = 0; i < entryCount; ++i)
+    {
+        found += pMap->Erase(MakeKey(i)) ? 1 : 0;
+    }
+
+    pMeasurement->erase = (static_cast<double>(GetPerfCpuTime() - startTicks) * nsPerTick) / entryCount;
+
+    // Every key is found once by the hit pass and once by the erase pass.
+    if ((result == Result::Success) && (found != (2ull * entryCount)))
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 initialSize = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultInitialSize;
+
+    if (initialSize == 0)
+    {
+        fprintf(stderr, "Usage: %s [initialSize]\n", argv[0]);
+        return 1;
+    }
+
+    GenericAllocator allocator;
+    Result           result = Result::Success;
+
+    printf("Both maps start sized for %u entries; times in ns/op\n\n", initialSize);
+    printf("%-12s %10s %10s %10s %10s %10s\n", "map", "entries", "insert", "hit", "miss", "erase");
+
+    for (uint32 i = 0; (i < (sizeof(EntryCounts) / sizeof(EntryCounts[0]))) && (result == Result::Success); ++i)
+    {
+        Measurement hashMap     = {};
+        Measurement flatHashMap = {};
+
+        {
+            HashMap<uint64, uint32, GenericAllocator, JenkinsHashFunc> map(initialSize, &allocator);
+
+            result = MeasureMap(&map, EntryCounts[i], &hashMap);
+        }
+
+        if (result == Result::Success)
+        {
+            FlatHashMap<uint64, uint32, GenericAllocator, JenkinsHashFunc> map(initialSize, &allocator);
+
+            result = MeasureMap(&map, EntryCounts[i], &flatHashMap);
+        }
+
+        if (result == Result::Success)
+        {
+            printf("%-12s %10u %10.1f %10.1f %10.1f %10.1f\n",
+                   "HashMap",
+                   EntryCounts[i],
+                   hashMap.insert,
+                   hashMap.hit,
+                   hashMap.miss,
+                   hashMap.erase);
+            printf("%-12s %10u %10.1f %10.1f %10.1f %10.1f\n",
+                   "FlatHashMap",
+                   EntryCounts[i],
+                   flatHashMap.insert,
+                   flatHashMap.hit,
+                   flatHashMap.miss,
+                   flatHashMap.erase);
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  imageCreateBench.cpp
+ * @brief Image creation latency benchmark. Creates and destroys images with and without metadata on a null device and
+ *        reports the average time per image. Each description is timed twice: once with a different extent for every
+ *        image, so that no layout or meta equation can be reused, and once with the same extent every time, which is
+ *        what an application recreating its render targets sees.
+ *
+ * Usage: palImageCreateBench [iterations] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "palImage.h"
+#include "palLib.h"
+#include "palPlatform.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultIterations = 500;
+
+// Describes one kind of image whose creation is timed.
+struct ImageConfig
+{
+    const char* pName;
+    ChNumFormat format;
+    uint32      width;
+    uint32      height;
+    uint32      mipLevels;
+    uint32      samples;
+    bool        colorTarget;
+    bool        depthStencil;
+};
+
+const ImageConfig Configs[] =
+{
+    { "color rt (dcc)",      ChNumFormat::X8Y8Z8W8_Unorm,    1920, 1080,  1, 1, true,  false },
+    { "color rt 4x (cmask)", ChNumFormat::X8Y8Z8W8_Unorm,    1920, 1080,  1, 4, true,  false },
+    { "depth (htile)",       ChNumFormat::D32_Float_S8_Uint, 1920, 1080,  1, 1, false, true  },
+    { "texture mips",        ChNumFormat::X8Y8Z8W8_Srgb,     2048, 2048, 12, 1, false, false },
+};
+
+// =====================================================================================================================
+// Creates and immediately destroys one image of the given config, whose width is grown by widthDelta texels.
+Result CreateAndDestroyImage(
+    IDevice*           pDevice,
+    const ImageConfig& config,
+    uint32             widthDelta,
+    void*              pObjectMemory,
+    size_t             objectMemorySize)
+{
+    ImageCreateInfo createInfo = {};
+    createInfo.usageFlags.shaderRead   = 1;
+    createInfo.usageFlags.colorTarget  = config.colorTarget ? 1 : 0;
+    createInfo.usageFlags.depthStencil = config.depthStencil ? 1 : 0;
+    createInfo.imageType               = ImageType::Tex2d;
+    createInfo.swizzledFormat.format   = config.format;
+    createInfo.swizzledFormat.swizzle  = { ChannelSwizzle::X, ChannelSwizzle::Y, ChannelSwizzle::Z, ChannelSwizzle::W };
+    createInfo.extent                  = { config.width + widthDelta, config.height, 1 };
+    createInfo.mipLevels               = config.mipLevels;
+    createInfo.arraySize               = 1;
+    createInfo.samples                 = config.samples;
+    createInfo.fragments               = config.samples;
+    createInfo.tiling                  = ImageTiling::Optimal;
+
+    Result       result     = Result::Success;
+    const size_t objectSize = pDevice->GetImageSize(createInfo, &result);
+
+    if ((result == Result::Success) && (objectSize > objectMemorySize))
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    IImage* pImage = nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CreateImage(createInfo, pObjectMemory, &pImage);
+    }
+
+    if (result == Result::Success)
+    {
+        pImage->Destroy();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Returns the average time in nanoseconds it took to create and destroy one image of the given config. If
+// varyExtent is set, every image gets a different width.
+Result MeasureConfig(
+    IDevice*           pDevice,
+    const ImageConfig& config,
+    uint32             iterations,
+    bool               varyExtent,
+    void*              pObjectMemory,
+    size_t             objectMemorySize,
+    double*            pNsPerImage)
+{
+    Result result = Result::Success;
+
+    const int64 startTicks = GetPerfCpuTime();
+
+    for (uint32 iter = 0; (iter < iterations) && (result == Result::Success); ++iter)
+    {
+        result = CreateAndDestroyImage(pDevice, config, (varyExtent ? iter : 0), pObjectMemory, objectMemorySize);
+    }
+
+    const int64 endTicks = GetPerfCpuTime();
+
+    *pNsPerImage = (static_cast<double>(endTicks - startTicks) * 1.0e9) /
+                   (static_cast<double>(GetPerfFrequency()) * iterations);
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 iterations = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultIterations;
+    const uint32 nullGpuId  = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0))
+                                         : static_cast<uint32>(NullGpuId::Navi10);
+
+    if (iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations] [nullGpuId]\n", argv[0]);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    IPlatform* pPlatform       = nullptr;
+    void*      pPlatformMemory = malloc(GetPlatformSize());
+    Result     result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = CreatePlatform(platformInfo, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    IDevice* const pDevice = (result == Result::Success) ? pDevices[0] : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    // Every image is placed into the same object memory, so size it for the largest image object of any config.
+    size_t objectMemorySize = 0;
+
+    for (uint32 i = 0; (i < ArrayLen(Configs)) && (result == Result::Success); ++i)
+    {
+        ImageCreateInfo createInfo = {};
+        createInfo.usageFlags.shaderRead   = 1;
+        createInfo.usageFlags.colorTarget  = Configs[i].colorTarget ? 1 : 0;
+        createInfo.usageFlags.depthStencil = Configs[i].depthStencil ? 1 : 0;
+        createInfo.imageType               = ImageType::Tex2d;
+        createInfo.swizzledFormat.format   = Configs[i].format;
+        createInfo.extent                  = { Configs[i].width, Configs[i].height, 1 };
+        createInfo.mipLevels               = Configs[i].mipLevels;
+        createInfo.arraySize               = 1;
+        createInfo.samples                 = Configs[i].samples;
+        createInfo.fragments               = Configs[i].samples;
+
+        objectMemorySize = Max(objectMemorySize, pDevice->GetImageSize(createInfo, &result));
+    }
+
+    void* const pObjectMemory = (result == Result::Success) ? malloc(objectMemorySize) : nullptr;
+
+    if ((result == Result::Success) && (pObjectMemory == nullptr))
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%u images per measurement; ns per image created and destroyed\n\n", iterations);
+        printf("%-20s %12s %12s\n", "image", "new extent", "same extent");
+    }
+
+    for (uint32 i = 0; (i < ArrayLen(Configs)) && (result == Result::Success); ++i)
+    {
+        double newExtentNs  = 0.0;
+        double sameExtentNs = 0.0;
+
+        result = MeasureConfig(pDevice, Configs[i], iterations, true, pObjectMemory, objectMemorySize, &newExtentNs);
+
+        if (result == Result::Success)
+        {
+            result = MeasureConfig(pDevice,
+                                   Configs[i],
+                                   iterations,
+                                   false,
+                                   pObjectMemory,
+                                   objectMemorySize,
+                                   &sameExtentNs);
+        }
+
+        if (result == Result::Success)
+        {
+            printf("%-20s %12.0f %12.0f\n", Configs[i].pName, newExtentNs, sameExtentNs);
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    free(pObjectMemory);
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
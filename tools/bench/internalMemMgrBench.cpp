@@ -0,0 +1,301 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  internalMemMgrBench.cpp
+ * @brief InternalMemMgr churn benchmark. Keeps a working set of internal suballocations live on a null device and
+ *        randomly frees and replaces them, once with small allocations only (served by the slabs) and once with a
+ *        mix of small and larger ones (served by the pools' buddy allocators). Reports the CPU time per allocation
+ *        or free and the pool and slab statistics at the end of each run, which show how fragmented the pools got.
+ *
+ *        The memory manager is internal to PAL, so this creates the core platform directly rather than through
+ *        CreatePlatform(), which would wrap the devices in layer decorators.
+ *
+ * Usage: palInternalMemMgrBench [workingSetSize] [operationCount] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "core/device.h"
+#include "core/internalMemMgr.h"
+#include "core/platform.h"
+#include "palLib.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultWorkingSet  = 4096;
+constexpr uint32 DefaultOperations  = 1000000;
+constexpr uint32 SmallSizeMin       = 16;        // Small allocations are a random multiple of this up to SmallSizeMax
+constexpr uint32 SmallSizeMax       = 256;
+constexpr uint32 LargeSizeMin       = 1024;      // Larger allocations are a random multiple of this up to LargeSizeMax
+constexpr uint32 LargeSizeMax       = 64 * 1024;
+constexpr uint32 LargePercentage    = 20;        // Share of the mixed workload's allocations which are large
+
+// One live suballocation in the working set.
+struct Suballocation
+{
+    GpuMemory* pGpuMemory;
+    gpusize    offset;
+};
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMem)
+{
+    free(pMem);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+// Xorshift generator, so that every run replays the same sequence of operations.
+uint32 NextRandom(
+    uint32* pState)
+{
+    uint32 x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+
+    return x;
+}
+
+// =====================================================================================================================
+// Runs operationCount random frees and allocations over a working set of workingSetSize slots, then frees whatever
+// is left. Prints the average CPU time per operation and the memory manager's statistics from before the final frees.
+Result RunChurn(
+    Device*        pDevice,
+    Suballocation* pWorkingSet,
+    uint32         workingSetSize,
+    uint32         operationCount,
+    uint32         largePercentage,
+    const char*    pName)
+{
+    InternalMemMgr*const pMemMgr = pDevice->MemMgr();
+
+    GpuMemoryCreateInfo createInfo = {};
+    createInfo.alignment = SmallSizeMin;
+    createInfo.priority  = GpuMemPriority::Normal;
+    createInfo.vaRange   = VaRange::Default;
+    createInfo.heaps[0]  = GpuHeapGartUswc;
+    createInfo.heaps[1]  = GpuHeapGartCacheable;
+    createInfo.heapCount = 2;
+
+    GpuMemoryInternalCreateInfo internalInfo = {};
+    internalInfo.flags.alwaysResident = 1;
+
+    Result result = Result::Success;
+    uint32 random = 0x12345678;
+    int64  ticks  = 0;
+
+    for (uint32 op = 0; (op < operationCount) && (result == Result::Success); ++op)
+    {
+        Suballocation*const pSlot = &pWorkingSet[NextRandom(&random) % workingSetSize];
+
+        if (pSlot->pGpuMemory == nullptr)
+        {
+            const bool large = ((NextRandom(&random) % 100) < largePercentage);
+
+            createInfo.size = large ? (LargeSizeMin * (1 + (NextRandom(&random) % (LargeSizeMax / LargeSizeMin))))
+                                    : (SmallSizeMin * (1 + (NextRandom(&random) % (SmallSizeMax / SmallSizeMin))));
+
+            const int64 startTicks = GetPerfCpuTime();
+            result = pMemMgr->AllocateGpuMem(createInfo, internalInfo, false, &pSlot->pGpuMemory, &pSlot->offset);
+            ticks += GetPerfCpuTime() - startTicks;
+        }
+        else
+        {
+            const int64 startTicks = GetPerfCpuTime();
+            result = pMemMgr->FreeGpuMem(pSlot->pGpuMemory, pSlot->offset);
+            ticks += GetPerfCpuTime() - startTicks;
+
+            pSlot->pGpuMemory = nullptr;
+        }
+    }
+
+    InternalMemMgrStats stats = {};
+    pMemMgr->GetStats(&stats);
+
+    for (uint32 idx = 0; idx < workingSetSize; ++idx)
+    {
+        if (pWorkingSet[idx].pGpuMemory != nullptr)
+        {
+            const Result freeResult = pMemMgr->FreeGpuMem(pWorkingSet[idx].pGpuMemory, pWorkingSet[idx].offset);
+            result = (result == Result::Success) ? freeResult : result;
+
+            pWorkingSet[idx].pGpuMemory = nullptr;
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+        const double slabBytes = static_cast<double>(stats.numSlabs) * static_cast<double>(SlabSize);
+
+        printf("%-8s %10.1f %8u %10.1f %8u %8u %10u %10.1f\n",
+               pName,
+               (static_cast<double>(ticks) * nsPerTick) / operationCount,
+               stats.numPools,
+               static_cast<double>(stats.poolBytes) / (1024.0 * 1024.0),
+               stats.numBuddyAllocs,
+               stats.numSlabs,
+               stats.numSlabAllocs,
+               (stats.numSlabs > 0) ? ((100.0 * stats.slabBytesInUse) / slabBytes) : 0.0);
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 workingSetSize = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultWorkingSet;
+    const uint32 operationCount = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultOperations;
+    const uint32 nullGpuId      = (argc > 3) ? static_cast<uint32>(strtoul(argv[3], nullptr, 0))
+                                             : static_cast<uint32>(NullGpuId::Navi10);
+
+    if ((workingSetSize == 0) || (operationCount == 0))
+    {
+        fprintf(stderr, "Usage: %s [workingSetSize] [operationCount] [nullGpuId]\n", argv[0]);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.pAllocCb               = &g_callbacks;
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    Platform* pPlatform       = nullptr;
+    void*     pPlatformMemory = malloc(GetPlatformSize());
+    Result    result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = Platform::Create(platformInfo, g_callbacks, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    Device* const pDevice = (result == Result::Success) ? static_cast<Device*>(pDevices[0]) : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    Suballocation* const pWorkingSet = static_cast<Suballocation*>(calloc(workingSetSize, sizeof(Suballocation)));
+
+    result = ((result == Result::Success) && (pWorkingSet == nullptr)) ? Result::ErrorOutOfMemory : result;
+
+    if (result == Result::Success)
+    {
+        printf("%u live suballocations, %u operations per run\n\n", workingSetSize, operationCount);
+        printf("%-8s %10s %8s %10s %8s %8s %10s %10s\n",
+               "workload",
+               "ns/op",
+               "pools",
+               "pool MiB",
+               "buddy",
+               "slabs",
+               "slab allocs",
+               "slab fill%");
+    }
+
+    if (result == Result::Success)
+    {
+        result = RunChurn(pDevice, pWorkingSet, workingSetSize, operationCount, 0, "small");
+    }
+
+    if (result == Result::Success)
+    {
+        result = RunChurn(pDevice, pWorkingSet, workingSetSize, operationCount, LargePercentage, "mixed");
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    free(pWorkingSet);
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  memoryCacheBench.cpp
+ * @brief In-memory cache layer benchmark. Fills a memory cache layer and then queries it from several threads at once,
+ *        once with a single shard and once with the requested shard count, reporting the lookup throughput of each.
+ *        A mixed workload which stores a new entry every few lookups exercises eviction under contention.
+ *
+ * Usage: palMemoryCacheBench [threadCount] [lookupsPerThread] [numShards]
+ ***********************************************************************************************************************
+ */
+
+#include "palCacheLayer.h"
+#include "palInlineFuncs.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+#include "palThread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 MaxThreads         = 64;
+constexpr uint32 DefaultThreadCount = 8;
+constexpr uint32 DefaultLookups     = 1000000;
+constexpr uint32 DefaultNumShards   = 16;
+constexpr uint32 EntryCount         = 4096;      // Entries stored before the lookups start
+constexpr size_t EntrySize          = 256;
+constexpr uint32 StoreInterval      = 16;        // The mixed workload stores a new entry after this many lookups
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMemory)
+{
+    free(pMemory);
+}
+
+// State shared by all lookup threads.
+struct BenchContext
+{
+    ICacheLayer*  pCache;
+    uint32        lookups;
+    bool          mixed;     // Also store new entries, forcing evictions once the cache is full
+    volatile bool failed;
+};
+
+// State owned by one lookup thread.
+struct ThreadContext
+{
+    BenchContext* pBench;
+    uint32        threadIdx;
+    Thread        thread;
+    int64         ticks;
+    uint32        hits;
+};
+
+// =====================================================================================================================
+// Builds a well-distributed hash for the given entry index.
+Hash128 MakeHash(
+    uint32 index)
+{
+    Hash128 hash = {};
+    hash.dwords[0] = index * 2654435761u;
+    hash.dwords[1] = index;
+    hash.dwords[2] = ~index;
+
+    return hash;
+}
+
+// =====================================================================================================================
+// Body of each lookup thread: queries and loads entries in a per-thread order, storing new ones in the mixed workload.
+void LookupThread(
+    void* pParameter)
+{
+    ThreadContext* const pThread = static_cast<ThreadContext*>(pParameter);
+    BenchContext*  const pBench  = pThread->pBench;
+
+    uint8  data[EntrySize] = {};
+    Result result          = Result::Success;
+
+    const int64 startTicks = GetPerfCpuTime();
+
+    for (uint32 i = 0; (i < pBench->lookups) && (result == Result::Success); ++i)
+    {
+        const Hash128 hash  = MakeHash(((i * 7) + pThread->threadIdx) % EntryCount);
+        QueryResult   query = {};
+
+        if (pBench->pCache->Query(&hash, 0, 0, &query) == Result::Success)
+        {
+            result = pBench->pCache->Load(&query, data);
+            pThread->hits++;
+        }
+
+        if (pBench->mixed && ((i % StoreInterval) == 0))
+        {
+            const Hash128 newHash = MakeHash(EntryCount + (pThread->threadIdx * pBench->lookups) + i);
+
+            result = pBench->pCache->Store(&newHash, data, sizeof(data));
+        }
+    }
+
+    pThread->ticks = GetPerfCpuTime() - startTicks;
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Lookup thread %u failed (%d).\n", pThread->threadIdx, static_cast<int32>(result));
+        pBench->failed = true;
+    }
+}
+
+// =====================================================================================================================
+// Creates and fills a memory cache layer with the given shard count, then runs the lookup threads against it.
+Result RunCache(
+    uint32 numShards,
+    uint32 threadCount,
+    uint32 lookups,
+    bool   mixed)
+{
+    AllocCallbacks callbacks = {};
+    callbacks.pClientData = &callbacks;
+    callbacks.pfnAlloc    = &BenchAlloc;
+    callbacks.pfnFree     = &BenchFree;
+
+    MemoryCacheCreateInfo createInfo = {};
+    createInfo.baseInfo.pCallbacks = &callbacks;
+    createInfo.maxObjectCount      = EntryCount;
+    createInfo.maxMemorySize       = EntryCount * EntrySize;
+    createInfo.evictOnFull         = true;
+    createInfo.numShards           = numShards;
+
+    ICacheLayer* pCache  = nullptr;
+    void*        pMemory = malloc(GetMemoryCacheLayerSize(&createInfo));
+    Result       result  = (pMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = CreateMemoryCacheLayer(&createInfo, pMemory, &pCache);
+    }
+
+    uint8 data[EntrySize] = {};
+
+    for (uint32 i = 0; (i < EntryCount) && (result == Result::Success); ++i)
+    {
+        const Hash128 hash = MakeHash(i);
+
+        result = pCache->Store(&hash, data, sizeof(data));
+    }
+
+    BenchContext bench = {};
+    bench.pCache  = pCache;
+    bench.lookups = lookups;
+    bench.mixed   = mixed;
+
+    ThreadContext* const pThreads = new ThreadContext[threadCount]();
+    uint32               started  = 0;
+
+    const int64 startTicks = GetPerfCpuTime();
+
+    for (; (started < threadCount) && (result == Result::Success); ++started)
+    {
+        pThreads[started].pBench    = &bench;
+        pThreads[started].threadIdx = started;
+
+        result = pThreads[started].thread.Begin(&LookupThread, &pThreads[started]);
+    }
+
+    for (uint32 threadIdx = 0; threadIdx < started; ++threadIdx)
+    {
+        pThreads[threadIdx].thread.Join();
+    }
+
+    const int64 wallTicks = GetPerfCpuTime() - startTicks;
+
+    if ((result == Result::Success) && (bench.failed == false))
+    {
+        const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+
+        int64  threadTicks = 0;
+        uint64 hits        = 0;
+
+        for (uint32 threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+        {
+            threadTicks += pThreads[threadIdx].ticks;
+            hits        += pThreads[threadIdx].hits;
+        }
+
+        const double totalLookups = static_cast<double>(threadCount) * lookups;
+
+        printf("%-6s %6u %8u %14.1f %14.1f %9.1f%%\n",
+               mixed ? "mixed" : "hits",
+               numShards,
+               threadCount,
+               totalLookups / ((static_cast<double>(wallTicks) * nsPerTick) / 1000.0),
+               (static_cast<double>(threadTicks) * nsPerTick) / totalLookups,
+               (100.0 * hits) / totalLookups);
+    }
+    else
+    {
+        result = (result == Result::Success) ? Result::ErrorUnknown : result;
+    }
+
+    delete[] pThreads;
+
+    if (pCache != nullptr)
+    {
+        pCache->Destroy();
+    }
+
+    free(pMemory);
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 threadCount = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultThreadCount;
+    const uint32 lookups     = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultLookups;
+    const uint32 numShards   = (argc > 3) ? static_cast<uint32>(strtoul(argv[3], nullptr, 0)) : DefaultNumShards;
+
+    if ((threadCount == 0) || (threadCount > MaxThreads) || (lookups == 0))
+    {
+        fprintf(stderr, "Usage: %s [threadCount (1-%u)] [lookupsPerThread] [numShards]\n", argv[0], MaxThreads);
+        return 1;
+    }
+
+    printf("%-6s %6s %8s %14s %14s %10s\n", "load", "shards", "threads", "lookups/us", "ns/lookup", "hit rate");
+
+    Result result = Result::Success;
+
+    for (uint32 mixed = 0; (mixed < 2) && (result == Result::Success); ++mixed)
+    {
+        for (uint32 threads = 1; (threads <= threadCount) && (result == Result::Success); threads *= 2)
+        {
+            result = RunCache(1, threads, lookups, (mixed != 0));
+
+            if ((result == Result::Success) && (numShards > 1))
+            {
+                result = RunCache(numShards, threads, lookups, (mixed != 0));
+            }
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    return (result == Result::Success) ? 0 : 1;
+}
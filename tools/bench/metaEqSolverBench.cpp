@@ -0,0 +1,423 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  metaEqSolverBench.cpp
+ * @brief Meta equation solver verification and benchmark. Creates color, MSAA and depth images on a null device and,
+ *        for every mask-ram which has a meta equation, compares MetaDataAddrSolver against
+ *        MetaDataAddrEquation::CpuSolve() at every pixel, slice and sample of the image and at every metablock the
+ *        equation can address. Results are reported per swizzle mode, next to the throughput of both solvers.
+ *
+ *        The solver is internal to PAL, so this creates the core platform directly rather than through
+ *        CreatePlatform(), which would wrap the devices in layer decorators.
+ *
+ * Usage: palMetaEqSolverBench [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "core/device.h"
+#include "core/image.h"
+#include "core/platform.h"
+#include "core/hw/gfxip/gfx9/gfx9Image.h"
+#include "core/hw/gfxip/gfx9/gfx9MaskRam.h"
+#include "core/hw/gfxip/gfx9/gfx9MetaEq.h"
+#include "palLib.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Pal::Gfx9;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 MaxMetaBlockBits = 10;  // Limits the metablock sweep to the first 1024 metablocks.
+
+// Describes one image whose mask-rams are checked.
+struct ImageConfig
+{
+    const char* pName;
+    ImageType   imageType;
+    ChNumFormat format;
+    Extent3d    extent;
+    uint32      arraySize;
+    uint32      samples;
+    bool        depthStencil;
+};
+
+// The mix of formats, sample counts and dimensions makes AddrLib pick a range of swizzle modes.
+const ImageConfig Configs[] =
+{
+    { "r8",           ImageType::Tex2d, ChNumFormat::X8_Unorm,           {  200,  120, 1 }, 1, 1, false },
+    { "rgba8",        ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     {  256,  256, 1 }, 1, 1, false },
+    { "rgba8 large",  ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     { 1920, 1080, 1 }, 1, 1, false },
+    { "rgba8 array",  ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     {  128,  128, 1 }, 4, 1, false },
+    { "rgba16f",      ImageType::Tex2d, ChNumFormat::X16Y16Z16W16_Float, {  160,   96, 1 }, 1, 1, false },
+    { "rgba32",       ImageType::Tex2d, ChNumFormat::X32Y32Z32W32_Float, {   96,   64, 1 }, 1, 1, false },
+    { "rgba8 2x",     ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     {  128,   64, 1 }, 1, 2, false },
+    { "rgba8 4x",     ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     {  128,   64, 1 }, 1, 4, false },
+    { "rgba8 8x",     ImageType::Tex2d, ChNumFormat::X8Y8Z8W8_Unorm,     {  128,   64, 1 }, 1, 8, false },
+    { "rgba8 3d",     ImageType::Tex3d, ChNumFormat::X8Y8Z8W8_Unorm,     {   64,   64, 8 }, 1, 1, false },
+    { "d16",          ImageType::Tex2d, ChNumFormat::X16_Unorm,          {  256,  192, 1 }, 1, 1, true  },
+    { "d32",          ImageType::Tex2d, ChNumFormat::X32_Float,          {  256,  192, 1 }, 1, 1, true  },
+    { "d32s8",        ImageType::Tex2d, ChNumFormat::D32_Float_S8_Uint,  {  256,  192, 1 }, 1, 1, true  },
+    { "d32 4x array", ImageType::Tex2d, ChNumFormat::X32_Float,          {  128,   96, 1 }, 2, 4, true  },
+};
+
+// Totals for all of the equations generated for one swizzle mode.
+struct SwizzleStats
+{
+    uint32 equations;
+    uint64 coordinates;
+    uint64 mismatches;
+    int64  solverTicks;
+    int64  cpuSolveTicks;
+};
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMem)
+{
+    free(pMem);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+// Solves one row of coordinates with both solvers and counts the outputs which differ. pRow must hold "width" values.
+void CheckRow(
+    const MetaDataAddrEquation& equation,
+    const MetaDataAddrSolver&   solver,
+    uint32                      width,
+    uint32                      y,
+    uint32                      z,
+    uint32                      sample,
+    uint32                      metaBlock,
+    uint32*                     pRow,
+    SwizzleStats*               pStats)
+{
+    const int64 startTicks = GetPerfCpuTime();
+
+    solver.SolveRow(0, y, z, sample, metaBlock, width, pRow);
+
+    const int64 midTicks = GetPerfCpuTime();
+
+    for (uint32 x = 0; x < width; ++x)
+    {
+        if (pRow[x] != equation.CpuSolve(x, y, z, sample, metaBlock))
+        {
+            pStats->mismatches++;
+        }
+    }
+
+    const int64 endTicks = GetPerfCpuTime();
+
+    pStats->coordinates   += width;
+    pStats->solverTicks   += (midTicks - startTicks);
+    pStats->cpuSolveTicks += (endTicks - midTicks);
+}
+
+// =====================================================================================================================
+// Compares the solver against CpuSolve() for one mask-ram. Every pixel, slice and effective sample of the image is
+// checked in metablock zero, then the first row of every metablock the equation can address is checked too.
+Result CheckMaskRam(
+    const Gfx9MaskRam&     maskRam,
+    const ImageCreateInfo& createInfo,
+    SwizzleStats*          pStats)
+{
+    const Gfx9MetaEqGenerator&  generator = *maskRam.GetMetaEqGenerator();
+    const MetaDataAddrEquation& equation  = generator.GetMetaEquation();
+    const MetaDataAddrSolver    solver(equation);
+
+    const uint32 width     = createInfo.extent.width;
+    const uint32 numSlices = (createInfo.imageType == ImageType::Tex3d) ? createInfo.extent.depth
+                                                                        : createInfo.arraySize;
+    const uint32 numSamples = Max(generator.GetNumEffectiveSamples(), 1u);
+
+    uint32 metaBlockMask = 0;
+
+    for (uint32 bitPos = 0; bitPos < equation.GetNumValidBits(); ++bitPos)
+    {
+        metaBlockMask |= equation.Get(bitPos, MetaDataAddrCompM);
+    }
+
+    const uint32 numMetaBlockBits = (metaBlockMask != 0) ? Min(Log2(metaBlockMask) + 1, MaxMetaBlockBits) : 0;
+
+    uint32* const pRow   = static_cast<uint32*>(malloc(width * sizeof(uint32)));
+    Result        result = (pRow != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        if (solver.MatchesCpuSolve(equation) == false)
+        {
+            pStats->mismatches++;
+        }
+
+        for (uint32 sample = 0; sample < numSamples; ++sample)
+        {
+            for (uint32 z = 0; z < numSlices; ++z)
+            {
+                for (uint32 y = 0; y < createInfo.extent.height; ++y)
+                {
+                    CheckRow(equation, solver, width, y, z, sample, 0, pRow, pStats);
+                }
+            }
+        }
+
+        for (uint32 metaBlock = 1; metaBlock < (1u << numMetaBlockBits); ++metaBlock)
+        {
+            CheckRow(equation, solver, width, 0, 0, 0, metaBlock, pRow, pStats);
+        }
+
+        pStats->equations++;
+    }
+
+    free(pRow);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Creates the image described by the given config and checks each of its mask-rams which has a meta equation.
+// Returns the number of mask-rams checked in pNumChecked.
+Result CheckImage(
+    Pal::Device*       pDevice,
+    const ImageConfig& config,
+    SwizzleStats*      pStats,
+    uint32*            pNumChecked)
+{
+    ImageCreateInfo createInfo = {};
+    createInfo.usageFlags.shaderRead   = 1;
+    createInfo.usageFlags.colorTarget  = config.depthStencil ? 0 : 1;
+    createInfo.usageFlags.depthStencil = config.depthStencil ? 1 : 0;
+    createInfo.imageType               = config.imageType;
+    createInfo.swizzledFormat.format   = config.format;
+    createInfo.swizzledFormat.swizzle  = { ChannelSwizzle::X, ChannelSwizzle::Y, ChannelSwizzle::Z, ChannelSwizzle::W };
+    createInfo.extent                  = config.extent;
+    createInfo.mipLevels               = 1;
+    createInfo.arraySize               = config.arraySize;
+    createInfo.samples                 = config.samples;
+    createInfo.fragments               = config.samples;
+    createInfo.tiling                  = ImageTiling::Optimal;
+
+    Result       result        = Result::Success;
+    const size_t objectSize    = pDevice->GetImageSize(createInfo, &result);
+    void* const  pObjectMemory = (result == Result::Success) ? malloc(objectSize) : nullptr;
+
+    if ((result == Result::Success) && (pObjectMemory == nullptr))
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    IImage* pImage = nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CreateImage(createInfo, pObjectMemory, &pImage);
+    }
+
+    *pNumChecked = 0;
+
+    if (result == Result::Success)
+    {
+        const auto& gfxImage = *static_cast<const Gfx9::Image*>(static_cast<Pal::Image*>(pImage)->GetGfxImage());
+
+        const Gfx9MaskRam* const pMaskRams[] =
+        {
+            gfxImage.GetHtile(),
+            gfxImage.HasColorMetaData() ? gfxImage.GetDcc(ImageAspect::Color) : nullptr,
+            gfxImage.GetCmask(),
+        };
+
+        for (uint32 idx = 0; (idx < ArrayLen(pMaskRams)) && (result == Result::Success); ++idx)
+        {
+            const Gfx9MaskRam* const pMaskRam = pMaskRams[idx];
+
+            if ((pMaskRam != nullptr)                &&
+                pMaskRam->HasMetaEqGenerator()       &&
+                pMaskRam->GetMetaEqGenerator()->IsMetaEquationValid())
+            {
+                const uint32 swizzleMode = static_cast<uint32>(pMaskRam->GetSwizzleMode());
+
+                if (swizzleMode < ADDR_SW_MAX_TYPE)
+                {
+                    result = CheckMaskRam(*pMaskRam, createInfo, &pStats[swizzleMode]);
+                    (*pNumChecked)++;
+                }
+            }
+        }
+
+        pImage->Destroy();
+    }
+
+    free(pObjectMemory);
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 nullGpuId = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0))
+                                        : static_cast<uint32>(NullGpuId::Navi10);
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.pAllocCb               = &g_callbacks;
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    Platform* pPlatform       = nullptr;
+    void*     pPlatformMemory = malloc(GetPlatformSize());
+    Result    result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = Platform::Create(platformInfo, g_callbacks, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    Pal::Device* const pDevice = (result == Result::Success) ? static_cast<Pal::Device*>(pDevices[0]) : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    // Meta equations only exist in the Gfx9 hardware layer, which also covers gfx10.
+    if ((result == Result::Success) && (pDevice->ChipProperties().gfxLevel < GfxIpLevel::GfxIp9))
+    {
+        fprintf(stderr, "Usage: %s [nullGpuId of a gfx9 or newer GPU]\n", argv[0]);
+        result = Result::ErrorUnavailable;
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    SwizzleStats stats[ADDR_SW_MAX_TYPE] = {};
+
+    for (uint32 i = 0; (i < ArrayLen(Configs)) && (result == Result::Success); ++i)
+    {
+        uint32 numChecked = 0;
+
+        result = CheckImage(pDevice, Configs[i], &stats[0], &numChecked);
+
+        if (result == Result::Success)
+        {
+            printf("%-14s %u mask-ram equation(s) checked\n", Configs[i].pName, numChecked);
+        }
+    }
+
+    uint64 mismatches = 0;
+
+    if (result == Result::Success)
+    {
+        const double ticksPerSec = static_cast<double>(GetPerfFrequency());
+
+        printf("\n%-10s %10s %14s %12s %14s %14s\n",
+               "swizzle", "equations", "coordinates", "mismatches", "solver Mc/s", "CpuSolve Mc/s");
+
+        for (uint32 swizzleMode = 0; swizzleMode < ADDR_SW_MAX_TYPE; ++swizzleMode)
+        {
+            const SwizzleStats& modeStats = stats[swizzleMode];
+
+            if (modeStats.equations > 0)
+            {
+                const double coordinates = static_cast<double>(modeStats.coordinates) / 1.0e6;
+
+                printf("%-10u %10u %14llu %12llu %14.1f %14.1f\n",
+                       swizzleMode,
+                       modeStats.equations,
+                       static_cast<unsigned long long>(modeStats.coordinates),
+                       static_cast<unsigned long long>(modeStats.mismatches),
+                       (coordinates * ticksPerSec) / static_cast<double>(Max<int64>(modeStats.solverTicks, 1)),
+                       (coordinates * ticksPerSec) / static_cast<double>(Max<int64>(modeStats.cpuSolveTicks, 1)));
+
+                mismatches += modeStats.mismatches;
+            }
+        }
+
+        if (mismatches > 0)
+        {
+            fprintf(stderr, "MetaDataAddrSolver disagrees with CpuSolve() on %llu coordinate(s).\n",
+                    static_cast<unsigned long long>(mismatches));
+            result = Result::ErrorUnknown;
+        }
+    }
+    else
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  metadataBench.cpp
+ * @brief Pipeline metadata decode benchmark. Reads the PAL metadata of the real compute pipeline ELFs which ship with
+ *        GpuUtil, once by fully decoding it with GetMetadata and once through the lazily-decoded metadata view, and
+ *        reports the CPU time each approach costs per pipeline.
+ *
+ * Usage: palMetadataBench [iterations]
+ ***********************************************************************************************************************
+ */
+
+#include "palPipelineAbiReader.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include "mlaa/g_mlaaComputePipelineBinaries.h"
+#include "timeGraph/g_timeGraphComputePipelineBinaries.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Util;
+using namespace Util::Abi;
+
+namespace
+{
+
+constexpr uint32 DefaultIterations = 10000;
+
+// A named group of pipeline ELFs.
+struct BinaryTable
+{
+    const char* pName;
+    const void* pTable;      // Array of PipelineBinary structures from one of the generated binary headers.
+    size_t      entrySize;   // Size of one entry of pTable, in bytes.
+    uint32      count;
+};
+
+// Both generated headers declare the same PipelineBinary layout in their own namespaces.
+static_assert(sizeof(GpuUtil::Mlaa::PipelineBinary) == sizeof(GpuUtil::TimeGraphDraw::PipelineBinary),
+              "The generated PipelineBinary structures must match.");
+
+// =====================================================================================================================
+// Describes one of the generated pipeline binary tables.
+template <typename PipelineBinary, size_t Count>
+constexpr BinaryTable MakeTable(
+    const char*          pName,
+    const PipelineBinary (&table)[Count])
+{
+    return { pName, table, sizeof(PipelineBinary), static_cast<uint32>(Count) };
+}
+
+const BinaryTable Tables[] =
+{
+    MakeTable("mlaa gfx9",       GpuUtil::Mlaa::mlaaComputeBinaryTableVega10),
+    MakeTable("mlaa gfx10",      GpuUtil::Mlaa::mlaaComputeBinaryTableNavi10),
+    MakeTable("timeGraph gfx9",  GpuUtil::TimeGraphDraw::timeGraphComputeBinaryTableVega10),
+    MakeTable("timeGraph gfx10", GpuUtil::TimeGraphDraw::timeGraphComputeBinaryTableNavi10),
+};
+
+// Time taken by each step of reading one pipeline's metadata, in nanoseconds per pipeline.
+struct Measurement
+{
+    double elfInit;     // Constructing and initializing the PipelineAbiReader.
+    double fullDecode;  // GetMetadata, which is what pipeline creation does.
+    double viewIndex;   // GetMetadataView.
+    double viewStage;   // GetMetadataView followed by decoding the compute stage.
+};
+
+// =====================================================================================================================
+// Reads the metadata of every pipeline in the given table the given number of times, one step at a time.
+Result MeasureTable(
+    GenericAllocator*  pAllocator,
+    const BinaryTable& table,
+    uint32             iterations,
+    Measurement*       pMeasurement)
+{
+    const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+    const double count     = static_cast<double>(iterations) * table.count;
+
+    Result result = Result::Success;
+    int64  ticks[4] = { };
+
+    for (uint32 iter = 0; (iter < iterations) && (result == Result::Success); ++iter)
+    {
+        for (uint32 i = 0; (i < table.count) && (result == Result::Success); ++i)
+        {
+            const auto& binary = *static_cast<const GpuUtil::Mlaa::PipelineBinary*>(
+                                    VoidPtrInc(table.pTable, i * table.entrySize));
+
+            int64 startTicks = GetPerfCpuTime();
+
+            PipelineAbiReader abiReader(pAllocator, binary.pBuffer);
+            result = abiReader.Init();
+
+            int64 endTicks = GetPerfCpuTime();
+            ticks[0]      += (endTicks - startTicks);
+
+            MsgPackReader         metadataReader;
+            PalCodeObjectMetadata metadata;
+
+            if (result == Result::Success)
+            {
+                startTicks = GetPerfCpuTime();
+                result     = abiReader.GetMetadata(&metadataReader, &metadata);
+                endTicks   = GetPerfCpuTime();
+                ticks[1]  += (endTicks - startTicks);
+            }
+
+            PipelineMetadataView metadataView;
+
+            if (result == Result::Success)
+            {
+                startTicks = GetPerfCpuTime();
+                result     = abiReader.GetMetadataView(&metadataReader, &metadataView);
+                endTicks   = GetPerfCpuTime();
+                ticks[2]  += (endTicks - startTicks);
+            }
+
+            if (result == Result::Success)
+            {
+                HardwareStageMetadata stageMetadata;
+
+                startTicks = GetPerfCpuTime();
+                result     = abiReader.GetMetadataView(&metadataReader, &metadataView);
+
+                if (result == Result::Success)
+                {
+                    result = metadataView.GetHardwareStage(&metadataReader, HardwareStage::Cs, &stageMetadata);
+                }
+
+                endTicks  = GetPerfCpuTime();
+                ticks[3] += (endTicks - startTicks);
+            }
+        }
+    }
+
+    pMeasurement->elfInit    = (static_cast<double>(ticks[0]) * nsPerTick) / count;
+    pMeasurement->fullDecode = (static_cast<double>(ticks[1]) * nsPerTick) / count;
+    pMeasurement->viewIndex  = (static_cast<double>(ticks[2]) * nsPerTick) / count;
+    pMeasurement->viewStage  = (static_cast<double>(ticks[3]) * nsPerTick) / count;
+
+    return result;
+}
+
+// =====================================================================================================================
+// Returns the average size of the pipeline ELFs in the given table, in bytes.
+size_t AverageElfSize(
+    const BinaryTable& table)
+{
+    size_t totalSize = 0;
+
+    for (uint32 i = 0; i < table.count; ++i)
+    {
+        totalSize += static_cast<const GpuUtil::Mlaa::PipelineBinary*>(
+                        VoidPtrInc(table.pTable, i * table.entrySize))->size;
+    }
+
+    return totalSize / table.count;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 iterations = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultIterations;
+
+    if (iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    GenericAllocator allocator;
+    Result           result = Result::Success;
+
+    printf("%u iterations over each table; times in ns/pipeline\n\n", iterations);
+    printf("%-16s %6s %10s %10s %10s %10s %10s\n",
+           "ELFs",
+           "count",
+           "avg bytes",
+           "elf init",
+           "full",
+           "view",
+           "view+cs");
+
+    for (uint32 i = 0; (i < ArrayLen(Tables)) && (result == Result::Success); ++i)
+    {
+        Measurement measurement = {};
+
+        result = MeasureTable(&allocator, Tables[i], iterations, &measurement);
+
+        if (result == Result::Success)
+        {
+            printf("%-16s %6u %10zu %10.1f %10.1f %10.1f %10.1f\n",
+                   Tables[i].pName,
+                   Tables[i].count,
+                   AverageElfSize(Tables[i]),
+                   measurement.elfInit,
+                   measurement.fullDecode,
+                   measurement.viewIndex,
+                   measurement.viewStage);
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    return (result == Result::Success) ? 0 : 1;
+}
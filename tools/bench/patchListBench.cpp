@@ -0,0 +1,278 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  patchListBench.cpp
+ * @brief GPU memory patch list benchmark. Builds patch lists which reference a growing number of allocations, several
+ *        patches per allocation in interleaved order, and reports the CPU time per patch entry. A list which looks up
+ *        its references linearly gets slower with every allocation it references; an indexed one should not.
+ *
+ *        The patch list is internal to PAL, so this creates the core platform directly rather than through
+ *        CreatePlatform(), which would wrap the devices in layer decorators.
+ *
+ * Usage: palPatchListBench [maxReferenceCount] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "core/device.h"
+#include "core/gpuMemPatchList.h"
+#include "core/gpuMemory.h"
+#include "core/platform.h"
+#include "palLib.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32  DefaultMaxReferences = 16384;
+constexpr uint32  PatchesPerReference  = 8;
+constexpr uint32  MinPatchEntries      = 1 << 20;   // Small lists are rebuilt until at least this many entries
+constexpr gpusize AllocationSize       = 4096;
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMem)
+{
+    free(pMem);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+GpuMemory* CreateAllocation(
+    Device* pDevice)
+{
+    GpuMemoryCreateInfo createInfo = {};
+    createInfo.size      = AllocationSize;
+    createInfo.vaRange   = VaRange::Default;
+    createInfo.heapCount = 1;
+    createInfo.heaps[0]  = GpuHeapGartUswc;
+    createInfo.priority  = GpuMemPriority::Normal;
+
+    Result      result  = Result::Success;
+    IGpuMemory* pGpuMem = nullptr;
+    void*       pMemory = malloc(pDevice->GetGpuMemorySize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory != nullptr))
+    {
+        result = pDevice->CreateGpuMemory(createInfo, pMemory, &pGpuMem);
+    }
+
+    if (result != Result::Success)
+    {
+        free(pMemory);
+        pGpuMem = nullptr;
+    }
+
+    return static_cast<GpuMemory*>(pGpuMem);
+}
+
+// =====================================================================================================================
+// Builds patch lists which reference the first referenceCount allocations, PatchesPerReference times each. The
+// patches cycle through all of the allocations so that every lookup after the first pass finds an existing reference.
+Result MeasurePatchList(
+    Device*           pDevice,
+    GpuMemory*const*  ppGpuMemory,
+    uint32            referenceCount)
+{
+    const uint32 patchCount = referenceCount * PatchesPerReference;
+    const uint32 listCount  = Max(1u, MinPatchEntries / patchCount);
+
+    GpuMemoryPatchList patchList(pDevice);
+
+    Result result     = Result::Success;
+    int64  totalTicks = 0;
+
+    for (uint32 list = 0; (list < listCount) && (result == Result::Success); ++list)
+    {
+        const int64 startTicks = GetPerfCpuTime();
+
+        patchList.Reset();
+
+        for (uint32 patch = 0; (patch < patchCount) && (result == Result::Success); ++patch)
+        {
+            result = patchList.AddPatchEntry(ppGpuMemory[patch % referenceCount],
+                                             0,
+                                             GpuMemoryPatchOp::VceSurfAddrLo,
+                                             patch,
+                                             ((patch & 1) != 0),
+                                             0,
+                                             patch * sizeof(uint32));
+        }
+
+        totalTicks += GetPerfCpuTime() - startTicks;
+    }
+
+    if ((result == Result::Success) && (patchList.NumMemoryRefs() != (referenceCount + 1)))
+    {
+        // Every allocation should be referenced exactly once, plus the null reference.
+        result = Result::ErrorUnknown;
+    }
+
+    if (result == Result::Success)
+    {
+        const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+
+        printf("%12u %12u %14.1f\n",
+               referenceCount,
+               patchCount,
+               (static_cast<double>(totalTicks) * nsPerTick) / (static_cast<double>(patchCount) * listCount));
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 maxReferences = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0))
+                                            : DefaultMaxReferences;
+    const uint32 nullGpuId     = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0))
+                                            : static_cast<uint32>(NullGpuId::Navi10);
+
+    if (maxReferences == 0)
+    {
+        fprintf(stderr, "Usage: %s [maxReferenceCount] [nullGpuId]\n", argv[0]);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.pAllocCb               = &g_callbacks;
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    Platform* pPlatform       = nullptr;
+    void*     pPlatformMemory = malloc(GetPlatformSize());
+    Result    result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = Platform::Create(platformInfo, g_callbacks, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    Device* const pDevice = (result == Result::Success) ? static_cast<Device*>(pDevices[0]) : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    GpuMemory** const ppGpuMemory = static_cast<GpuMemory**>(calloc(maxReferences, sizeof(GpuMemory*)));
+
+    result = ((result == Result::Success) && (ppGpuMemory == nullptr)) ? Result::ErrorOutOfMemory : result;
+
+    for (uint32 idx = 0; (idx < maxReferences) && (result == Result::Success); ++idx)
+    {
+        ppGpuMemory[idx] = CreateAllocation(pDevice);
+        result           = (ppGpuMemory[idx] != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%12s %12s %14s\n", "references", "patches", "ns/patch");
+    }
+
+    for (uint32 referenceCount = 1;
+         (referenceCount <= maxReferences) && (result == Result::Success);
+         referenceCount *= 4)
+    {
+        result = MeasurePatchList(pDevice, ppGpuMemory, referenceCount);
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    for (uint32 idx = 0; (ppGpuMemory != nullptr) && (idx < maxReferences); ++idx)
+    {
+        if (ppGpuMemory[idx] != nullptr)
+        {
+            ppGpuMemory[idx]->Destroy();
+            free(ppGpuMemory[idx]);
+        }
+    }
+
+    free(ppGpuMemory);
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
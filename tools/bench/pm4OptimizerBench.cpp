@@ -0,0 +1,562 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  pm4OptimizerBench.cpp
+ * @brief Gfx9 PM4 optimizer benchmark. Replays a stream of SET_CONTEXT_REG and SET_SH_REG packets through
+ *        Pm4Optimizer and reports the CPU time per packet and per register, next to the cost of copying the same
+ *        packets unoptimized.
+ *
+ *        The stream is either read from a command buffer dump (cmdBufDumpFormat = CmdBufDumpFormatBinaryHeaders, which
+ *        needs a build with PAL_ENABLE_PRINTS_ASSERTS) or synthesized to look like pipeline binds: runs of PS context
+ *        registers which mostly match between pipelines, followed by a few draws' worth of user data.
+ *
+ *        The optimizer is internal to PAL, so this creates the core platform directly rather than through
+ *        CreatePlatform(), which would wrap the devices in layer decorators.
+ *
+ * Usage: palPm4OptimizerBench [dumpFile.pm4] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "core/cmdBuffer.h"
+#include "core/device.h"
+#include "core/platform.h"
+#include "core/hw/gfxip/gfx9/gfx9Device.h"
+#include "core/hw/gfxip/gfx9/gfx9Pm4Optimizer.h"
+#include "palFile.h"
+#include "palLib.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Pal;
+using namespace Pal::Gfx9;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 MinReplayedPackets  = 1 << 22;   // Short streams are replayed until at least this many packets
+constexpr uint32 SynthPipelineCount  = 16;
+constexpr uint32 SynthBindCount      = 4096;
+constexpr uint32 SynthDrawsPerBind   = 4;
+constexpr uint32 SynthUserDataCount  = 8;
+constexpr uint32 MaxPacketDwords     = 2 + 64;    // Header plus register offset plus the longest synthesized run
+
+// A run of consecutive registers which every synthesized pipeline bind writes with one packet.
+struct RegRun
+{
+    uint32 firstReg;
+    uint32 count;
+};
+
+// The context registers a typical pixel shader bind writes, in the order the Gfx9 pipeline chunks write them.
+constexpr RegRun ContextRuns[] =
+{
+    { mmCB_TARGET_MASK,        2 },  // CB_TARGET_MASK, CB_SHADER_MASK
+    { mmSPI_PS_INPUT_CNTL_0,  32 },
+    { mmSPI_SHADER_Z_FORMAT,   2 },  // SPI_SHADER_Z_FORMAT, SPI_SHADER_COL_FORMAT
+    { mmSPI_PS_INPUT_ENA,      2 },  // SPI_PS_INPUT_ENA, SPI_PS_INPUT_ADDR
+    { mmSPI_PS_IN_CONTROL,     1 },
+    { mmSPI_BARYC_CNTL,        1 },
+    { mmCB_BLEND0_CONTROL,     8 },
+    { mmDB_SHADER_CONTROL,     1 },
+    { mmPA_CL_VS_OUT_CNTL,     1 },
+    { mmVGT_SHADER_STAGES_EN,  1 },
+};
+
+// The SH registers a pixel shader bind writes: the program address and resource descriptors.
+constexpr RegRun ShRuns[] =
+{
+    { mmSPI_SHADER_PGM_LO_PS,  4 },  // PGM_LO, PGM_HI, PGM_RSRC1, PGM_RSRC2
+};
+
+// A growable stream of PM4 packets.
+struct PacketStream
+{
+    uint32* pData;
+    size_t  numDwords;
+    size_t  capacity;
+    uint32  numPackets;
+    uint64  numRegisters;
+};
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMem)
+{
+    free(pMem);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+// Makes room for another packet at the end of the stream and returns where it should be written.
+uint32* ReservePacket(
+    PacketStream* pStream)
+{
+    if ((pStream->numDwords + MaxPacketDwords) > pStream->capacity)
+    {
+        const size_t newCapacity = Max<size_t>(pStream->capacity * 2, 1 << 16);
+        uint32*const pNewData    = static_cast<uint32*>(realloc(pStream->pData, newCapacity * sizeof(uint32)));
+
+        if (pNewData != nullptr)
+        {
+            pStream->pData    = pNewData;
+            pStream->capacity = newCapacity;
+        }
+    }
+
+    return ((pStream->numDwords + MaxPacketDwords) <= pStream->capacity) ? (pStream->pData + pStream->numDwords)
+                                                                          : nullptr;
+}
+
+// =====================================================================================================================
+// Appends a packet which was written at the location ReservePacket() returned.
+void CommitPacket(
+    PacketStream* pStream,
+    size_t        packetDwords,
+    uint32        registerCount)
+{
+    pStream->numDwords    += packetDwords;
+    pStream->numRegisters += registerCount;
+    pStream->numPackets++;
+}
+
+// =====================================================================================================================
+// Returns the value a synthesized pipeline writes to a register. Three registers out of four hold the same value in
+// every pipeline, which is roughly what binding pipelines compiled from related shaders looks like.
+uint32 PipelineRegValue(
+    uint32 pipeline,
+    uint32 regAddr)
+{
+    const uint32 regHash = (regAddr * 0x9E3779B1u) >> 7;
+
+    return ((regHash & 3) != 0) ? regHash : (regHash ^ ((pipeline + 1) * 0x85EBCA6Bu));
+}
+
+// =====================================================================================================================
+// Fills the stream with SynthBindCount pipeline binds, each followed by a few draws which update the PS user data.
+Result SynthesizeStream(
+    const CmdUtil& cmdUtil,
+    PacketStream*  pStream)
+{
+    Result result = Result::Success;
+    uint32 random = 0x12345678;
+
+    for (uint32 bind = 0; (bind < SynthBindCount) && (result == Result::Success); ++bind)
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+
+        const uint32 pipeline = random % SynthPipelineCount;
+
+        for (uint32 run = 0; (run < ArrayLen(ContextRuns)) && (result == Result::Success); ++run)
+        {
+            const RegRun& regRun  = ContextRuns[run];
+            uint32*const  pPacket = ReservePacket(pStream);
+
+            if (pPacket != nullptr)
+            {
+                const size_t headerDwords = cmdUtil.BuildSetSeqContextRegs(regRun.firstReg,
+                                                                           regRun.firstReg + regRun.count - 1,
+                                                                           pPacket);
+
+                for (uint32 reg = 0; reg < regRun.count; ++reg)
+                {
+                    pPacket[headerDwords + reg] = PipelineRegValue(pipeline, regRun.firstReg + reg);
+                }
+
+                CommitPacket(pStream, headerDwords + regRun.count, regRun.count);
+            }
+            else
+            {
+                result = Result::ErrorOutOfMemory;
+            }
+        }
+
+        for (uint32 run = 0; (run < ArrayLen(ShRuns)) && (result == Result::Success); ++run)
+        {
+            const RegRun& regRun  = ShRuns[run];
+            uint32*const  pPacket = ReservePacket(pStream);
+
+            if (pPacket != nullptr)
+            {
+                const size_t headerDwords = cmdUtil.BuildSetSeqShRegs(regRun.firstReg,
+                                                                      regRun.firstReg + regRun.count - 1,
+                                                                      ShaderGraphics,
+                                                                      pPacket);
+
+                for (uint32 reg = 0; reg < regRun.count; ++reg)
+                {
+                    pPacket[headerDwords + reg] = PipelineRegValue(pipeline, regRun.firstReg + reg);
+                }
+
+                CommitPacket(pStream, headerDwords + regRun.count, regRun.count);
+            }
+            else
+            {
+                result = Result::ErrorOutOfMemory;
+            }
+        }
+
+        // The first half of the user data (table pointers) only changes with the pipeline, the rest changes per draw.
+        for (uint32 draw = 0; (draw < SynthDrawsPerBind) && (result == Result::Success); ++draw)
+        {
+            uint32*const pPacket = ReservePacket(pStream);
+
+            if (pPacket != nullptr)
+            {
+                const size_t headerDwords =
+                    cmdUtil.BuildSetSeqShRegs(mmSPI_SHADER_USER_DATA_PS_0,
+                                              mmSPI_SHADER_USER_DATA_PS_0 + SynthUserDataCount - 1,
+                                              ShaderGraphics,
+                                              pPacket);
+
+                for (uint32 reg = 0; reg < SynthUserDataCount; ++reg)
+                {
+                    pPacket[headerDwords + reg] = (reg < (SynthUserDataCount / 2))
+                                                  ? PipelineRegValue(pipeline, mmSPI_SHADER_USER_DATA_PS_0 + reg)
+                                                  : ((bind * SynthDrawsPerBind) + draw);
+                }
+
+                CommitPacket(pStream, headerDwords + SynthUserDataCount, SynthUserDataCount);
+            }
+            else
+            {
+                result = Result::ErrorOutOfMemory;
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Fills the stream with the SET_CONTEXT_REG and SET_SH_REG packets of the DE command streams in a command buffer dump
+// which was written with chunk headers. Every other packet is skipped.
+Result LoadStream(
+    const char*   pFilename,
+    PacketStream* pStream)
+{
+    const size_t fileSize = File::GetFileSize(pFilename);
+    uint8*const  pFile    = static_cast<uint8*>(malloc(Max<size_t>(fileSize, 1)));
+
+    Result result = (pFile != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    File   file;
+
+    if (result == Result::Success)
+    {
+        result = file.Open(pFilename, FileAccessMode::FileAccessRead | FileAccessMode::FileAccessBinary);
+    }
+
+    size_t bytesRead = 0;
+
+    if (result == Result::Success)
+    {
+        result = file.Read(pFile, fileSize, &bytesRead);
+        file.Close();
+    }
+
+    for (size_t offset = 0;
+         (result == Result::Success) && ((offset + sizeof(CmdBufferDumpHeader)) <= bytesRead);)
+    {
+        CmdBufferDumpHeader chunkHeader;
+        memcpy(&chunkHeader, pFile + offset, sizeof(chunkHeader));
+
+        if ((chunkHeader.size < sizeof(chunkHeader)) ||
+            ((offset + chunkHeader.size + chunkHeader.cmdBufferSize) > bytesRead))
+        {
+            result = Result::ErrorInvalidValue;
+            break;
+        }
+
+        const uint32* pCmds     = reinterpret_cast<const uint32*>(pFile + offset + chunkHeader.size);
+        const size_t  numDwords = chunkHeader.cmdBufferSize / sizeof(uint32);
+
+        // Only the DE stream carries register writes the optimizer sees.
+        for (size_t idx = 0; (chunkHeader.subEngineId == 0) && (idx < numDwords) && (result == Result::Success);)
+        {
+            PM4_PFP_TYPE_3_HEADER header;
+            header.u32All = pCmds[idx];
+
+            if (header.type != 3)
+            {
+                // Type-2 filler packets are a single DWORD. Anything else means we lost track of the packets.
+                if (header.type != 2)
+                {
+                    result = Result::ErrorInvalidValue;
+                }
+
+                idx++;
+                continue;
+            }
+
+            const size_t packetDwords = header.count + 2;
+
+            if (((header.opcode == IT_SET_CONTEXT_REG) || (header.opcode == IT_SET_SH_REG)) &&
+                (packetDwords <= MaxPacketDwords) && ((idx + packetDwords) <= numDwords))
+            {
+                uint32*const pPacket = ReservePacket(pStream);
+
+                if (pPacket != nullptr)
+                {
+                    memcpy(pPacket, pCmds + idx, packetDwords * sizeof(uint32));
+                    CommitPacket(pStream, packetDwords, header.count);
+                }
+                else
+                {
+                    result = Result::ErrorOutOfMemory;
+                }
+            }
+
+            idx += packetDwords;
+        }
+
+        offset += chunkHeader.size + chunkHeader.cmdBufferSize;
+    }
+
+    if ((result == Result::Success) && (pStream->numPackets == 0))
+    {
+        result = Result::ErrorInvalidValue;
+    }
+
+    free(pFile);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Replays the stream through the optimizer, or just copies each packet if pOptimizer is null. The optimizer is reset
+// before every pass so that each pass behaves like recording a fresh command buffer. Returns the total CPU ticks and
+// the number of DWORDs the replay wrote.
+int64 ReplayStream(
+    const PacketStream& stream,
+    Pm4Optimizer*       pOptimizer,
+    uint32              passCount,
+    uint64*             pDwordsWritten)
+{
+    uint32 cmdSpace[MaxPacketDwords];
+    uint64 dwordsWritten       = 0;
+    bool   contextRollDetected = false;
+
+    const int64 startTicks = GetPerfCpuTime();
+
+    for (uint32 pass = 0; pass < passCount; ++pass)
+    {
+        if (pOptimizer != nullptr)
+        {
+            pOptimizer->Reset();
+        }
+
+        for (size_t idx = 0; idx < stream.numDwords;)
+        {
+            const uint32* pPacket = stream.pData + idx;
+
+            PM4_PFP_TYPE_3_HEADER header;
+            header.u32All = pPacket[0];
+
+            const size_t packetDwords = header.count + 2;
+            uint32*      pCmdSpace    = cmdSpace;
+
+            if (pOptimizer == nullptr)
+            {
+                memcpy(pCmdSpace, pPacket, packetDwords * sizeof(uint32));
+                pCmdSpace += packetDwords;
+            }
+            else if (header.opcode == IT_SET_CONTEXT_REG)
+            {
+                PM4_PFP_SET_CONTEXT_REG setData;
+                memcpy(&setData, pPacket, sizeof(setData));
+
+                pCmdSpace = pOptimizer->WriteOptimizedSetSeqContextRegs(setData,
+                                                                        &contextRollDetected,
+                                                                        pPacket + PM4_PFP_SET_CONTEXT_REG_SIZEDW__CORE,
+                                                                        pCmdSpace);
+            }
+            else
+            {
+                PM4_ME_SET_SH_REG setData;
+                memcpy(&setData, pPacket, sizeof(setData));
+
+                pCmdSpace = pOptimizer->WriteOptimizedSetSeqShRegs(setData,
+                                                                   pPacket + PM4_ME_SET_SH_REG_SIZEDW__CORE,
+                                                                   pCmdSpace);
+            }
+
+            dwordsWritten += static_cast<uint64>(pCmdSpace - cmdSpace);
+            idx           += packetDwords;
+        }
+    }
+
+    const int64 ticks = GetPerfCpuTime() - startTicks;
+
+    (*pDwordsWritten) = dwordsWritten;
+
+    return ticks;
+}
+
+// =====================================================================================================================
+// Replays the stream with and without the optimizer and prints the results.
+void MeasureStream(
+    const Pal::Gfx9::Device& gfxDevice,
+    const PacketStream&      stream)
+{
+    const uint32 passCount = Max(1u, MinReplayedPackets / stream.numPackets);
+    const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+    const double packets   = static_cast<double>(stream.numPackets) * passCount;
+    const double registers = static_cast<double>(stream.numRegisters) * passCount;
+
+    Pm4Optimizer optimizer(gfxDevice);
+
+    uint64 copiedDwords = 0;
+    uint64 keptDwords   = 0;
+
+    const int64 copyTicks     = ReplayStream(stream, nullptr, passCount, &copiedDwords);
+    const int64 optimizeTicks = ReplayStream(stream, &optimizer, passCount, &keptDwords);
+
+    printf("%u packets, %llu registers, replayed %u times\n\n",
+           stream.numPackets,
+           static_cast<unsigned long long>(stream.numRegisters),
+           passCount);
+    printf("%-10s %12s %12s %12s\n", "replay", "ns/packet", "ns/register", "dwords kept");
+    printf("%-10s %12.2f %12.3f %11.1f%%\n",
+           "copy",
+           (static_cast<double>(copyTicks) * nsPerTick) / packets,
+           (static_cast<double>(copyTicks) * nsPerTick) / registers,
+           100.0);
+    printf("%-10s %12.2f %12.3f %11.1f%%\n",
+           "optimize",
+           (static_cast<double>(optimizeTicks) * nsPerTick) / packets,
+           (static_cast<double>(optimizeTicks) * nsPerTick) / registers,
+           (100.0 * static_cast<double>(keptDwords)) / static_cast<double>(copiedDwords));
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const char*  pDumpFile = ((argc > 1) && (strcmp(argv[1], "-") != 0)) ? argv[1] : nullptr;
+    const uint32 nullGpuId = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0))
+                                        : static_cast<uint32>(NullGpuId::Navi10);
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.pAllocCb               = &g_callbacks;
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    Platform* pPlatform       = nullptr;
+    void*     pPlatformMemory = malloc(GetPlatformSize());
+    Result    result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = Platform::Create(platformInfo, g_callbacks, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    Pal::Device* const pDevice = (result == Result::Success) ? static_cast<Pal::Device*>(pDevices[0]) : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    // The optimizer only exists for the Gfx9 hardware layer, which also covers gfx10.
+    if ((result == Result::Success) && (pDevice->ChipProperties().gfxLevel < GfxIpLevel::GfxIp9))
+    {
+        fprintf(stderr, "Usage: %s [dumpFile.pm4 | -] [nullGpuId of a gfx9 or newer GPU]\n", argv[0]);
+        result = Result::ErrorUnavailable;
+    }
+
+    PacketStream stream = {};
+
+    if (result == Result::Success)
+    {
+        const auto& gfxDevice = *static_cast<const Pal::Gfx9::Device*>(pDevice->GetGfxDevice());
+
+        result = (pDumpFile != nullptr) ? LoadStream(pDumpFile, &stream)
+                                        : SynthesizeStream(gfxDevice.CmdUtil(), &stream);
+
+        if (result == Result::Success)
+        {
+            printf("Register stream: %s\n", (pDumpFile != nullptr) ? pDumpFile : "synthesized pipeline binds");
+            MeasureStream(gfxDevice, stream);
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    free(stream.pData);
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,412 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  residencyBench.cpp
+ * @brief Queue residency benchmark. Makes a large set of allocations resident on a queue through persistent memory
+ *        references, then measures the CPU cost of a submit when none, a few or many of those references change
+ *        between submits. This is the cost of keeping the kernel bo list in sync with the resident set.
+ *
+ *        The null device doesn't submit to a kernel driver, so this needs a real GPU.
+ *
+ * Usage: palResidencyBench [allocationCount] [submitCount]
+ ***********************************************************************************************************************
+ */
+
+#include "pal.h"
+#include "palCmdAllocator.h"
+#include "palCmdBuffer.h"
+#include "palDevice.h"
+#include "palGpuMemory.h"
+#include "palLib.h"
+#include "palPlatform.h"
+#include "palQueue.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32  DefaultAllocationCount = 20000;
+constexpr uint32  DefaultSubmitCount     = 200;
+constexpr uint32  ChurnCounts[]          = { 0, 1, 16, 256 };   // References replaced before each submit
+constexpr gpusize AllocationSize         = 4096;
+constexpr uint32  SubmitsPerWait         = 16;                  // Submits between WaitIdle() calls
+
+// Objects used by the benchmark, all created on the first device.
+struct BenchContext
+{
+    IDevice*       pDevice;
+    IQueue*        pQueue;
+    ICmdAllocator* pCmdAllocator;
+    ICmdBuffer*    pCmdBuffer;
+    IGpuMemory**   ppGpuMemory;
+    uint32         allocationCount;
+};
+
+// =====================================================================================================================
+IGpuMemory* CreateAllocation(
+    IDevice* pDevice)
+{
+    GpuMemoryCreateInfo createInfo = {};
+    createInfo.size      = AllocationSize;
+    createInfo.vaRange   = VaRange::Default;
+    createInfo.heapCount = 1;
+    createInfo.heaps[0]  = GpuHeapGartUswc;
+    createInfo.priority  = GpuMemPriority::Normal;
+
+    Result      result  = Result::Success;
+    IGpuMemory* pGpuMem = nullptr;
+    void*       pMemory = malloc(pDevice->GetGpuMemorySize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory != nullptr))
+    {
+        result = pDevice->CreateGpuMemory(createInfo, pMemory, &pGpuMem);
+    }
+
+    if (result != Result::Success)
+    {
+        free(pMemory);
+        pGpuMem = nullptr;
+    }
+
+    return pGpuMem;
+}
+
+// =====================================================================================================================
+// Creates the universal queue, a command allocator and an empty command buffer to submit over and over.
+Result CreateSubmitObjects(
+    BenchContext* pBench)
+{
+    QueueCreateInfo queueInfo = {};
+    queueInfo.queueType  = QueueTypeUniversal;
+    queueInfo.engineType = EngineTypeUniversal;
+
+    Result result  = Result::Success;
+    void*  pMemory = malloc(pBench->pDevice->GetQueueSize(queueInfo, &result));
+
+    result = ((result == Result::Success) && (pMemory == nullptr)) ? Result::ErrorOutOfMemory : result;
+
+    if (result == Result::Success)
+    {
+        result = pBench->pDevice->CreateQueue(queueInfo, pMemory, &pBench->pQueue);
+    }
+
+    if ((result != Result::Success) && (pMemory != nullptr))
+    {
+        free(pMemory);
+        pBench->pQueue = nullptr;
+    }
+
+    CmdAllocatorCreateInfo allocatorInfo = {};
+    allocatorInfo.flags.autoMemoryReuse = 1;
+
+    for (uint32 type = 0; type < CmdAllocatorTypeCount; ++type)
+    {
+        allocatorInfo.allocInfo[type].allocHeap    = (type == GpuScratchMemAlloc) ? GpuHeapInvisible : GpuHeapGartUswc;
+        allocatorInfo.allocInfo[type].allocSize    = 256 * 1024;
+        allocatorInfo.allocInfo[type].suballocSize = 16 * 1024;
+    }
+
+    if (result == Result::Success)
+    {
+        pMemory = malloc(pBench->pDevice->GetCmdAllocatorSize(allocatorInfo, &result));
+        result  = ((result == Result::Success) && (pMemory == nullptr)) ? Result::ErrorOutOfMemory : result;
+
+        if (result == Result::Success)
+        {
+            result = pBench->pDevice->CreateCmdAllocator(allocatorInfo, pMemory, &pBench->pCmdAllocator);
+        }
+
+        if ((result != Result::Success) && (pMemory != nullptr))
+        {
+            free(pMemory);
+            pBench->pCmdAllocator = nullptr;
+        }
+    }
+
+    CmdBufferCreateInfo cmdBufferInfo = {};
+    cmdBufferInfo.pCmdAllocator = pBench->pCmdAllocator;
+    cmdBufferInfo.queueType     = QueueTypeUniversal;
+    cmdBufferInfo.engineType    = EngineTypeUniversal;
+
+    if (result == Result::Success)
+    {
+        pMemory = malloc(pBench->pDevice->GetCmdBufferSize(cmdBufferInfo, &result));
+        result  = ((result == Result::Success) && (pMemory == nullptr)) ? Result::ErrorOutOfMemory : result;
+
+        if (result == Result::Success)
+        {
+            result = pBench->pDevice->CreateCmdBuffer(cmdBufferInfo, pMemory, &pBench->pCmdBuffer);
+        }
+
+        if ((result != Result::Success) && (pMemory != nullptr))
+        {
+            free(pMemory);
+            pBench->pCmdBuffer = nullptr;
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        CmdBufferBuildInfo buildInfo = {};
+        result = pBench->pCmdBuffer->Begin(buildInfo);
+    }
+
+    if (result == Result::Success)
+    {
+        result = pBench->pCmdBuffer->End();
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Submits the empty command buffer submitCount times, replacing churnCount persistent references before each submit.
+// Prints the average CPU time of a submit including the reference updates.
+Result MeasureSubmits(
+    BenchContext* pBench,
+    uint32        submitCount,
+    uint32        churnCount)
+{
+    const double nsPerTick = 1000000000.0 / static_cast<double>(GetPerfFrequency());
+
+    PerSubQueueSubmitInfo perSubQueueInfo = {};
+    perSubQueueInfo.cmdBufferCount = 1;
+    perSubQueueInfo.ppCmdBuffers   = &pBench->pCmdBuffer;
+
+    MultiSubmitInfo submitInfo = {};
+    submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
+    submitInfo.perSubQueueInfoCount = 1;
+
+    Result result     = Result::Success;
+    int64  totalTicks = 0;
+    uint32 nextChurn  = 0;
+
+    for (uint32 submit = 0; (submit < submitCount) && (result == Result::Success); ++submit)
+    {
+        const int64 startTicks = GetPerfCpuTime();
+
+        for (uint32 i = 0; (i < churnCount) && (result == Result::Success); ++i)
+        {
+            IGpuMemory* const pGpuMemory = pBench->ppGpuMemory[nextChurn];
+
+            GpuMemoryRef memRef = {};
+            memRef.pGpuMemory   = pGpuMemory;
+
+            result = pBench->pDevice->RemoveGpuMemoryReferences(1, &pGpuMemory, pBench->pQueue);
+
+            if (result == Result::Success)
+            {
+                result = pBench->pDevice->AddGpuMemoryReferences(1, &memRef, pBench->pQueue, 0);
+            }
+
+            nextChurn = (nextChurn + 1) % pBench->allocationCount;
+        }
+
+        if (result == Result::Success)
+        {
+            result = pBench->pQueue->Submit(submitInfo);
+        }
+
+        totalTicks += GetPerfCpuTime() - startTicks;
+
+        if ((result == Result::Success) && (((submit + 1) % SubmitsPerWait) == 0))
+        {
+            result = pBench->pQueue->WaitIdle();
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        result = pBench->pQueue->WaitIdle();
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%12u %12u %16.1f\n",
+               pBench->allocationCount,
+               churnCount,
+               (static_cast<double>(totalTicks) * nsPerTick) / (1000.0 * submitCount));
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 allocationCount = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0))
+                                              : DefaultAllocationCount;
+    const uint32 submitCount     = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultSubmitCount;
+
+    if ((allocationCount == 0) || (submitCount == 0))
+    {
+        fprintf(stderr, "Usage: %s [allocationCount] [submitCount]\n", argv[0]);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+
+    IPlatform* pPlatform       = nullptr;
+    void*      pPlatformMemory = malloc(GetPlatformSize());
+    Result     result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = CreatePlatform(platformInfo, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        fprintf(stderr, "No GPU found. The null device has no kernel submit path to measure.\n");
+        result = Result::ErrorUnavailable;
+    }
+
+    BenchContext bench = {};
+    bench.pDevice         = (result == Result::Success) ? pDevices[0] : nullptr;
+    bench.allocationCount = allocationCount;
+
+    if (result == Result::Success)
+    {
+        result = bench.pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = bench.pDevice->Finalize(finalizeInfo);
+    }
+
+    if (result == Result::Success)
+    {
+        result = CreateSubmitObjects(&bench);
+    }
+
+    if (result == Result::Success)
+    {
+        bench.ppGpuMemory = static_cast<IGpuMemory**>(calloc(allocationCount, sizeof(IGpuMemory*)));
+        result            = (bench.ppGpuMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+    }
+
+    uint32 referencedCount = 0;
+
+    for (; (referencedCount < allocationCount) && (result == Result::Success); ++referencedCount)
+    {
+        bench.ppGpuMemory[referencedCount] = CreateAllocation(bench.pDevice);
+
+        GpuMemoryRef memRef = {};
+        memRef.pGpuMemory   = bench.ppGpuMemory[referencedCount];
+
+        result = (memRef.pGpuMemory != nullptr)
+                 ? bench.pDevice->AddGpuMemoryReferences(1, &memRef, bench.pQueue, 0)
+                 : Result::ErrorOutOfMemory;
+    }
+
+    if (result == Result::Success)
+    {
+        printf("%12s %12s %16s\n", "resident", "changed", "us/submit");
+    }
+
+    for (uint32 i = 0; (i < (sizeof(ChurnCounts) / sizeof(ChurnCounts[0]))) && (result == Result::Success); ++i)
+    {
+        result = MeasureSubmits(&bench, submitCount, Min(ChurnCounts[i], allocationCount));
+    }
+
+    if (result != Result::Success)
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    for (uint32 i = 0; i < allocationCount; ++i)
+    {
+        IGpuMemory* const pGpuMemory = (bench.ppGpuMemory != nullptr) ? bench.ppGpuMemory[i] : nullptr;
+
+        if (pGpuMemory != nullptr)
+        {
+            if (i < referencedCount)
+            {
+                bench.pDevice->RemoveGpuMemoryReferences(1, &pGpuMemory, bench.pQueue);
+            }
+
+            pGpuMemory->Destroy();
+            free(pGpuMemory);
+        }
+    }
+
+    free(bench.ppGpuMemory);
+
+    if (bench.pCmdBuffer != nullptr)
+    {
+        bench.pCmdBuffer->Destroy();
+        free(bench.pCmdBuffer);
+    }
+
+    if (bench.pCmdAllocator != nullptr)
+    {
+        bench.pCmdAllocator->Destroy();
+        free(bench.pCmdAllocator);
+    }
+
+    if (bench.pQueue != nullptr)
+    {
+        bench.pQueue->Destroy();
+        free(bench.pQueue);
+    }
+
+    if (bench.pDevice != nullptr)
+    {
+        bench.pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,488 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  rmtTraceBench.cpp
+ * @brief Memory tracing overhead benchmark. Creates and destroys GPU memory objects from several threads on a null
+ *        device, first with memory profiling disabled and then with it enabled, and reports the allocation throughput
+ *        of both along with the size of the RMT trace that was collected.
+ *
+ *        Memory profiling is normally turned on over the developer driver connection, so this creates the core
+ *        platform directly and sends the event service its "enableMemoryProfiling" and "disableMemoryProfiling"
+ *        requests itself.
+ *
+ *        A final pass streams the trace to a file in the current directory through small staging buffers and checks
+ *        that the file is a gapless series of RMT data chunks with consecutive chunk indices.
+ *
+ * Usage: palRmtTraceBench [threadCount] [iterationCount] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "core/device.h"
+#include "core/eventProvider.h"
+#include "core/platform.h"
+#include "palGpuMemory.h"
+#include "palLib.h"
+#include "palSysMemory.h"
+#include "palSysUtil.h"
+#include "palThread.h"
+#include "util/rmtFileFormat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32  DefaultThreadCount = 4;
+constexpr uint32  DefaultIterations  = 20000;
+constexpr uint32  MaxThreads         = 64;
+constexpr gpusize AllocationSize     = 64 * 1024;
+constexpr uint32  StreamBufferSizeKb = 64;
+
+// State shared by every allocating thread.
+struct BenchContext
+{
+    IDevice*      pDevice;
+    uint32        iterations;
+    volatile bool failed;
+};
+
+// State owned by one allocating thread.
+struct ThreadContext
+{
+    BenchContext* pBench;
+    Thread        thread;
+};
+
+// Stands in for a developer driver request: holds the request arguments, counts the bytes of the response and keeps
+// the start of it as a string.
+class BenchRequestContext : public DevDriver::IURIRequestContext, public DevDriver::IByteWriter
+{
+public:
+    explicit BenchRequestContext(const char* pArguments)
+        : m_response()
+        , m_responseSize(0)
+    {
+        Strncpy(m_arguments, pArguments, sizeof(m_arguments));
+    }
+    ~BenchRequestContext() override {}
+
+    char* GetRequestArguments() override { return m_arguments; }
+    const DevDriver::PostDataInfo& GetPostData() const override { return m_postData; }
+
+    DevDriver::Result BeginByteResponse(DevDriver::IByteWriter** ppWriter) override
+    {
+        *ppWriter = this;
+        return DevDriver::Result::Success;
+    }
+    DevDriver::Result BeginTextResponse(DevDriver::ITextWriter** ppWriter) override
+        { return DevDriver::Result::Unavailable; }
+    DevDriver::Result BeginJsonResponse(DevDriver::IStructuredWriter** ppWriter) override
+        { return DevDriver::Result::Unavailable; }
+
+    DevDriver::Result End() override { return DevDriver::Result::Success; }
+    void WriteBytes(const void* pBytes, size_t length) override
+    {
+        if (m_responseSize < (sizeof(m_response) - 1))
+        {
+            memcpy(&m_response[m_responseSize], pBytes, Min(length, sizeof(m_response) - 1 - m_responseSize));
+        }
+
+        m_responseSize += length;
+    }
+
+    const char* Response() const { return m_response; }
+    size_t ResponseSize() const { return m_responseSize; }
+
+private:
+    char                     m_arguments[64];
+    char                     m_response[MaxPathStrLen];
+    DevDriver::PostDataInfo  m_postData;
+    size_t                   m_responseSize;
+};
+
+// =====================================================================================================================
+void* PAL_STDCALL BenchAlloc(
+    void*           pClientData,
+    size_t          size,
+    size_t          alignment,
+    SystemAllocType allocType)
+{
+    void* pMemory = nullptr;
+    return (posix_memalign(&pMemory, Max(alignment, sizeof(void*)), size) == 0) ? pMemory : nullptr;
+}
+
+// =====================================================================================================================
+void PAL_STDCALL BenchFree(
+    void* pClientData,
+    void* pMem)
+{
+    free(pMem);
+}
+
+AllocCallbacks g_callbacks = { &g_callbacks, &BenchAlloc, &BenchFree };
+
+// =====================================================================================================================
+// Repeatedly creates and destroys a GPU memory object. Every creation and destruction logs a memory event.
+void AllocatingThread(
+    void* pParameter)
+{
+    ThreadContext* const pThread = static_cast<ThreadContext*>(pParameter);
+    BenchContext*  const pBench  = pThread->pBench;
+
+    GpuMemoryCreateInfo createInfo = {};
+    createInfo.size      = AllocationSize;
+    createInfo.vaRange   = VaRange::Default;
+    createInfo.heapCount = 1;
+    createInfo.heaps[0]  = GpuHeapGartUswc;
+    createInfo.priority  = GpuMemPriority::Normal;
+
+    Result      result  = Result::Success;
+    void* const pMemory = malloc(pBench->pDevice->GetGpuMemorySize(createInfo, &result));
+
+    if ((result == Result::Success) && (pMemory == nullptr))
+    {
+        result = Result::ErrorOutOfMemory;
+    }
+
+    for (uint32 iter = 0; (iter < pBench->iterations) && (result == Result::Success); ++iter)
+    {
+        IGpuMemory* pGpuMemory = nullptr;
+
+        result = pBench->pDevice->CreateGpuMemory(createInfo, pMemory, &pGpuMemory);
+
+        if (result == Result::Success)
+        {
+            pGpuMemory->Destroy();
+        }
+    }
+
+    if (result != Result::Success)
+    {
+        pBench->failed = true;
+    }
+
+    free(pMemory);
+}
+
+// =====================================================================================================================
+// Runs the allocating threads to completion and returns the number of allocations per second they achieved together.
+Result MeasureThroughput(
+    BenchContext* pBench,
+    uint32        threadCount,
+    double*       pAllocsPerSec)
+{
+    ThreadContext threads[MaxThreads] = {};
+    uint32        started             = 0;
+    Result        result              = Result::Success;
+
+    pBench->failed = false;
+
+    const int64 startTicks = GetPerfCpuTime();
+
+    for (; (started < threadCount) && (result == Result::Success); ++started)
+    {
+        threads[started].pBench = pBench;
+        result                  = threads[started].thread.Begin(&AllocatingThread, &threads[started]);
+    }
+
+    for (uint32 threadIdx = 0; threadIdx < started; ++threadIdx)
+    {
+        threads[threadIdx].thread.Join();
+    }
+
+    const int64 endTicks = GetPerfCpuTime();
+
+    if ((result == Result::Success) && pBench->failed)
+    {
+        result = Result::ErrorUnknown;
+    }
+
+    *pAllocsPerSec = (static_cast<double>(threadCount) * pBench->iterations * GetPerfFrequency()) /
+                     static_cast<double>(Max<int64>(endTicks - startTicks, 1));
+
+    return result;
+}
+
+// =====================================================================================================================
+// Sends one request to the memory profiling service. Returns the size of its response in pResponseSize and, if
+// pResponse is non-null, the response as a string.
+Result SendRequest(
+    EventService* pEventService,
+    const char*   pRequest,
+    size_t*       pResponseSize,
+    char*         pResponse = nullptr,
+    size_t        responseBufferSize = 0)
+{
+    BenchRequestContext context(pRequest);
+
+    const DevDriver::Result result = pEventService->HandleRequest(&context);
+
+    *pResponseSize = context.ResponseSize();
+
+    if (pResponse != nullptr)
+    {
+        Strncpy(pResponse, context.Response(), responseBufferSize);
+    }
+
+    return (result == DevDriver::Result::Success) ? Result::Success : Result::ErrorUnknown;
+}
+
+// =====================================================================================================================
+// Checks that a streamed trace is a gapless series of RMT data chunks with consecutive chunk indices which exactly
+// covers the file. Returns the file size and chunk count.
+Result VerifyStreamedTrace(
+    const char* pFilePath,
+    size_t*     pFileSize,
+    uint32*     pChunkCount)
+{
+    FILE*  pFile  = fopen(pFilePath, "rb");
+    Result result = (pFile != nullptr) ? Result::Success : Result::ErrorUnavailable;
+
+    size_t fileSize   = 0;
+    uint32 chunkCount = 0;
+
+    while (result == Result::Success)
+    {
+        DevDriver::RmtFileChunkRmtData chunk = {};
+        const size_t readSize = fread(&chunk, 1, sizeof(chunk), pFile);
+
+        if (readSize == 0)
+        {
+            break;
+        }
+
+        // The writer wraps the 8-bit chunk index around within its non-negative range.
+        if ((readSize != sizeof(chunk))                                                              ||
+            (chunk.header.chunkIdentifier.chunkType != DevDriver::RMT_FILE_CHUNK_TYPE_RMT_DATA)      ||
+            (chunk.header.chunkIdentifier.chunkIndex != static_cast<int32>(chunkCount % 128))        ||
+            (chunk.header.sizeInBytes < static_cast<int32>(sizeof(chunk)))                           ||
+            (fseek(pFile, chunk.header.sizeInBytes - static_cast<int32>(sizeof(chunk)), SEEK_CUR) != 0))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+        else
+        {
+            fileSize += chunk.header.sizeInBytes;
+            chunkCount++;
+        }
+    }
+
+    if (pFile != nullptr)
+    {
+        // A chunk which claims more data than the file holds leaves us past the end of the file.
+        if ((result == Result::Success) && (static_cast<size_t>(ftell(pFile)) != fileSize))
+        {
+            result = Result::ErrorInvalidValue;
+        }
+
+        fclose(pFile);
+    }
+
+    *pFileSize   = fileSize;
+    *pChunkCount = chunkCount;
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 threadCount = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultThreadCount;
+    const uint32 iterations  = (argc > 2) ? static_cast<uint32>(strtoul(argv[2], nullptr, 0)) : DefaultIterations;
+    const uint32 nullGpuId   = (argc > 3) ? static_cast<uint32>(strtoul(argv[3], nullptr, 0))
+                                          : static_cast<uint32>(NullGpuId::Navi10);
+
+    if ((threadCount == 0) || (threadCount > MaxThreads) || (iterations == 0))
+    {
+        fprintf(stderr, "Usage: %s [threadCount (1-%u)] [iterationCount] [nullGpuId]\n", argv[0], MaxThreads);
+        return 1;
+    }
+
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.pAllocCb               = &g_callbacks;
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = static_cast<NullGpuId>(nullGpuId);
+
+    Platform* pPlatform       = nullptr;
+    void*     pPlatformMemory = malloc(GetPlatformSize());
+    Result    result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = Platform::Create(platformInfo, g_callbacks, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    IDevice* const pDevice = (result == Result::Success) ? pDevices[0] : nullptr;
+
+    if (result == Result::Success)
+    {
+        result = pDevice->CommitSettingsAndInit();
+    }
+
+    if (result == Result::Success)
+    {
+        DeviceFinalizeInfo finalizeInfo = {};
+        finalizeInfo.requestedEngineCounts[EngineTypeUniversal].engines = 1;
+
+        result = pDevice->Finalize(finalizeInfo);
+    }
+
+    BenchContext bench = {};
+    bench.pDevice    = pDevice;
+    bench.iterations = iterations;
+
+    double tracingOff = 0.0;
+    double tracingOn  = 0.0;
+    size_t traceSize  = 0;
+
+    if (result == Result::Success)
+    {
+        result = MeasureThroughput(&bench, threadCount, &tracingOff);
+    }
+
+    EventService* const pEventService = (pPlatform != nullptr) ? pPlatform->GetEventProvider()->GetEventService()
+                                                               : nullptr;
+
+    if (result == Result::Success)
+    {
+        size_t responseSize = 0;
+        result = SendRequest(pEventService, "enableMemoryProfiling", &responseSize);
+    }
+
+    if (result == Result::Success)
+    {
+        result = MeasureThroughput(&bench, threadCount, &tracingOn);
+
+        // Always stop profiling once it was started, but keep the first error.
+        const Result disableResult = SendRequest(pEventService, "disableMemoryProfiling", &traceSize);
+        result = (result == Result::Success) ? disableResult : result;
+    }
+
+    // Stream the same workload to a file through small staging buffers so that it is split into many data chunks.
+    PalPlatformSettings* const pSettings = (pPlatform != nullptr) ? pPlatform->PlatformSettingsPtr() : nullptr;
+
+    char   streamPath[MaxPathStrLen] = {};
+    size_t streamSize                = 0;
+    uint32 streamChunks              = 0;
+
+    if (result == Result::Success)
+    {
+        Strncpy(pSettings->rmtTraceDirectory, ".", sizeof(pSettings->rmtTraceDirectory));
+        pSettings->rmtTraceStreamBufferSizeInKb = StreamBufferSizeKb;
+        pSettings->rmtTraceMaxFileSizeInMb      = 0;
+
+        size_t responseSize = 0;
+        result = SendRequest(pEventService, "enableMemoryProfiling stream", &responseSize);
+    }
+
+    if (result == Result::Success)
+    {
+        double tracingStreamed = 0.0;
+        result = MeasureThroughput(&bench, threadCount, &tracingStreamed);
+
+        size_t       responseSize  = 0;
+        const Result disableResult = SendRequest(pEventService,
+                                                 "disableMemoryProfiling",
+                                                 &responseSize,
+                                                 streamPath,
+                                                 sizeof(streamPath));
+        result = (result == Result::Success) ? disableResult : result;
+
+        if (result == Result::Success)
+        {
+            result = VerifyStreamedTrace(streamPath, &streamSize, &streamChunks);
+
+            if (result != Result::Success)
+            {
+                fprintf(stderr, "Streamed trace %s is not a valid series of RMT data chunks.\n", streamPath);
+            }
+        }
+
+        if (streamPath[0] != '\0')
+        {
+            remove(streamPath);
+        }
+    }
+
+    if (result == Result::Success)
+    {
+        const double allocations = static_cast<double>(threadCount) * iterations;
+
+        printf("%u threads x %u allocations\n\n", threadCount, iterations);
+        printf("%-12s %16s\n", "tracing", "allocations/s");
+        printf("%-12s %16.0f\n", "off", tracingOff);
+        printf("%-12s %16.0f\n", "on", tracingOn);
+        printf("\nTrace: %zu bytes, %.1f bytes per allocation, %.1f%% slower with tracing\n",
+               traceSize,
+               static_cast<double>(traceSize) / allocations,
+               (tracingOn > 0.0) ? (100.0 * ((tracingOff / tracingOn) - 1.0)) : 0.0);
+        printf("Streamed: %zu bytes in %u data chunks of at most %u KB\n",
+               streamSize,
+               streamChunks,
+               StreamBufferSizeKb);
+    }
+    else
+    {
+        fprintf(stderr, "Benchmark failed (%d).\n", static_cast<int32>(result));
+    }
+
+    if (pDevice != nullptr)
+    {
+        pDevice->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return (result == Result::Success) ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2018-2020 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+/**
+ ***********************************************************************************************************************
+ * @file  rpmInitBench.cpp
+ * @brief Device initialization benchmark. Repeatedly brings up a null device and measures CommitSettingsAndInit(),
+ *        which is dominated by the RsrcProcMgr creating its internal compute and graphics pipelines. Reports the
+ *        fastest, median and mean time for one GPU of each hardware layer unless a null GPU ID is given.
+ *
+ * Usage: palRpmInitBench [iterationCount] [nullGpuId]
+ ***********************************************************************************************************************
+ */
+
+#include "pal.h"
+#include "palDevice.h"
+#include "palInlineFuncs.h"
+#include "palLib.h"
+#include "palPlatform.h"
+#include "palSysUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Pal;
+using namespace Util;
+
+namespace
+{
+
+constexpr uint32 DefaultIterations = 20;
+constexpr uint32 MaxIterations     = 1000;
+
+// One GPU per hardware layer with a different set of RPM pipelines.
+constexpr NullGpuId   DefaultGpus[]     = { NullGpuId::Polaris10, NullGpuId::Vega10, NullGpuId::Navi10 };
+constexpr const char* DefaultGpuNames[] = { "Polaris10",          "Vega10",          "Navi10"          };
+constexpr uint32      DefaultGpuCount   = sizeof(DefaultGpus) / sizeof(DefaultGpus[0]);
+
+// =====================================================================================================================
+// Creates a platform for the given null GPU and times CommitSettingsAndInit() on its device. Everything is torn down
+// again before returning.
+Result MeasureInit(
+    NullGpuId nullGpuId,
+    int64*    pTicks)
+{
+    PlatformCreateInfo platformInfo = {};
+    platformInfo.flags.createNullDevice = 1;
+    platformInfo.nullGpuId              = nullGpuId;
+
+    IPlatform* pPlatform       = nullptr;
+    void*      pPlatformMemory = malloc(GetPlatformSize());
+    Result     result          = (pPlatformMemory != nullptr) ? Result::Success : Result::ErrorOutOfMemory;
+
+    if (result == Result::Success)
+    {
+        result = CreatePlatform(platformInfo, pPlatformMemory, &pPlatform);
+    }
+
+    IDevice* pDevices[MaxDevices] = {};
+    uint32   deviceCount          = 0;
+
+    if (result == Result::Success)
+    {
+        result = pPlatform->EnumerateDevices(&deviceCount, pDevices);
+    }
+
+    if ((result == Result::Success) && (deviceCount == 0))
+    {
+        result = Result::ErrorUnavailable;
+    }
+
+    if (result == Result::Success)
+    {
+        const int64 startTicks = GetPerfCpuTime();
+        result = pDevices[0]->CommitSettingsAndInit();
+        (*pTicks) = GetPerfCpuTime() - startTicks;
+    }
+
+    for (uint32 idx = 0; idx < deviceCount; ++idx)
+    {
+        pDevices[idx]->Cleanup();
+    }
+
+    if (pPlatform != nullptr)
+    {
+        pPlatform->Destroy();
+    }
+
+    free(pPlatformMemory);
+
+    return result;
+}
+
+// =====================================================================================================================
+// Sorts the measured times in place so that the fastest and median runs can be reported.
+void SortTicks(
+    int64* pTicks,
+    uint32 count)
+{
+    for (uint32 i = 1; i < count; ++i)
+    {
+        const int64 value = pTicks[i];
+        uint32      j     = i;
+
+        for (; (j > 0) && (pTicks[j - 1] > value); --j)
+        {
+            pTicks[j] = pTicks[j - 1];
+        }
+
+        pTicks[j] = value;
+    }
+}
+
+// =====================================================================================================================
+Result RunGpu(
+    NullGpuId   nullGpuId,
+    const char* pName,
+    uint32      iterations)
+{
+    int64  ticks[MaxIterations] = {};
+    Result result               = Result::Success;
+
+    for (uint32 iter = 0; (iter < iterations) && (result == Result::Success); ++iter)
+    {
+        result = MeasureInit(nullGpuId, &ticks[iter]);
+    }
+
+    if (result == Result::Success)
+    {
+        const double msPerTick  = 1000.0 / static_cast<double>(GetPerfFrequency());
+        int64        totalTicks = 0;
+
+        for (uint32 iter = 0; iter < iterations; ++iter)
+        {
+            totalTicks += ticks[iter];
+        }
+
+        SortTicks(ticks, iterations);
+
+        printf("%-12s %10.2f %10.2f %10.2f\n",
+               pName,
+               static_cast<double>(ticks[0]) * msPerTick,
+               static_cast<double>(ticks[iterations / 2]) * msPerTick,
+               (static_cast<double>(totalTicks) * msPerTick) / iterations);
+    }
+    else
+    {
+        fprintf(stderr, "Initializing %s failed (%d).\n", pName, static_cast<int32>(result));
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+// =====================================================================================================================
+int main(
+    int   argc,
+    char* argv[])
+{
+    const uint32 iterations = (argc > 1) ? static_cast<uint32>(strtoul(argv[1], nullptr, 0)) : DefaultIterations;
+
+    if ((iterations == 0) || (iterations > MaxIterations))
+    {
+        fprintf(stderr, "Usage: %s [iterationCount (1-%u)] [nullGpuId]\n", argv[0], MaxIterations);
+        return 1;
+    }
+
+    printf("%u device initializations per GPU\n\n", iterations);
+    printf("%-12s %10s %10s %10s\n", "gpu", "min ms", "median ms", "mean ms");
+
+    Result result = Result::Success;
+
+    if (argc > 2)
+    {
+        result = RunGpu(static_cast<NullGpuId>(strtoul(argv[2], nullptr, 0)), argv[2], iterations);
+    }
+    else
+    {
+        for (uint32 idx = 0; (idx < DefaultGpuCount) && (result == Result::Success); ++idx)
+        {
+            result = RunGpu(DefaultGpus[idx], DefaultGpuNames[idx], iterations);
+        }
+    }
+
+    return (result == Result::Success) ? 0 : 1;
+}